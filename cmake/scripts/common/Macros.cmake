@@ -119,6 +119,15 @@ function(core_add_test_library name)
   endforeach()
 endfunction()
 
+# Add benchmark sources. They are built into the opt-in benchmark binary,
+# not into the unit tests run by ctest
+function(core_add_benchmark_library name)
+  foreach(src IN LISTS SOURCES HEADERS)
+    get_filename_component(src_path "${src}" ABSOLUTE)
+    set(benchmark_sources "${src_path}" ${benchmark_sources} CACHE STRING "" FORCE)
+  endforeach()
+endfunction()
+
 # Add an addon callback library
 # Arguments:
 #   name name of the library to add
@@ -45,10 +45,15 @@
 #endif
 
 #include <lzo/lzo1x.h>
+#ifdef HAVE_LZ4
+#include <lz4.h>
+#include <lz4hc.h>
+#endif
 
 using namespace std;
 
 #define FLAGS_USE_LZO     1
+#define FLAGS_USE_LZ4     2
 
 #define DIR_SEPARATOR "/"
 
@@ -138,7 +143,30 @@ CXBTFFrame appendContent(CXBTFWriter &writer, int width, int height, unsigned ch
 {
   CXBTFFrame frame;
   lzo_uint packedSize = size;
+  XBTFCodec codec = XBTFCodec::LZO;
 
+#ifdef HAVE_LZ4
+  if ((flags & FLAGS_USE_LZ4) == FLAGS_USE_LZ4)
+  {
+    int bound = LZ4_compressBound(size);
+    unsigned char *packed = new unsigned char[bound];
+    int compressed = LZ4_compress_HC((const char *)data, (char *)packed, size, bound, LZ4HC_CLEVEL_MAX);
+    if (compressed <= 0 || (unsigned int)compressed >= size)
+    {
+      // compression failed, or compressed size isn't smaller than uncompressed, so store as uncompressed
+      packedSize = size;
+      writer.AppendContent(data, size);
+    }
+    else
+    {
+      packedSize = compressed;
+      writer.AppendContent(packed, packedSize);
+      codec = XBTFCodec::LZ4;
+    }
+    delete[] packed;
+  }
+  else
+#endif
   if ((flags & FLAGS_USE_LZO) == FLAGS_USE_LZO)
   {
     // grab a temporary buffer for unpacking into
@@ -179,6 +207,7 @@ CXBTFFrame appendContent(CXBTFWriter &writer, int width, int height, unsigned ch
   frame.SetWidth(width);
   frame.SetHeight(height);
   frame.SetFormat(hasAlpha ? format : format | XB_FMT_OPAQUE);
+  frame.SetCodec(codec);
   frame.SetDuration(0);
   return frame;
 }
@@ -219,6 +248,9 @@ void Usage()
   puts("  -input <dir>     Input directory. Default: current dir");
   puts("  -output <dir>    Output directory/filename. Default: Textures.xbt");
   puts("  -dupecheck       Enable duplicate file detection. Reduces output file size. Default: off");
+#ifdef HAVE_LZ4
+  puts("  -codec <name>    Compression of the frames, lzo or lz4. lz4 decompresses faster. Default: lzo");
+#endif
 }
 
 static bool checkDupe(struct MD5Context* ctx,
@@ -381,6 +413,18 @@ int main(int argc, char* argv[])
     {
       dupecheck = true;
     }
+#ifdef HAVE_LZ4
+    else if (!platform_stricmp(args[i], "-codec") && i + 1 < args.size())
+    {
+      const char *codec = args[++i];
+      if (!platform_stricmp(codec, "lz4"))
+        flags = FLAGS_USE_LZ4;
+      else if (!platform_stricmp(codec, "lzo"))
+        flags = FLAGS_USE_LZO;
+      else
+        fprintf(stderr, "Unrecognized codec: %s\n", codec);
+    }
+#endif
     else if (!platform_stricmp(args[i], "-output") || !platform_stricmp(args[i], "-o"))
     {
       OutputFilename = args[++i];
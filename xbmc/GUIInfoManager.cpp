@@ -167,7 +167,10 @@ CGUIInfoManager::CGUIInfoManager(void) :
   m_playerShowTime = false;
   m_playerShowInfo = false;
   m_fps = 0.0f;
-  m_refreshCounter = 0;
+  m_lastPlaying = false;
+  m_lastDialogOnScreen = false;
+  m_lastActiveWindow = WINDOW_INVALID;
+  m_lastTime = 0;
   ResetLibraryBools();
 }
 
@@ -6912,9 +6915,9 @@ INFO::InfoPtr CGUIInfoManager::Register(const std::string &expression, int conte
   std::pair<INFOBOOLTYPE::iterator, bool> res;
 
   if (condition.find_first_of("|+[]!") != condition.npos)
-    res = m_bools.insert(std::make_shared<InfoExpression>(condition, context, m_refreshCounter));
+    res = m_bools.insert(std::make_shared<InfoExpression>(condition, context, m_infoSources));
   else
-    res = m_bools.insert(std::make_shared<InfoSingle>(condition, context, m_refreshCounter));
+    res = m_bools.insert(std::make_shared<InfoSingle>(condition, context, m_infoSources));
 
   if (res.second)
     res.first->get()->Initialize();
@@ -10644,7 +10647,123 @@ void CGUIInfoManager::ResetCache()
   m_containerMoves.clear();
   // mark our infobools as dirty
   CSingleLock lock(m_critInfo);
-  ++m_refreshCounter;
+  m_infoSources.ChangedAll();
+}
+
+void CGUIInfoManager::ResetFrameCache()
+{
+  // reset any animation triggers as well
+  m_containerMoves.clear();
+
+  CSingleLock lock(m_critInfo);
+  m_infoSources.Changed(INFO::INFO_SOURCE_OTHER);
+  m_infoSources.Changed(INFO::INFO_SOURCE_LISTITEM);
+
+  // playback state changes all the time while playing, and once when playback ends
+  bool playing = g_application.m_pPlayer->IsPlaying();
+  if (playing || m_lastPlaying)
+    m_infoSources.Changed(INFO::INFO_SOURCE_PLAYER);
+  m_lastPlaying = playing;
+
+  // dialogs can be opened and closed without the active window changing, and their
+  // close animations affect whether they count as active
+  bool dialogOnScreen = g_windowManager.HasDialogOnScreen();
+  int activeWindow = g_windowManager.GetActiveWindow();
+  if (dialogOnScreen || m_lastDialogOnScreen || activeWindow != m_lastActiveWindow)
+    m_infoSources.Changed(INFO::INFO_SOURCE_WINDOW);
+  m_lastDialogOnScreen = dialogOnScreen;
+  m_lastActiveWindow = activeWindow;
+
+  time_t now = time(NULL);
+  if (now != m_lastTime)
+    m_infoSources.Changed(INFO::INFO_SOURCE_TIME);
+  m_lastTime = now;
+}
+
+unsigned int CGUIInfoManager::GetDependencies(int condition, bool listItemDependent) const
+{
+  if (listItemDependent)
+    return INFO_DEPENDS_ON(INFO::INFO_SOURCE_LISTITEM) | INFO_DEPENDS_ON(INFO::INFO_SOURCE_OTHER);
+
+  condition = abs(condition);
+  if (condition >= MULTI_INFO_START && condition <= MULTI_INFO_END)
+  {
+    switch (abs(m_multiInfo[condition - MULTI_INFO_START].m_info))
+    {
+      case SYSTEM_DATE:
+      case SYSTEM_TIME:
+        return INFO_DEPENDS_ON(INFO::INFO_SOURCE_TIME);
+      case WINDOW_NEXT:
+      case WINDOW_PREVIOUS:
+      case WINDOW_IS_VISIBLE:
+      case WINDOW_IS_TOPMOST:
+      case WINDOW_IS_ACTIVE:
+        return INFO_DEPENDS_ON(INFO::INFO_SOURCE_WINDOW);
+      default:
+        return INFO_DEPENDS_ON(INFO::INFO_SOURCE_OTHER);
+    }
+  }
+
+  if (condition >= LIBRARY_HAS_MUSIC && condition <= LIBRARY_HAS_COMPILATIONS)
+    return INFO_DEPENDS_ON(INFO::INFO_SOURCE_LIBRARY);
+
+  switch (condition)
+  {
+    case SYSTEM_ALWAYS_TRUE:
+    case SYSTEM_ALWAYS_FALSE:
+    case SYSTEM_ETHERNET_LINK_ACTIVE:
+    case SYSTEM_PLATFORM_LINUX:
+    case SYSTEM_PLATFORM_WINDOWS:
+    case SYSTEM_PLATFORM_DARWIN:
+    case SYSTEM_PLATFORM_DARWIN_OSX:
+    case SYSTEM_PLATFORM_DARWIN_IOS:
+    case SYSTEM_PLATFORM_ANDROID:
+    case SYSTEM_PLATFORM_LINUX_RASPBERRY_PI:
+      return 0;
+    case WINDOW_IS_MEDIA:
+      return INFO_DEPENDS_ON(INFO::INFO_SOURCE_WINDOW);
+    // only ever true while playing, see GetBool()
+    case PLAYER_HAS_MEDIA:
+    case PLAYER_HAS_AUDIO:
+    case PLAYER_HAS_VIDEO:
+    case PLAYER_HAS_GAME:
+    case PLAYER_PLAYING:
+    case PLAYER_PAUSED:
+    case PLAYER_REWINDING:
+    case PLAYER_REWINDING_2x:
+    case PLAYER_REWINDING_4x:
+    case PLAYER_REWINDING_8x:
+    case PLAYER_REWINDING_16x:
+    case PLAYER_REWINDING_32x:
+    case PLAYER_FORWARDING:
+    case PLAYER_FORWARDING_2x:
+    case PLAYER_FORWARDING_4x:
+    case PLAYER_FORWARDING_8x:
+    case PLAYER_FORWARDING_16x:
+    case PLAYER_FORWARDING_32x:
+    case PLAYER_CAN_PAUSE:
+    case PLAYER_CAN_SEEK:
+    case PLAYER_SUPPORTS_TEMPO:
+    case PLAYER_IS_TEMPO:
+    case PLAYER_DISPLAY_AFTER_SEEK:
+    case PLAYER_CACHING:
+    case PLAYER_SEEKBAR:
+    case PLAYER_SEEKING:
+    case PLAYER_SHOWTIME:
+    case PLAYER_PASSTHROUGH:
+    case PLAYER_ISINTERNETSTREAM:
+    case PLAYER_HASDURATION:
+    case MUSICPLAYER_HASPREVIOUS:
+    case MUSICPLAYER_HASNEXT:
+    case VIDEOPLAYER_USING_OVERLAYS:
+    case VIDEOPLAYER_HASMENU:
+    case VIDEOPLAYER_HASTELETEXT:
+    case VIDEOPLAYER_HASSUBTITLES:
+    case VIDEOPLAYER_HAS_EPG:
+      return INFO_DEPENDS_ON(INFO::INFO_SOURCE_PLAYER);
+    default:
+      return INFO_DEPENDS_ON(INFO::INFO_SOURCE_OTHER);
+  }
 }
 
 std::string CGUIInfoManager::GetPictureLabel(int info)
@@ -10814,6 +10933,7 @@ void CGUIInfoManager::SetLibraryBool(int condition, bool value)
     default:
       break;
   }
+  m_infoSources.Changed(INFO::INFO_SOURCE_LIBRARY);
 }
 
 void CGUIInfoManager::ResetLibraryBools()
@@ -10826,6 +10946,7 @@ void CGUIInfoManager::ResetLibraryBools()
   m_libraryHasSingles = -1;
   m_libraryHasCompilations = -1;
   m_libraryRoleCounts.clear();
+  m_infoSources.Changed(INFO::INFO_SOURCE_LIBRARY);
 }
 
 bool CGUIInfoManager::GetLibraryBool(int condition)
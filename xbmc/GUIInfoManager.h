@@ -41,6 +41,7 @@
 #include "pvr/PVRTypes.h"
 
 #include <atomic>
+#include <ctime>
 #include <map>
 #include <string>
 #include <vector>
@@ -201,10 +202,19 @@ public:
   void UpdateAVInfo();
   inline float GetFPS() const { return m_fps; };
 
-  void SetNextWindow(int windowID) { m_nextWindowID = windowID; };
-  void SetPreviousWindow(int windowID) { m_prevWindowID = windowID; };
+  void SetNextWindow(int windowID) { m_nextWindowID = windowID; m_infoSources.Changed(INFO::INFO_SOURCE_WINDOW); };
+  void SetPreviousWindow(int windowID) { m_prevWindowID = windowID; m_infoSources.Changed(INFO::INFO_SOURCE_WINDOW); };
 
+  /*! \brief Mark all info bools as dirty
+   \sa ResetFrameCache
+   */
   void ResetCache();
+
+  /*! \brief Mark the info bools depending on state that changed during the last frame as dirty
+   Called once per frame. Sources that can't tell whether they changed are assumed to change every frame.
+   \sa ResetCache
+   */
+  void ResetFrameCache();
   bool GetItemInt(int &value, const CGUIListItem *item, int info) const;
   std::string GetItemLabel(const CFileItem *item, int info, std::string *fallback = NULL);
   std::string GetItemImage(const CFileItem *item, int info, std::string *fallback = NULL);
@@ -239,6 +249,13 @@ protected:
   bool GetBool(int condition, int contextWindow = 0, const CGUIListItem *item=NULL);
   int TranslateSingleString(const std::string &strCondition, bool &listItemDependent);
 
+  /*! \brief Get the state sources a condition is computed from
+   \param condition condition as returned by TranslateSingleString()
+   \param listItemDependent whether the condition depends on a listitem
+   \return INFO_DEPENDS_ON() flags of the sources
+   */
+  unsigned int GetDependencies(int condition, bool listItemDependent) const;
+
   // routines for window retrieval
   bool CheckWindowCondition(CGUIWindow *window, int condition) const;
   CGUIWindow *GetWindowWithCondition(int contextWindow, int condition) const;
@@ -330,7 +347,13 @@ protected:
 
   typedef std::set<INFO::InfoPtr, bool(*)(const INFO::InfoPtr&, const INFO::InfoPtr&)> INFOBOOLTYPE;
   INFOBOOLTYPE m_bools;
-  unsigned int m_refreshCounter;
+  INFO::InfoSourceCounters m_infoSources;
+
+  // state seen by the last ResetFrameCache()
+  bool m_lastPlaying;
+  bool m_lastDialogOnScreen;
+  int m_lastActiveWindow;
+  time_t m_lastTime;
   std::vector<INFO::CSkinVariableString> m_skinVariableStrings;
 
   int m_libraryHasMusic;
@@ -34,6 +34,7 @@ using namespace ActiveAE;
 #include "settings/Settings.h"
 #include "windowing/WinSystem.h"
 #include "utils/log.h"
+#include "utils/TimeUtils.h"
 
 #define MAX_CACHE_LEVEL 0.4   // total cache time of stream in seconds
 #define MAX_WATER_LEVEL 0.2   // buffered time after stream stages in seconds
@@ -268,6 +269,71 @@ AEAudioFormat CEngineStats::GetCurrentSinkFormat()
   return m_sinkFormat;
 }
 
+CEngineProfile::CEngineProfile() : m_enabled(false)
+{
+  Reset();
+}
+
+void CEngineProfile::Enable(bool enable)
+{
+  Reset();
+  m_enabled = enable;
+}
+
+void CEngineProfile::Reset()
+{
+  CSingleLock lock(m_lock);
+  for (int i = 0; i < STAGE_MAX; i++)
+  {
+    m_ticks[i] = 0;
+    m_calls[i] = 0;
+  }
+  m_packets = 0;
+  m_waterLevelSum = 0.0;
+  m_waterLevelMax = 0.0f;
+}
+
+int64_t CEngineProfile::Start() const
+{
+  if (!m_enabled)
+    return 0;
+  return CurrentHostCounter();
+}
+
+void CEngineProfile::Stop(Stage stage, int64_t start)
+{
+  if (!start)
+    return;
+  int64_t ticks = CurrentHostCounter() - start;
+  CSingleLock lock(m_lock);
+  m_ticks[stage] += ticks;
+  m_calls[stage]++;
+}
+
+void CEngineProfile::AddPacket(float waterLevel)
+{
+  if (!m_enabled)
+    return;
+  CSingleLock lock(m_lock);
+  m_packets++;
+  m_waterLevelSum += waterLevel;
+  m_waterLevelMax = std::max(m_waterLevelMax, waterLevel);
+}
+
+void CEngineProfile::GetSnapshot(Snapshot &snapshot)
+{
+  CSingleLock lock(m_lock);
+  double frequency = CurrentHostFrequency();
+  for (int i = 0; i < STAGE_MAX; i++)
+  {
+    snapshot.time[i] = m_ticks[i] / frequency;
+    snapshot.calls[i] = m_calls[i];
+  }
+  snapshot.packets = m_packets;
+  snapshot.waterLevelAvg = m_packets ? m_waterLevelSum / m_packets : 0.0f;
+  snapshot.waterLevelMax = m_waterLevelMax;
+}
+
 CActiveAE::CActiveAE() :
   CThread("ActiveAE"),
   m_controlPort("OutputControlPort", &m_inMsgEvent, &m_outMsgEvent),
@@ -1840,7 +1906,11 @@ bool CActiveAE::RunStages()
   for (it = m_streams.begin(); it != m_streams.end(); ++it)
   {
     if ((*it)->m_processingBuffers && !(*it)->m_paused)
+    {
+      int64_t start = m_profile.Start();
       busy = (*it)->m_processingBuffers->ProcessBuffers();
+      m_profile.Stop(CEngineProfile::STAGE_PROCESS, start);
+    }
 
     if ((*it)->m_streamIsBuffering &&
         (*it)->m_processingBuffers &&
@@ -1965,6 +2035,7 @@ bool CActiveAE::RunStages()
           allStreamsReady = false;
       }
 
+      int64_t mixStart = m_profile.Start();
       bool needClamp = false;
       for (it = m_streams.begin(); it != m_streams.end() && allStreamsReady; ++it)
       {
@@ -2047,15 +2118,7 @@ bool CActiveAE::RunStages()
 
               for(int j=0; j<out->pkt->planes; j++)
               {
-#if defined(HAVE_SSE) && defined(__SSE__)
-                CAEUtil::SSEMulArray((float*)out->pkt->data[j]+i*nb_floats, volume, nb_floats);
-#else
-                float* fbuffer = (float*) out->pkt->data[j]+i*nb_floats;
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  fbuffer[k] *= volume;
-                }
-#endif
+                CAEUtil::MulArray((float*)out->pkt->data[j]+i*nb_floats, volume, nb_floats);
               }
             }
           }
@@ -2116,24 +2179,8 @@ bool CActiveAE::RunStages()
               {
                 float *dst = (float*)out->pkt->data[j]+i*nb_floats;
                 float *src = (float*)mix->pkt->data[j]+i*nb_floats;
-#if defined(HAVE_SSE) && defined(__SSE__)
-                CAEUtil::SSEMulAddArray(dst, src, volume, nb_floats);
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  if (fabs(dst[k]) > 1.0f)
-                  {
-                    needClamp = true;
-                    break;
-                  }
-                }
-#else
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  dst[k] += src[k] * volume;
-                  if (fabs(dst[k]) > 1.0f)
-                    needClamp = true;
-                }
-#endif
+                if (CAEUtil::MulAddArray(dst, src, volume, nb_floats))
+                  needClamp = true;
               }
             }
             mix->Return();
@@ -2151,6 +2198,8 @@ bool CActiveAE::RunStages()
           CAEUtil::ClampArray((float*)out->pkt->data[i], nb_floats);
         }
       }
+      if (out)
+        m_profile.Stop(CEngineProfile::STAGE_MIX, mixStart);
 
       // process output buffer, gui sounds, encode, viz
       if (out)
@@ -2208,12 +2257,15 @@ bool CActiveAE::RunStages()
         }
 
         // mix gui sounds
+        int64_t start = m_profile.Start();
         MixSounds(*(out->pkt));
         if (!m_sinkHasVolume || m_muted)
           Deamplify(*(out->pkt));
+        m_profile.Stop(CEngineProfile::STAGE_SOUNDS, start);
 
         if (m_mode == MODE_TRANSCODE && m_encoder)
         {
+          start = m_profile.Start();
           CSampleBuffer *buf = m_encoderBuffers->GetFreeBuffer();
           buf->pkt->nb_samples = m_encoder->Encode(out->pkt->data[0], out->pkt->planes*out->pkt->linesize,
                                                    buf->pkt->data[0], buf->pkt->planes*buf->pkt->linesize);
@@ -2224,6 +2276,7 @@ bool CActiveAE::RunStages()
 
           out->Return();
           out = buf;
+          m_profile.Stop(CEngineProfile::STAGE_ENCODE, start);
         }
         busy = true;
       }
@@ -2233,6 +2286,7 @@ bool CActiveAE::RunStages()
       {
         int samples = (m_mode == MODE_TRANSCODE) ? 1 : out->pkt->nb_samples;
         m_stats.AddSamples(samples, m_streams);
+        m_profile.AddPacket(m_stats.GetWaterLevel());
         m_sinkBuffers->m_inputSamples.push_back(out);
       }
     }
@@ -2254,6 +2308,7 @@ bool CActiveAE::RunStages()
             (*it)->m_processingBuffers->m_outputSamples.pop_front();
           }
           m_stats.AddSamples(1, m_streams);
+          m_profile.AddPacket(m_stats.GetWaterLevel());
           m_sinkBuffers->m_inputSamples.push_back(buffer);
         }
       }
@@ -2261,7 +2316,9 @@ bool CActiveAE::RunStages()
   }
 
   // serve sink buffers
+  int64_t start = m_profile.Start();
   busy |= m_sinkBuffers->ResampleBuffers();
+  m_profile.Stop(CEngineProfile::STAGE_RESAMPLE, start);
   while(!m_sinkBuffers->m_outputSamples.empty())
   {
     CSampleBuffer *out = NULL;
@@ -2512,12 +2569,7 @@ void CActiveAE::MixSounds(CSoundPacket &dstSample)
       out = (float*)dstSample.data[j];
       sample_buffer = (float*)(it->sound->GetSound(false)->data[j]+start);
       int nb_floats = mix_samples * dstSample.config.channels / dstSample.planes;
-#if defined(HAVE_SSE) && defined(__SSE__)
-      CAEUtil::SSEMulAddArray(out, sample_buffer, volume, nb_floats);
-#else
-      for (int k = 0; k < nb_floats; ++k)
-        *out++ += *sample_buffer++ * volume;
-#endif
+      CAEUtil::MulAddArray(out, sample_buffer, volume, nb_floats);
     }
 
     it->samples_played += mix_samples;
@@ -2542,13 +2594,7 @@ void CActiveAE::Deamplify(CSoundPacket &dstSample)
     for(int j=0; j<dstSample.planes; j++)
     {
       float* buffer = reinterpret_cast<float*>(dstSample.data[j]);
-#if defined(HAVE_SSE) && defined(__SSE__)
-      CAEUtil::SSEMulArray(buffer, volume, nb_floats);
-#else
-      float *fbuffer = buffer;
-      for (int i = 0; i < nb_floats; i++)
-        *fbuffer++ *= volume;
-#endif
+      CAEUtil::MulArray(buffer, volume, nb_floats);
     }
   }
 }
@@ -19,6 +19,7 @@
  *
  */
 
+#include <atomic>
 #include <list>
 #include <string>
 #include <vector>
@@ -224,6 +225,54 @@ protected:
   std::vector<StreamStats> m_streamStats;
 };
 
+/*!
+ \brief Cost of the stages RunStages goes through
+
+ Only collected while enabled, the engine benchmark turns it on. Timings are
+ taken on the engine thread and can be read from any other thread.
+ */
+class CEngineProfile
+{
+public:
+  enum Stage
+  {
+    STAGE_PROCESS,  ///< ProcessBuffers of the streams, resample and dsp
+    STAGE_MIX,      ///< volume, fading and mixing of the streams
+    STAGE_SOUNDS,   ///< gui sounds and deamplification
+    STAGE_ENCODE,   ///< transcoding for passthrough sinks
+    STAGE_RESAMPLE, ///< conversion of the mix to the sink format
+    STAGE_MAX
+  };
+
+  struct Snapshot
+  {
+    double time[STAGE_MAX];     ///< seconds spent in the stage
+    uint64_t calls[STAGE_MAX];
+    uint64_t packets;           ///< packets handed over to the sink
+    float waterLevelAvg;        ///< seconds buffered between engine and sink
+    float waterLevelMax;
+  };
+
+  CEngineProfile();
+  void Enable(bool enable);
+  void Reset();
+  /*!
+   \brief Start timing a stage, returns 0 if the profile is disabled
+   */
+  int64_t Start() const;
+  void Stop(Stage stage, int64_t start);
+  void AddPacket(float waterLevel);
+  void GetSnapshot(Snapshot &snapshot);
+protected:
+  std::atomic<bool> m_enabled;
+  CCriticalSection m_lock;
+  int64_t m_ticks[STAGE_MAX];
+  uint64_t m_calls[STAGE_MAX];
+  uint64_t m_packets;
+  double m_waterLevelSum;
+  float m_waterLevelMax;
+};
+
 class CActiveAE : public IAE, public IDispResource, private CThread
 {
 protected:
@@ -279,6 +328,12 @@ public:
   void OnResetDisplay() override;
   void OnAppFocusChange(bool focus) override;
 
+  /*!
+   \brief Timing of the engine stages, see CEngineProfile
+   */
+  void EnableProfile(bool enable) { m_profile.Enable(enable); }
+  void GetProfile(CEngineProfile::Snapshot &snapshot) { m_profile.GetSnapshot(snapshot); }
+
 protected:
   void PlaySound(CActiveAESound *sound);
   static uint8_t **AllocSoundSample(SampleConfig &config, int &samples, int &bytes_per_sample, int &planes, int &linesize);
@@ -362,6 +417,7 @@ protected:
   AEAudioFormat m_inputFormat;
   AudioSettings m_settings;
   CEngineStats m_stats;
+  CEngineProfile m_profile;
   IAEEncoder *m_encoder;
   std::string m_currDevice;
 
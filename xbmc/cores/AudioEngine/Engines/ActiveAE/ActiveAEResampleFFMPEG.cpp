@@ -18,6 +18,7 @@
  *
  */
 
+#include "cores/AudioEngine/Utils/AEKernels.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "ActiveAEResampleFFMPEG.h"
 #include "utils/log.h"
@@ -34,6 +35,7 @@ CActiveAEResampleFFMPEG::CActiveAEResampleFFMPEG()
 {
   m_pContext = NULL;
   m_doesResample = false;
+  m_convert = false;
 }
 
 CActiveAEResampleFFMPEG::~CActiveAEResampleFFMPEG()
@@ -105,6 +107,10 @@ bool CActiveAEResampleFFMPEG::Init(uint64_t dst_chan_layout, int dst_channels, i
      av_opt_set_double(m_pContext, "rematrix_maxval", 1.0, 0);
   }
 
+  // without resampling or mixing channels only the sample format changes,
+  // which the kernels do without going through swresample
+  bool sameChannels = m_src_channels == m_dst_channels && m_src_chan_layout == m_dst_chan_layout;
+
   if (remapLayout)
   {
     // one-to-one mapping of channels
@@ -112,6 +118,7 @@ bool CActiveAEResampleFFMPEG::Init(uint64_t dst_chan_layout, int dst_channels, i
     // the channel is mapped by setting coef 1.0
     memset(m_rematrix, 0, sizeof(m_rematrix));
     m_dst_chan_layout = 0;
+    sameChannels = (int)remapLayout->Count() == m_src_channels && m_src_channels == m_dst_channels;
     for (unsigned int out=0; out<remapLayout->Count(); out++)
     {
       m_dst_chan_layout += ((uint64_t)1) << out;
@@ -120,6 +127,8 @@ bool CActiveAEResampleFFMPEG::Init(uint64_t dst_chan_layout, int dst_channels, i
       {
         m_rematrix[out][idx] = 1.0;
       }
+      if (idx != (int)out)
+        sameChannels = false;
     }
 
     av_opt_set_int(m_pContext, "out_channel_count", m_dst_channels, 0);
@@ -134,6 +143,7 @@ bool CActiveAEResampleFFMPEG::Init(uint64_t dst_chan_layout, int dst_channels, i
   // stereo upmix
   else if (upmix && m_src_channels == 2 && m_dst_channels > 2)
   {
+    sameChannels = false;
     memset(m_rematrix, 0, sizeof(m_rematrix));
     for (int out=0; out<m_dst_channels; out++)
     {
@@ -175,9 +185,51 @@ bool CActiveAEResampleFFMPEG::Init(uint64_t dst_chan_layout, int dst_channels, i
     CLog::Log(LOGERROR, "CActiveAEResampleFFMPEG::Init - init resampler failed");
     return false;
   }
+
+  // the context is still set up, it takes over once the ratio changes
+  m_convert = !m_doesResample && sameChannels && CanConvert(m_dst_fmt, m_src_fmt);
   return true;
 }
 
+bool CActiveAEResampleFFMPEG::CanConvert(AVSampleFormat dst_fmt, AVSampleFormat src_fmt)
+{
+  if (av_sample_fmt_is_planar(dst_fmt) != av_sample_fmt_is_planar(src_fmt))
+    return false;
+
+  dst_fmt = av_get_packed_sample_fmt(dst_fmt);
+  src_fmt = av_get_packed_sample_fmt(src_fmt);
+  if (src_fmt == AV_SAMPLE_FMT_FLT)
+    return dst_fmt == AV_SAMPLE_FMT_S16 || dst_fmt == AV_SAMPLE_FMT_S32;
+  if (dst_fmt == AV_SAMPLE_FMT_FLT)
+    return src_fmt == AV_SAMPLE_FMT_S16 || src_fmt == AV_SAMPLE_FMT_S32;
+  return false;
+}
+
+int CActiveAEResampleFFMPEG::Convert(uint8_t **dst_buffer, uint8_t **src_buffer, int samples)
+{
+  if (samples <= 0 || !src_buffer)
+    return 0;
+
+  const AEKernels &kernels = AEKernels::Get();
+  AVSampleFormat dst_fmt = av_get_packed_sample_fmt(m_dst_fmt);
+  AVSampleFormat src_fmt = av_get_packed_sample_fmt(m_src_fmt);
+  int planes = av_sample_fmt_is_planar(m_dst_fmt) ? m_dst_channels : 1;
+  uint32_t count = samples * m_dst_channels / planes;
+
+  for (int i=0; i<planes; i++)
+  {
+    if (src_fmt == AV_SAMPLE_FMT_FLT && dst_fmt == AV_SAMPLE_FMT_S16)
+      kernels.floatToS16((const float*)src_buffer[i], (int16_t*)dst_buffer[i], count);
+    else if (src_fmt == AV_SAMPLE_FMT_FLT)
+      kernels.floatToS32((const float*)src_buffer[i], (int32_t*)dst_buffer[i], count);
+    else if (src_fmt == AV_SAMPLE_FMT_S16)
+      kernels.s16ToFloat((const int16_t*)src_buffer[i], (float*)dst_buffer[i], count);
+    else
+      kernels.s32ToFloat((const int32_t*)src_buffer[i], (float*)dst_buffer[i], count);
+  }
+  return samples;
+}
+
 int CActiveAEResampleFFMPEG::Resample(uint8_t **dst_buffer, int dst_samples, uint8_t **src_buffer, int src_samples, double ratio)
 {
   int delta = 0;
@@ -189,20 +241,31 @@ int CActiveAEResampleFFMPEG::Resample(uint8_t **dst_buffer, int dst_samples, uin
     m_doesResample = true;
   }
 
-  if (m_doesResample)
+  int ret;
+  // swresample would buffer what doesn't fit, from then on it has to do all the work
+  if (m_convert && !m_doesResample && src_samples <= dst_samples)
+  {
+    ret = Convert(dst_buffer, src_buffer, src_samples);
+  }
+  else
   {
-    if (swr_set_compensation(m_pContext, delta, distance) < 0)
+    m_convert = false;
+
+    if (m_doesResample)
     {
-      CLog::Log(LOGERROR, "CActiveAEResampleFFMPEG::Resample - set compensation failed");
-      return -1;
+      if (swr_set_compensation(m_pContext, delta, distance) < 0)
+      {
+        CLog::Log(LOGERROR, "CActiveAEResampleFFMPEG::Resample - set compensation failed");
+        return -1;
+      }
     }
-  }
 
-  int ret = swr_convert(m_pContext, dst_buffer, dst_samples, (const uint8_t**)src_buffer, src_samples);
-  if (ret < 0)
-  {
-    CLog::Log(LOGERROR, "CActiveAEResampleFFMPEG::Resample - resample failed");
-    return -1;
+    ret = swr_convert(m_pContext, dst_buffer, dst_samples, (const uint8_t**)src_buffer, src_samples);
+    if (ret < 0)
+    {
+      CLog::Log(LOGERROR, "CActiveAEResampleFFMPEG::Resample - resample failed");
+      return -1;
+    }
   }
 
   // special handling for S24 formats which are carried in S32
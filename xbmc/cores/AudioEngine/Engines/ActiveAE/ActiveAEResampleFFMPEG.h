@@ -49,8 +49,12 @@ public:
   int GetDstBufferSize(int samples) override;
 
 protected:
+  static bool CanConvert(AVSampleFormat dst_fmt, AVSampleFormat src_fmt);
+  int Convert(uint8_t **dst_buffer, uint8_t **src_buffer, int samples);
+
   bool m_loaded;
   bool m_doesResample;
+  bool m_convert; ///< only the sample format changes, swresample is bypassed
   uint64_t m_src_chan_layout, m_dst_chan_layout;
   int m_src_rate, m_dst_rate;
   int m_src_channels, m_dst_channels;
@@ -923,8 +923,6 @@ unsigned int CActiveAESink::OutputSamples(CSampleBuffer* samples)
   unsigned int maxFrames;
   int retry = 0;
   unsigned int written = 0;
-  std::unique_ptr<uint8_t[]> mergebuffer;
-  uint8_t* p_mergebuffer = NULL;
   AEDelayStatus status;
 
   if (m_requestedFormat.m_dataFormat == AE_FMT_RAW)
@@ -996,19 +994,17 @@ unsigned int CActiveAESink::OutputSamples(CSampleBuffer* samples)
     {
       if (m_sinkFormat.m_streamInfo.m_type == CAEStreamInfo::STREAM_TYPE_TRUEHD && frames == 61440)
       {
+        // the buffer is ours until it is returned, merge the units in place
         int offset;
         int len;
         unsigned int size = 0;
-        mergebuffer.reset(new uint8_t[MAX_IEC61937_PACKET]);
-        p_mergebuffer = mergebuffer.get();
         for (int i=0; i<24; i++)
         {
           offset = i*2560;
           len = (*(buffer[0] + offset+2560-2) << 8) + *(buffer[0] + offset+2560-1);
-          memcpy(&(mergebuffer.get())[size], buffer[0] + offset, len);
+          memmove(buffer[0] + size, buffer[0] + offset, len);
           size += len;
         }
-        buffer = &p_mergebuffer;
         totalFrames = size / m_sinkFormat.m_frameSize;
         frames = totalFrames;
       }
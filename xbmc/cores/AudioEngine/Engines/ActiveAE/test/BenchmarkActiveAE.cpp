@@ -0,0 +1,219 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ServiceBroker.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAE.h"
+#include "cores/AudioEngine/Interfaces/AEStream.h"
+#include "cores/AudioEngine/Utils/AEAudioFormat.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "settings/Settings.h"
+#include "test/AllocationCounter.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define BENCHMARK_WARMUP_MS 500
+#define BENCHMARK_MS 2000
+#define BENCHMARK_POLL_MS 20
+
+// share of the wall time each stage may take, in percent. The engine of a
+// slow CI host stays well below these, so exceeding one means a stage got
+// several times slower rather than noise.
+static const double stageBudget[] = { 20.0, 10.0, 5.0, 20.0, 15.0 };
+static const double engineBudget = 40.0;
+
+using namespace ActiveAE;
+using ::testing::Test;
+using ::testing::WithParamInterface;
+using ::testing::ValuesIn;
+
+struct BenchmarkActiveAEData
+{
+  const char *name;
+  AEStdChLayout layout;
+  unsigned int sampleRate;
+  AEDataFormat dataFormat;
+  int streams;
+};
+
+std::ostream& operator<<(std::ostream& os, const BenchmarkActiveAEData& rhs)
+{
+  return os << rhs.name;
+}
+
+/*!
+ Plays synthetic streams through ActiveAE into the NULL sink, which needs no
+ hardware and consumes in real time, and records what the engine thread spent
+ on every stage as test properties. Every stage has to stay within its budget.
+ */
+class BenchmarkActiveAE : public Test,
+                              public WithParamInterface<BenchmarkActiveAEData>
+{
+protected:
+  void SetUp() override
+  {
+    m_ae = dynamic_cast<CActiveAE*>(&CServiceBroker::GetActiveAE());
+    ASSERT_NE(nullptr, m_ae);
+
+    m_device = CServiceBroker::GetSettings().GetString(CSettings::SETTING_AUDIOOUTPUT_AUDIODEVICE);
+    CServiceBroker::GetSettings().SetString(CSettings::SETTING_AUDIOOUTPUT_AUDIODEVICE, "NULL:NULL");
+    m_ae->OnSettingsChange(CSettings::SETTING_AUDIOOUTPUT_AUDIODEVICE);
+  }
+
+  void TearDown() override
+  {
+    if (!m_ae)
+      return;
+    m_ae->EnableProfile(false);
+    CServiceBroker::GetSettings().SetString(CSettings::SETTING_AUDIOOUTPUT_AUDIODEVICE, m_device);
+    m_ae->OnSettingsChange(CSettings::SETTING_AUDIOOUTPUT_AUDIODEVICE);
+  }
+
+  // one second of a tone, channels a few Hz apart
+  static std::vector<uint8_t> MakeTone(const AEAudioFormat &format)
+  {
+    unsigned int channels = format.m_channelLayout.Count();
+    std::vector<uint8_t> data(format.m_sampleRate * format.m_frameSize);
+    for (unsigned int frame = 0; frame < format.m_sampleRate; frame++)
+    {
+      for (unsigned int ch = 0; ch < channels; ch++)
+      {
+        float sample = 0.5f * sin(2 * M_PI * (440 + ch * 5) * frame / format.m_sampleRate);
+        unsigned int i = frame * channels + ch;
+        if (format.m_dataFormat == AE_FMT_FLOAT)
+          ((float*)data.data())[i] = sample;
+        else if (format.m_dataFormat == AE_FMT_S32NE)
+          ((int32_t*)data.data())[i] = sample * INT32_MAX;
+        else
+          ((int16_t*)data.data())[i] = sample * INT16_MAX;
+      }
+    }
+    return data;
+  }
+
+  CActiveAE *m_ae = nullptr;
+  std::string m_device;
+};
+
+TEST_P(BenchmarkActiveAE, NullSink)
+{
+  const BenchmarkActiveAEData &param = GetParam();
+
+  AEAudioFormat format;
+  format.m_dataFormat = param.dataFormat;
+  format.m_sampleRate = param.sampleRate;
+  format.m_channelLayout = CAEChannelInfo(param.layout);
+  format.m_frameSize = format.m_channelLayout.Count() * (CAEUtil::DataFormatToBits(format.m_dataFormat) >> 3);
+  std::vector<uint8_t> tone = MakeTone(format);
+
+  std::vector<IAEStream*> streams;
+  for (int i = 0; i < param.streams; i++)
+  {
+    IAEStream *stream = m_ae->MakeStream(format);
+    ASSERT_NE(nullptr, stream);
+    streams.push_back(stream);
+  }
+
+  // AddData blocks until the engine takes the data, the way a player does
+  std::atomic<bool> stop(false);
+  std::vector<std::thread> feeders;
+  for (IAEStream *stream : streams)
+  {
+    feeders.emplace_back([&stop, &tone, &format, stream]() {
+      const uint8_t *data = tone.data();
+      unsigned int chunk = format.m_sampleRate / 50;
+      unsigned int offset = 0;
+      while (!stop)
+      {
+        offset += stream->AddData(&data, offset, chunk);
+        if (offset + chunk > format.m_sampleRate)
+          offset = 0;
+      }
+    });
+  }
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(BENCHMARK_WARMUP_MS));
+
+  std::vector<double> delays;
+  delays.reserve(BENCHMARK_MS / BENCHMARK_POLL_MS + 1);
+  m_ae->EnableProfile(true);
+  CAllocationCounter allocations(CAllocationCounter::ALL_THREADS);
+  auto start = std::chrono::steady_clock::now();
+  while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(BENCHMARK_MS))
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(BENCHMARK_POLL_MS));
+    delays.push_back(streams.front()->GetDelay() * 1000);
+  }
+  double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  uint64_t allocationCount = allocations.GetCount();
+  uint64_t allocationBytes = allocations.GetBytes();
+  CEngineProfile::Snapshot profile;
+  m_ae->GetProfile(profile);
+  m_ae->EnableProfile(false);
+
+  stop = true;
+  for (auto &feeder : feeders)
+    feeder.join();
+  for (IAEStream *stream : streams)
+    m_ae->FreeStream(stream);
+
+  static const char *stages[] = { "process", "mix", "sounds", "encode", "resample" };
+  double busy = 0.0;
+  for (int i = 0; i < CEngineProfile::STAGE_MAX; i++)
+  {
+    busy += profile.time[i];
+    RecordProperty(std::string(stages[i]) + "_us", static_cast<int>(profile.time[i] * 1e6));
+    RecordProperty(std::string(stages[i]) + "_calls", static_cast<int>(profile.calls[i]));
+    EXPECT_LT(profile.time[i] * 100 / wall, stageBudget[i]) << stages[i];
+  }
+  std::sort(delays.begin(), delays.end());
+  RecordProperty("wall_ms", static_cast<int>(wall * 1000));
+  RecordProperty("engine_load_permille", static_cast<int>(busy * 1000 / wall));
+  RecordProperty("packets", static_cast<int>(profile.packets));
+  RecordProperty("water_level_avg_ms", static_cast<int>(profile.waterLevelAvg * 1000));
+  RecordProperty("water_level_max_ms", static_cast<int>(profile.waterLevelMax * 1000));
+  RecordProperty("delay_median_ms", static_cast<int>(delays[delays.size() / 2]));
+  RecordProperty("delay_max_ms", static_cast<int>(delays.back()));
+  RecordProperty("allocations_per_s", static_cast<int>(allocationCount / wall));
+  RecordProperty("allocated_kib_per_s", static_cast<int>(allocationBytes / wall / 1024));
+
+  EXPECT_LT(0u, profile.packets);
+  EXPECT_LT(0u, profile.calls[CEngineProfile::STAGE_PROCESS]);
+  EXPECT_LT(0u, profile.calls[CEngineProfile::STAGE_MIX]);
+  EXPECT_LT(busy * 100 / wall, engineBudget);
+}
+
+const BenchmarkActiveAEData configurations[] = {
+  { "stereo 44.1 kHz s16", AE_CH_LAYOUT_2_0, 44100, AE_FMT_S16NE, 1 },
+  { "stereo 48 kHz float", AE_CH_LAYOUT_2_0, 48000, AE_FMT_FLOAT, 1 },
+  { "5.1 48 kHz float", AE_CH_LAYOUT_5_1, 48000, AE_FMT_FLOAT, 1 },
+  { "7.1 96 kHz s32", AE_CH_LAYOUT_7_1, 96000, AE_FMT_S32NE, 1 },
+  { "2 x stereo 44.1 kHz s16", AE_CH_LAYOUT_2_0, 44100, AE_FMT_S16NE, 2 },
+};
+
+INSTANTIATE_TEST_CASE_P(ActiveAE, BenchmarkActiveAE, ValuesIn(configurations));
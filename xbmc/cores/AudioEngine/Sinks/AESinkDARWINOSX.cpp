@@ -20,6 +20,7 @@
 
 #include "cores/AudioEngine/Engines/ActiveAE/ActiveAE.h"
 #include "cores/AudioEngine/Sinks/AESinkDARWINOSX.h"
+#include "cores/AudioEngine/Utils/AEKernels.h"
 #include "cores/AudioEngine/Utils/AERingBuffer.h"
 #include "cores/AudioEngine/Sinks/osx/CoreAudioHelpers.h"
 #include "cores/AudioEngine/Sinks/osx/CoreAudioHardware.h"
@@ -491,21 +492,23 @@ OSStatus CAESinkDARWINOSX::renderCallback(AudioDeviceID inDevice, const AudioTim
     {
       /* HACK for bitstreaming AC3/DTS via PCM.
        We reverse the float->S16LE conversion done in the stream or device */
-      static const float mul = 1.0f / (INT16_MAX + 1);
-
       size_t wanted = outOutputData->mBuffers[0].mDataByteSize / sizeof(float) * sizeof(int16_t);
       size_t bytes = std::min((size_t)sink->m_buffer->GetReadSize(), wanted);
-      for (unsigned int j = 0; j < bytes / sizeof(int16_t); j++)
+      size_t samples = bytes / sizeof(int16_t);
+      for (unsigned int i = startIdx; i < endIdx; i++)
       {
-        for (unsigned int i = startIdx; i < endIdx; i++)
+        float *dest = NULL;
+        if (i < outOutputData->mNumberBuffers)
+          dest = (float *)outOutputData->mBuffers[i].mData;
+
+        // convert in chunks, no allocations on the render thread
+        int16_t src[512];
+        for (size_t done = 0; done < samples; done += sizeof(src) / sizeof(int16_t))
         {
-          int16_t src;
-          sink->m_buffer->Read((unsigned char *)&src, sizeof(int16_t), i);
-          if (i < outOutputData->mNumberBuffers && outOutputData->mBuffers[i].mData)
-          {
-            float *dest = (float *)outOutputData->mBuffers[i].mData;
-            dest[j] = src * mul;
-          }
+          size_t count = std::min(samples - done, sizeof(src) / sizeof(int16_t));
+          sink->m_buffer->Read((unsigned char *)src, count * sizeof(int16_t), i);
+          if (dest)
+            AEKernels::Get().s16ToFloat(src, dest + done, count);
         }
       }
       LogLevel(bytes, wanted);
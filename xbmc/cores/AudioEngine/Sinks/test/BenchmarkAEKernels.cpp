@@ -0,0 +1,66 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AEKernels.h"
+#include "utils/Stopwatch.h"
+
+#include "gtest/gtest.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#define BENCHMARK_SAMPLES 8192
+#define BENCHMARK_LOOPS 2000
+
+TEST(BenchmarkAEKernels, MixAndConvert)
+{
+  std::mt19937 random(4711);
+  std::uniform_real_distribution<float> distribution(-1.5f, 1.5f);
+  std::vector<float> mix(BENCHMARK_SAMPLES);
+  std::vector<float> stream(BENCHMARK_SAMPLES);
+  for (auto &sample : stream)
+    sample = distribution(random);
+  std::vector<int16_t> s16(BENCHMARK_SAMPLES);
+  std::vector<int32_t> s32(BENCHMARK_SAMPLES);
+  CStopWatch watch;
+
+  for (const AEKernels *kernels : AEKernels::GetAvailable())
+  {
+    watch.StartZero();
+    for (int i = 0; i < BENCHMARK_LOOPS; i++)
+    {
+      kernels->mulAddArray(mix.data(), stream.data(), 0.5f, BENCHMARK_SAMPLES);
+      kernels->mulArray(mix.data(), 0.5f, BENCHMARK_SAMPLES);
+    }
+    float timeMix = watch.GetElapsedMilliseconds();
+
+    watch.StartZero();
+    for (int i = 0; i < BENCHMARK_LOOPS; i++)
+    {
+      kernels->floatToS16(stream.data(), s16.data(), BENCHMARK_SAMPLES);
+      kernels->floatToS32(stream.data(), s32.data(), BENCHMARK_SAMPLES);
+    }
+    float timeConvert = watch.GetElapsedMilliseconds();
+
+    ::testing::Test::RecordProperty(std::string(kernels->name) + "_mix_us", static_cast<int>(timeMix * 1000));
+    ::testing::Test::RecordProperty(std::string(kernels->name) + "_convert_us", static_cast<int>(timeConvert * 1000));
+  }
+}
@@ -0,0 +1,182 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AEKernels.h"
+
+#include "gtest/gtest.h"
+
+#include <random>
+#include <string.h>
+#include <vector>
+
+class TestAEKernels : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    // mixes go beyond [-1, 1] before they are clamped
+    std::mt19937 random(4711);
+    std::uniform_real_distribution<float> distribution(-1.5f, 1.5f);
+    m_float.resize(4099);
+    for (auto &sample : m_float)
+      sample = distribution(random);
+
+    // ties, full scale and everything around the rounding corner cases
+    const float edges[] = { 0.0f, -0.0f, 1.0f, -1.0f, 2.0f, -2.0f, 3.0f, -3.0f, 1e6f, -1e6f,
+                            0.5f / 32768, 1.5f / 32768, -0.5f / 32768, -2.5f / 32768,
+                            32766.5f / 32768, -32767.5f / 32768, 32767.5f / 32768,
+                            1.0f / 256, -1.0f / 256, 1.5f / 16777216, 2.5f / 16777216,
+                            0.999999f, -0.999999f };
+    std::copy(std::begin(edges), std::end(edges), m_float.begin() + 100);
+
+    std::uniform_int_distribution<int32_t> s32(INT32_MIN, INT32_MAX);
+    m_s32.resize(m_float.size());
+    m_s16.resize(m_float.size());
+    for (size_t i = 0; i < m_float.size(); i++)
+    {
+      m_s32[i] = s32(random);
+      m_s16[i] = m_s32[i] >> 16;
+    }
+    m_s32[0] = INT32_MIN;
+    m_s32[1] = INT32_MAX;
+    m_s16[0] = INT16_MIN;
+    m_s16[1] = INT16_MAX;
+  }
+
+  // every length up to a few vectors, then all of it, at every alignment
+  template<typename F>
+  void ForEachRange(F check)
+  {
+    for (uint32_t offset = 0; offset < 4; offset++)
+    {
+      for (uint32_t count = 0; count < 40; count++)
+        check(offset, count);
+      check(offset, m_float.size() - offset);
+    }
+  }
+
+  std::vector<float> m_float;
+  std::vector<int16_t> m_s16;
+  std::vector<int32_t> m_s32;
+};
+
+TEST_F(TestAEKernels, Scalar)
+{
+  const AEKernels &kernels = AEKernels::GetScalar();
+  // rounds like swresample, half to even and saturating
+  float in[] = { 1.0f, -1.0f, 0.5f / 32768, 1.5f / 32768, -2.5f / 32768, 2.0f, -2.0f };
+  int16_t s16[7];
+  kernels.floatToS16(in, s16, 7);
+  EXPECT_EQ(INT16_MAX, s16[0]);
+  EXPECT_EQ(INT16_MIN, s16[1]);
+  EXPECT_EQ(0, s16[2]);
+  EXPECT_EQ(2, s16[3]);
+  EXPECT_EQ(-2, s16[4]);
+  EXPECT_EQ(INT16_MAX, s16[5]);
+  EXPECT_EQ(INT16_MIN, s16[6]);
+
+  int32_t s32[7];
+  kernels.floatToS32(in, s32, 7);
+  EXPECT_EQ(INT32_MAX, s32[0]);
+  EXPECT_EQ(INT32_MIN, s32[1]);
+  EXPECT_EQ(32768, s32[2]);
+  EXPECT_EQ(INT32_MAX, s32[5]);
+  EXPECT_EQ(INT32_MIN, s32[6]);
+
+  float clamp[] = { 0.0f, 3.0f, -3.0f, 5.0f, -5.0f, 0.5f };
+  kernels.clampArray(clamp, 6);
+  EXPECT_EQ(0.0f, clamp[0]);
+  EXPECT_EQ(1.0f, clamp[1]);
+  EXPECT_EQ(-1.0f, clamp[2]);
+  EXPECT_EQ(1.0f, clamp[3]);
+  EXPECT_EQ(-1.0f, clamp[4]);
+  EXPECT_LT(0.45f, clamp[5]);
+  EXPECT_GT(0.5f, clamp[5]);
+
+  float mix[] = { 0.5f, 0.5f };
+  float add[] = { 0.5f, 1.5f };
+  EXPECT_FALSE(kernels.mulAddArray(mix, add, 1.0f, 1));
+  EXPECT_TRUE(kernels.mulAddArray(mix, add, 1.0f, 2));
+}
+
+TEST_F(TestAEKernels, BitExact)
+{
+  const AEKernels &scalar = AEKernels::GetScalar();
+  for (const AEKernels *kernels : AEKernels::GetAvailable())
+  {
+    SCOPED_TRACE(kernels->name);
+
+    ForEachRange([&](uint32_t offset, uint32_t count) {
+      SCOPED_TRACE(testing::Message() << "offset " << offset << " count " << count);
+      const float *in = m_float.data() + offset;
+
+      std::vector<float> expected(in, in + count);
+      std::vector<float> actual(expected);
+      scalar.mulArray(expected.data(), 0.7f, count);
+      kernels->mulArray(actual.data(), 0.7f, count);
+      EXPECT_EQ(0, memcmp(expected.data(), actual.data(), count * sizeof(float)));
+
+      expected.assign(count, 0.3f);
+      actual = expected;
+      bool expectedClip = scalar.mulAddArray(expected.data(), in, 0.6f, count);
+      bool actualClip = kernels->mulAddArray(actual.data(), in, 0.6f, count);
+      EXPECT_EQ(expectedClip, actualClip);
+      EXPECT_EQ(0, memcmp(expected.data(), actual.data(), count * sizeof(float)));
+
+      expected.assign(in, in + count);
+      for (auto &sample : expected)
+        sample *= 3.0f;
+      actual = expected;
+      scalar.clampArray(expected.data(), count);
+      kernels->clampArray(actual.data(), count);
+      EXPECT_EQ(0, memcmp(expected.data(), actual.data(), count * sizeof(float)));
+
+      std::vector<int16_t> expected16(count), actual16(count);
+      scalar.floatToS16(in, expected16.data(), count);
+      kernels->floatToS16(in, actual16.data(), count);
+      EXPECT_EQ(expected16, actual16);
+
+      std::vector<int32_t> expected32(count), actual32(count);
+      scalar.floatToS32(in, expected32.data(), count);
+      kernels->floatToS32(in, actual32.data(), count);
+      EXPECT_EQ(expected32, actual32);
+
+      expected.resize(count);
+      actual.resize(count);
+      scalar.s16ToFloat(m_s16.data() + offset, expected.data(), count);
+      kernels->s16ToFloat(m_s16.data() + offset, actual.data(), count);
+      EXPECT_EQ(0, memcmp(expected.data(), actual.data(), count * sizeof(float)));
+
+      scalar.s32ToFloat(m_s32.data() + offset, expected.data(), count);
+      kernels->s32ToFloat(m_s32.data() + offset, actual.data(), count);
+      EXPECT_EQ(0, memcmp(expected.data(), actual.data(), count * sizeof(float)));
+    });
+  }
+}
+
+TEST_F(TestAEKernels, RoundTrip)
+{
+  const AEKernels &kernels = AEKernels::Get();
+  std::vector<float> samples(m_s16.size());
+  std::vector<int16_t> s16(m_s16.size());
+  kernels.s16ToFloat(m_s16.data(), samples.data(), samples.size());
+  kernels.floatToS16(samples.data(), s16.data(), s16.size());
+  EXPECT_EQ(m_s16, s16);
+}
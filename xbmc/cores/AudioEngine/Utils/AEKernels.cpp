@@ -0,0 +1,414 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "AEKernels.h"
+#include "utils/CPUInfo.h"
+
+#include <math.h>
+
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+#include <emmintrin.h>
+#define AE_KERNELS_SSE2
+#endif
+
+#if defined(HAS_NEON) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#include <arm_neon.h>
+#define AE_KERNELS_NEON
+#endif
+
+// AEKernelsAVX2.cpp, NULL unless it was built with -mavx2
+extern const AEKernels* GetAEKernelsAVX2();
+
+/*
+ * The vector versions have to round exactly like these. This file is built
+ * with fp contraction turned off, a fused multiply-add would round once
+ * where the scalar code rounds twice.
+ */
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#endif
+
+static void MulArrayC(float *data, float mul, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    data[i] *= mul;
+}
+
+static bool MulAddArrayC(float *data, const float *add, float mul, uint32_t count)
+{
+  bool clip = false;
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    data[i] += add[i] * mul;
+    if (fabsf(data[i]) > 1.0f)
+      clip = true;
+  }
+  return clip;
+}
+
+static void ClampArrayC(float *data, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    /*
+       This is a rational function to approximate a tanh-like soft clipper.
+       It is based on the pade-approximation of the tanh function with tweaked coefficients.
+       See: http://www.musicdsp.org/showone.php?id=238
+       It reaches exactly +-1 at +-3.
+    */
+    float x = data[i];
+    if (x < -3.0f)
+      data[i] = -1.0f;
+    else if (x > 3.0f)
+      data[i] = 1.0f;
+    else
+    {
+      float y = x * x;
+      data[i] = x * (27.0f + y) / (27.0f + 9.0f * y);
+    }
+  }
+}
+
+static void FloatToS16C(const float *src, int16_t *dst, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    float v = src[i] * 32768.0f;
+    if (v >= 32767.0f)
+      dst[i] = INT16_MAX;
+    else if (v <= -32768.0f)
+      dst[i] = INT16_MIN;
+    else
+      dst[i] = (int16_t)lrintf(v);
+  }
+}
+
+static void S16ToFloatC(const int16_t *src, float *dst, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    dst[i] = src[i] * (1.0f / 32768.0f);
+}
+
+static void FloatToS32C(const float *src, int32_t *dst, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    float v = src[i] * 2147483648.0f;
+    if (v >= 2147483648.0f)
+      dst[i] = INT32_MAX;
+    else if (v <= -2147483648.0f)
+      dst[i] = INT32_MIN;
+    else
+      dst[i] = (int32_t)lrintf(v);
+  }
+}
+
+static void S32ToFloatC(const int32_t *src, float *dst, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    dst[i] = src[i] * (1.0f / 2147483648.0f);
+}
+
+static const AEKernels g_aeKernelsC =
+{
+  "C",
+  MulArrayC,
+  MulAddArrayC,
+  ClampArrayC,
+  FloatToS16C,
+  S16ToFloatC,
+  FloatToS32C,
+  S32ToFloatC
+};
+
+#if defined(AE_KERNELS_SSE2)
+static void MulArraySSE2(float *data, float mul, uint32_t count)
+{
+  const __m128 m = _mm_set1_ps(mul);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), m));
+  MulArrayC(data + i, mul, count - i);
+}
+
+static bool MulAddArraySSE2(float *data, const float *add, float mul, uint32_t count)
+{
+  const __m128 m = _mm_set1_ps(mul);
+  const __m128 mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+  const __m128 one = _mm_set1_ps(1.0f);
+  __m128 clip = _mm_setzero_ps();
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 d = _mm_add_ps(_mm_loadu_ps(data + i), _mm_mul_ps(_mm_loadu_ps(add + i), m));
+    clip = _mm_or_ps(clip, _mm_cmpgt_ps(_mm_and_ps(d, mask), one));
+    _mm_storeu_ps(data + i, d);
+  }
+  bool tail = MulAddArrayC(data + i, add + i, mul, count - i);
+  return _mm_movemask_ps(clip) || tail;
+}
+
+static void ClampArraySSE2(float *data, uint32_t count)
+{
+  const __m128 lo = _mm_set1_ps(-3.0f);
+  const __m128 hi = _mm_set1_ps(3.0f);
+  const __m128 c1 = _mm_set1_ps(27.0f);
+  const __m128 c2 = _mm_set1_ps(9.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    // min/max return their second operand for NaN, which keeps it
+    __m128 x = _mm_min_ps(hi, _mm_max_ps(lo, _mm_loadu_ps(data + i)));
+    __m128 y = _mm_mul_ps(x, x);
+    __m128 n = _mm_mul_ps(x, _mm_add_ps(c1, y));
+    _mm_storeu_ps(data + i, _mm_div_ps(n, _mm_add_ps(c1, _mm_mul_ps(c2, y))));
+  }
+  ClampArrayC(data + i, count - i);
+}
+
+static void FloatToS16SSE2(const float *src, int16_t *dst, uint32_t count)
+{
+  const __m128 scale = _mm_set1_ps(32768.0f);
+  const __m128 lo = _mm_set1_ps(-32768.0f);
+  const __m128 hi = _mm_set1_ps(32767.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m128 a = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i), scale), lo), hi);
+    __m128 b = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i + 4), scale), lo), hi);
+    __m128i s = _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+    _mm_storeu_si128((__m128i*)(dst + i), s);
+  }
+  FloatToS16C(src + i, dst + i, count - i);
+}
+
+static void S16ToFloatSSE2(const int16_t *src, float *dst, uint32_t count)
+{
+  const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+    __m128i a = _mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16);
+    __m128i b = _mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16);
+    _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(a), scale));
+    _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(b), scale));
+  }
+  S16ToFloatC(src + i, dst + i, count - i);
+}
+
+static void FloatToS32SSE2(const float *src, int32_t *dst, uint32_t count)
+{
+  const __m128 scale = _mm_set1_ps(2147483648.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 v = _mm_mul_ps(_mm_loadu_ps(src + i), scale);
+    // out of range converts to INT32_MIN, flip it to INT32_MAX for positive overflow
+    __m128i s = _mm_cvtps_epi32(v);
+    s = _mm_xor_si128(s, _mm_castps_si128(_mm_cmpge_ps(v, scale)));
+    _mm_storeu_si128((__m128i*)(dst + i), s);
+  }
+  FloatToS32C(src + i, dst + i, count - i);
+}
+
+static void S32ToFloatSSE2(const int32_t *src, float *dst, uint32_t count)
+{
+  const __m128 scale = _mm_set1_ps(1.0f / 2147483648.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 v = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(src + i)));
+    _mm_storeu_ps(dst + i, _mm_mul_ps(v, scale));
+  }
+  S32ToFloatC(src + i, dst + i, count - i);
+}
+
+static const AEKernels g_aeKernelsSSE2 =
+{
+  "SSE2",
+  MulArraySSE2,
+  MulAddArraySSE2,
+  ClampArraySSE2,
+  FloatToS16SSE2,
+  S16ToFloatSSE2,
+  FloatToS32SSE2,
+  S32ToFloatSSE2
+};
+#endif
+
+#if defined(AE_KERNELS_NEON)
+/*
+ * ARMv7 NEON has no division and only converts to integer towards zero.
+ * Rounding is emulated by adding and subtracting a power of two which leaves
+ * no fraction bits. Note that ARMv7 NEON flushes denormals to zero.
+ */
+
+static inline int32x4_t RoundNEON(float32x4_t v)
+{
+#if defined(__aarch64__)
+  return vcvtnq_s32_f32(v);
+#else
+  // from 2^23 on floats are whole numbers already
+  const uint32x4_t sign = vdupq_n_u32(0x80000000);
+  const float32x4_t whole = vdupq_n_f32(8388608.0f);
+  float32x4_t magic = vreinterpretq_f32_u32(vorrq_u32(vandq_u32(vreinterpretq_u32_f32(v), sign),
+                                                      vreinterpretq_u32_f32(whole)));
+  float32x4_t rounded = vsubq_f32(vaddq_f32(v, magic), magic);
+  return vcvtq_s32_f32(vbslq_f32(vcageq_f32(v, whole), v, rounded));
+#endif
+}
+
+static void MulArrayNEON(float *data, float mul, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(data + i, vmulq_n_f32(vld1q_f32(data + i), mul));
+  MulArrayC(data + i, mul, count - i);
+}
+
+static bool MulAddArrayNEON(float *data, const float *add, float mul, uint32_t count)
+{
+  const float32x4_t one = vdupq_n_f32(1.0f);
+  uint32x4_t clip = vdupq_n_u32(0);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    float32x4_t d = vaddq_f32(vld1q_f32(data + i), vmulq_n_f32(vld1q_f32(add + i), mul));
+    clip = vorrq_u32(clip, vcagtq_f32(d, one));
+    vst1q_f32(data + i, d);
+  }
+  uint32x2_t any = vorr_u32(vget_low_u32(clip), vget_high_u32(clip));
+  bool tail = MulAddArrayC(data + i, add + i, mul, count - i);
+  return (vget_lane_u32(any, 0) | vget_lane_u32(any, 1)) || tail;
+}
+
+#if defined(__aarch64__)
+static void ClampArrayNEON(float *data, uint32_t count)
+{
+  const float32x4_t lo = vdupq_n_f32(-3.0f);
+  const float32x4_t hi = vdupq_n_f32(3.0f);
+  const float32x4_t c1 = vdupq_n_f32(27.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    float32x4_t x = vminq_f32(vmaxq_f32(vld1q_f32(data + i), lo), hi);
+    float32x4_t y = vmulq_f32(x, x);
+    float32x4_t n = vmulq_f32(x, vaddq_f32(c1, y));
+    vst1q_f32(data + i, vdivq_f32(n, vaddq_f32(c1, vmulq_n_f32(y, 9.0f))));
+  }
+  ClampArrayC(data + i, count - i);
+}
+#else
+// no exact division, only clipped mixes get here anyway
+#define ClampArrayNEON ClampArrayC
+#endif
+
+static void FloatToS16NEON(const float *src, int16_t *dst, uint32_t count)
+{
+  const float32x4_t lo = vdupq_n_f32(-32768.0f);
+  const float32x4_t hi = vdupq_n_f32(32767.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    float32x4_t a = vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(src + i), 32768.0f), lo), hi);
+    float32x4_t b = vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(src + i + 4), 32768.0f), lo), hi);
+    vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(RoundNEON(a)), vqmovn_s32(RoundNEON(b))));
+  }
+  FloatToS16C(src + i, dst + i, count - i);
+}
+
+static void S16ToFloatNEON(const int16_t *src, float *dst, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    int16x8_t s = vld1q_s16(src + i);
+    float32x4_t a = vcvtq_f32_s32(vmovl_s16(vget_low_s16(s)));
+    float32x4_t b = vcvtq_f32_s32(vmovl_s16(vget_high_s16(s)));
+    vst1q_f32(dst + i, vmulq_n_f32(a, 1.0f / 32768.0f));
+    vst1q_f32(dst + i + 4, vmulq_n_f32(b, 1.0f / 32768.0f));
+  }
+  S16ToFloatC(src + i, dst + i, count - i);
+}
+
+static void FloatToS32NEON(const float *src, int32_t *dst, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    // the conversion saturates
+    float32x4_t v = vmulq_n_f32(vld1q_f32(src + i), 2147483648.0f);
+    vst1q_s32(dst + i, RoundNEON(v));
+  }
+  FloatToS32C(src + i, dst + i, count - i);
+}
+
+static void S32ToFloatNEON(const int32_t *src, float *dst, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(src + i)), 1.0f / 2147483648.0f));
+  S32ToFloatC(src + i, dst + i, count - i);
+}
+
+static const AEKernels g_aeKernelsNEON =
+{
+  "NEON",
+  MulArrayNEON,
+  MulAddArrayNEON,
+  ClampArrayNEON,
+  FloatToS16NEON,
+  S16ToFloatNEON,
+  FloatToS32NEON,
+  S32ToFloatNEON
+};
+#endif
+
+std::vector<const AEKernels*> AEKernels::GetAvailable()
+{
+  std::vector<const AEKernels*> kernels;
+  kernels.push_back(&g_aeKernelsC);
+
+  unsigned int features = g_cpuInfo.GetCPUFeatures();
+#if defined(AE_KERNELS_SSE2)
+  if (features & CPU_FEATURE_SSE2)
+    kernels.push_back(&g_aeKernelsSSE2);
+#endif
+  if ((features & CPU_FEATURE_AVX2) && GetAEKernelsAVX2())
+    kernels.push_back(GetAEKernelsAVX2());
+#if defined(AE_KERNELS_NEON)
+  if (features & CPU_FEATURE_NEON)
+    kernels.push_back(&g_aeKernelsNEON);
+#endif
+  return kernels;
+}
+
+const AEKernels& AEKernels::Get()
+{
+  // fastest last
+  static const AEKernels *kernels = GetAvailable().back();
+  return *kernels;
+}
+
+const AEKernels& AEKernels::GetScalar()
+{
+  return g_aeKernelsC;
+}
@@ -0,0 +1,56 @@
+#pragma once
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <vector>
+
+/*!
+ \brief Sample processing kernels for one instruction set.
+
+ Get() picks the fastest table the CPU supports the first time it is called.
+ Every table produces the same output as the scalar one bit for bit, so the
+ choice never changes what ends up at the sink. Pointers need no alignment.
+ The conversions round and saturate the way swresample does.
+ */
+struct AEKernels
+{
+  const char *name;
+
+  //! data[i] *= mul
+  void (*mulArray)(float *data, float mul, uint32_t count);
+  //! data[i] += add[i] * mul, returns whether any result left [-1, 1]
+  bool (*mulAddArray)(float *data, const float *add, float mul, uint32_t count);
+  //! soft clips the samples to [-1, 1]
+  void (*clampArray)(float *data, uint32_t count);
+
+  void (*floatToS16)(const float *src, int16_t *dst, uint32_t count);
+  void (*s16ToFloat)(const int16_t *src, float *dst, uint32_t count);
+  void (*floatToS32)(const float *src, int32_t *dst, uint32_t count);
+  void (*s32ToFloat)(const int32_t *src, float *dst, uint32_t count);
+
+  static const AEKernels& Get();
+  static const AEKernels& GetScalar();
+
+  /*!
+   \brief All tables this CPU can run, the scalar one first
+   */
+  static std::vector<const AEKernels*> GetAvailable();
+};
@@ -0,0 +1,154 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Built with -mavx2 on its own (ENABLE_AVX2) so nothing else in the audio
+ * engine picks up AVX2 instructions. AEKernels only hands this table out once
+ * CPUInfo reports AVX2. The tails are left to the scalar kernels.
+ */
+
+#include "AEKernels.h"
+
+#include <stddef.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+
+static void MulArrayAVX2(float *data, float mul, uint32_t count)
+{
+  const __m256 m = _mm256_set1_ps(mul);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+    _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), m));
+  AEKernels::GetScalar().mulArray(data + i, mul, count - i);
+}
+
+static bool MulAddArrayAVX2(float *data, const float *add, float mul, uint32_t count)
+{
+  const __m256 m = _mm256_set1_ps(mul);
+  const __m256 mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+  const __m256 one = _mm256_set1_ps(1.0f);
+  __m256 clip = _mm256_setzero_ps();
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 d = _mm256_add_ps(_mm256_loadu_ps(data + i), _mm256_mul_ps(_mm256_loadu_ps(add + i), m));
+    clip = _mm256_or_ps(clip, _mm256_cmp_ps(_mm256_and_ps(d, mask), one, _CMP_GT_OQ));
+    _mm256_storeu_ps(data + i, d);
+  }
+  bool tail = AEKernels::GetScalar().mulAddArray(data + i, add + i, mul, count - i);
+  return _mm256_movemask_ps(clip) || tail;
+}
+
+static void ClampArrayAVX2(float *data, uint32_t count)
+{
+  const __m256 lo = _mm256_set1_ps(-3.0f);
+  const __m256 hi = _mm256_set1_ps(3.0f);
+  const __m256 c1 = _mm256_set1_ps(27.0f);
+  const __m256 c2 = _mm256_set1_ps(9.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    // min/max return their second operand for NaN, which keeps it
+    __m256 x = _mm256_min_ps(hi, _mm256_max_ps(lo, _mm256_loadu_ps(data + i)));
+    __m256 y = _mm256_mul_ps(x, x);
+    __m256 n = _mm256_mul_ps(x, _mm256_add_ps(c1, y));
+    _mm256_storeu_ps(data + i, _mm256_div_ps(n, _mm256_add_ps(c1, _mm256_mul_ps(c2, y))));
+  }
+  AEKernels::GetScalar().clampArray(data + i, count - i);
+}
+
+static void FloatToS16AVX2(const float *src, int16_t *dst, uint32_t count)
+{
+  const __m256 scale = _mm256_set1_ps(32768.0f);
+  const __m256 lo = _mm256_set1_ps(-32768.0f);
+  const __m256 hi = _mm256_set1_ps(32767.0f);
+  uint32_t i = 0;
+  for (; i + 16 <= count; i += 16)
+  {
+    __m256 a = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i), scale), lo), hi);
+    __m256 b = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i + 8), scale), lo), hi);
+    // packs works per 128 bit lane, put the quarters back in order
+    __m256i s = _mm256_packs_epi32(_mm256_cvtps_epi32(a), _mm256_cvtps_epi32(b));
+    _mm256_storeu_si256((__m256i*)(dst + i), _mm256_permute4x64_epi64(s, _MM_SHUFFLE(3, 1, 2, 0)));
+  }
+  AEKernels::GetScalar().floatToS16(src + i, dst + i, count - i);
+}
+
+static void S16ToFloatAVX2(const int16_t *src, float *dst, uint32_t count)
+{
+  const __m256 scale = _mm256_set1_ps(1.0f / 32768.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256i s = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(src + i)));
+    _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(s), scale));
+  }
+  AEKernels::GetScalar().s16ToFloat(src + i, dst + i, count - i);
+}
+
+static void FloatToS32AVX2(const float *src, int32_t *dst, uint32_t count)
+{
+  const __m256 scale = _mm256_set1_ps(2147483648.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 v = _mm256_mul_ps(_mm256_loadu_ps(src + i), scale);
+    // out of range converts to INT32_MIN, flip it to INT32_MAX for positive overflow
+    __m256i s = _mm256_cvtps_epi32(v);
+    s = _mm256_xor_si256(s, _mm256_castps_si256(_mm256_cmp_ps(v, scale, _CMP_GE_OQ)));
+    _mm256_storeu_si256((__m256i*)(dst + i), s);
+  }
+  AEKernels::GetScalar().floatToS32(src + i, dst + i, count - i);
+}
+
+static void S32ToFloatAVX2(const int32_t *src, float *dst, uint32_t count)
+{
+  const __m256 scale = _mm256_set1_ps(1.0f / 2147483648.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 v = _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i*)(src + i)));
+    _mm256_storeu_ps(dst + i, _mm256_mul_ps(v, scale));
+  }
+  AEKernels::GetScalar().s32ToFloat(src + i, dst + i, count - i);
+}
+
+static const AEKernels g_aeKernelsAVX2 =
+{
+  "AVX2",
+  MulArrayAVX2,
+  MulAddArrayAVX2,
+  ClampArrayAVX2,
+  FloatToS16AVX2,
+  S16ToFloatAVX2,
+  FloatToS32AVX2,
+  S32ToFloatAVX2
+};
+#endif
+
+const AEKernels* GetAEKernelsAVX2()
+{
+#if defined(__AVX2__)
+  return &g_aeKernelsAVX2;
+#else
+  return NULL;
+#endif
+}
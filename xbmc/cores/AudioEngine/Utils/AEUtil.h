@@ -133,8 +133,6 @@ private:
     static __m128i m_sseSeed;
   #endif
 
-  static float SoftClamp(const float x);
-
 public:
   static CAEChannelInfo          GuessChLayout     (const unsigned int channels);
   static const char*             GetStdChLayoutName(const enum AEStdChLayout layout);
@@ -202,10 +200,12 @@ public:
     return 20*log10(scale);
   }
 
-  #if defined(HAVE_SSE) && defined(__SSE__)
-  static void SSEMulArray     (float *data, const float mul, uint32_t count);
-  static void SSEMulAddArray  (float *data, float *add, const float mul, uint32_t count);
-  #endif
+  /*! \brief multiply the samples by mul, see AEKernels */
+  static void MulArray(float *data, const float mul, uint32_t count);
+  /*! \brief add add * mul to the samples
+   \return whether any result exceeds [-1, 1] and needs ClampArray
+   */
+  static bool MulAddArray(float *data, const float *add, const float mul, uint32_t count);
   static void ClampArray(float *data, uint32_t count);
 
   static bool S16NeedsByteSwap(AEDataFormat in, AEDataFormat out);
@@ -21,9 +21,14 @@
 #include "DVDDemuxUtils.h"
 #include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
 #include "cores/VideoPlayer/Interface/Addon/DemuxCrypto.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "system.h"
 
+#include <atomic>
+#include <vector>
+
 #ifdef TARGET_POSIX
 #include "linux/XMemUtils.h"
 #endif
@@ -32,12 +37,139 @@ extern "C" {
 #include "libavcodec/avcodec.h"
 }
 
+namespace
+{
+
+// payloads up to 2^POOL_MAX_CLASS bytes (padding included) are recycled
+#define POOL_MIN_CLASS 8
+#define POOL_MAX_CLASS 22
+#define POOL_MAX_BYTES (32 * 1024 * 1024)
+
+class CDemuxPacketPool
+{
+public:
+  CDemuxPacketPool() : m_allocations(0), m_hits(0), m_pooledBytes(0), m_usedBytes(0) {}
+  ~CDemuxPacketPool() { Clear(); }
+
+  uint8_t* Allocate(unsigned int size);
+  void Free(uint8_t* data);
+  void Clear();
+  DemuxPacketPoolStats GetStats() const;
+
+private:
+  // stored in front of every payload, keeps the payload 16 byte aligned
+  struct Header
+  {
+    uint32_t sizeClass; // 0 for buffers too large for the pool
+    uint32_t capacity;
+    uint8_t reserved[8];
+  };
+
+  CCriticalSection m_section;
+  std::vector<uint8_t*> m_free[POOL_MAX_CLASS + 1];
+  std::atomic<uint64_t> m_allocations;
+  std::atomic<uint64_t> m_hits;
+  std::atomic<uint64_t> m_pooledBytes;
+  std::atomic<uint64_t> m_usedBytes;
+};
+
+uint8_t* CDemuxPacketPool::Allocate(unsigned int size)
+{
+  unsigned int sizeClass = POOL_MIN_CLASS;
+  while (sizeClass <= POOL_MAX_CLASS && (1u << sizeClass) < size)
+    sizeClass++;
+
+  m_allocations++;
+
+  uint8_t* block = nullptr;
+  unsigned int capacity = size;
+  if (sizeClass <= POOL_MAX_CLASS)
+  {
+    capacity = 1u << sizeClass;
+
+    CSingleLock lock(m_section);
+    if (!m_free[sizeClass].empty())
+    {
+      block = m_free[sizeClass].back();
+      m_free[sizeClass].pop_back();
+      m_pooledBytes -= capacity;
+      m_hits++;
+    }
+  }
+  else
+    sizeClass = 0;
+
+  if (!block)
+  {
+    block = (uint8_t*)_aligned_malloc(capacity + sizeof(Header), 16);
+    if (!block)
+      return nullptr;
+
+    Header* header = reinterpret_cast<Header*>(block);
+    header->sizeClass = sizeClass;
+    header->capacity = capacity;
+  }
+
+  m_usedBytes += capacity;
+  return block + sizeof(Header);
+}
+
+void CDemuxPacketPool::Free(uint8_t* data)
+{
+  uint8_t* block = data - sizeof(Header);
+  Header* header = reinterpret_cast<Header*>(block);
+  m_usedBytes -= header->capacity;
+
+  if (header->sizeClass)
+  {
+    CSingleLock lock(m_section);
+    if (m_pooledBytes + header->capacity <= POOL_MAX_BYTES)
+    {
+      m_free[header->sizeClass].push_back(block);
+      m_pooledBytes += header->capacity;
+      return;
+    }
+  }
+
+  _aligned_free(block);
+}
+
+void CDemuxPacketPool::Clear()
+{
+  CSingleLock lock(m_section);
+  for (unsigned int sizeClass = POOL_MIN_CLASS; sizeClass <= POOL_MAX_CLASS; sizeClass++)
+  {
+    for (auto block : m_free[sizeClass])
+      _aligned_free(block);
+    m_free[sizeClass].clear();
+  }
+  m_pooledBytes = 0;
+}
+
+DemuxPacketPoolStats CDemuxPacketPool::GetStats() const
+{
+  DemuxPacketPoolStats stats;
+  stats.allocations = m_allocations;
+  stats.hits = m_hits;
+  stats.pooledBytes = m_pooledBytes;
+  stats.usedBytes = m_usedBytes;
+  return stats;
+}
+
+CDemuxPacketPool& GetPacketPool()
+{
+  static CDemuxPacketPool pool;
+  return pool;
+}
+
+}
+
 void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 {
   if (pPacket)
   {
     try {
-      if (pPacket->pData) _aligned_free(pPacket->pData);
+      if (pPacket->pData) GetPacketPool().Free(pPacket->pData);
       delete pPacket;
     }
     catch(...) {
@@ -61,7 +193,7 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
      * Note, if the first 23 bits of the additional bytes are not 0 then damaged
      * MPEG bitstreams could cause overread and segfault
      */
-    pPacket->pData =(uint8_t*)_aligned_malloc(iDataSize + AV_INPUT_BUFFER_PADDING_SIZE, 16);
+    pPacket->pData = GetPacketPool().Allocate(iDataSize + AV_INPUT_BUFFER_PADDING_SIZE);
     if (!pPacket->pData)
     {
       FreeDemuxPacket(pPacket);
@@ -82,3 +214,13 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(unsigned int iDataSize, unsigne
     ret->cryptoInfo = std::shared_ptr<DemuxCryptoInfo>(new DemuxCryptoInfo(encryptedSubsampleCount));
   return ret;
 }
+
+DemuxPacketPoolStats CDVDDemuxUtils::GetPacketPoolStats()
+{
+  return GetPacketPool().GetStats();
+}
+
+void CDVDDemuxUtils::ReleasePacketPool()
+{
+  GetPacketPool().Clear();
+}
@@ -21,6 +21,15 @@
  */
 
 #include "cores/VideoPlayer/Interface/Addon/DemuxPacket.h"
+#include <stdint.h>
+
+struct DemuxPacketPoolStats
+{
+  uint64_t allocations = 0; // payload allocations
+  uint64_t hits = 0;        // payload allocations served by a recycled buffer
+  uint64_t pooledBytes = 0; // bytes of free buffers kept for reuse
+  uint64_t usedBytes = 0;   // bytes of buffers held by packets
+};
 
 class CDVDDemuxUtils
 {
@@ -28,5 +37,12 @@ public:
   static void FreeDemuxPacket(DemuxPacket* pPacket);
   static DemuxPacket* AllocateDemuxPacket(int iDataSize = 0);
   static DemuxPacket* AllocateDemuxPacket(unsigned int iDataSize, unsigned int encryptedSubsampleCount);
+
+  /*!
+   * Packet payloads are recycled through a thread safe pool of power of two
+   * sized buffers. ReleasePacketPool frees the buffers currently not in use.
+   */
+  static DemuxPacketPoolStats GetPacketPoolStats();
+  static void ReleasePacketPool();
 };
 
@@ -25,8 +25,12 @@
 #include "pictures/Picture.h"
 #include "video/VideoInfoTag.h"
 #include "filesystem/StackDirectory.h"
+#include "threads/SingleLock.h"
+#include "utils/CPUInfo.h"
 #include "utils/log.h"
+#include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
+#include "utils/WorkerPool.h"
 
 #include "DVDStreamInfo.h"
 #include "DVDInputStreams/DVDInputStream.h"
@@ -53,13 +57,18 @@
 #include "Util.h"
 #include "utils/LangCodeExpander.h"
 
+#include <algorithm>
 #include <cstdlib>
+#include <map>
 #include <memory>
 
 extern "C" {
 #include "libavformat/avformat.h"
 }
 
+#define MAX_THUMB_WORKERS 4
+#define MAX_IDLE_THUMB_DECODERS 4
+
 bool CDVDFileInfo::GetFileDuration(const std::string &path, int& duration)
 {
   std::unique_ptr<CDVDInputStream> input;
@@ -99,84 +108,312 @@ int DegreeToOrientation(int degrees)
   }
 }
 
-bool CDVDFileInfo::ExtractThumb(const std::string &strPath,
-                                CTextureDetails &details,
-                                CStreamDetails *pStreamDetails, int pos)
+namespace
+{
+
+/*!
+ A software decoder set up for thumbnails. Once a file is done it is flushed
+ and handed to the next file with the same stream parameters, which saves
+ opening a codec for every episode of a season.
+ */
+struct ThumbDecoder
+{
+  ~ThumbDecoder() { sws_freeContext(sws); }
+
+  CDVDStreamInfo hint;
+  std::unique_ptr<CProcessInfo> processInfo;
+  std::unique_ptr<CDVDVideoCodec> codec;
+  bool intraOnly = false;    ///< decoder skips everything but intra frames
+  SwsContext *sws = nullptr; ///< scaler of the last thumb, mostly fits the next one
+};
+
+}
+
+/*!
+ Decoders not used by a file right now, shared by the files of a batch or
+ of several batches
+ */
+class CThumbDecoders
+{
+public:
+  std::unique_ptr<ThumbDecoder> Get(CDVDStreamInfo &hint)
+  {
+    {
+      CSingleLock lock(m_section);
+      for (auto it = m_idle.begin(); it != m_idle.end(); ++it)
+      {
+        if ((*it)->hint.Equal(hint, true))
+        {
+          std::unique_ptr<ThumbDecoder> decoder = std::move(*it);
+          m_idle.erase(it);
+          return decoder;
+        }
+      }
+    }
+    return Open(hint);
+  }
+
+  void Put(std::unique_ptr<ThumbDecoder> decoder)
+  {
+    // addon decoders belong to the input stream that created them
+    if (decoder->hint.externalInterfaces)
+      return;
+
+    CSingleLock lock(m_section);
+    if (m_idle.size() >= MAX_IDLE_THUMB_DECODERS)
+      m_idle.erase(m_idle.begin());
+    m_idle.push_back(std::move(decoder));
+  }
+
+private:
+  static std::unique_ptr<ThumbDecoder> Open(CDVDStreamInfo &hint)
+  {
+    std::unique_ptr<ThumbDecoder> decoder(new ThumbDecoder);
+    decoder->hint = hint;
+    decoder->processInfo.reset(CProcessInfo::CreateInstance());
+    std::vector<AVPixelFormat> pixFmts;
+    pixFmts.push_back(AV_PIX_FMT_YUV420P);
+    decoder->processInfo->SetPixFormats(pixFmts);
+
+    if (hint.externalInterfaces)
+    {
+      decoder->codec.reset(CDVDFactoryCodec::CreateVideoCodec(hint, *decoder->processInfo));
+      if (!decoder->codec)
+        return nullptr;
+      return decoder;
+    }
+
+    // one picture is all we need: any intra frame will do, decoded at the
+    // smallest scale still covering the thumb if the codec can scale down
+    CDVDCodecOptions options;
+    options.m_keys.push_back(CDVDCodecOption("skip_frame", "nointra"));
+    AVCodec *pCodec = avcodec_find_decoder(hint.codec);
+    int lowres = 0;
+    while (pCodec && lowres < pCodec->max_lowres &&
+           (hint.width >> (lowres + 1)) >= g_advancedSettings.m_imageRes)
+      lowres++;
+    if (lowres > 0)
+      options.m_keys.push_back(CDVDCodecOption("lowres", StringUtils::Format("%d", lowres)));
+
+    decoder->codec.reset(new CDVDVideoCodecFFmpeg(*decoder->processInfo));
+    if (!decoder->codec->Open(hint, options))
+      return nullptr;
+    decoder->intraOnly = true;
+    return decoder;
+  }
+
+  CCriticalSection m_section;
+  std::vector<std::unique_ptr<ThumbDecoder>> m_idle;
+};
+
+/*!
+ \brief Feed packets of the video stream to the decoder until it hands out a picture
+ \return false if there was none within the packet budget
+ */
+static bool DecodePicture(CDVDDemux *pDemuxer, int nVideoStream, CDVDVideoCodec &codec, VideoPicture &picture, int &packetsTried)
 {
+  // num streams * 160 frames, should get a valid frame, if not abort.
+  int abort_index = pDemuxer->GetNrOfStreams() * 160;
+  do
+  {
+    DemuxPacket* pPacket = pDemuxer->Read();
+    packetsTried++;
+
+    if (!pPacket)
+      break;
+
+    if (pPacket->iStreamId != nVideoStream)
+    {
+      CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+      continue;
+    }
+
+    codec.AddData(*pPacket);
+    CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+
+    // GetPicture releases the buffer of a picture it overwrites
+    CDVDVideoCodec::VCReturn iDecoderState = CDVDVideoCodec::VC_NONE;
+    while (iDecoderState == CDVDVideoCodec::VC_NONE)
+      iDecoderState = codec.GetPicture(&picture);
+
+    if (iDecoderState == CDVDVideoCodec::VC_PICTURE && !(picture.iFlags & DVP_FLAG_DROPPED))
+      return true;
+
+  } while (abort_index--);
+
+  return false;
+}
+
+static bool CacheThumb(ThumbDecoder &decoder, const CDVDStreamInfo &hint, VideoPicture &picture, CTextureDetails &details)
+{
+  unsigned int nWidth = g_advancedSettings.m_imageRes;
+  double aspect = (double)picture.iDisplayWidth / (double)picture.iDisplayHeight;
+  if(hint.forced_aspect && hint.aspect != 0)
+    aspect = hint.aspect;
+  unsigned int nHeight = (unsigned int)((double)g_advancedSettings.m_imageRes / aspect);
+
+  decoder.sws = sws_getCachedContext(decoder.sws, picture.iWidth, picture.iHeight, AV_PIX_FMT_YUV420P,
+                                     nWidth, nHeight, AV_PIX_FMT_BGRA, SWS_FAST_BILINEAR, NULL, NULL, NULL);
+  if (!decoder.sws)
+    return false;
+
+  uint8_t *pOutBuf = (uint8_t*)av_malloc(nWidth * nHeight * 4);
+  uint8_t *planes[YuvImage::MAX_PLANES];
+  int stride[YuvImage::MAX_PLANES];
+  picture.videoBuffer->GetPlanes(planes);
+  picture.videoBuffer->GetStrides(stride);
+  uint8_t *src[4]= { planes[0], planes[1], planes[2], 0 };
+  int srcStride[] = { stride[0], stride[1], stride[2], 0 };
+  uint8_t *dst[] = { pOutBuf, 0, 0, 0 };
+  int dstStride[] = { (int)nWidth*4, 0, 0, 0 };
+  int orientation = DegreeToOrientation(hint.orientation);
+  sws_scale(decoder.sws, src, srcStride, 0, picture.iHeight, dst, dstStride);
+
+  details.width = nWidth;
+  details.height = nHeight;
+  CPicture::CacheTexture(pOutBuf, nWidth, nHeight, nWidth * 4, orientation, nWidth, nHeight, CTextureCache::GetCachedPath(details.file));
+  av_free(pOutBuf);
+  return true;
+}
+
+static bool ExtractThumbAt(CDVDDemux *pDemuxer, int nVideoStream, const CDVDStreamInfo &hint, ThumbDecoder &decoder,
+                           int pos, CTextureDetails &details, const std::string &redactPath, int &packetsTried)
+{
+  int nTotalLen = pDemuxer->GetStreamLength();
+  int nSeekTo = (pos==-1) ? nTotalLen / 3 : pos;
+
+  CLog::Log(LOGDEBUG,"%s - seeking to pos %dms (total: %dms) in %s", __FUNCTION__, nSeekTo, nTotalLen, redactPath.c_str());
+  if (!pDemuxer->SeekTime(nSeekTo, true))
+    return false;
+
+  VideoPicture picture;
+  memset(&picture, 0, sizeof(picture));
+
+  // drop whatever is left from the previous position or file
+  decoder.codec->Reset();
+  bool decoded = DecodePicture(pDemuxer, nVideoStream, *decoder.codec, picture, packetsTried);
+  if (!decoded && decoder.intraOnly)
+  {
+    // e.g. intra refresh streams never send a whole intra frame
+    CLog::Log(LOGDEBUG,"%s - no intra frame in %s, decoding all frames", __FUNCTION__, redactPath.c_str());
+    decoder.intraOnly = false;
+    decoder.codec->SetCodecControl(0);
+    if (pDemuxer->SeekTime(nSeekTo, true))
+    {
+      decoder.codec->Reset();
+      decoded = DecodePicture(pDemuxer, nVideoStream, *decoder.codec, picture, packetsTried);
+    }
+  }
+
+  if (!decoded)
+  {
+    CLog::Log(LOGDEBUG,"%s - decode failed in %s after %d packets.", __FUNCTION__, redactPath.c_str(), packetsTried);
+    return false;
+  }
+
+  return CacheThumb(decoder, hint, picture, details);
+}
+
+static bool FileToStreamDetails(CDVDInputStream *pInputStream, CDVDDemux *pDemuxer, const std::string &strPath, CStreamDetails &details)
+{
+  bool result = CDVDFileInfo::DemuxerToStreamDetails(pInputStream, pDemuxer, details, strPath);
+
+  //extern subtitles
+  std::vector<std::string> filenames;
+  std::string video_path;
+  if (strPath.empty())
+    video_path = pInputStream->GetFileName();
+  else
+    video_path = strPath;
+
+  CUtil::ScanForExternalSubtitles(video_path, filenames);
+
+  for(unsigned int i=0;i<filenames.size();i++)
+  {
+    // if vobsub subtitle:
+    if (URIUtils::GetExtension(filenames[i]) == ".idx")
+    {
+      std::string strSubFile;
+      if ( CUtil::FindVobSubPair(filenames, filenames[i], strSubFile) )
+        CDVDFileInfo::AddExternalSubtitleToDetails(video_path, details, filenames[i], strSubFile);
+    }
+    else
+    {
+      if ( !CUtil::IsVobSub(filenames, filenames[i]) )
+      {
+        CDVDFileInfo::AddExternalSubtitleToDetails(video_path, details, filenames[i]);
+      }
+    }
+  }
+  return result;
+}
+
+/*!
+ \brief Serve all requests for one file from a single demuxer and decoder
+ */
+static void ExtractFromFile(const std::vector<CDVDFileInfo::ThumbRequest*> &requests, CThumbDecoders &decoders)
+{
+  const std::string &strPath = requests.front()->path;
   std::string redactPath = CURL::GetRedacted(strPath);
   unsigned int nTime = XbmcThreads::SystemClockMillis();
   CFileItem item(strPath, false);
 
   item.SetMimeTypeForInternetFile();
-  CDVDInputStream *pInputStream = CDVDFactoryInputStream::CreateInputStream(NULL, item);
+  std::unique_ptr<CDVDInputStream> pInputStream(CDVDFactoryInputStream::CreateInputStream(NULL, item));
   if (!pInputStream)
   {
     CLog::Log(LOGERROR, "InputStream: Error creating stream for %s", redactPath.c_str());
-    return false;
+    return;
   }
 
   if (!pInputStream->Open())
   {
     CLog::Log(LOGERROR, "InputStream: Error opening, %s", redactPath.c_str());
-    if (pInputStream)
-      delete pInputStream;
-    return false;
+    return;
   }
 
-  CDVDDemux *pDemuxer = NULL;
+  std::unique_ptr<CDVDDemux> pDemuxer;
 
   try
   {
-    pDemuxer = CDVDFactoryDemuxer::CreateDemuxer(pInputStream, true);
+    pDemuxer.reset(CDVDFactoryDemuxer::CreateDemuxer(pInputStream.get(), true));
     if(!pDemuxer)
     {
-      delete pInputStream;
       CLog::Log(LOGERROR, "%s - Error creating demuxer", __FUNCTION__);
-      return false;
+      return;
     }
   }
   catch(...)
   {
     CLog::Log(LOGERROR, "%s - Exception thrown when opening demuxer", __FUNCTION__);
-    if (pDemuxer)
-      delete pDemuxer;
-    delete pInputStream;
-    return false;
+    return;
   }
 
-  if (pStreamDetails)
+  // probe once, copy to the other requests of the file
+  CStreamDetails *pStreamDetails = nullptr;
+  bool hasStreamDetails = false;
+  unsigned int thumbs = 0;
+  for (CDVDFileInfo::ThumbRequest *request : requests)
   {
-    DemuxerToStreamDetails(pInputStream, pDemuxer, *pStreamDetails, strPath);
+    if (request->details)
+      thumbs++;
+    if (!request->streamDetails)
+      continue;
 
-    //extern subtitles
-    std::vector<std::string> filenames;
-    std::string video_path;
-    if (strPath.empty())
-      video_path = pInputStream->GetFileName();
+    if (pStreamDetails)
+      *request->streamDetails = *pStreamDetails;
     else
-      video_path = strPath;
-
-    CUtil::ScanForExternalSubtitles(video_path, filenames);
-
-    for(unsigned int i=0;i<filenames.size();i++)
     {
-      // if vobsub subtitle:
-      if (URIUtils::GetExtension(filenames[i]) == ".idx")
-      {
-        std::string strSubFile;
-        if ( CUtil::FindVobSubPair(filenames, filenames[i], strSubFile) )
-          AddExternalSubtitleToDetails(video_path, *pStreamDetails, filenames[i], strSubFile);
-      }
-      else
-      {
-        if ( !CUtil::IsVobSub(filenames, filenames[i]) )
-        {
-          AddExternalSubtitleToDetails(video_path, *pStreamDetails, filenames[i]);
-        }
-      }
+      pStreamDetails = request->streamDetails;
+      hasStreamDetails = FileToStreamDetails(pInputStream.get(), pDemuxer.get(), strPath, *pStreamDetails);
     }
+    if (!request->details)
+      request->result = hasStreamDetails;
   }
 
+  if (thumbs == 0)
+    return;
+
   int nVideoStream = -1;
   int64_t demuxerId = -1;
   for (CDemuxStream* pStream : pDemuxer->GetStreams())
@@ -194,128 +431,101 @@ bool CDVDFileInfo::ExtractThumb(const std::string &strPath,
     }
   }
 
-  bool bOk = false;
-  int packetsTried = 0;
-
+  CDVDStreamInfo hint;
+  std::unique_ptr<ThumbDecoder> decoder;
   if (nVideoStream != -1)
   {
-    CDVDVideoCodec *pVideoCodec;
-    std::unique_ptr<CProcessInfo> pProcessInfo(CProcessInfo::CreateInstance());
-    std::vector<AVPixelFormat> pixFmts;
-    pixFmts.push_back(AV_PIX_FMT_YUV420P);
-    pProcessInfo->SetPixFormats(pixFmts);
-
-    CDVDStreamInfo hint(*pDemuxer->GetStream(demuxerId, nVideoStream), true);
+    hint.Assign(*pDemuxer->GetStream(demuxerId, nVideoStream), true);
     hint.codecOptions = CODEC_FORCE_SOFTWARE;
+    decoder = decoders.Get(hint);
+  }
 
-    pVideoCodec = CDVDFactoryCodec::CreateVideoCodec(hint, *pProcessInfo);
+  int packetsTried = 0;
+  for (CDVDFileInfo::ThumbRequest *request : requests)
+  {
+    if (!request->details)
+      continue;
 
-    if (pVideoCodec)
+    if (decoder)
+      request->result = ExtractThumbAt(pDemuxer.get(), nVideoStream, hint, *decoder, request->pos,
+                                       *request->details, redactPath, packetsTried);
+    if (!request->result)
     {
-      int nTotalLen = pDemuxer->GetStreamLength();
-      int nSeekTo = (pos==-1) ? nTotalLen / 3 : pos;
-
-      CLog::Log(LOGDEBUG,"%s - seeking to pos %dms (total: %dms) in %s", __FUNCTION__, nSeekTo, nTotalLen, redactPath.c_str());
-      if (pDemuxer->SeekTime(nSeekTo, true))
-      {
-        CDVDVideoCodec::VCReturn iDecoderState = CDVDVideoCodec::VC_NONE;
-        VideoPicture picture;
-
-        memset(&picture, 0, sizeof(picture));
-
-        // num streams * 160 frames, should get a valid frame, if not abort.
-        int abort_index = pDemuxer->GetNrOfStreams() * 160;
-        do
-        {
-          DemuxPacket* pPacket = pDemuxer->Read();
-          packetsTried++;
-
-          if (!pPacket)
-            break;
-
-          if (pPacket->iStreamId != nVideoStream)
-          {
-            CDVDDemuxUtils::FreeDemuxPacket(pPacket);
-            continue;
-          }
+      XFILE::CFile file;
+      if(file.OpenForWrite(CTextureCache::GetCachedPath(request->details->file)))
+        file.Close();
+    }
+  }
 
-          pVideoCodec->AddData(*pPacket);
-          CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+  if (decoder)
+    decoders.Put(std::move(decoder));
 
-          iDecoderState = CDVDVideoCodec::VC_NONE;
-          while (iDecoderState == CDVDVideoCodec::VC_NONE)
-          {
-            memset(&picture, 0, sizeof(VideoPicture));
-            iDecoderState = pVideoCodec->GetPicture(&picture);
-          }
+  unsigned int nTotalTime = XbmcThreads::SystemClockMillis() - nTime;
+  CLog::Log(LOGDEBUG,"%s - measured %u ms to extract %u thumbs from file <%s> in %d packets. ", __FUNCTION__, nTotalTime, thumbs, redactPath.c_str(), packetsTried);
+}
 
-          if (iDecoderState == CDVDVideoCodec::VC_PICTURE)
-          {
-            if(!(picture.iFlags & DVP_FLAG_DROPPED))
-              break;
-          }
+bool CDVDFileInfo::ExtractThumb(const std::string &strPath,
+                                CTextureDetails &details,
+                                CStreamDetails *pStreamDetails, int pos)
+{
+  ThumbRequest request;
+  request.path = strPath;
+  request.details = &details;
+  request.streamDetails = pStreamDetails;
+  request.pos = pos;
+
+  CThumbDecoders decoders;
+  ExtractFromFile({ &request }, decoders);
+  return request.result;
+}
 
-        } while (abort_index--);
+CDVDFileInfo::ThumbDecodersPtr CDVDFileInfo::CreateThumbDecoders()
+{
+  return std::make_shared<CThumbDecoders>();
+}
 
-        if (iDecoderState == CDVDVideoCodec::VC_PICTURE && !(picture.iFlags & DVP_FLAG_DROPPED))
-        {
-          {
-            unsigned int nWidth = g_advancedSettings.m_imageRes;
-            double aspect = (double)picture.iDisplayWidth / (double)picture.iDisplayHeight;
-            if(hint.forced_aspect && hint.aspect != 0)
-              aspect = hint.aspect;
-            unsigned int nHeight = (unsigned int)((double)g_advancedSettings.m_imageRes / aspect);
-
-            uint8_t *pOutBuf = (uint8_t*)av_malloc(nWidth * nHeight * 4);
-            struct SwsContext *context = sws_getContext(picture.iWidth, picture.iHeight,
-                  AV_PIX_FMT_YUV420P, nWidth, nHeight, AV_PIX_FMT_BGRA, SWS_FAST_BILINEAR, NULL, NULL, NULL);
-
-            if (context)
-            {
-              uint8_t *planes[YuvImage::MAX_PLANES];
-              int stride[YuvImage::MAX_PLANES];
-              picture.videoBuffer->GetPlanes(planes);
-              picture.videoBuffer->GetStrides(stride);
-              uint8_t *src[4]= { planes[0], planes[1], planes[2], 0 };
-              int srcStride[] = { stride[0], stride[1], stride[2], 0 };
-              uint8_t *dst[] = { pOutBuf, 0, 0, 0 };
-              int dstStride[] = { (int)nWidth*4, 0, 0, 0 };
-              int orientation = DegreeToOrientation(hint.orientation);
-              sws_scale(context, src, srcStride, 0, picture.iHeight, dst, dstStride);
-              sws_freeContext(context);
-
-              details.width = nWidth;
-              details.height = nHeight;
-              CPicture::CacheTexture(pOutBuf, nWidth, nHeight, nWidth * 4, orientation, nWidth, nHeight, CTextureCache::GetCachedPath(details.file));
-              bOk = true;
-            }
-            av_free(pOutBuf);
-          }
-        }
-        else
-        {
-          CLog::Log(LOGDEBUG,"%s - decode failed in %s after %d packets.", __FUNCTION__, redactPath.c_str(), packetsTried);
-        }
-      }
-      delete pVideoCodec;
+void CDVDFileInfo::ExtractThumbs(std::vector<ThumbRequest> &requests, unsigned int threads,
+                                 const ThumbDecodersPtr &sharedDecoders)
+{
+  // requests for the same file are served by one demuxer, front to back
+  std::vector<std::vector<ThumbRequest*>> files;
+  std::map<std::string, size_t> fileIndex;
+  for (ThumbRequest &request : requests)
+  {
+    request.result = false;
+    auto it = fileIndex.find(request.path);
+    if (it == fileIndex.end())
+    {
+      fileIndex[request.path] = files.size();
+      files.push_back({ &request });
     }
+    else
+      files[it->second].push_back(&request);
+  }
+  for (auto &file : files)
+  {
+    std::stable_sort(file.begin(), file.end(), [](const ThumbRequest *a, const ThumbRequest *b) {
+      return a->pos < b->pos;
+    });
   }
 
-  if (pDemuxer)
-    delete pDemuxer;
-
-  delete pInputStream;
+  if (threads == 0)
+    threads = std::max(1, std::min(g_cpuInfo.getCPUCount(), MAX_THUMB_WORKERS));
+  threads = std::min(threads, static_cast<unsigned int>(files.size()));
 
-  if(!bOk)
+  CThumbDecoders batchDecoders;
+  CThumbDecoders &decoders = sharedDecoders ? *sharedDecoders : batchDecoders;
+  if (threads <= 1)
   {
-    XFILE::CFile file;
-    if(file.OpenForWrite(CTextureCache::GetCachedPath(details.file)))
-      file.Close();
+    for (auto &file : files)
+      ExtractFromFile(file, decoders);
+    return;
   }
 
-  unsigned int nTotalTime = XbmcThreads::SystemClockMillis() - nTime;
-  CLog::Log(LOGDEBUG,"%s - measured %u ms to extract thumb from file <%s> in %d packets. ", __FUNCTION__, nTotalTime, redactPath.c_str(), packetsTried);
-  return bOk;
+  CWorkerPool pool("ThumbExtractor", threads, threads * 2);
+  for (auto &file : files)
+    pool.Submit([&file, &decoders]() { ExtractFromFile(file, decoders); });
+  pool.Wait();
 }
 
 /**
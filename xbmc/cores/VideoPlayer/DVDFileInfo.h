@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -29,15 +30,40 @@ class CStreamDetails;
 class CStreamDetailSubtitle;
 class CDVDInputStream;
 class CTextureDetails;
+class CThumbDecoders;
 
 class CDVDFileInfo
 {
 public:
+  /*! \brief A thumbnail and/or the stream details to extract with ExtractThumbs() */
+  struct ThumbRequest
+  {
+    std::string path;
+    CTextureDetails *details = nullptr;       ///< thumb to cache at details->file, nullptr for stream details only
+    CStreamDetails *streamDetails = nullptr;  ///< filled if not nullptr
+    int pos = -1;                             ///< position of the thumb in ms, -1 for a third into the file
+    bool result = false;                      ///< thumb cached, or stream details found if there is no thumb
+  };
+
   // Extract a thumbnail image from the media at strPath, optionally populating a streamdetails class with the data
   static bool ExtractThumb(const std::string &strPath,
                            CTextureDetails &details,
                            CStreamDetails *pStreamDetails, int pos=-1);
 
+  typedef std::shared_ptr<CThumbDecoders> ThumbDecodersPtr;
+
+  /*! \brief Create decoders to keep open between ExtractThumbs() calls, e.g. for the jobs of a directory */
+  static ThumbDecodersPtr CreateThumbDecoders();
+
+  /*! \brief Extract a batch of thumbnails, e.g. all chapters of a file or the episodes of a season
+   *  \details Requests for one file share its demuxer, files with the same video parameters reuse
+   *  the decoder of the previous one. Files are worked off in parallel.
+   *  \param threads number of files open at once, 0 picks one per core up to a few
+   *  \param decoders decoders to reuse and leave open for the next call, nullptr for the batch only
+   */
+  static void ExtractThumbs(std::vector<ThumbRequest> &requests, unsigned int threads = 0,
+                            const ThumbDecodersPtr &decoders = nullptr);
+
   // Probe the files streams and store the info in the VideoInfoTag
   static bool GetFileStreamDetails(CFileItem *pItem);
   static bool DemuxerToStreamDetails(CDVDInputStream* pInputStream, CDVDDemux *pDemux, CStreamDetails &details, const std::string &path = "");
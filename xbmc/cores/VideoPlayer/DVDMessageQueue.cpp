@@ -25,6 +25,9 @@
 #include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
 #include "math.h"
 
+// must be a power of 2
+#define RING_SIZE 4096
+
 CDVDMessageQueue::CDVDMessageQueue(const std::string &owner) : m_hEvent(true), m_owner(owner)
 {
   m_iDataSize     = 0;
@@ -35,6 +38,12 @@ CDVDMessageQueue::CDVDMessageQueue(const std::string &owner) : m_hEvent(true), m
   m_TimeFront = DVD_NOPTS_VALUE;
   m_TimeSize = 1.0 / 4.0; /* 4 seconds */
   m_iMaxDataSize = 0;
+
+  m_messageCount = 0;
+  m_ring.resize(RING_SIZE, nullptr);
+  m_ringRead = 0;
+  m_ringWrite = 0;
+  m_waiting = false;
 }
 
 CDVDMessageQueue::~CDVDMessageQueue()
@@ -57,9 +66,22 @@ void CDVDMessageQueue::Flush(CDVDMsg::Message type)
 {
   CSingleLock lock(m_section);
 
-  m_messages.remove_if([type](const DVDMessageListItem &item){
-    return type == CDVDMsg::NONE || item.message->IsType(type);
+  // the producer of the ring keeps adding to m_iDataSize while we flush, so
+  // take off what was removed instead of resetting it. Only demuxer packets
+  // count, so there is nothing to take off for other types.
+  int removedSize = 0;
+  m_messages.remove_if([type, &removedSize](const DVDMessageListItem &item){
+    if (type != CDVDMsg::NONE && !item.message->IsType(type))
+      return false;
+    if (item.message->IsType(CDVDMsg::DEMUXER_PACKET))
+    {
+      DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(item.message)->GetPacket();
+      if (packet)
+        removedSize += packet->iSize;
+    }
+    return true;
   });
+  m_messageCount = m_messages.size();
 
   m_prioMessages.remove_if([type](const DVDMessageListItem &item){
     return type == CDVDMsg::NONE || item.message->IsType(type);
@@ -67,7 +89,25 @@ void CDVDMessageQueue::Flush(CDVDMsg::Message type)
 
   if (type == CDVDMsg::DEMUXER_PACKET ||  type == CDVDMsg::NONE)
   {
-    m_iDataSize = 0;
+    // the ring only holds demuxer packets, anything put after we read the
+    // write position stays for the next Get
+    unsigned int read = m_ringRead;
+    unsigned int write = m_ringWrite;
+    for (; read != write; read++)
+    {
+      CDVDMsg* msg = m_ring[read & (RING_SIZE - 1)];
+      DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(msg)->GetPacket();
+      if (packet)
+        removedSize += packet->iSize;
+      msg->Release();
+      m_ring[read & (RING_SIZE - 1)] = nullptr;
+    }
+
+    // before the slots are handed back, the producer must not see them free
+    // with the old size still counted
+    m_iDataSize -= removedSize;
+    m_ringRead = read;
+
     m_TimeBack = DVD_NOPTS_VALUE;
     m_TimeFront = DVD_NOPTS_VALUE;
   }
@@ -104,8 +144,62 @@ MsgQueueReturnCode CDVDMessageQueue::PutBack(CDVDMsg* pMsg, int priority)
   return Put(pMsg, priority, false);
 }
 
+bool CDVDMessageQueue::PutRing(CDVDMsg* pMsg)
+{
+  // only one thread at a time may produce into the ring, everybody else takes the locked path
+  if (m_ringProducer.test_and_set(std::memory_order_acquire))
+    return false;
+
+  unsigned int write = m_ringWrite.load(std::memory_order_relaxed);
+  unsigned int read = m_ringRead;
+  if (write - read >= RING_SIZE)
+  {
+    m_ringProducer.clear(std::memory_order_release);
+    return false;
+  }
+
+  // the size is exact and may be changed by Get or Flush right now, only the
+  // times of an empty queue start over
+  if (read == write && m_messageCount == 0)
+  {
+    m_TimeBack = DVD_NOPTS_VALUE;
+    m_TimeFront = DVD_NOPTS_VALUE;
+  }
+
+  // the ring takes over the reference of the caller
+  m_ring[write & (RING_SIZE - 1)] = pMsg;
+
+  DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(pMsg)->GetPacket();
+  if (packet)
+  {
+    m_iDataSize += packet->iSize;
+    UpdateTimeFront(pMsg);
+  }
+
+  m_ringWrite = write + 1;
+  m_ringProducer.clear(std::memory_order_release);
+
+  // inform waiter for new packet, Get checks the ring again after setting m_waiting
+  if (m_waiting)
+    m_hEvent.Set();
+
+  return true;
+}
+
 MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front)
 {
+  if (!pMsg)
+  {
+    CLog::Log(LOGFATAL, "CDVDMessageQueue(%s)::Put MSGQ_INVALID_MSG", m_owner.c_str());
+    return MSGQ_INVALID_MSG;
+  }
+
+  if (m_bInitialized && priority == 0 && front && pMsg->IsType(CDVDMsg::DEMUXER_PACKET))
+  {
+    if (PutRing(pMsg))
+      return MSGQ_OK;
+  }
+
   CSingleLock lock(m_section);
 
   if (!m_bInitialized)
@@ -114,11 +208,6 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front
     pMsg->Release();
     return MSGQ_NOT_INITIALIZED;
   }
-  if (!pMsg)
-  {
-    CLog::Log(LOGFATAL, "CDVDMessageQueue(%s)::Put MSGQ_INVALID_MSG", m_owner.c_str());
-    return MSGQ_INVALID_MSG;
-  }
 
   if (priority > 0)
   {
@@ -134,17 +223,25 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front
   }
   else
   {
-    if (m_messages.empty())
+    if (m_messages.empty() && m_ringRead == m_ringWrite)
     {
-      m_iDataSize = 0;
       m_TimeBack = DVD_NOPTS_VALUE;
       m_TimeFront = DVD_NOPTS_VALUE;
     }
 
+    // a message put at the front comes after everything in the ring so far,
+    // one put back comes before anything still left in the ring
     if (front)
+    {
       m_messages.emplace_front(pMsg, priority);
+      m_messages.front().sequence = m_ringWrite;
+    }
     else
+    {
       m_messages.emplace_back(pMsg, priority);
+      m_messages.back().sequence = m_ringRead;
+    }
+    m_messageCount = m_messages.size();
   }
 
   if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET) && priority == 0)
@@ -154,9 +251,9 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front
     {
       m_iDataSize += packet->iSize;
       if (front)
-        UpdateTimeFront();
+        UpdateTimeFront(pMsg);
       else
-        UpdateTimeBack();
+        UpdateTimeBack(pMsg);
     }
   }
 
@@ -168,6 +265,18 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front
   return MSGQ_OK;
 }
 
+CDVDMsg* CDVDMessageQueue::GetOldest(unsigned int ringRead)
+{
+  // messages in m_messages are older than ring entries at or after their sequence
+  if (!m_messages.empty() && (int)(m_messages.back().sequence - ringRead) <= 0)
+    return m_messages.back().message;
+  if (ringRead != m_ringWrite)
+    return m_ring[ringRead & (RING_SIZE - 1)];
+  if (!m_messages.empty())
+    return m_messages.back().message;
+  return nullptr;
+}
+
 MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutInMilliSeconds, int &priority)
 {
   CSingleLock lock(m_section);
@@ -184,25 +293,56 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
 
   while (!m_bAbortRequest)
   {
-    std::list<DVDMessageListItem> &msgs = (priority > 0 || !m_prioMessages.empty()) ? m_prioMessages : m_messages;
+    bool prio = priority > 0 || !m_prioMessages.empty();
+    unsigned int ringRead = m_ringRead;
 
-    if (!msgs.empty() && (msgs.back().priority >= priority || m_drain))
+    if (prio && !m_prioMessages.empty() && (m_prioMessages.back().priority >= priority || m_drain))
     {
-      DVDMessageListItem& item(msgs.back());
+      DVDMessageListItem& item(m_prioMessages.back());
       priority = item.priority;
 
-      if (item.message->IsType(CDVDMsg::DEMUXER_PACKET) && item.priority == 0)
+      *pMsg = item.message->Acquire();
+      m_prioMessages.pop_back();
+      UpdateTimeBack(GetOldest(ringRead));
+      ret = MSGQ_OK;
+      break;
+    }
+    else if (!prio && GetOldest(ringRead))
+    {
+      priority = 0;
+
+      if (m_messages.empty() || (int)(m_messages.back().sequence - ringRead) > 0)
       {
-        DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(item.message)->GetPacket();
+        // take the packet from the ring and hand its reference to the caller
+        CDVDMsg* msg = m_ring[ringRead & (RING_SIZE - 1)];
+        m_ring[ringRead & (RING_SIZE - 1)] = nullptr;
+
+        DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(msg)->GetPacket();
         if (packet)
-        {
           m_iDataSize -= packet->iSize;
-        }
+
+        // update before releasing the slot, the producer resets the sizes once it sees us empty
+        UpdateTimeBack(GetOldest(ringRead + 1));
+        m_ringRead = ringRead + 1;
+        *pMsg = msg;
       }
+      else
+      {
+        DVDMessageListItem& item(m_messages.back());
+        if (item.message->IsType(CDVDMsg::DEMUXER_PACKET))
+        {
+          DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(item.message)->GetPacket();
+          if (packet)
+          {
+            m_iDataSize -= packet->iSize;
+          }
+        }
 
-      *pMsg = item.message->Acquire();
-      msgs.pop_back();
-      UpdateTimeBack();
+        *pMsg = item.message->Acquire();
+        m_messages.pop_back();
+        m_messageCount = m_messages.size();
+        UpdateTimeBack(GetOldest(ringRead));
+      }
       ret = MSGQ_OK;
       break;
     }
@@ -214,10 +354,21 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
     else
     {
       m_hEvent.Reset();
+
+      // packets put into the ring don't take the lock, so check again after
+      // announcing that we wait
+      m_waiting = true;
+      if (!prio && m_ringWrite != ringRead)
+      {
+        m_waiting = false;
+        continue;
+      }
       lock.Leave();
 
       // wait for a new message
-      if (!m_hEvent.WaitMSec(iTimeoutInMilliSeconds))
+      bool newMessage = m_hEvent.WaitMSec(iTimeoutInMilliSeconds);
+      m_waiting = false;
+      if (!newMessage)
         return MSGQ_TIMEOUT;
 
       lock.Enter();
@@ -230,46 +381,38 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
   return (MsgQueueReturnCode)ret;
 }
 
-void CDVDMessageQueue::UpdateTimeFront()
+void CDVDMessageQueue::UpdateTimeFront(CDVDMsg* pMsg)
 {
-  if (!m_messages.empty())
+  if (pMsg && pMsg->IsType(CDVDMsg::DEMUXER_PACKET))
   {
-    auto &item = m_messages.front();
-    if (item.message->IsType(CDVDMsg::DEMUXER_PACKET))
+    DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(pMsg)->GetPacket();
+    if (packet)
     {
-      DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(item.message)->GetPacket();
-      if (packet)
-      {
-        if (packet->dts != DVD_NOPTS_VALUE)
-          m_TimeFront = packet->dts;
-        else if (packet->pts != DVD_NOPTS_VALUE)
-          m_TimeFront = packet->pts;
+      if (packet->dts != DVD_NOPTS_VALUE)
+        m_TimeFront = packet->dts;
+      else if (packet->pts != DVD_NOPTS_VALUE)
+        m_TimeFront = packet->pts;
 
-        if (m_TimeBack == DVD_NOPTS_VALUE)
-          m_TimeBack = m_TimeFront;
-      }
+      if (m_TimeBack == DVD_NOPTS_VALUE)
+        m_TimeBack = m_TimeFront.load();
     }
   }
 }
 
-void CDVDMessageQueue::UpdateTimeBack()
+void CDVDMessageQueue::UpdateTimeBack(CDVDMsg* pMsg)
 {
-  if (!m_messages.empty())
+  if (pMsg && pMsg->IsType(CDVDMsg::DEMUXER_PACKET))
   {
-    auto &item = m_messages.back();
-    if (item.message->IsType(CDVDMsg::DEMUXER_PACKET))
+    DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(pMsg)->GetPacket();
+    if (packet)
     {
-      DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(item.message)->GetPacket();
-      if (packet)
-      {
-        if (packet->dts != DVD_NOPTS_VALUE)
-          m_TimeBack = packet->dts;
-        else if (packet->pts != DVD_NOPTS_VALUE)
-          m_TimeBack = packet->pts;
+      if (packet->dts != DVD_NOPTS_VALUE)
+        m_TimeBack = packet->dts;
+      else if (packet->pts != DVD_NOPTS_VALUE)
+        m_TimeBack = packet->pts;
 
-        if (m_TimeFront == DVD_NOPTS_VALUE)
-          m_TimeFront = m_TimeBack;
-      }
+      if (m_TimeFront == DVD_NOPTS_VALUE)
+        m_TimeFront = m_TimeBack.load();
     }
   }
 }
@@ -292,6 +435,8 @@ unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
     if(item.message->IsType(type))
       count++;
   }
+  if (type == CDVDMsg::DEMUXER_PACKET)
+    count += m_ringWrite - m_ringRead;
 
   return count;
 }
@@ -317,22 +462,22 @@ void CDVDMessageQueue::WaitUntilEmpty()
 
 int CDVDMessageQueue::GetLevel() const
 {
-  CSingleLock lock(m_section);
-
-  if (m_iDataSize > m_iMaxDataSize)
+  // lock free, the level is queried after every packet put into the ring
+  int dataSize = m_iDataSize;
+  if (dataSize > m_iMaxDataSize)
     return 100;
-  if (m_iDataSize == 0)
+  if (dataSize == 0)
     return 0;
 
   if (IsDataBased())
   {
-    return std::min(100, 100 * m_iDataSize / m_iMaxDataSize);
+    return std::min(100, 100 * dataSize / m_iMaxDataSize);
   }
 
   int level = std::min(100.0, ceil(100.0 * m_TimeSize * (m_TimeFront - m_TimeBack) / DVD_TIME_BASE ));
 
   // if we added lots of packets with NOPTS, make sure that the queue is not signalled empty
-  if (level == 0 && m_iDataSize != 0)
+  if (level == 0 && dataSize != 0)
   {
     CLog::Log(LOGDEBUG, "CDVDMessageQueue::GetLevel() - can't determine level");
     return 1;
@@ -343,8 +488,6 @@ int CDVDMessageQueue::GetLevel() const
 
 int CDVDMessageQueue::GetTimeSize() const
 {
-  CSingleLock lock(m_section);
-
   if (IsDataBased())
     return 0;
   else
@@ -24,6 +24,7 @@
 #include <atomic>
 #include <string>
 #include <list>
+#include <vector>
 #include <algorithm>
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
@@ -34,11 +35,13 @@ struct DVDMessageListItem
   {
     message = msg->Acquire();
     priority = prio;
+    sequence = 0;
   }
   DVDMessageListItem()
   {
     message = NULL;
     priority = 0;
+    sequence = 0;
   }
   DVDMessageListItem(const DVDMessageListItem&) = delete;
  ~DVDMessageListItem()
@@ -51,6 +54,7 @@ struct DVDMessageListItem
 
   CDVDMsg* message;
   int priority;
+  unsigned int sequence; // ring write position at the time the message was queued
 };
 
 enum MsgQueueReturnCode
@@ -111,19 +115,21 @@ public:
 private:
 
   MsgQueueReturnCode Put(CDVDMsg* pMsg, int priority, bool front);
-  void UpdateTimeFront();
-  void UpdateTimeBack();
+  bool PutRing(CDVDMsg* pMsg);
+  CDVDMsg* GetOldest(unsigned int ringRead);
+  void UpdateTimeFront(CDVDMsg* pMsg);
+  void UpdateTimeBack(CDVDMsg* pMsg);
 
   CEvent m_hEvent;
   mutable CCriticalSection m_section;
 
   std::atomic<bool> m_bAbortRequest;
-  bool m_bInitialized;
+  std::atomic<bool> m_bInitialized;
   bool m_drain = false;
 
-  int m_iDataSize;
-  double m_TimeFront;
-  double m_TimeBack;
+  std::atomic<int> m_iDataSize;
+  std::atomic<double> m_TimeFront;
+  std::atomic<double> m_TimeBack;
   double m_TimeSize;
 
   int m_iMaxDataSize;
@@ -131,5 +137,21 @@ private:
 
   std::list<DVDMessageListItem> m_messages;
   std::list<DVDMessageListItem> m_prioMessages;
+  std::atomic<unsigned int> m_messageCount; // m_messages.size(), readable without m_section
+
+  /**
+   * Demuxer packets put at the front with priority 0 go to a bounded single
+   * producer/single consumer ring without taking m_section or allocating a
+   * list node. The producer side is lock free, the consumer side (Get, Flush)
+   * runs under m_section. Messages in m_messages carry the ring write position
+   * at the time they were queued, which keeps the order between both.
+   * Packets fall back to m_messages when the ring is full or a second thread
+   * is putting at the same time.
+   */
+  std::vector<CDVDMsg*> m_ring;
+  std::atomic<unsigned int> m_ringRead;
+  std::atomic<unsigned int> m_ringWrite;
+  std::atomic_flag m_ringProducer = ATOMIC_FLAG_INIT;
+  std::atomic<bool> m_waiting; // Get is about to wait on m_hEvent
 };
 
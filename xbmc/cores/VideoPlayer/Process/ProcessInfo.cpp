@@ -20,6 +20,7 @@
 
 #include "ProcessInfo.h"
 #include "cores/DataCacheCore.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
 #include "threads/SingleLock.h"
 
 CCriticalSection createSection;
@@ -546,6 +547,11 @@ int CProcessInfo::GetLevelVQ()
   return m_levelVQ;
 }
 
+DemuxPacketPoolStats CProcessInfo::GetDemuxPacketPoolStats()
+{
+  return CDVDDemuxUtils::GetPacketPoolStats();
+}
+
 void CProcessInfo::SetGuiRender(bool gui)
 {
   CSingleLock lock(m_stateSection);
@@ -31,6 +31,7 @@
 
 class CProcessInfo;
 class CDataCacheCore;
+struct DemuxPacketPoolStats;
 
 using CreateProcessControl = CProcessInfo* (*)();
 
@@ -109,6 +110,9 @@ public:
   void SetPlayTimes(time_t start, int64_t current, int64_t min, int64_t max);
   int64_t GetMaxTime();
 
+  // demux packet pool, shared by all players
+  DemuxPacketPoolStats GetDemuxPacketPoolStats();
+
   // settings
   CVideoSettings GetVideoSettings();
   void SetVideoSettings(CVideoSettings &settings);
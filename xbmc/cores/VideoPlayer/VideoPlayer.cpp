@@ -2482,6 +2482,7 @@ void CVideoPlayer::OnExit()
   }
 
   CFFmpegLog::ClearLogLevel();
+  CDVDDemuxUtils::ReleasePacketPool();
   m_bStop = true;
 
   IPlayerCallback *cb = &m_callback;
@@ -3214,6 +3215,14 @@ void CVideoPlayer::GetGeneralInfo(std::string& strGeneralInfo)
           strBuf += StringUtils::Format(" %d msec", DVD_TIME_TO_MSEC(m_State.cache_delay));
       }
 
+      DemuxPacketPoolStats pool = m_processInfo->GetDemuxPacketPoolStats();
+      if (pool.allocations)
+      {
+        strBuf += StringUtils::Format(" pool:%2.0f%% %s"
+                                      , 100.0 * pool.hits / pool.allocations
+                                      , StringUtils::SizeToString(pool.pooledBytes + pool.usedBytes).c_str());
+      }
+
       strGeneralInfo = StringUtils::Format("Player: a/v:% 6.3f, %s"
                                            , dDiff
                                            , strBuf.c_str());
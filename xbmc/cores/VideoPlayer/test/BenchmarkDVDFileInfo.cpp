@@ -0,0 +1,87 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TestDVDFileInfo.h"
+#include "utils/Stopwatch.h"
+
+/*!
+ 1080p clips of a few seconds, the kind of files a season folder holds
+ */
+class BenchmarkDVDFileInfo : public DVDFileInfoClips<BenchmarkDVDFileInfo>
+{
+public:
+  static constexpr int CLIPS = 4;
+  static constexpr int CLIP_SECONDS = 8;
+  static constexpr int CLIP_WIDTH = 1920;
+  static constexpr int CLIP_HEIGHT = 1080;
+};
+
+TEST_F(BenchmarkDVDFileInfo, ExtractThumbs)
+{
+  CStopWatch watch;
+
+  // one ExtractThumb per thumb, each opening its own decoder
+  std::vector<CDVDFileInfo::ThumbRequest> requests;
+  std::vector<CTextureDetails> details;
+  std::vector<CStreamDetails> streamDetails;
+  MakeRequests(requests, details, streamDetails, "single");
+  watch.StartZero();
+  for (auto &request : requests)
+    request.result = CDVDFileInfo::ExtractThumb(request.path, *request.details, request.streamDetails, request.pos);
+  float timeSingle = watch.GetElapsedMilliseconds();
+  for (const auto &request : requests)
+    EXPECT_TRUE(request.result);
+
+  // one thumb per call with the decoders of the loader, what a CThumbExtractor job does
+  std::vector<CDVDFileInfo::ThumbRequest> jobs;
+  std::vector<CTextureDetails> jobsDetails;
+  std::vector<CStreamDetails> jobsStreamDetails;
+  MakeRequests(jobs, jobsDetails, jobsStreamDetails, "jobs");
+  CDVDFileInfo::ThumbDecodersPtr decoders = CDVDFileInfo::CreateThumbDecoders();
+  watch.StartZero();
+  for (auto &job : jobs)
+  {
+    std::vector<CDVDFileInfo::ThumbRequest> request(1, job);
+    CDVDFileInfo::ExtractThumbs(request, 1, decoders);
+    job.result = request[0].result;
+  }
+  float timeJobs = watch.GetElapsedMilliseconds();
+  for (const auto &job : jobs)
+    EXPECT_TRUE(job.result);
+
+  for (unsigned int threads : { 1u, 0u })
+  {
+    std::vector<CDVDFileInfo::ThumbRequest> batch;
+    std::vector<CTextureDetails> batchDetails;
+    std::vector<CStreamDetails> batchStreamDetails;
+    MakeRequests(batch, batchDetails, batchStreamDetails, StringUtils::Format("batch%u", threads));
+    watch.StartZero();
+    CDVDFileInfo::ExtractThumbs(batch, threads);
+    float timeBatch = watch.GetElapsedMilliseconds();
+    for (const auto &request : batch)
+      EXPECT_TRUE(request.result);
+
+    RecordProperty(threads ? StringUtils::Format("batch_%u_thread_ms", threads) : "batch_default_threads_ms",
+                   static_cast<int>(timeBatch));
+  }
+  RecordProperty("thumbs", static_cast<int>(requests.size()));
+  RecordProperty("single_ms", static_cast<int>(timeSingle));
+  RecordProperty("shared_decoders_ms", static_cast<int>(timeJobs));
+}
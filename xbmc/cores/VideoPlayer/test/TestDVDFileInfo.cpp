@@ -0,0 +1,52 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TestDVDFileInfo.h"
+
+constexpr int TestDVDFileInfo::CLIPS;
+constexpr int TestDVDFileInfo::CLIP_SECONDS;
+constexpr int TestDVDFileInfo::CLIP_WIDTH;
+constexpr int TestDVDFileInfo::CLIP_HEIGHT;
+
+TEST_F(TestDVDFileInfo, ExtractThumbs)
+{
+  std::vector<CDVDFileInfo::ThumbRequest> requests;
+  std::vector<CTextureDetails> details;
+  std::vector<CStreamDetails> streamDetails;
+  MakeRequests(requests, details, streamDetails, "batch");
+
+  CDVDFileInfo::ExtractThumbs(requests);
+
+  for (const auto &request : requests)
+  {
+    SCOPED_TRACE(request.details->file);
+    EXPECT_TRUE(request.result);
+    EXPECT_LT(0u, request.details->width);
+    struct __stat64 buffer;
+    ASSERT_EQ(0, XFILE::CFile::Stat(CTextureCache::GetCachedPath(request.details->file), &buffer));
+    EXPECT_LT(0, buffer.st_size);
+  }
+  for (const auto &details : streamDetails)
+  {
+    EXPECT_EQ(CLIP_WIDTH, details.GetVideoWidth());
+    EXPECT_EQ(CLIP_HEIGHT, details.GetVideoHeight());
+    EXPECT_EQ(CLIP_SECONDS, details.GetVideoDuration());
+  }
+}
@@ -0,0 +1,210 @@
+#pragma once
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/VideoPlayer/DVDFileInfo.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "TextureCache.h"
+#include "TextureCacheJob.h"
+#include "utils/StreamDetails.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "libavcodec/avcodec.h"
+#include "libavformat/avformat.h"
+}
+
+/*!
+ Encodes MPEG-4 clips with a keyframe every second and extracts a thumb a
+ third in plus chapter thumbs from each of them. The fixture TClips derived
+ from it picks the clips with the constants CLIPS, CLIP_SECONDS, CLIP_WIDTH
+ and CLIP_HEIGHT.
+ */
+template<typename TClips>
+class DVDFileInfoClips : public testing::Test
+{
+protected:
+  static constexpr int CLIP_FPS = 25;
+  static constexpr int CHAPTERS = 4;
+
+  static void SetUpTestCase()
+  {
+    av_register_all();
+    avcodec_register_all();
+
+    std::string dir = CSpecialProtocol::TranslatePath("special://temp/dvdfileinfo/");
+    XFILE::CDirectory::Create(dir);
+    for (int i = 0; i < TClips::CLIPS; i++)
+    {
+      std::string path = URIUtils::AddFileToFolder(dir, StringUtils::Format("clip%d.mkv", i));
+      if (WriteClip(path, i))
+        Clips().push_back(path);
+    }
+  }
+
+  static void TearDownTestCase()
+  {
+    XFILE::CDirectory::RemoveRecursive("special://temp/dvdfileinfo/");
+    Clips().clear();
+  }
+
+  void SetUp() override
+  {
+    ASSERT_EQ(static_cast<size_t>(TClips::CLIPS), Clips().size());
+    XFILE::CDirectory::Create(CTextureCache::GetCachedPath("dvdfileinfo"));
+  }
+
+  // the thumbs are written straight into the texture cache folder
+  void TearDown() override
+  {
+    XFILE::CDirectory::RemoveRecursive(CTextureCache::GetCachedPath("dvdfileinfo/"));
+  }
+
+  static bool WriteClip(const std::string &path, int seed)
+  {
+    AVFormatContext *format = nullptr;
+    if (avformat_alloc_output_context2(&format, nullptr, nullptr, path.c_str()) < 0)
+      return false;
+
+    bool ok = false;
+    AVCodec *codec = avcodec_find_encoder(AV_CODEC_ID_MPEG4);
+    AVStream *stream = avformat_new_stream(format, nullptr);
+    AVCodecContext *context = codec ? avcodec_alloc_context3(codec) : nullptr;
+    AVFrame *frame = av_frame_alloc();
+    if (stream && context && frame)
+    {
+      context->width = TClips::CLIP_WIDTH;
+      context->height = TClips::CLIP_HEIGHT;
+      context->time_base = { 1, CLIP_FPS };
+      context->pix_fmt = AV_PIX_FMT_YUV420P;
+      context->gop_size = CLIP_FPS;
+      context->bit_rate = 4000000;
+      if (format->oformat->flags & AVFMT_GLOBALHEADER)
+        context->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+
+      frame->format = context->pix_fmt;
+      frame->width = context->width;
+      frame->height = context->height;
+
+      if (avcodec_open2(context, codec, nullptr) >= 0 &&
+          avcodec_parameters_from_context(stream->codecpar, context) >= 0 &&
+          av_frame_get_buffer(frame, 32) >= 0 &&
+          avio_open(&format->pb, path.c_str(), AVIO_FLAG_WRITE) >= 0)
+      {
+        stream->time_base = context->time_base;
+        ok = avformat_write_header(format, nullptr) >= 0;
+
+        AVPacket packet;
+        av_init_packet(&packet);
+        packet.data = nullptr;
+        packet.size = 0;
+        int frames = TClips::CLIP_SECONDS * CLIP_FPS;
+        for (int i = 0; ok && i <= frames; i++)
+        {
+          // moving gradients, the last round flushes the encoder
+          if (i < frames)
+          {
+            av_frame_make_writable(frame);
+            for (int y = 0; y < TClips::CLIP_HEIGHT; y++)
+              for (int x = 0; x < TClips::CLIP_WIDTH; x++)
+                frame->data[0][y * frame->linesize[0] + x] = x + y + i * 3 + seed * 40;
+            for (int y = 0; y < TClips::CLIP_HEIGHT / 2; y++)
+            {
+              for (int x = 0; x < TClips::CLIP_WIDTH / 2; x++)
+              {
+                frame->data[1][y * frame->linesize[1] + x] = 128 + y + i * 2;
+                frame->data[2][y * frame->linesize[2] + x] = 64 + x + i * 5;
+              }
+            }
+            frame->pts = i;
+          }
+          if (avcodec_send_frame(context, i < frames ? frame : nullptr) < 0)
+            ok = false;
+          while (ok && avcodec_receive_packet(context, &packet) == 0)
+          {
+            av_packet_rescale_ts(&packet, context->time_base, stream->time_base);
+            packet.stream_index = stream->index;
+            ok = av_interleaved_write_frame(format, &packet) >= 0;
+          }
+        }
+        if (ok)
+          ok = av_write_trailer(format) >= 0;
+        avio_closep(&format->pb);
+      }
+    }
+
+    av_frame_free(&frame);
+    avcodec_free_context(&context);
+    avformat_free_context(format);
+    return ok;
+  }
+
+  // a thumb with stream details per clip, the way the library asks for
+  // them, and the chapter thumbs the bookmark dialog wants
+  static void MakeRequests(std::vector<CDVDFileInfo::ThumbRequest> &requests,
+                           std::vector<CTextureDetails> &details,
+                           std::vector<CStreamDetails> &streamDetails,
+                           const std::string &name)
+  {
+    details.resize(TClips::CLIPS * (CHAPTERS + 1));
+    streamDetails.resize(TClips::CLIPS);
+    for (int i = 0; i < TClips::CLIPS; i++)
+    {
+      for (int chapter = 0; chapter <= CHAPTERS; chapter++)
+      {
+        CDVDFileInfo::ThumbRequest request;
+        request.path = Clips()[i];
+        request.details = &details[i * (CHAPTERS + 1) + chapter];
+        request.details->file = StringUtils::Format("dvdfileinfo/%s-%d-%d.jpg", name.c_str(), i, chapter);
+        if (chapter == 0)
+          request.streamDetails = &streamDetails[i];
+        else
+          request.pos = (chapter * TClips::CLIP_SECONDS * 1000) / (CHAPTERS + 1);
+        requests.push_back(request);
+      }
+    }
+  }
+
+  static std::vector<std::string> &Clips()
+  {
+    static std::vector<std::string> clips;
+    return clips;
+  }
+};
+
+/*!
+ A couple of short low resolution clips, enough to cover every kind of request
+ */
+class TestDVDFileInfo : public DVDFileInfoClips<TestDVDFileInfo>
+{
+public:
+  static constexpr int CLIPS = 2;
+  static constexpr int CLIP_SECONDS = 2;
+  static constexpr int CLIP_WIDTH = 320;
+  static constexpr int CLIP_HEIGHT = 180;
+};
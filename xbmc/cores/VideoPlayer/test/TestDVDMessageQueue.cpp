@@ -0,0 +1,194 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
+#include "cores/VideoPlayer/DVDMessageQueue.h"
+#include "cores/VideoPlayer/Interface/Addon/DemuxPacket.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <thread>
+
+#define PACKET_SIZE 100
+#define CONCURRENT_PACKETS 50000
+
+namespace
+{
+CDVDMsg* MakePacket(int pts)
+{
+  DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(PACKET_SIZE);
+  packet->iSize = PACKET_SIZE;
+  packet->pts = pts;
+  return new CDVDMsgDemuxerPacket(packet);
+}
+
+// pts of a packet, -1 for any other message
+int GetPts(CDVDMsg* msg)
+{
+  if (!msg->IsType(CDVDMsg::DEMUXER_PACKET))
+    return -1;
+  return static_cast<int>(static_cast<CDVDMsgDemuxerPacket*>(msg)->GetPacket()->pts);
+}
+
+int GetNext(CDVDMessageQueue &queue, int &priority)
+{
+  CDVDMsg* msg = nullptr;
+  if (queue.Get(&msg, 0, priority) != MSGQ_OK)
+    return -2;
+  int pts = GetPts(msg);
+  msg->Release();
+  return pts;
+}
+
+int GetNext(CDVDMessageQueue &queue)
+{
+  int priority = 0;
+  return GetNext(queue, priority);
+}
+}
+
+TEST(TestDVDMessageQueue, Order)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  // packets go to the ring, other messages to the locked list in between
+  queue.Put(MakePacket(1));
+  queue.Put(MakePacket(2));
+  queue.Put(new CDVDMsg(CDVDMsg::GENERAL_RESYNC));
+  queue.Put(MakePacket(3));
+  queue.PutBack(MakePacket(0));
+  EXPECT_EQ(4 * PACKET_SIZE, queue.GetDataSize());
+
+  EXPECT_EQ(0, GetNext(queue));
+  EXPECT_EQ(1, GetNext(queue));
+  EXPECT_EQ(2, GetNext(queue));
+  EXPECT_EQ(-1, GetNext(queue));
+  EXPECT_EQ(3, GetNext(queue));
+  EXPECT_EQ(-2, GetNext(queue));
+  EXPECT_EQ(0, queue.GetDataSize());
+}
+
+TEST(TestDVDMessageQueue, Priority)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  queue.Put(MakePacket(1));
+  queue.Put(MakePacket(10), 1);
+  queue.Put(MakePacket(20), 2);
+  queue.PutBack(MakePacket(21), 2);
+
+  // the highest priority comes first, a message put back goes before one
+  // of the same priority put at the front
+  int priority = 2;
+  EXPECT_EQ(21, GetNext(queue, priority));
+  EXPECT_EQ(2, priority);
+  EXPECT_EQ(20, GetNext(queue, priority));
+
+  // nothing else is at priority 2 or above
+  EXPECT_EQ(-2, GetNext(queue, priority));
+
+  priority = 0;
+  EXPECT_EQ(10, GetNext(queue, priority));
+  EXPECT_EQ(1, priority);
+  priority = 0;
+  EXPECT_EQ(1, GetNext(queue, priority));
+  EXPECT_EQ(0, priority);
+
+  // priority messages don't count as data
+  EXPECT_EQ(0, queue.GetDataSize());
+}
+
+TEST(TestDVDMessageQueue, Flush)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  queue.Put(MakePacket(1));
+  queue.Put(new CDVDMsg(CDVDMsg::GENERAL_RESYNC));
+  queue.Put(MakePacket(2));
+  queue.Put(MakePacket(3), 1);
+
+  queue.Flush(CDVDMsg::GENERAL_RESYNC);
+  EXPECT_EQ(2 * PACKET_SIZE, queue.GetDataSize());
+  EXPECT_EQ(3u, queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+
+  queue.Flush();
+  EXPECT_EQ(0, queue.GetDataSize());
+  EXPECT_EQ(0u, queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+  EXPECT_EQ(-2, GetNext(queue));
+}
+
+TEST(TestDVDMessageQueue, FlushWhilePutAndGet)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  std::atomic<bool> produced(false);
+  std::atomic<bool> stop(false);
+  std::atomic<bool> negative(false);
+  std::atomic<bool> ordered(true);
+
+  std::thread producer([&]() {
+    for (int i = 0; i < CONCURRENT_PACKETS; i++)
+      queue.Put(MakePacket(i));
+    produced = true;
+  });
+
+  // packets of one producer never come out of order, even across flushes
+  std::thread consumer([&]() {
+    int last = -1;
+    while (!stop)
+    {
+      int pts = GetNext(queue);
+      if (pts >= 0)
+      {
+        if (pts <= last)
+          ordered = false;
+        last = pts;
+      }
+      if (queue.GetDataSize() < 0)
+        negative = true;
+    }
+  });
+
+  while (!produced)
+  {
+    queue.Flush();
+    if (queue.GetDataSize() < 0)
+      negative = true;
+    std::this_thread::yield();
+  }
+  producer.join();
+  stop = true;
+  consumer.join();
+
+  EXPECT_FALSE(negative);
+  EXPECT_TRUE(ordered);
+
+  // what is left accounts exactly for the packets still queued
+  unsigned int left = queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET);
+  EXPECT_EQ((int)left * PACKET_SIZE, queue.GetDataSize());
+  while (GetNext(queue) != -2)
+    ;
+  EXPECT_EQ(0, queue.GetDataSize());
+}
@@ -152,6 +152,7 @@ bool CDatabase::ExistsSubQuery::BuildSQL(std::string & strSQL)
 CDatabase::CDatabase(void)
 {
   m_openCount = 0;
+  m_transactionDepth = 0;
   m_sqlite = true;
   m_bMultiWrite = false;
   m_multipleExecute = false;
@@ -212,6 +213,26 @@ std::string CDatabase::GetSingleValue(const std::string &query, std::unique_ptr<
   return ret;
 }
 
+std::string CDatabase::GetSingleValue(const std::string &query, const std::vector<field_value> &params)
+{
+  std::string ret;
+  try
+  {
+    if (!m_pDB.get() || !m_pDS.get())
+      return ret;
+
+    if (m_pDS->query(query, params) && m_pDS->num_rows() > 0)
+      ret = m_pDS->fv(0).get_asString();
+
+    m_pDS->close();
+  }
+  catch(...)
+  {
+    CLog::Log(LOGERROR, "%s - failed on query '%s'", __FUNCTION__, query.c_str());
+  }
+  return ret;
+}
+
 std::string CDatabase::GetSingleValue(const std::string &strTable, const std::string &strColumn, const std::string &strWhereClause /* = std::string() */, const std::string &strOrderBy /* = std::string() */)
 {
   std::string query = PrepareSQL("SELECT %s FROM %s", strColumn.c_str(), strTable.c_str());
@@ -284,6 +305,30 @@ bool CDatabase::ExecuteQuery(const std::string &strQuery)
   return bReturn;
 }
 
+bool CDatabase::ExecuteQuery(const std::string &strQuery, const std::vector<field_value> &params)
+{
+  bool bReturn = false;
+
+  try
+  {
+    if (NULL == m_pDB.get()) return bReturn;
+    if (NULL == m_pDS.get()) return bReturn;
+
+    if (m_multipleExecute)
+      m_multipleQueries.push_back(m_pDS->bind_sql(strQuery, params));
+    else
+      m_pDS->exec(strQuery, params);
+    bReturn = true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - failed to execute query '%s'",
+        __FUNCTION__, strQuery.c_str());
+  }
+
+  return bReturn;
+}
+
 bool CDatabase::ResultQuery(const std::string &strQuery)
 {
   bool bReturn = false;
@@ -500,6 +545,7 @@ bool CDatabase::Connect(const std::string &dbName, const DatabaseSettings &dbSet
   }
 
   m_openCount = 1; // our database is open
+  m_transactionDepth = 0;
   return true;
 }
 
@@ -528,6 +574,7 @@ void CDatabase::Close()
   }
 
   m_openCount = 0;
+  m_transactionDepth = 0;
   m_multipleExecute = false;
 
   if (NULL == m_pDB.get() ) return ;
@@ -583,19 +630,36 @@ void CDatabase::BeginTransaction()
 {
   try
   {
-    if (NULL != m_pDB.get())
+    if (m_transactionDepth > 0)
+    {
+      // nested transactions are savepoints, so rolling one back keeps what the outer ones did
+      if (NULL != m_pDS.get())
+        m_pDS->exec(PrepareSQL("SAVEPOINT nested%u", m_transactionDepth));
+    }
+    else if (NULL != m_pDB.get())
       m_pDB->start_transaction();
   }
   catch (...)
   {
     CLog::Log(LOGERROR, "database:begintransaction failed");
+    return;
   }
+  m_transactionDepth++;
 }
 
 bool CDatabase::CommitTransaction()
 {
   try
   {
+    if (m_transactionDepth > 1)
+    {
+      m_transactionDepth--;
+      if (NULL != m_pDS.get())
+        m_pDS->exec(PrepareSQL("RELEASE SAVEPOINT nested%u", m_transactionDepth));
+      return true;
+    }
+    m_transactionDepth = 0;
+
     if (NULL != m_pDB.get())
       m_pDB->commit_transaction();
   }
@@ -611,6 +675,18 @@ void CDatabase::RollbackTransaction()
 {
   try
   {
+    if (m_transactionDepth > 1)
+    {
+      m_transactionDepth--;
+      if (NULL != m_pDS.get())
+      {
+        m_pDS->exec(PrepareSQL("ROLLBACK TO SAVEPOINT nested%u", m_transactionDepth));
+        m_pDS->exec(PrepareSQL("RELEASE SAVEPOINT nested%u", m_transactionDepth));
+      }
+      return;
+    }
+    m_transactionDepth = 0;
+
     if (NULL != m_pDB.get())
       m_pDB->rollback_transaction();
   }
@@ -622,8 +698,7 @@ void CDatabase::RollbackTransaction()
 
 bool CDatabase::InTransaction()
 {
-  if (NULL != m_pDB.get()) return false;
-  return m_pDB->in_transaction();
+  return m_transactionDepth > 0;
 }
 
 bool CDatabase::CreateDatabase()
@@ -29,6 +29,8 @@ namespace dbiplus {
 #include <string>
 #include <vector>
 
+#include "qry_dat.h"
+
 class DatabaseSettings; // forward
 class CDbUrl;
 struct SortDescription;
@@ -82,6 +84,14 @@ public:
 
   bool Open(const DatabaseSettings &db);
 
+  /*!
+   \brief Start a transaction
+   \details Transactions nest. Only the outermost one is sent to the database
+   and everything done within it is committed when it's committed. Nested ones
+   are savepoints, so rolling one back only undoes what was done within it.
+   A transaction which failed to start isn't counted, so InTransaction() tells
+   whether the changes that follow are part of one.
+   */
   void BeginTransaction();
   virtual bool CommitTransaction();
   void RollbackTransaction();
@@ -110,6 +120,13 @@ public:
    */
   std::string GetSingleValue(const std::string &query, std::unique_ptr<dbiplus::Dataset> &ds);
 
+  /*! \brief Get a single value from a query with '?' placeholders.
+   \param query the query in question.
+   \param params the values to bind to the placeholders, in order.
+   \return the value from the query, empty on failure.
+   */
+  std::string GetSingleValue(const std::string &query, const std::vector<dbiplus::field_value> &params);
+
   /*!
    * @brief Delete values from a table.
    * @param strTable The table to delete the values from.
@@ -128,6 +145,17 @@ public:
    */
   bool ExecuteQuery(const std::string &strQuery);
 
+  /*!
+   * @brief Execute a query with '?' placeholders that does not return any result.
+   *        The query is run through the connection's prepared statement cache.
+   *        If BeginMultipleExecute() has been called, the parameters are
+   *        expanded into the query and it is queued as with ExecuteQuery().
+   * @param strQuery The query to execute.
+   * @param params The values to bind to the placeholders, in order.
+   * @return True if the query was executed successfully, false otherwise.
+   */
+  bool ExecuteQuery(const std::string &strQuery, const std::vector<dbiplus::field_value> &params);
+
   /*!
    * @brief Execute a query that returns a result.
    * @remarks Call m_pDS->close(); to clean up the dataset when done.
@@ -228,6 +256,7 @@ private:
 
   bool m_bMultiWrite; /*!< True if there are any queries in the queue, false otherwise */
   unsigned int m_openCount;
+  unsigned int m_transactionDepth; /*!< Number of transactions begun and not committed or rolled back yet */
 
   bool m_multipleExecute;
   std::vector<std::string> m_multipleQueries;
@@ -0,0 +1,202 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "column_set.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace dbiplus {
+
+void column_set::clear()
+{
+  m_columns.clear();
+  m_text.clear();
+  m_rows = 0;
+}
+
+void column_set::reserve(unsigned int rows, size_t textBytes /* = 0 */)
+{
+  for (auto &col : m_columns)
+    col.cells.reserve(rows);
+  if (textBytes)
+    m_text.reserve(textBytes);
+}
+
+void column_set::add_column(const char *name)
+{
+  column col;
+  col.name = name ? name : "";
+  m_columns.push_back(std::move(col));
+}
+
+void column_set::append_null(unsigned int col)
+{
+  cell c;
+  c.type = cell_null;
+  c.int_value = 0;
+  m_columns[col].cells.push_back(c);
+}
+
+void column_set::append_int(unsigned int col, int64_t value)
+{
+  cell c;
+  c.type = cell_int;
+  c.int_value = value;
+  m_columns[col].cells.push_back(c);
+}
+
+void column_set::append_double(unsigned int col, double value)
+{
+  cell c;
+  c.type = cell_double;
+  c.double_value = value;
+  m_columns[col].cells.push_back(c);
+}
+
+void column_set::append_text(unsigned int col, const char *text, size_t length)
+{
+  cell c;
+  c.type = cell_text;
+  c.text.offset = m_text.size();
+  c.text.length = length;
+  m_text.insert(m_text.end(), text, text + length);
+  m_text.push_back('\0');
+  m_columns[col].cells.push_back(c);
+}
+
+void column_set::append_text(unsigned int col, const char *text)
+{
+  if (text == nullptr)
+    append_null(col);
+  else
+    append_text(col, text, strlen(text));
+}
+
+int column_set::column_index(const char *name) const
+{
+  for (unsigned int i = 0; i < m_columns.size(); i++)
+  {
+    if (m_columns[i].name == name)
+      return i;
+  }
+
+  // "table.column" requests match plain column names
+  const char *dot = strchr(name, '.');
+  if (dot)
+    return column_index(dot + 1);
+
+  return -1;
+}
+
+int64_t column_set::get_int64(unsigned int row, unsigned int col) const
+{
+  const cell &c = cell_at(row, col);
+  switch (c.type)
+  {
+  case cell_int:
+    return c.int_value;
+  case cell_double:
+    return (int64_t)c.double_value;
+  case cell_text:
+    return strtoll(&m_text[c.text.offset], nullptr, 10);
+  default:
+    return 0;
+  }
+}
+
+double column_set::get_double(unsigned int row, unsigned int col) const
+{
+  const cell &c = cell_at(row, col);
+  switch (c.type)
+  {
+  case cell_int:
+    return (double)c.int_value;
+  case cell_double:
+    return c.double_value;
+  case cell_text:
+    return strtod(&m_text[c.text.offset], nullptr);
+  default:
+    return 0.0;
+  }
+}
+
+bool column_set::get_bool(unsigned int row, unsigned int col) const
+{
+  const cell &c = cell_at(row, col);
+  switch (c.type)
+  {
+  case cell_int:
+    return c.int_value != 0;
+  case cell_double:
+    return c.double_value != 0.0;
+  case cell_text:
+    {
+      const char *text = &m_text[c.text.offset];
+      return strcmp(text, "1") == 0 || strcmp(text, "true") == 0 || strcmp(text, "True") == 0;
+    }
+  default:
+    return false;
+  }
+}
+
+const char *column_set::get_text(unsigned int row, unsigned int col) const
+{
+  const cell &c = cell_at(row, col);
+  if (c.type != cell_text)
+    return "";
+  return &m_text[c.text.offset];
+}
+
+size_t column_set::get_text_length(unsigned int row, unsigned int col) const
+{
+  const cell &c = cell_at(row, col);
+  if (c.type != cell_text)
+    return 0;
+  return c.text.length;
+}
+
+std::string column_set::get_string(unsigned int row, unsigned int col) const
+{
+  const cell &c = cell_at(row, col);
+  switch (c.type)
+  {
+  case cell_int:
+    {
+      char t[24];
+      snprintf(t, sizeof(t), "%" PRId64, c.int_value);
+      return t;
+    }
+  case cell_double:
+    {
+      char t[32];
+      snprintf(t, sizeof(t), "%f", c.double_value);
+      return t;
+    }
+  case cell_text:
+    return std::string(&m_text[c.text.offset], c.text.length);
+  default:
+    return std::string();
+  }
+}
+
+} // namespace
@@ -0,0 +1,118 @@
+#pragma once
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace dbiplus {
+
+/*! \brief Typed, columnar query result.
+
+ Unlike result_set, which stores every cell as a heap allocated field_value in a
+ heap allocated row, a column_set keeps one vector of fixed size cells per column
+ and copies all text into a single arena. Filling a column_set with n rows costs
+ O(columns) allocations (amortised) instead of O(n * columns).
+
+ Rows are appended with add_row() followed by exactly one append_*() call per
+ column, in column order. Text returned by get_text() stays valid until the
+ column_set is cleared or destroyed.
+ */
+class column_set
+{
+public:
+  enum cell_type : uint8_t
+  {
+    cell_null,
+    cell_int,
+    cell_double,
+    cell_text
+  };
+
+  column_set() = default;
+  column_set(const column_set&) = delete;
+  column_set& operator=(const column_set&) = delete;
+
+  void clear();
+  void reserve(unsigned int rows, size_t textBytes = 0);
+
+  /* building */
+  void add_column(const char *name);
+  void add_row() { m_rows++; }
+  void append_null(unsigned int col);
+  void append_int(unsigned int col, int64_t value);
+  void append_double(unsigned int col, double value);
+  void append_text(unsigned int col, const char *text, size_t length);
+  void append_text(unsigned int col, const char *text);
+
+  /* metadata */
+  unsigned int num_rows() const { return m_rows; }
+  unsigned int num_columns() const { return m_columns.size(); }
+  const std::string& column_name(unsigned int col) const { return m_columns[col].name; }
+  /* returns the index of the column, -1 if not found. Accepts "table.column" names */
+  int column_index(const char *name) const;
+
+  /* typed access. Values are converted like field_value does when the stored type differs */
+  cell_type type(unsigned int row, unsigned int col) const { return cell_at(row, col).type; }
+  bool is_null(unsigned int row, unsigned int col) const { return cell_at(row, col).type == cell_null; }
+  int64_t get_int64(unsigned int row, unsigned int col) const;
+  int get_int(unsigned int row, unsigned int col) const { return (int)get_int64(row, col); }
+  double get_double(unsigned int row, unsigned int col) const;
+  bool get_bool(unsigned int row, unsigned int col) const;
+  /* returns the text of a text cell without copying, "" for any other cell type */
+  const char *get_text(unsigned int row, unsigned int col) const;
+  size_t get_text_length(unsigned int row, unsigned int col) const;
+  /* returns the cell formatted as a string, including numeric cells */
+  std::string get_string(unsigned int row, unsigned int col) const;
+
+  /* total bytes held in the text arena */
+  size_t text_size() const { return m_text.size(); }
+
+private:
+  struct cell
+  {
+    cell_type type;
+    union
+    {
+      int64_t int_value;
+      double double_value;
+      struct
+      {
+        uint32_t offset;
+        uint32_t length;
+      } text;
+    };
+  };
+
+  struct column
+  {
+    std::string name;
+    std::vector<cell> cells;
+  };
+
+  const cell& cell_at(unsigned int row, unsigned int col) const { return m_columns[col].cells[row]; }
+
+  std::vector<column> m_columns;
+  std::vector<char> m_text;
+  unsigned int m_rows = 0;
+};
+
+} // namespace
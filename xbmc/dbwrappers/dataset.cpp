@@ -202,6 +202,108 @@ void Dataset::parse_sql(std::string &sql) {
 }
 
 
+bool Dataset::query(const std::string &sql, const BindParams &params) {
+  return query(bind_sql(sql, params));
+}
+
+
+int Dataset::exec(const std::string &sql, const BindParams &params) {
+  return exec(bind_sql(sql, params));
+}
+
+
+bool Dataset::query_columns(const std::string &sql, column_set &columns) {
+  columns.clear();
+  if (!query(sql))
+    return false;
+
+  // generic fallback, backends override this to fill the columns directly
+  for (unsigned int i = 0; i < result.record_header.size(); i++)
+    columns.add_column(result.record_header[i].name.c_str());
+  columns.reserve(result.records.size());
+
+  for (unsigned int r = 0; r < result.records.size(); r++)
+  {
+    const sql_record *row = result.records[r];
+    columns.add_row();
+    for (unsigned int i = 0; i < columns.num_columns(); i++)
+    {
+      const field_value &v = row->at(i);
+      if (v.get_isNull())
+        columns.append_null(i);
+      else if (v.get_fType() == ft_String)
+        columns.append_text(i, v.get_asString().c_str());
+      else if (v.get_fType() == ft_Float || v.get_fType() == ft_Double)
+        columns.append_double(i, v.get_asDouble());
+      else
+        columns.append_int(i, v.get_asInt64());
+    }
+  }
+  close();
+  return true;
+}
+
+
+bool Dataset::query_columns(const std::string &sql, const BindParams &params, column_set &columns) {
+  return query_columns(bind_sql(sql, params), columns);
+}
+
+
+std::string Dataset::bind_sql(const std::string &sql, const BindParams &params) {
+  if (db == NULL) throw DbErrors("No Database Connection");
+
+  std::string result;
+  result.reserve(sql.size() + params.size() * 16);
+
+  bool quoted = false;
+  size_t param = 0;
+  for (size_t i = 0; i < sql.size(); i++)
+  {
+    const char c = sql[i];
+    if (c == '\'')
+      quoted = !quoted;
+    if (c != '?' || quoted)
+    {
+      result += c;
+      continue;
+    }
+    if (param >= params.size())
+      throw DbErrors("Too few bind parameters for query: %s", sql.c_str());
+
+    const field_value &v = params[param++];
+    if (v.get_isNull())
+    {
+      result += "NULL";
+      continue;
+    }
+    switch (v.get_fType())
+    {
+    case ft_String:
+      result += db->prepare("'%s'", v.get_asString().c_str());
+      break;
+    case ft_Boolean:
+      result += v.get_asBool() ? "1" : "0";
+      break;
+    case ft_Float:
+    case ft_Double:
+      {
+        char t[32];
+        snprintf(t, sizeof(t), "%.17g", v.get_asDouble());
+        result += t;
+      }
+      break;
+    default:
+      result += v.get_asString();
+      break;
+    }
+  }
+  if (param != params.size())
+    throw DbErrors("Too many bind parameters for query: %s", sql.c_str());
+
+  return result;
+}
+
+
 void Dataset::close(void) {
   haveError  = false;
   frecno = 0;
@@ -34,6 +34,7 @@
 #include <string>
 #include <vector>
 #include "qry_dat.h"
+#include "column_set.h"
 #include <stdarg.h>
 
 namespace dbiplus {
@@ -183,6 +184,7 @@ enum sqlType {sqlSelect,sqlUpdate,sqlInsert,sqlDelete,sqlExec};
 
 typedef std::list<std::string> StringList;
 typedef std::map<std::string,field_value> ParamList;
+typedef std::vector<field_value> BindParams;   // values for '?' placeholders, in order
 
 
 class Dataset  {
@@ -308,6 +310,17 @@ public:
   virtual const void* getExecRes()=0;
 /* as open, but with our query exec Sql */
   virtual bool query(const std::string &sql) = 0;
+/* as query, but with '?' placeholders in sql bound to params */
+  virtual bool query(const std::string &sql, const BindParams &params);
+/* as exec, but with '?' placeholders in sql bound to params */
+  virtual int  exec(const std::string &sql, const BindParams &params);
+/* Expand '?' placeholders in sql into escaped literals.
+   Used by backends without native parameter binding. */
+  std::string bind_sql(const std::string &sql, const BindParams &params);
+/* as query, but fills a typed columnar result instead of the dataset's rows.
+   The dataset itself is left closed. */
+  virtual bool query_columns(const std::string &sql, column_set &columns);
+  virtual bool query_columns(const std::string &sql, const BindParams &params, column_set &columns);
 /* Close SQL Query*/
   virtual void close();
 /* This function looks for field Field_name with value equal Field_value
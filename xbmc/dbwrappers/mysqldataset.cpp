@@ -502,7 +502,8 @@ long MysqlDatabase::nextid(const char* sname) {
 void MysqlDatabase::start_transaction() {
   if (active)
   {
-    mysql_autocommit(conn, false);
+    if (mysql_autocommit(conn, false))
+      throw DbErrors("Can't start transaction: %s", mysql_error(conn));
     CLog::Log(LOGDEBUG,"Mysql Start transaction");
     _in_transaction = true;
   }
@@ -1376,9 +1377,12 @@ MYSQL* MysqlDataset::handle(){
 void MysqlDataset::make_query(StringList &_sql) {
   std::string query;
   if (db == NULL) throw DbErrors("No Database Connection");
+
+  // inside a transaction of the caller the queries become part of it
+  bool ownTransaction = autocommit && !db->in_transaction();
   try
   {
-    if (autocommit) db->start_transaction();
+    if (ownTransaction) db->start_transaction();
 
     for (std::list<std::string>::iterator i =_sql.begin(); i!=_sql.end(); ++i)
     {
@@ -1390,7 +1394,7 @@ void MysqlDataset::make_query(StringList &_sql) {
       }
     } // end of for
 
-    if (db->in_transaction() && autocommit) db->commit_transaction();
+    if (ownTransaction) db->commit_transaction();
 
     active = true;
     ds_state = dsSelect;
@@ -1399,7 +1403,7 @@ void MysqlDataset::make_query(StringList &_sql) {
   } // end of try
   catch(...)
   {
-    if (db->in_transaction()) db->rollback_transaction();
+    if (ownTransaction && db->in_transaction()) db->rollback_transaction();
     throw;
   }
 
@@ -1635,6 +1639,79 @@ bool MysqlDataset::query(const std::string &query) {
   return true;
 }
 
+bool MysqlDataset::query_columns(const std::string &query, column_set &columns) {
+  if(!handle()) throw DbErrors("No Database Connection");
+  std::string qry = query;
+  int fs = qry.find("select");
+  int fS = qry.find("SELECT");
+  if (!( fs >= 0 || fS >=0))
+    throw DbErrors("MUST be select SQL!");
+
+  close();
+  columns.clear();
+
+  size_t loc;
+
+  // mysql doesn't understand CAST(foo as integer) => change to CAST(foo as signed integer)
+  while ((loc = ci_find(qry, "as integer)")) != std::string::npos)
+    qry = qry.insert(loc + 3, "signed ");
+
+  if ( static_cast<MysqlDatabase*>(db)->setErr(static_cast<MysqlDatabase*>(db)->query_with_reconnect(qry.c_str()), qry.c_str()) != MYSQL_OK )
+    throw DbErrors(db->getErrorMsg());
+
+  MYSQL_RES *stmt = mysql_store_result(handle());
+  if (stmt == NULL)
+    throw DbErrors("Missing result set!");
+
+  const unsigned int numColumns = mysql_num_fields(stmt);
+  MYSQL_FIELD *fields = mysql_fetch_fields(stmt);
+  for (unsigned int i = 0; i < numColumns; i++)
+    columns.add_column(fields[i].name);
+  columns.reserve(mysql_num_rows(stmt));
+
+  MYSQL_ROW row;
+  while ((row = mysql_fetch_row(stmt)))
+  {
+    unsigned long *lengths = mysql_fetch_lengths(stmt);
+    columns.add_row();
+    for (unsigned int i = 0; i < numColumns; i++)
+    {
+      // SQL NULL is NULL whatever the column type, like sqlite reports it
+      if (row[i] == NULL)
+      {
+        columns.append_null(i);
+        continue;
+      }
+
+      switch (fields[i].type)
+      {
+        case MYSQL_TYPE_LONGLONG:
+        case MYSQL_TYPE_DECIMAL:
+        case MYSQL_TYPE_NEWDECIMAL:
+        case MYSQL_TYPE_TINY:
+        case MYSQL_TYPE_SHORT:
+        case MYSQL_TYPE_INT24:
+        case MYSQL_TYPE_LONG:
+          columns.append_int(i, strtoll(row[i], NULL, 10));
+          break;
+        case MYSQL_TYPE_FLOAT:
+        case MYSQL_TYPE_DOUBLE:
+          columns.append_double(i, atof(row[i]));
+          break;
+        case MYSQL_TYPE_NULL:
+          columns.append_null(i);
+          break;
+        default:
+          // strings, blobs and dates/times, which sqlite stores as text too
+          columns.append_text(i, row[i], lengths[i]);
+          break;
+      }
+    }
+  }
+  mysql_free_result(stmt);
+  return true;
+}
+
 void MysqlDataset::open(const std::string &sql) {
    set_select_sql(sql);
    open();
@@ -149,6 +149,11 @@ or insert() operations default = false) */
   const void* getExecRes() override;
 /* as open, but with our query exec Sql */
   bool query(const std::string &query) override;
+/* as query, but fill a typed columnar result straight from the mysql rows */
+  bool query_columns(const std::string &query, column_set &columns) override;
+  using Dataset::query_columns;
+  using Dataset::query;
+  using Dataset::exec;
 /* func. closes a query */
   void close(void) override;
 /* Cancel changes, made in insert or edit states of dataset */
@@ -85,9 +85,12 @@ static int busy_callback(void*, int busyCount)
 
 //************* SqliteDatabase implementation ***************
 
+#define DEFAULT_STMT_CACHE_SIZE 64
+
 SqliteDatabase::SqliteDatabase() {
 
   active = false;  
+  stmt_cache_size = DEFAULT_STMT_CACHE_SIZE;
   _in_transaction = false;    // for transaction
 
   error = "Unknown database error";//S_NO_CONNECTION;
@@ -257,6 +260,7 @@ bool SqliteDatabase::exists(void)
 
 void SqliteDatabase::disconnect(void) {
   if (active == false) return;
+  clearStatementCache();
   sqlite3_close(conn);
   active = false;
 }
@@ -392,7 +396,8 @@ long SqliteDatabase::nextid(const char* sname) {
 // ---------------------------------------------
 void SqliteDatabase::start_transaction() {
   if (active) {
-    sqlite3_exec(conn,"begin IMMEDIATE",NULL,NULL,NULL);
+    if (setErr(sqlite3_exec(conn,"begin IMMEDIATE",NULL,NULL,NULL),"begin IMMEDIATE") != SQLITE_OK)
+      throw DbErrors(getErrorMsg());
     _in_transaction = true;
   }
 }
@@ -412,6 +417,71 @@ void SqliteDatabase::rollback_transaction() {
 }
 
 
+// methods for the prepared statement cache
+// ---------------------------------------------
+sqlite3_stmt *SqliteDatabase::acquireStatement(const std::string &sql) {
+  if (!active) throw DbErrors("No Database Connection");
+
+  auto it = stmt_index.find(sql);
+  if (it != stmt_index.end())
+  {
+    sqlite3_stmt *stmt = it->second->second;
+    stmt_lru.erase(it->second);
+    stmt_index.erase(it);
+    return stmt;
+  }
+
+  sqlite3_stmt *stmt = NULL;
+  if (setErr(sqlite3_prepare_v2(conn, sql.c_str(), -1, &stmt, NULL), sql.c_str()) != SQLITE_OK)
+  {
+    sqlite3_finalize(stmt);
+    throw DbErrors(getErrorMsg());
+  }
+  return stmt;
+}
+
+void SqliteDatabase::releaseStatement(const std::string &sql, sqlite3_stmt *stmt) {
+  if (stmt == NULL) return;
+
+  sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+
+  // another user of the same template released first, or caching is disabled
+  if (!active || stmt_cache_size == 0 || stmt_index.find(sql) != stmt_index.end())
+  {
+    sqlite3_finalize(stmt);
+    return;
+  }
+
+  stmt_lru.push_front(std::make_pair(sql, stmt));
+  stmt_index[sql] = stmt_lru.begin();
+
+  while (stmt_lru.size() > stmt_cache_size)
+  {
+    sqlite3_finalize(stmt_lru.back().second);
+    stmt_index.erase(stmt_lru.back().first);
+    stmt_lru.pop_back();
+  }
+}
+
+void SqliteDatabase::clearStatementCache() {
+  for (StatementList::iterator i = stmt_lru.begin(); i != stmt_lru.end(); ++i)
+    sqlite3_finalize(i->second);
+  stmt_lru.clear();
+  stmt_index.clear();
+}
+
+void SqliteDatabase::setStatementCacheSize(unsigned int size) {
+  stmt_cache_size = size;
+  while (stmt_lru.size() > stmt_cache_size)
+  {
+    sqlite3_finalize(stmt_lru.back().second);
+    stmt_index.erase(stmt_lru.back().first);
+    stmt_lru.pop_back();
+  }
+}
+
+
 // methods for formatting
 // ---------------------------------------------
 std::string SqliteDatabase::vprepare(const char *format, va_list args)
@@ -485,9 +555,12 @@ void SqliteDataset::make_query(StringList &_sql) {
   std::string query;
   if (db == NULL) throw DbErrors("No Database Connection");
 
+  // inside a transaction of the caller the queries become part of it
+  bool ownTransaction = autocommit && !db->in_transaction();
+
  try {
 
-  if (autocommit) db->start_transaction();
+  if (ownTransaction) db->start_transaction();
 
 
   for (std::list<std::string>::iterator i =_sql.begin(); i!=_sql.end(); ++i) {
@@ -500,7 +573,7 @@ void SqliteDataset::make_query(StringList &_sql) {
   } // end of for
 
 
-  if (db->in_transaction() && autocommit) db->commit_transaction();
+  if (ownTransaction) db->commit_transaction();
 
   active = true;
   ds_state = dsSelect;    
@@ -509,7 +582,7 @@ void SqliteDataset::make_query(StringList &_sql) {
 
  } // end of try
  catch(...) {
-  if (db->in_transaction()) db->rollback_transaction();
+  if (ownTransaction && db->in_transaction()) db->rollback_transaction();
   throw;
  }
 
@@ -650,6 +723,159 @@ bool SqliteDataset::query(const std::string &query) {
   if (db->setErr(sqlite3_prepare_v2(handle(),query.c_str(),-1,&stmt, NULL),query.c_str()) != SQLITE_OK)
     throw DbErrors(db->getErrorMsg());
 
+  fetch_rows(stmt);
+
+  if (db->setErr(sqlite3_finalize(stmt),query.c_str()) == SQLITE_OK)
+  {
+    active = true;
+    ds_state = dsSelect;
+    this->first();
+    return true;
+  }
+  else
+  {
+    throw DbErrors(db->getErrorMsg());
+  }  
+}
+
+bool SqliteDataset::query(const std::string &query, const BindParams &params) {
+  if(!handle()) throw DbErrors("No Database Connection");
+  if (query.find("select") == std::string::npos && query.find("SELECT") == std::string::npos)
+    throw DbErrors("MUST be select SQL!");
+
+  close();
+
+  SqliteDatabase *sqlitedb = static_cast<SqliteDatabase*>(db);
+  sqlite3_stmt *stmt = sqlitedb->acquireStatement(query);
+  try
+  {
+    bind_params(stmt, params, query);
+    fetch_rows(stmt);
+  }
+  catch (...)
+  {
+    sqlitedb->releaseStatement(query, stmt);
+    throw;
+  }
+
+  // with sqlite3_prepare_v2 the error of a failed step is returned by reset
+  int err = sqlite3_reset(stmt);
+  sqlitedb->releaseStatement(query, stmt);
+  if (db->setErr(err, query.c_str()) != SQLITE_OK)
+    throw DbErrors(db->getErrorMsg());
+
+  active = true;
+  ds_state = dsSelect;
+  this->first();
+  return true;
+}
+
+int SqliteDataset::exec(const std::string &sql, const BindParams &params) {
+  if (!handle()) throw DbErrors("No Database Connection");
+  exec_res.clear();
+
+  SqliteDatabase *sqlitedb = static_cast<SqliteDatabase*>(db);
+  sqlite3_stmt *stmt = sqlitedb->acquireStatement(sql);
+  int err;
+  try
+  {
+    bind_params(stmt, params, sql);
+    while ((err = sqlite3_step(stmt)) == SQLITE_ROW)
+      ;
+  }
+  catch (...)
+  {
+    sqlitedb->releaseStatement(sql, stmt);
+    throw;
+  }
+  sqlitedb->releaseStatement(sql, stmt);
+
+  if (err == SQLITE_DONE)
+    err = SQLITE_OK;
+  if (db->setErr(err, sql.c_str()) != SQLITE_OK)
+    throw DbErrors(db->getErrorMsg());
+  return err;
+}
+
+bool SqliteDataset::query_columns(const std::string &query, column_set &columns) {
+  if(!handle()) throw DbErrors("No Database Connection");
+
+  close();
+  columns.clear();
+
+  sqlite3_stmt *stmt = NULL;
+  if (db->setErr(sqlite3_prepare_v2(handle(),query.c_str(),-1,&stmt, NULL),query.c_str()) != SQLITE_OK)
+    throw DbErrors(db->getErrorMsg());
+
+  fetch_columns(stmt, columns);
+
+  if (db->setErr(sqlite3_finalize(stmt),query.c_str()) != SQLITE_OK)
+    throw DbErrors(db->getErrorMsg());
+  return true;
+}
+
+bool SqliteDataset::query_columns(const std::string &query, const BindParams &params, column_set &columns) {
+  if(!handle()) throw DbErrors("No Database Connection");
+
+  close();
+  columns.clear();
+
+  SqliteDatabase *sqlitedb = static_cast<SqliteDatabase*>(db);
+  sqlite3_stmt *stmt = sqlitedb->acquireStatement(query);
+  try
+  {
+    bind_params(stmt, params, query);
+    fetch_columns(stmt, columns);
+  }
+  catch (...)
+  {
+    sqlitedb->releaseStatement(query, stmt);
+    throw;
+  }
+
+  int err = sqlite3_reset(stmt);
+  sqlitedb->releaseStatement(query, stmt);
+  if (db->setErr(err, query.c_str()) != SQLITE_OK)
+    throw DbErrors(db->getErrorMsg());
+  return true;
+}
+
+void SqliteDataset::bind_params(sqlite3_stmt *stmt, const BindParams &params, const std::string &sql) {
+  if (sqlite3_bind_parameter_count(stmt) != (int)params.size())
+    throw DbErrors("Wrong number of bind parameters (%u) for query: %s", (unsigned int)params.size(), sql.c_str());
+
+  for (unsigned int i = 0; i < params.size(); i++)
+  {
+    const field_value &v = params[i];
+    int err;
+    if (v.get_isNull())
+      err = sqlite3_bind_null(stmt, i + 1);
+    else
+    {
+      switch (v.get_fType())
+      {
+      case ft_String:
+        {
+          const std::string &str = v.get_asString();
+          err = sqlite3_bind_text(stmt, i + 1, str.c_str(), str.size(), SQLITE_TRANSIENT);
+        }
+        break;
+      case ft_Float:
+      case ft_Double:
+      case ft_LongDouble:
+        err = sqlite3_bind_double(stmt, i + 1, v.get_asDouble());
+        break;
+      default:
+        err = sqlite3_bind_int64(stmt, i + 1, v.get_asInt64());
+        break;
+      }
+    }
+    if (db->setErr(err, sql.c_str()) != SQLITE_OK)
+      throw DbErrors(db->getErrorMsg());
+  }
+}
+
+void SqliteDataset::fetch_rows(sqlite3_stmt *stmt) {
   // column headers
   const unsigned int numColumns = sqlite3_column_count(stmt);
   result.record_header.resize(numColumns);
@@ -687,17 +913,40 @@ bool SqliteDataset::query(const std::string &query) {
     }
     result.records.push_back(res);
   }
-  if (db->setErr(sqlite3_finalize(stmt),query.c_str()) == SQLITE_OK)
+}
+
+void SqliteDataset::fetch_columns(sqlite3_stmt *stmt, column_set &columns) {
+  const unsigned int numColumns = sqlite3_column_count(stmt);
+  for (unsigned int i = 0; i < numColumns; i++)
+    columns.add_column(sqlite3_column_name(stmt, i));
+
+  while (sqlite3_step(stmt) == SQLITE_ROW)
   {
-    active = true;
-    ds_state = dsSelect;
-    this->first();
-    return true;
+    columns.add_row();
+    for (unsigned int i = 0; i < numColumns; i++)
+    {
+      switch (sqlite3_column_type(stmt, i))
+      {
+      case SQLITE_INTEGER:
+        columns.append_int(i, sqlite3_column_int64(stmt, i));
+        break;
+      case SQLITE_FLOAT:
+        columns.append_double(i, sqlite3_column_double(stmt, i));
+        break;
+      case SQLITE_TEXT:
+      case SQLITE_BLOB:
+        {
+          const char *text = (const char *)sqlite3_column_text(stmt, i);
+          columns.append_text(i, text, sqlite3_column_bytes(stmt, i));
+        }
+        break;
+      case SQLITE_NULL:
+      default:
+        columns.append_null(i);
+        break;
+      }
+    }
   }
-  else
-  {
-    throw DbErrors(db->getErrorMsg());
-  }  
 }
 
 void SqliteDataset::open(const std::string &sql) {
@@ -29,6 +29,8 @@
  **********************************************************************/
 
 #include <stdio.h>
+#include <list>
+#include <unordered_map>
 #include "dataset.h"
 #include <sqlite3.h>
 
@@ -96,6 +98,33 @@ public:
 
   bool in_transaction() override {return _in_transaction;}; 	
 
+/* prepared statement cache for parameterised queries */
+
+  /*! \brief Get a prepared statement for the given SQL template.
+   The statement is taken out of the cache (or freshly prepared) and must be handed
+   back via releaseStatement() once it has been stepped, so that nested use of the
+   same template on this connection gets its own statement.
+   \param sql - SQL text, optionally with '?' placeholders.
+   \return the prepared statement; throws DbErrors on failure.
+   */
+  sqlite3_stmt *acquireStatement(const std::string &sql);
+
+  /*! \brief Return a statement obtained by acquireStatement() to the cache.
+   The statement is reset and its bindings cleared. The least recently used
+   statement is finalized once the cache exceeds its capacity.
+   */
+  void releaseStatement(const std::string &sql, sqlite3_stmt *stmt);
+
+  /*! \brief Finalize all cached statements. */
+  void clearStatementCache();
+
+  void setStatementCacheSize(unsigned int size);
+
+private:
+  typedef std::list<std::pair<std::string, sqlite3_stmt*> > StatementList;
+  StatementList stmt_lru;       // most recently used first
+  std::unordered_map<std::string, StatementList::iterator> stmt_index;
+  unsigned int stmt_cache_size;
 };
 
 
@@ -121,6 +150,13 @@ protected:
 
   //static int sqlite_callback(void* res_ptr,int ncol, char** result, char** cols);
 
+/* Bind params to the '?' placeholders of stmt */
+  void bind_params(sqlite3_stmt *stmt, const BindParams &params, const std::string &sql);
+/* Step through stmt and fill the result set */
+  void fetch_rows(sqlite3_stmt *stmt);
+/* Step through stmt and fill columns */
+  void fetch_columns(sqlite3_stmt *stmt, column_set &columns);
+
 /* This function works only with MySQL database
   Filling the fields information from select statement */
   void fill_fields() override;
@@ -148,6 +184,11 @@ or insert() operations default = false) */
   const void* getExecRes() override;
 /* as open, but with our query exec Sql */
   bool query(const std::string &query) override;
+/* parameterised versions using the connection's prepared statement cache */
+  bool query(const std::string &query, const BindParams &params) override;
+  int  exec(const std::string &sql, const BindParams &params) override;
+  bool query_columns(const std::string &query, column_set &columns) override;
+  bool query_columns(const std::string &query, const BindParams &params, column_set &columns) override;
 /* func. closes a query */
   void close(void) override;
 /* Cancel changes, made in insert or edit states of dataset */
@@ -0,0 +1,81 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TestColumnSet.h"
+#include "test/AllocationCounter.h"
+#include "utils/Stopwatch.h"
+
+using namespace dbiplus;
+
+#define BENCHMARK_ROWS 20000
+
+class BenchmarkColumnSet : public TestColumnSet
+{
+};
+
+TEST_F(BenchmarkColumnSet, Query)
+{
+  AddSongs(BENCHMARK_ROWS);
+  const std::string sql = "SELECT * FROM song";
+
+  CStopWatch watch;
+  int64_t checksumRows = 0;
+  uint64_t allocationsRows;
+  {
+    CAllocationCounter counter;
+    watch.StartZero();
+    m_ds->query(sql);
+    while (!m_ds->eof())
+    {
+      checksumRows += m_ds->fv(0).get_asInt() + m_ds->fv(2).get_asInt() + m_ds->fv(3).get_asInt();
+      checksumRows += m_ds->fv(1).get_asString().size() + m_ds->fv(5).get_asString().size();
+      m_ds->next();
+    }
+    m_ds->close();
+    watch.Stop();
+    allocationsRows = counter.GetCount();
+  }
+  float timeRows = watch.GetElapsedMilliseconds();
+
+  int64_t checksumColumns = 0;
+  uint64_t allocationsColumns;
+  {
+    CAllocationCounter counter;
+    watch.StartZero();
+    column_set columns;
+    m_ds->query_columns(sql, columns);
+    for (unsigned int row = 0; row < columns.num_rows(); row++)
+    {
+      checksumColumns += columns.get_int(row, 0) + columns.get_int(row, 2) + columns.get_int(row, 3);
+      checksumColumns += columns.get_text_length(row, 1) + columns.get_text_length(row, 5);
+    }
+    watch.Stop();
+    allocationsColumns = counter.GetCount();
+  }
+  float timeColumns = watch.GetElapsedMilliseconds();
+
+  EXPECT_EQ(checksumRows, checksumColumns);
+  EXPECT_LT(allocationsColumns, allocationsRows);
+
+  RecordProperty("result_set_allocations", static_cast<int>(allocationsRows));
+  RecordProperty("result_set_us", static_cast<int>(timeRows * 1000));
+  RecordProperty("column_set_allocations", static_cast<int>(allocationsColumns));
+  RecordProperty("column_set_us", static_cast<int>(timeColumns * 1000));
+}
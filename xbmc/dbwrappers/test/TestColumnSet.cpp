@@ -0,0 +1,73 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TestColumnSet.h"
+
+using namespace dbiplus;
+
+TEST_F(TestColumnSet, TypedAccess)
+{
+  AddSongs(3);
+
+  column_set columns;
+  ASSERT_TRUE(m_ds->query_columns("SELECT * FROM song ORDER BY idSong", columns));
+  ASSERT_EQ(3u, columns.num_rows());
+  ASSERT_EQ(6u, columns.num_columns());
+  EXPECT_EQ(1, columns.column_index("strTitle"));
+  EXPECT_EQ(2, columns.column_index("song.iTrack"));
+  EXPECT_EQ(-1, columns.column_index("missing"));
+
+  EXPECT_EQ(column_set::cell_int, columns.type(1, 0));
+  EXPECT_EQ(2, columns.get_int(1, 0));
+  EXPECT_STREQ("Song title 1", columns.get_text(1, 1));
+  EXPECT_EQ(12u, columns.get_text_length(1, 1));
+  EXPECT_EQ(2, columns.get_int(1, 2));
+  EXPECT_EQ("181", columns.get_string(1, 3));
+  EXPECT_DOUBLE_EQ(0.5, columns.get_double(1, 4));
+
+  EXPECT_TRUE(columns.is_null(0, 5));
+  EXPECT_STREQ("", columns.get_text(0, 5));
+  EXPECT_FALSE(columns.is_null(1, 5));
+}
+
+TEST_F(TestColumnSet, TextConversion)
+{
+  column_set columns;
+  columns.add_column("a");
+  columns.add_row();
+  columns.append_text(0, "42");
+  columns.add_row();
+  columns.append_text(0, "true");
+
+  EXPECT_EQ(42, columns.get_int(0, 0));
+  EXPECT_DOUBLE_EQ(42.0, columns.get_double(0, 0));
+  EXPECT_TRUE(columns.get_bool(1, 0));
+  EXPECT_EQ(0, columns.get_int(1, 0));
+}
+
+TEST_F(TestColumnSet, BoundQuery)
+{
+  AddSongs(50);
+
+  column_set columns;
+  ASSERT_TRUE(m_ds->query_columns("SELECT strTitle FROM song WHERE iTrack = ?", { field_value(5) }, columns));
+  EXPECT_EQ(3u, columns.num_rows());
+  EXPECT_STREQ("Song title 4", columns.get_text(0, 0));
+}
@@ -0,0 +1,76 @@
+#pragma once
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "dbwrappers/sqlitedataset.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/StringUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <memory>
+
+/*!
+ A song table in a scratch sqlite database under special://temp
+ */
+class TestColumnSet : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_db.setHostName(CSpecialProtocol::TranslatePath("special://temp/").c_str());
+    m_db.setDatabase("columnsettest");
+    ASSERT_EQ(DB_CONNECTION_OK, m_db.connect(true));
+    m_ds.reset(m_db.CreateDataset());
+
+    m_ds->exec("DROP TABLE IF EXISTS song");
+    m_ds->exec("CREATE TABLE song (idSong INTEGER PRIMARY KEY, strTitle TEXT, iTrack INTEGER, "
+               "iDuration INTEGER, rating FLOAT, comment TEXT)");
+  }
+
+  void TearDown() override
+  {
+    m_ds.reset();
+    m_db.disconnect();
+    XFILE::CFile::Delete("special://temp/columnsettest.db");
+  }
+
+  void AddSongs(int count)
+  {
+    m_db.start_transaction();
+    for (int i = 0; i < count; i++)
+    {
+      dbiplus::field_value comment("");
+      if (i % 3 == 0)
+        comment.set_isNull();
+      else
+        comment = StringUtils::Format("comment for a song that is longer than the small string buffer %i", i);
+
+      m_ds->exec("INSERT INTO song (idSong, strTitle, iTrack, iDuration, rating, comment) VALUES (NULL, ?, ?, ?, ?, ?)",
+                 { dbiplus::field_value(StringUtils::Format("Song title %i", i)), dbiplus::field_value(i % 20 + 1),
+                   dbiplus::field_value(180 + i % 300), dbiplus::field_value(i % 10 / 2.0), comment });
+    }
+    m_db.commit_transaction();
+  }
+
+  dbiplus::SqliteDatabase m_db;
+  std::unique_ptr<dbiplus::Dataset> m_ds;
+};
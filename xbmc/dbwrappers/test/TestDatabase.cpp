@@ -0,0 +1,125 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "dbwrappers/Database.h"
+#include "dbwrappers/dataset.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "settings/AdvancedSettings.h"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+class CItemDatabase : public CDatabase
+{
+public:
+  bool Connect()
+  {
+    DatabaseSettings settings;
+    settings.type = "sqlite3";
+    settings.host = CSpecialProtocol::TranslatePath("special://temp/");
+    return CDatabase::Connect(GetBaseDBName(), settings, true);
+  }
+
+  void AddItem(int id)
+  {
+    m_pDS->exec(PrepareSQL("INSERT INTO item (idItem) VALUES (%i)", id));
+  }
+
+  int CountItems()
+  {
+    m_pDS->query("SELECT COUNT(*) FROM item");
+    int count = m_pDS->fv(0).get_asInt();
+    m_pDS->close();
+    return count;
+  }
+
+protected:
+  void CreateTables() override
+  {
+    m_pDS->exec("CREATE TABLE item (idItem INTEGER PRIMARY KEY)");
+  }
+  void CreateAnalytics() override {}
+  int GetSchemaVersion() const override { return 1; }
+  const char *GetBaseDBName() const override { return "transactiontest"; }
+};
+}
+
+class TestDatabase : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    ASSERT_TRUE(m_db.Connect());
+  }
+
+  void TearDown() override
+  {
+    m_db.Close();
+    XFILE::CFile::Delete("special://temp/transactiontest.db");
+  }
+
+  CItemDatabase m_db;
+};
+
+TEST_F(TestDatabase, NestedCommit)
+{
+  m_db.BeginTransaction();
+  m_db.AddItem(1);
+  m_db.BeginTransaction();
+  m_db.AddItem(2);
+  EXPECT_TRUE(m_db.CommitTransaction());
+  EXPECT_TRUE(m_db.InTransaction());
+  EXPECT_TRUE(m_db.CommitTransaction());
+  EXPECT_FALSE(m_db.InTransaction());
+  EXPECT_EQ(2, m_db.CountItems());
+}
+
+TEST_F(TestDatabase, NestedRollback)
+{
+  // rolling back a nested transaction keeps what the outer one did before and after it
+  m_db.BeginTransaction();
+  m_db.AddItem(1);
+  m_db.BeginTransaction();
+  m_db.AddItem(2);
+  m_db.BeginTransaction();
+  m_db.AddItem(3);
+  EXPECT_TRUE(m_db.CommitTransaction());
+  m_db.RollbackTransaction();
+  EXPECT_TRUE(m_db.InTransaction());
+  m_db.AddItem(4);
+  EXPECT_TRUE(m_db.CommitTransaction());
+  EXPECT_FALSE(m_db.InTransaction());
+  EXPECT_EQ(2, m_db.CountItems());
+}
+
+TEST_F(TestDatabase, OuterRollback)
+{
+  m_db.BeginTransaction();
+  m_db.AddItem(1);
+  m_db.BeginTransaction();
+  m_db.AddItem(2);
+  EXPECT_TRUE(m_db.CommitTransaction());
+  m_db.RollbackTransaction();
+  EXPECT_FALSE(m_db.InTransaction());
+  EXPECT_EQ(0, m_db.CountItems());
+}
@@ -63,6 +63,26 @@ void CCacheStrategy::ClearEndOfInput()
   m_bEndOfInput = false;
 }
 
+size_t CCacheStrategy::GetWriteSpan(char *&pData, size_t iRequestSize)
+{
+  pData = NULL;
+  return GetMaxWriteSize(iRequestSize);
+}
+
+void CCacheStrategy::CommitWrite(size_t iSize)
+{
+}
+
+bool CCacheStrategy::IsStoredPosition(int64_t iFilePosition)
+{
+  return false;
+}
+
+int CCacheStrategy::ReadFromStore(int64_t iFilePosition, char *pBuffer, size_t iMaxSize)
+{
+  return 0;
+}
+
 CSimpleFileCache::CSimpleFileCache()
   : m_cacheFileRead(new CacheLocalFile())
   , m_cacheFileWrite(new CacheLocalFile())
@@ -328,6 +348,16 @@ int64_t CDoubleCache::WaitForData(unsigned int iMinAvail, unsigned int iMillis)
   return m_pCache->WaitForData(iMinAvail, iMillis);
 }
 
+size_t CDoubleCache::GetWriteSpan(char *&pData, size_t iRequestSize)
+{
+  return m_pCache->GetWriteSpan(pData, iRequestSize);
+}
+
+void CDoubleCache::CommitWrite(size_t iSize)
+{
+  m_pCache->CommitWrite(iSize);
+}
+
 int64_t CDoubleCache::Seek(int64_t iFilePosition)
 {
   /* Check whether position is NOT in our current cache but IS in our old cache.
@@ -48,6 +48,34 @@ public:
   virtual int ReadFromCache(char *pBuffer, size_t iMaxSize) = 0;
   virtual int64_t WaitForData(unsigned int iMinAvail, unsigned int iMillis) = 0;
 
+  /*!
+   \brief Get free space in the cache the writer can fill directly, e.g. by reading from the source
+   \param pData set to the start of the space, NULL if the strategy needs data passed to WriteToCache()
+   \param iRequestSize maximum size wanted by the caller
+   \return number of bytes that may be written, to be followed by CommitWrite()
+   History the span would overwrite stays readable until CommitWrite(), the source must only
+   write the bytes it reports as read.
+   */
+  virtual size_t GetWriteSpan(char *&pData, size_t iRequestSize);
+
+  /*!
+   \brief Make iSize bytes written to the span from GetWriteSpan() available to the reader
+   Must be called after every GetWriteSpan(), with 0 if nothing was written.
+   */
+  virtual void CommitWrite(size_t iSize);
+
+  /*!
+   \brief Whether data at the source position is kept by the strategy beyond the cache, e.g. on disk
+   */
+  virtual bool IsStoredPosition(int64_t iFilePosition);
+
+  /*!
+   \brief Read data the strategy kept from an earlier read of the source instead of reading the source again
+   \param iFilePosition source position to read from
+   \return number of bytes read, 0 if the position isn't stored
+   */
+  virtual int ReadFromStore(int64_t iFilePosition, char *pBuffer, size_t iMaxSize);
+
   virtual int64_t Seek(int64_t iFilePosition) = 0;
 
   /*!
@@ -124,6 +152,9 @@ public:
   int ReadFromCache(char *pBuffer, size_t iMaxSize) override;
   int64_t WaitForData(unsigned int iMinAvail, unsigned int iMillis) override;
 
+  size_t GetWriteSpan(char *&pData, size_t iRequestSize) override;
+  void CommitWrite(size_t iSize) override;
+
   int64_t Seek(int64_t iFilePosition) override;
   bool Reset(int64_t iSourcePosition, bool clearAnyway=true) override;
   void EndOfInput() override;
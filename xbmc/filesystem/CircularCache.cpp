@@ -23,6 +23,19 @@
 #include "system.h"
 #include "threads/SingleLock.h"
 #include "CircularCache.h"
+#ifdef TARGET_POSIX
+#include "SpecialProtocol.h"
+#include "utils/log.h"
+#include <sys/mman.h>
+#include <stdlib.h>
+#include <unistd.h>
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+// caches at least this large are backed by a temporary file instead of anonymous memory
+#define FILE_BACKED_CACHE_SIZE (512 * 1024 * 1024)
+#endif
 
 using namespace XFILE;
 
@@ -31,11 +44,14 @@ CCircularCache::CCircularCache(size_t front, size_t back)
  , m_beg(0)
  , m_end(0)
  , m_cur(0)
+ , m_reserved(0)
  , m_buf(NULL)
  , m_size(front + back)
  , m_size_back(back)
 #ifdef TARGET_WINDOWS
  , m_handle(INVALID_HANDLE_VALUE)
+#else
+ , m_fd(-1)
 #endif
 {
 }
@@ -53,13 +69,35 @@ int CCircularCache::Open()
     return CACHE_RC_ERROR;
   m_buf = (uint8_t*)MapViewOfFile(m_handle, FILE_MAP_ALL_ACCESS, 0, 0, 0);
 #else
-  m_buf = new uint8_t[m_size];
+  void *buf = MAP_FAILED;
+  if (m_size >= FILE_BACKED_CACHE_SIZE)
+  {
+    // let the kernel page huge caches out to disk instead of pushing other memory to swap
+    std::string path = CSpecialProtocol::TranslatePath("special://temp/filecache-XXXXXX");
+    m_fd = mkstemp(&path[0]);
+    if (m_fd >= 0)
+    {
+      unlink(path.c_str());
+      if (ftruncate(m_fd, m_size) == 0)
+        buf = mmap(NULL, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+      if (buf == MAP_FAILED)
+      {
+        CLog::Log(LOGWARNING, "CCircularCache::Open - failed to map cache file, using memory");
+        close(m_fd);
+        m_fd = -1;
+      }
+    }
+  }
+  if (buf == MAP_FAILED)
+    buf = mmap(NULL, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  m_buf = buf == MAP_FAILED ? NULL : (uint8_t*)buf;
 #endif
   if(m_buf == 0)
     return CACHE_RC_ERROR;
   m_beg = 0;
   m_end = 0;
   m_cur = 0;
+  m_reserved = 0;
   return CACHE_RC_OK;
 }
 
@@ -70,17 +108,21 @@ void CCircularCache::Close()
   CloseHandle(m_handle);
   m_handle = INVALID_HANDLE_VALUE;
 #else
-  delete[] m_buf;
+  if (m_buf)
+    munmap(m_buf, m_size);
+  if (m_fd >= 0)
+    close(m_fd);
+  m_fd = -1;
 #endif
   m_buf = NULL;
 }
 
 size_t CCircularCache::GetMaxWriteSize(const size_t& iRequestSize)
 {
-  CSingleLock lock(m_sync);
-
-  size_t back  = (size_t)(m_cur - m_beg); // Backbuffer size
-  size_t front = (size_t)(m_end - m_cur); // Frontbuffer size
+  // the reader only moves m_cur forward outside of m_sync, which can only make this estimate smaller
+  int64_t cur = m_cur;
+  size_t back  = (size_t)(cur - m_beg); // Backbuffer size
+  size_t front = (size_t)(m_end - cur); // Frontbuffer size
   size_t limit = m_size - std::min(back, m_size_back) - front;
 
   // Never return more than limit and size requested by caller
@@ -88,8 +130,8 @@ size_t CCircularCache::GetMaxWriteSize(const size_t& iRequestSize)
 }
 
 /**
- * Function will write to m_buf at m_end % m_size location
- * it will write at maximum m_size, but it will only write
+ * Reserves space in m_buf at m_end % m_size location
+ * it will reserve at maximum m_size, but it will only reserve
  * as much it can without wrapping around in the buffer
  *
  * It will always leave m_size_back of the backbuffer intact
@@ -104,16 +146,21 @@ size_t CCircularCache::GetMaxWriteSize(const size_t& iRequestSize)
  *  * m_end <= m_cur <= m_end
  *  * m_end - m_beg <= m_size
  *
+ * History the span overlaps is only dropped by CommitWrite, for
+ * what was actually written. Until then seeks treat the whole
+ * span as gone, see GetBegin. The span always lies behind m_cur,
+ * so the reader never reads from it.
  * Multiple calls may be needed to fill buffer completely.
  */
-int CCircularCache::WriteToCache(const char *buf, size_t len)
+size_t CCircularCache::GetWriteSpan(char *&data, size_t len)
 {
   CSingleLock lock(m_sync);
 
   // where are we in the buffer
-  size_t pos   = m_end % m_size;
+  int64_t end  = m_end;
+  size_t pos   = end % m_size;
   size_t back  = (size_t)(m_cur - m_beg);
-  size_t front = (size_t)(m_end - m_cur);
+  size_t front = (size_t)(end - m_cur);
 
   size_t limit = m_size - std::min(back, m_size_back) - front;
   size_t wrap  = m_size - pos;
@@ -126,33 +173,56 @@ int CCircularCache::WriteToCache(const char *buf, size_t len)
   if(len > wrap)
     len = wrap;
 
-  if(len == 0)
-    return 0;
+  m_reserved = end + len;
 
-  // write the data
-  memcpy(m_buf + pos, buf, len);
-  m_end += len;
+  data = (char*)m_buf + pos;
+  return len;
+}
+
+void CCircularCache::CommitWrite(size_t len)
+{
+  CSingleLock lock(m_sync);
+  m_reserved = m_end.load();
+  if(len == 0)
+    return;
 
-  // drop history that was overwritten
-  if(m_end - m_beg > (int64_t)m_size)
-    m_beg = m_end - m_size;
+  // drop the history that was overwritten
+  int64_t end = m_end + len;
+  if(end - m_beg > (int64_t)m_size)
+    m_beg = end - m_size;
 
+  m_end = end;
   m_written.Set();
+}
+
+int64_t CCircularCache::GetBegin() const
+{
+  return std::max(m_beg.load(), m_reserved - (int64_t)m_size);
+}
+
+int CCircularCache::WriteToCache(const char *buf, size_t len)
+{
+  char *data;
+  len = GetWriteSpan(data, len);
+  if(len == 0)
+    return 0;
+
+  // write the data
+  memcpy(data, buf, len);
+  CommitWrite(len);
 
   return len;
 }
 
 /**
- * Reads data from cache. Will only read up till
- * the buffer wrap point. So multiple calls
- * may be needed to empty the whole cache
+ * Reads data from cache. Will only read up till the buffer wrap point.
+ * So multiple calls may be needed to empty the whole cache
  */
 int CCircularCache::ReadFromCache(char *buf, size_t len)
 {
-  CSingleLock lock(m_sync);
-
-  size_t pos   = m_cur % m_size;
-  size_t front = (size_t)(m_end - m_cur);
+  int64_t cur  = m_cur;
+  size_t pos   = cur % m_size;
+  size_t front = (size_t)(m_end - cur);
   size_t avail = std::min(m_size - pos, front);
 
   if(avail == 0)
@@ -171,7 +241,6 @@ int CCircularCache::ReadFromCache(char *buf, size_t len)
 
   memcpy(buf, m_buf + pos, len);
   m_cur += len;
-
   m_space.Set();
 
   return len;
@@ -183,7 +252,6 @@ int CCircularCache::ReadFromCache(char *buf, size_t len)
  */
 int64_t CCircularCache::WaitForData(unsigned int minimum, unsigned int millis)
 {
-  CSingleLock lock(m_sync);
   int64_t avail = m_end - m_cur;
 
   if(millis == 0 || IsEndOfInput())
@@ -195,9 +263,7 @@ int64_t CCircularCache::WaitForData(unsigned int minimum, unsigned int millis)
   XbmcThreads::EndTime endtime(millis);
   while (!IsEndOfInput() && avail < minimum && !endtime.IsTimePast() )
   {
-    lock.Leave();
     m_written.WaitMSec(50); // may miss the deadline. shouldn't be a problem.
-    lock.Enter();
     avail = m_end - m_cur;
   }
 
@@ -216,13 +282,13 @@ int64_t CCircularCache::Seek(int64_t pos)
      * there's sufficient forward space. Increasing it with only 100000 may not be
      * sufficient due to variable filesystem chunksize
      */
-    m_cur = m_end;
+    m_cur = m_end.load();
     lock.Leave();
     WaitForData((size_t)(pos - m_cur), 5000);
     lock.Enter();
   }
 
-  if(pos >= m_beg && pos <= m_end)
+  if(pos >= GetBegin() && pos <= m_end)
   {
     m_cur = pos;
     return pos;
@@ -242,6 +308,7 @@ bool CCircularCache::Reset(int64_t pos, bool clearAnyway)
   m_end = pos;
   m_beg = pos;
   m_cur = pos;
+  m_reserved = pos;
 
   return true;
 }
@@ -260,7 +327,7 @@ int64_t CCircularCache::CachedDataEndPos()
 
 bool CCircularCache::IsCachedPosition(int64_t iFilePosition)
 {
-  return iFilePosition >= m_beg && iFilePosition <= m_end;
+  return iFilePosition >= GetBegin() && iFilePosition <= m_end;
 }
 
 CCacheStrategy *CCircularCache::CreateNew()
@@ -25,6 +25,8 @@
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
 
+#include <atomic>
+
 namespace XFILE {
 
 class CCircularCache : public CCacheStrategy
@@ -41,6 +43,9 @@ public:
     int ReadFromCache(char *buf, size_t len) override;
     int64_t WaitForData(unsigned int minimum, unsigned int iMillis) override;
 
+    size_t GetWriteSpan(char *&data, size_t len) override;
+    void CommitWrite(size_t len) override;
+
     int64_t Seek(int64_t pos) override;
     bool Reset(int64_t pos, bool clearAnyway=true) override;
 
@@ -50,9 +55,16 @@ public:
 
     CCacheStrategy *CreateNew() override;
 protected:
-    int64_t           m_beg;       /**< index in file (not buffer) of beginning of valid data */
-    int64_t           m_end;       /**< index in file (not buffer) of end of valid data */
-    int64_t           m_cur;       /**< current reading index in file */
+    int64_t GetBegin() const;
+
+    /* One writer (the cache thread) and one reader. Positions are only ever
+     * advanced by their owner, so reading and writing data doesn't need m_sync.
+     * m_sync serialises the writer reserving and committing space with seeks
+     * of the reader. */
+    std::atomic<int64_t> m_beg;       /**< index in file (not buffer) of beginning of valid data */
+    std::atomic<int64_t> m_end;       /**< index in file (not buffer) of end of valid data */
+    std::atomic<int64_t> m_cur;       /**< current reading index in file */
+    std::atomic<int64_t> m_reserved; /**< end of the span handed out by GetWriteSpan, m_end if none */
     uint8_t          *m_buf;       /**< buffer holding data */
     size_t            m_size;      /**< size of data buffer used (m_buf) */
     size_t            m_size_back; /**< guaranteed size of back buffer (actual size can be smaller, or larger if front buffer doesn't need it) */
@@ -60,6 +72,8 @@ protected:
     CEvent            m_written;
 #ifdef TARGET_WINDOWS
     HANDLE            m_handle;
+#else
+    int               m_fd;        /**< backing file of large caches, -1 for anonymous memory */
 #endif
 };
 
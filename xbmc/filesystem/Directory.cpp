@@ -271,7 +271,13 @@ bool CDirectory::Create(const CURL& url)
     std::unique_ptr<IDirectory> pDirectory(CDirectoryFactory::Create(realURL));
     if (pDirectory.get())
       if(pDirectory->Create(realURL))
+      {
+        // drop the listing of the parent and any cached miss of the folder
+        std::string realPath(realURL.Get());
+        URIUtils::RemoveSlashAtEnd(realPath);
+        g_directoryCache.ClearFile(realPath);
         return true;
+      }
   }
   XBMCCOMMONS_HANDLE_UNCHECKED
   catch (...)
@@ -305,7 +311,17 @@ bool CDirectory::Exists(const CURL& url, bool bUseCache /* = true */)
     }
     std::unique_ptr<IDirectory> pDirectory(CDirectoryFactory::Create(realURL));
     if (pDirectory.get())
-      return pDirectory->Exists(realURL);
+    {
+      if (pDirectory->Exists(realURL))
+        return true;
+      if (bUseCache)
+      {
+        std::string realPath(realURL.Get());
+        URIUtils::AddSlashAtEnd(realPath);
+        g_directoryCache.SetMissing(realPath);
+      }
+      return false;
+    }
   }
   XBMCCOMMONS_HANDLE_UNCHECKED
   catch (...)
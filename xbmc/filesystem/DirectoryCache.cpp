@@ -24,14 +24,21 @@
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 #include "utils/StringUtils.h"
+#include "utils/Variant.h"
 #include "URL.h"
 #include "climits"
 
 #include <algorithm>
+#include <cstring>
+#include <sys/stat.h>
 
 // Maximum number of directories to keep in our cache
 #define MAX_CACHED_DIRS 50
 
+// Maximum number of paths known not to exist, and how long they're remembered
+#define MAX_MISSING_PATHS 1000
+#define MISSING_PATH_TIMEOUT 10000
+
 using namespace XFILE;
 
 CDirectoryCache::CDir::CDir(DIR_CACHE_TYPE cacheType)
@@ -128,6 +135,9 @@ void CDirectoryCache::ClearFile(const std::string& strFile)
   std::string strFile2 = CURL(strFile).GetWithoutOptions();
 
   ClearDirectory(URIUtils::GetDirectory(strFile2));
+
+  CSingleLock lock (m_cs);
+  ClearMissing(strFile2, false);
 }
 
 void CDirectoryCache::ClearDirectory(const std::string& strPath)
@@ -141,6 +151,8 @@ void CDirectoryCache::ClearDirectory(const std::string& strPath)
   iCache i = m_cache.find(storedPath);
   if (i != m_cache.end())
     Delete(i);
+
+  ClearMissing(storedPath, true);
 }
 
 void CDirectoryCache::ClearSubPaths(const std::string& strPath)
@@ -158,6 +170,8 @@ void CDirectoryCache::ClearSubPaths(const std::string& strPath)
     else
       i++;
   }
+
+  ClearMissing(storedPath, true);
 }
 
 void CDirectoryCache::AddFile(const std::string& strFile)
@@ -165,7 +179,10 @@ void CDirectoryCache::AddFile(const std::string& strFile)
   CSingleLock lock (m_cs);
 
   // Get rid of any URL options, else the compare may be wrong
-  std::string strPath = URIUtils::GetDirectory(CURL(strFile).GetWithoutOptions());
+  std::string strFile2 = CURL(strFile).GetWithoutOptions();
+  ClearMissing(strFile2, false);
+
+  std::string strPath = URIUtils::GetDirectory(strFile2);
   URIUtils::RemoveSlashAtEnd(strPath);
 
   ciCache i = m_cache.find(strPath);
@@ -185,6 +202,14 @@ bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
 
   // Get rid of any URL options, else the compare may be wrong
   std::string strPath = CURL(strFile).GetWithoutOptions();
+  if (IsMissing(strPath))
+  {
+    bInCache = true;
+#ifdef _DEBUG
+    m_cacheHits++;
+#endif
+    return false;
+  }
   URIUtils::RemoveSlashAtEnd(strPath);
   std::string storedPath = URIUtils::GetDirectory(strPath);
   URIUtils::RemoveSlashAtEnd(storedPath);
@@ -206,6 +231,107 @@ bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
   return false;
 }
 
+bool CDirectoryCache::GetStat(const std::string& strFile, struct __stat64* buffer, bool& bInCache)
+{
+  CSingleLock lock (m_cs);
+  bInCache = false;
+
+  // Get rid of any URL options, else the compare may be wrong
+  std::string strPath = CURL(strFile).GetWithoutOptions();
+  if (IsMissing(strPath))
+  {
+    bInCache = true;
+    return false;
+  }
+  URIUtils::RemoveSlashAtEnd(strPath);
+  std::string storedPath = URIUtils::GetDirectory(strPath);
+  URIUtils::RemoveSlashAtEnd(storedPath);
+
+  ciCache i = m_cache.find(storedPath);
+  if (i == m_cache.end() || URIUtils::PathEquals(strPath, storedPath))
+    return false;
+
+  CDir *dir = i->second;
+  dir->SetLastAccess(m_accessCounter);
+
+  // folders are listed with a slash at the end, callers don't always add one
+  CFileItemPtr item = dir->m_Items->Get(strPath);
+  if (!item)
+  {
+    std::string folder(strPath);
+    URIUtils::AddSlashAtEnd(folder);
+    item = dir->m_Items->Get(folder);
+  }
+  if (!item)
+  {
+    bInCache = true;
+    return false;
+  }
+
+  const CVariant &mtime = item->GetProperty("file:mtime");
+  if (mtime.isNull())
+    return false;
+
+  memset(buffer, 0, sizeof(struct __stat64));
+  buffer->st_size = item->m_bIsFolder ? 0 : item->m_dwSize;
+  buffer->st_mtime = buffer->st_ctime = (time_t)mtime.asInteger();
+  buffer->st_mode = item->m_bIsFolder ? S_IFDIR : S_IFREG;
+  bInCache = true;
+  return true;
+}
+
+void CDirectoryCache::SetMissing(const std::string& strPath)
+{
+  // local lookups are cheap, and other processes create files there behind our back
+  if (!URIUtils::IsRemote(strPath))
+    return;
+
+  CSingleLock lock (m_cs);
+
+  if (m_missing.size() >= MAX_MISSING_PATHS)
+  {
+    for (auto it = m_missing.begin(); it != m_missing.end(); )
+    {
+      if (it->second.IsTimePast())
+        it = m_missing.erase(it);
+      else
+        ++it;
+    }
+    if (m_missing.size() >= MAX_MISSING_PATHS)
+      m_missing.clear();
+  }
+
+  m_missing[CURL(strPath).GetWithoutOptions()].Set(MISSING_PATH_TIMEOUT);
+}
+
+bool CDirectoryCache::IsMissing(const std::string& strPath)
+{
+  auto it = m_missing.find(strPath);
+  if (it == m_missing.end())
+    return false;
+  if (!it->second.IsTimePast())
+    return true;
+  m_missing.erase(it);
+  return false;
+}
+
+void CDirectoryCache::ClearMissing(const std::string& strPath, bool subPaths)
+{
+  std::string path(strPath);
+  URIUtils::RemoveSlashAtEnd(path);
+  m_missing.erase(path);
+  URIUtils::AddSlashAtEnd(path);
+  m_missing.erase(path);
+
+  if (subPaths)
+  {
+    // paths below the folder are sorted right after it
+    auto it = m_missing.lower_bound(path);
+    while (it != m_missing.end() && StringUtils::StartsWith(it->first, path))
+      it = m_missing.erase(it);
+  }
+}
+
 void CDirectoryCache::Clear()
 {
   // this routine clears everything
@@ -214,6 +340,8 @@ void CDirectoryCache::Clear()
   iCache i = m_cache.begin();
   while (i != m_cache.end() )
     Delete(i++);
+
+  m_missing.clear();
 }
 
 void CDirectoryCache::InitCache(std::set<std::string>& dirs)
@@ -21,7 +21,9 @@
 
 #include "IDirectory.h"
 #include "Directory.h"
+#include "PlatformDefs.h"
 #include "threads/CriticalSection.h"
+#include "threads/SystemClock.h"
 
 #include <map>
 #include <set>
@@ -59,6 +61,29 @@ namespace XFILE
     void Clear();
     void AddFile(const std::string& strFile);
     bool FileExists(const std::string& strPath, bool& bInCache);
+
+    /*!
+     \brief Answer a stat of a file or folder from the cached listing of its parent.
+
+     Only items whose directory implementation recorded the raw modification
+     time in the "file:mtime" property can be answered, m_dateTime is converted
+     to local time and can't be turned back reliably.
+     \param strPath path of the file or folder
+     \param buffer filled with size, modification time and type if found
+     \param bInCache set to true if the cache knows that the path doesn't exist
+     \return true if buffer was filled from the cache
+     */
+    bool GetStat(const std::string& strPath, struct __stat64* buffer, bool& bInCache);
+
+    /*!
+     \brief Remember for a short while that a path doesn't exist.
+
+     FileExists() and GetStat() answer lookups of the path from the cache
+     until it expires or the cache is told about changes to its folder.
+     Folders are told apart from files by the slash at the end. Only remote
+     paths are remembered.
+     */
+    void SetMissing(const std::string& strPath);
 #ifdef _DEBUG
     void PrintStats() const;
 #endif
@@ -66,12 +91,16 @@ namespace XFILE
     void InitCache(std::set<std::string>& dirs);
     void ClearCache(std::set<std::string>& dirs);
     void CheckIfFull();
+    bool IsMissing(const std::string& strPath);
+    void ClearMissing(const std::string& strPath, bool subPaths);
 
     std::map<std::string, CDir*> m_cache;
     typedef std::map<std::string, CDir*>::iterator iCache;
     typedef std::map<std::string, CDir*>::const_iterator ciCache;
     void Delete(iCache i);
 
+    std::map<std::string, XbmcThreads::EndTime> m_missing; ///< paths without options, known not to exist
+
     CCriticalSection m_cs;
 
     unsigned int m_accessCounter;
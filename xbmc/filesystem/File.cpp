@@ -437,7 +437,11 @@ bool CFile::Exists(const CURL& file, bool bUseCache /* = true */)
     if (!pFile.get())
       return false;
 
-    return pFile->Exists(url);
+    if (pFile->Exists(url))
+      return true;
+    if (bUseCache)
+      g_directoryCache.SetMissing(url.Get());
+    return false;
   }
   XBMCCOMMONS_HANDLE_UNCHECKED
   catch (CRedirectException *pRedirectEx)
@@ -506,6 +510,16 @@ int CFile::Stat(const CURL& file, struct __stat64* buffer)
 
   CURL url(URIUtils::SubstitutePath(file));
 
+  bool bPathInCache;
+  if (g_directoryCache.GetStat(url.Get(), buffer, bPathInCache))
+    return 0;
+  if (bPathInCache)
+  {
+    memset(buffer, 0, sizeof(struct __stat64));
+    errno = ENOENT;
+    return -1;
+  }
+
   try
   {
     std::unique_ptr<IFile> pFile(CFileFactory::CreateLoader(url));
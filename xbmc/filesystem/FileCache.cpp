@@ -25,9 +25,11 @@
 #include "URL.h"
 
 #include "CircularCache.h"
+#include "PersistentCache.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "settings/AdvancedSettings.h"
+#include "utils/URIUtils.h"
 
 #if !defined(TARGET_WINDOWS)
 #include "linux/ConvUtils.h" //GetLastError()
@@ -216,6 +218,16 @@ bool CFileCache::Open(const CURL& url)
       // If READ_MULTI_STREAM flag is set: Double buffering is required
       m_pCache = new CDoubleCache(m_pCache);
     }
+
+    if (m_seekPossible > 0 && m_fileSize > 0 && URIUtils::IsRemote(m_sourcePath) &&
+        CPersistentCacheStore::GetInstance().IsEnabled())
+    {
+      // keep what we read on disk so reopening or seeking around the same file doesn't hit the network again.
+      // Without a modification time a changed file can't be told apart, so it isn't stored.
+      struct __stat64 st;
+      if (m_source.Stat(&st) == 0 && st.st_mtime > 0)
+        m_pCache = new CPersistentCache(m_pCache, CPersistentCache::GetKey(m_sourcePath, m_fileSize, st.st_mtime), m_fileSize);
+    }
   }
 
   // open cache strategy
@@ -257,6 +269,7 @@ void CFileCache::Process()
   CWriteRate limiter;
   CWriteRate average;
   bool cacheReachEOF = false;
+  bool sourceBehind = false; // the source position lags m_writePos because data came from the store
 
   while (!m_bStop)
   {
@@ -270,7 +283,14 @@ void CFileCache::Process()
       int64_t cacheMaxPos = m_pCache->CachedDataEndPosIfSeekTo(m_seekPos);
       cacheReachEOF = (cacheMaxPos == m_fileSize);
       bool sourceSeekFailed = false;
-      if (!cacheReachEOF)
+      sourceBehind = false;
+      if (!cacheReachEOF && m_pCache->IsStoredPosition(cacheMaxPos))
+      {
+        // the source is only seeked once we run out of stored data
+        m_nSeekResult = cacheMaxPos;
+        sourceBehind = true;
+      }
+      else if (!cacheReachEOF)
       {
         m_nSeekResult = m_source.Seek(cacheMaxPos, SEEK_SET);
         if (m_nSeekResult != cacheMaxPos)
@@ -313,7 +333,9 @@ void CFileCache::Process()
       }
     }
 
-    size_t maxWrite = m_pCache->GetMaxWriteSize(m_chunkSize);
+    // strategies that support it hand out their buffer so the source reads straight into the cache
+    char *span = NULL;
+    size_t maxWrite = m_pCache->GetWriteSpan(span, m_chunkSize);
 
     /* Only read from source if there's enough write space in the cache
      * else we may keep disposing data and seeking back on (slow) source
@@ -326,7 +348,30 @@ void CFileCache::Process()
 
     ssize_t iRead = 0;
     if (!cacheReachEOF)
-      iRead = m_source.Read(buffer.get(), maxWrite);
+    {
+      char *data = span ? span : buffer.get();
+      iRead = m_pCache->ReadFromStore(m_writePos, data, maxWrite);
+      if (iRead > 0)
+        sourceBehind = true;
+      else
+      {
+        if (sourceBehind)
+        {
+          sourceBehind = false;
+          if (m_source.Seek(m_writePos, SEEK_SET) != m_writePos)
+          {
+            CLog::Log(LOGERROR, "CFileCache::Process - Error seeking source to %" PRId64 " after reading stored data", m_writePos);
+            iRead = -1;
+          }
+        }
+        if (iRead == 0)
+          iRead = m_source.Read(data, maxWrite);
+      }
+    }
+    // hand back the span even if nothing was read, it still holds the history it overlaps
+    if (span)
+      m_pCache->CommitWrite(iRead > 0 ? iRead : 0);
+
     if (iRead == 0)
     {
       // Check for actual EOF and retry as long as we still have data in our cache
@@ -377,6 +422,9 @@ void CFileCache::Process()
     }
 
     int iTotalWrite = 0;
+    if (span)
+      iTotalWrite = iRead;
+
     while (!m_bStop && (iTotalWrite < iRead))
     {
       int iWrite = 0;
@@ -125,7 +125,8 @@ bool IDirectory::ProcessRequirements()
   if (type == "keyboard")
   {
     std::string input;
-    if (CGUIKeyboardFactory::ShowAndGetInput(input, m_requirements["heading"], false, m_requirements["hidden"].asBoolean()))
+    bool hidden = m_requirements["hidden"].asBoolean();
+    if (CGUIKeyboardFactory::ShowAndGetInput(input, m_requirements["heading"], false, hidden))
     {
       m_requirements["input"] = input;
       return true;
@@ -282,6 +282,7 @@ bool CNFSDirectory::GetDirectory(const CURL& url, CFileItemList &items)
       {
         pItem->SetProperty("file:hidden", true);
       }
+      pItem->SetProperty("file:mtime", lTimeDate);
       pItem->SetPath(path);
       items.Add(pItem);
     }
@@ -0,0 +1,397 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "PersistentCache.h"
+#include "Directory.h"
+#include "FileItem.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+#include "utils/md5.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cinttypes>
+
+using namespace XFILE;
+
+CPersistentCacheStore& CPersistentCacheStore::GetInstance()
+{
+  static CPersistentCacheStore store;
+  return store;
+}
+
+CPersistentCacheStore::CPersistentCacheStore()
+  : m_loaded(false)
+  , m_size(0)
+{
+}
+
+bool CPersistentCacheStore::IsEnabled() const
+{
+  return g_advancedSettings.m_cachePersistentSize > 0;
+}
+
+std::string CPersistentCacheStore::GetBlockPath(const std::string &name) const
+{
+  return m_path + name;
+}
+
+void CPersistentCacheStore::Load()
+{
+  m_loaded = true;
+  m_path = URIUtils::AddFileToFolder(g_advancedSettings.m_cachePath, "readahead/");
+
+  if (!CDirectory::Exists(m_path))
+  {
+    CDirectory::Create(m_path);
+    return;
+  }
+
+  CFileItemList items;
+  if (!CDirectory::GetDirectory(m_path, items, "", DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_BYPASS_CACHE))
+    return;
+
+  // oldest first, so the newest blocks end up at the front of the LRU list
+  items.Sort(SortByDate, SortOrderAscending);
+  for (int i = 0; i < items.Size(); i++)
+  {
+    const CFileItemPtr &item = items[i];
+    if (item->m_bIsFolder)
+      continue;
+
+    std::string name = URIUtils::GetFileName(item->GetPath());
+    if (URIUtils::HasExtension(name, ".blk") && item->m_dwSize > 0 && item->m_dwSize <= BLOCK_SIZE)
+      Add(name, (unsigned int)item->m_dwSize);
+    else
+      CFile::Delete(item->GetPath()); // left over from an interrupted write
+  }
+
+  Evict((uint64_t)g_advancedSettings.m_cachePersistentSize * 1024 * 1024);
+  CLog::Log(LOGDEBUG, "CPersistentCacheStore::Load - %u blocks, %" PRIu64 " bytes",
+            (unsigned int)m_blocks.size(), m_size);
+}
+
+void CPersistentCacheStore::Unload()
+{
+  CSingleLock lock(m_section);
+  m_loaded = false;
+  m_size = 0;
+  m_lru.clear();
+  m_blocks.clear();
+}
+
+void CPersistentCacheStore::Add(const std::string &name, unsigned int size)
+{
+  auto it = m_blocks.find(name);
+  if (it != m_blocks.end())
+  {
+    m_size -= it->second.size;
+    m_lru.erase(it->second.lru);
+    m_blocks.erase(it);
+  }
+
+  m_lru.push_front(name);
+  Block &block = m_blocks[name];
+  block.size = size;
+  block.lru = m_lru.begin();
+  m_size += size;
+}
+
+void CPersistentCacheStore::Evict(uint64_t budget)
+{
+  while (m_size > budget && !m_lru.empty())
+  {
+    const std::string &name = m_lru.back();
+    CFile::Delete(GetBlockPath(name));
+
+    auto it = m_blocks.find(name);
+    m_size -= it->second.size;
+    m_blocks.erase(it);
+    m_lru.pop_back();
+  }
+}
+
+bool CPersistentCacheStore::Lookup(const std::string &name, unsigned int &size)
+{
+  CSingleLock lock(m_section);
+  if (!m_loaded)
+    Load();
+
+  auto it = m_blocks.find(name);
+  if (it == m_blocks.end())
+    return false;
+
+  m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+  size = it->second.size;
+  return true;
+}
+
+bool CPersistentCacheStore::Insert(const std::string &name, const std::vector<char> &data)
+{
+  std::string path;
+  {
+    CSingleLock lock(m_section);
+    if (!m_loaded)
+      Load();
+    path = GetBlockPath(name);
+  }
+
+  // write without holding the lock, then move the block into place so readers never see it half written
+  std::string tmp = StringUtils::Format("%s.%p.tmp", path.c_str(), (const void*)&data);
+  CFile file;
+  if (!file.OpenForWrite(tmp, true))
+  {
+    CLog::Log(LOGWARNING, "CPersistentCacheStore::Insert - unable to create %s", tmp.c_str());
+    return false;
+  }
+  bool written = file.Write(data.data(), data.size()) == (ssize_t)data.size();
+  file.Close();
+  if (!written || !CFile::Rename(tmp, path))
+  {
+    CFile::Delete(tmp);
+    return false;
+  }
+
+  CSingleLock lock(m_section);
+  Add(name, data.size());
+  Evict((uint64_t)g_advancedSettings.m_cachePersistentSize * 1024 * 1024);
+  return true;
+}
+
+CPersistentCache::CPersistentCache(CCacheStrategy *impl, const std::string &key, int64_t fileSize)
+  : m_pCache(impl)
+  , m_key(key)
+  , m_fileSize(fileSize)
+  , m_writePos(0)
+  , m_collecting(false)
+  , m_span(NULL)
+  , m_blockIndex(-1)
+  , m_blockSize(0)
+{
+  assert(NULL != impl);
+}
+
+CPersistentCache::~CPersistentCache()
+{
+  m_blockFile.Close();
+  delete m_pCache;
+}
+
+std::string CPersistentCache::GetKey(const std::string &url, int64_t size, int64_t mtime)
+{
+  return XBMC::XBMC_MD5::GetMD5(StringUtils::Format("%s|%" PRId64 "|%" PRId64, url.c_str(), size, mtime));
+}
+
+std::string CPersistentCache::GetBlockName(int64_t block) const
+{
+  return StringUtils::Format("%s-%" PRId64 ".blk", m_key.c_str(), block);
+}
+
+int CPersistentCache::Open()
+{
+  m_writePos = 0;
+  m_collecting = false;
+  m_block.clear();
+  return m_pCache->Open();
+}
+
+void CPersistentCache::Close()
+{
+  m_blockFile.Close();
+  m_blockIndex = -1;
+  m_block.clear();
+  m_block.shrink_to_fit();
+  m_pCache->Close();
+}
+
+/**
+ * Copies data written to the cache into the block being collected. A block is
+ * only collected if writing started at its beginning and it isn't stored yet,
+ * and it is handed to the store once complete.
+ */
+void CPersistentCache::Collect(const char *pBuffer, size_t iSize)
+{
+  CPersistentCacheStore &store = CPersistentCacheStore::GetInstance();
+
+  while (iSize > 0)
+  {
+    int64_t block = m_writePos / CPersistentCacheStore::BLOCK_SIZE;
+    size_t offset = (size_t)(m_writePos % CPersistentCacheStore::BLOCK_SIZE);
+    if (offset == 0)
+    {
+      unsigned int size;
+      m_collecting = !store.Lookup(GetBlockName(block), size);
+      m_block.clear();
+    }
+
+    size_t len = std::min(iSize, CPersistentCacheStore::BLOCK_SIZE - offset);
+    if (m_collecting)
+      m_block.insert(m_block.end(), pBuffer, pBuffer + len);
+
+    m_writePos += len;
+    pBuffer += len;
+    iSize -= len;
+
+    if (m_collecting && (m_block.size() == CPersistentCacheStore::BLOCK_SIZE || m_writePos >= m_fileSize))
+    {
+      store.Insert(GetBlockName(block), m_block);
+      m_block.clear();
+      m_collecting = false;
+    }
+  }
+}
+
+size_t CPersistentCache::GetMaxWriteSize(const size_t& iRequestSize)
+{
+  return m_pCache->GetMaxWriteSize(iRequestSize);
+}
+
+int CPersistentCache::WriteToCache(const char *pBuffer, size_t iSize)
+{
+  int written = m_pCache->WriteToCache(pBuffer, iSize);
+  if (written > 0)
+    Collect(pBuffer, written);
+  return written;
+}
+
+int CPersistentCache::ReadFromCache(char *pBuffer, size_t iMaxSize)
+{
+  return m_pCache->ReadFromCache(pBuffer, iMaxSize);
+}
+
+int64_t CPersistentCache::WaitForData(unsigned int iMinAvail, unsigned int iMillis)
+{
+  return m_pCache->WaitForData(iMinAvail, iMillis);
+}
+
+size_t CPersistentCache::GetWriteSpan(char *&pData, size_t iRequestSize)
+{
+  size_t size = m_pCache->GetWriteSpan(pData, iRequestSize);
+  m_span = pData;
+  return size;
+}
+
+void CPersistentCache::CommitWrite(size_t iSize)
+{
+  m_pCache->CommitWrite(iSize);
+
+  // the writer won't touch the span again before the next GetWriteSpan(), so it's safe to read
+  if (m_span)
+    Collect(m_span, iSize);
+  m_span = NULL;
+}
+
+bool CPersistentCache::IsStoredPosition(int64_t iFilePosition)
+{
+  if (iFilePosition < 0 || iFilePosition >= m_fileSize)
+    return false;
+
+  unsigned int size;
+  if (!CPersistentCacheStore::GetInstance().Lookup(GetBlockName(iFilePosition / CPersistentCacheStore::BLOCK_SIZE), size))
+    return false;
+  return iFilePosition % CPersistentCacheStore::BLOCK_SIZE < size;
+}
+
+int CPersistentCache::ReadFromStore(int64_t iFilePosition, char *pBuffer, size_t iMaxSize)
+{
+  if (iFilePosition < 0 || iFilePosition >= m_fileSize)
+    return 0;
+
+  int64_t block = iFilePosition / CPersistentCacheStore::BLOCK_SIZE;
+  unsigned int offset = (unsigned int)(iFilePosition % CPersistentCacheStore::BLOCK_SIZE);
+  if (block != m_blockIndex)
+  {
+    CPersistentCacheStore &store = CPersistentCacheStore::GetInstance();
+    std::string name = GetBlockName(block);
+
+    m_blockFile.Close();
+    m_blockIndex = -1;
+    if (!store.Lookup(name, m_blockSize) || !m_blockFile.Open(store.GetBlockPath(name)))
+      return 0;
+    m_blockIndex = block;
+  }
+
+  if (offset >= m_blockSize || m_blockFile.Seek(offset, SEEK_SET) != offset)
+    return 0;
+
+  ssize_t read = m_blockFile.Read(pBuffer, std::min(iMaxSize, (size_t)(m_blockSize - offset)));
+  if (read <= 0)
+  {
+    // the block got evicted or damaged, fall back to the source
+    m_blockFile.Close();
+    m_blockIndex = -1;
+    return 0;
+  }
+  return (int)read;
+}
+
+int64_t CPersistentCache::Seek(int64_t iFilePosition)
+{
+  return m_pCache->Seek(iFilePosition);
+}
+
+bool CPersistentCache::Reset(int64_t iSourcePosition, bool clearAnyway)
+{
+  bool bRes = m_pCache->Reset(iSourcePosition, clearAnyway);
+
+  // collecting restarts at the next block boundary
+  m_writePos = m_pCache->CachedDataEndPos();
+  m_collecting = false;
+  m_block.clear();
+  return bRes;
+}
+
+void CPersistentCache::EndOfInput()
+{
+  m_pCache->EndOfInput();
+}
+
+bool CPersistentCache::IsEndOfInput()
+{
+  return m_pCache->IsEndOfInput();
+}
+
+void CPersistentCache::ClearEndOfInput()
+{
+  m_pCache->ClearEndOfInput();
+}
+
+int64_t CPersistentCache::CachedDataEndPosIfSeekTo(int64_t iFilePosition)
+{
+  return m_pCache->CachedDataEndPosIfSeekTo(iFilePosition);
+}
+
+int64_t CPersistentCache::CachedDataEndPos()
+{
+  return m_pCache->CachedDataEndPos();
+}
+
+bool CPersistentCache::IsCachedPosition(int64_t iFilePosition)
+{
+  return m_pCache->IsCachedPosition(iFilePosition);
+}
+
+CCacheStrategy *CPersistentCache::CreateNew()
+{
+  return new CPersistentCache(m_pCache->CreateNew(), m_key, m_fileSize);
+}
@@ -0,0 +1,163 @@
+#pragma once
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "CacheStrategy.h"
+#include "File.h"
+#include "threads/CriticalSection.h"
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace XFILE {
+
+/*!
+ \brief Size limited store of file blocks on local disk, shared by all CPersistentCache instances.
+
+ Blocks are kept as one file per block below <cachepath>/readahead/ and evicted
+ least recently used first once the size set with <cache><persistentsize> in
+ advancedsettings.xml is exceeded. The index is rebuilt from the directory on
+ first use, ordered by modification time, so the store survives restarts.
+ */
+class CPersistentCacheStore
+{
+public:
+  static CPersistentCacheStore& GetInstance();
+
+  static const unsigned int BLOCK_SIZE = 1024 * 1024;
+
+  /*!
+   \brief Whether the store is enabled in advancedsettings
+   */
+  bool IsEnabled() const;
+
+  /*!
+   \brief Look up a block and mark it as recently used
+   \param name name of the block
+   \param size set to the size of the stored block
+   \return true if the block is stored
+   */
+  bool Lookup(const std::string &name, unsigned int &size);
+
+  /*!
+   \brief Store a block, evicting old blocks if the store grows over budget
+   */
+  bool Insert(const std::string &name, const std::vector<char> &data);
+
+  /*!
+   \brief Path of the file holding the block
+   */
+  std::string GetBlockPath(const std::string &name) const;
+
+  /*!
+   \brief Forget the index, the next use rebuilds it from <cachepath>/readahead/
+   */
+  void Unload();
+
+private:
+  CPersistentCacheStore();
+  CPersistentCacheStore(const CPersistentCacheStore&) = delete;
+  CPersistentCacheStore& operator=(const CPersistentCacheStore&) = delete;
+
+  struct Block
+  {
+    unsigned int size;
+    std::list<std::string>::iterator lru;
+  };
+
+  void Load();
+  void Add(const std::string &name, unsigned int size);
+  void Evict(uint64_t budget);
+
+  CCriticalSection m_section;
+  std::string m_path;
+  bool m_loaded;
+  uint64_t m_size;
+  std::list<std::string> m_lru; ///< most recently used first
+  std::unordered_map<std::string, Block> m_blocks;
+};
+
+/*!
+ \brief Cache strategy keeping everything read from the source in the CPersistentCacheStore.
+
+ Wraps the strategy doing the actual read-ahead buffering. Every complete block
+ written to the cache is copied to the store, and ReadFromStore() lets the cache
+ thread take data from the store instead of the network the next time the same
+ file (identified by url, size and modification time) is read.
+ */
+class CPersistentCache : public CCacheStrategy
+{
+public:
+  CPersistentCache(CCacheStrategy *impl, const std::string &key, int64_t fileSize);
+  ~CPersistentCache() override;
+
+  /*!
+   \brief Build the store key of a file
+   */
+  static std::string GetKey(const std::string &url, int64_t size, int64_t mtime);
+
+  int Open() override;
+  void Close() override;
+
+  size_t GetMaxWriteSize(const size_t& iRequestSize) override;
+  int WriteToCache(const char *pBuffer, size_t iSize) override;
+  int ReadFromCache(char *pBuffer, size_t iMaxSize) override;
+  int64_t WaitForData(unsigned int iMinAvail, unsigned int iMillis) override;
+
+  size_t GetWriteSpan(char *&pData, size_t iRequestSize) override;
+  void CommitWrite(size_t iSize) override;
+
+  bool IsStoredPosition(int64_t iFilePosition) override;
+  int ReadFromStore(int64_t iFilePosition, char *pBuffer, size_t iMaxSize) override;
+
+  int64_t Seek(int64_t iFilePosition) override;
+  bool Reset(int64_t iSourcePosition, bool clearAnyway=true) override;
+  void EndOfInput() override;
+  bool IsEndOfInput() override;
+  void ClearEndOfInput() override;
+
+  int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition) override;
+  int64_t CachedDataEndPos() override;
+  bool IsCachedPosition(int64_t iFilePosition) override;
+
+  CCacheStrategy *CreateNew() override;
+
+protected:
+  std::string GetBlockName(int64_t block) const;
+  void Collect(const char *pBuffer, size_t iSize);
+
+  CCacheStrategy *m_pCache;
+  std::string m_key;
+  int64_t m_fileSize;
+
+  // writer side, only used by the cache thread
+  int64_t m_writePos;            ///< source position of the next byte written to the cache
+  bool m_collecting;             ///< whether the current block is collected for the store
+  std::vector<char> m_block;
+  char *m_span;
+
+  CFile m_blockFile;             ///< block ReadFromStore() reads from
+  int64_t m_blockIndex;
+  unsigned int m_blockSize;
+};
+
+}
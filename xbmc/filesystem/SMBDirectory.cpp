@@ -120,6 +120,7 @@ bool CSMBDirectory::GetDirectory(const CURL& url, CFileItemList &items)
       bool bIsDir = true;
       int64_t lTimeDate = 0;
       bool hidden = false;
+      bool statted = false;
 
       if(StringUtils::EndsWith(strFile, "$") && aDir.type == SMBC_FILE_SHARE )
         continue;
@@ -162,6 +163,7 @@ bool CSMBDirectory::GetDirectory(const CURL& url, CFileItemList &items)
             if(lTimeDate == 0) // if modification date is missing, use create date
               lTimeDate = info.st_ctime;
             iSize = info.st_size;
+            statted = true;
           }
           else
             CLog::Log(LOGERROR, "%s - Failed to stat file %s", __FUNCTION__, CURL::GetRedacted(strFullName).c_str());
@@ -196,6 +198,8 @@ bool CSMBDirectory::GetDirectory(const CURL& url, CFileItemList &items)
         pItem->m_dateTime=localTime;
         if (hidden)
           pItem->SetProperty("file:hidden", true);
+        if (statted)
+          pItem->SetProperty("file:mtime", lTimeDate);
         items.Add(pItem);
       }
       else
@@ -207,6 +211,8 @@ bool CSMBDirectory::GetDirectory(const CURL& url, CFileItemList &items)
         pItem->m_dateTime=localTime;
         if (hidden)
           pItem->SetProperty("file:hidden", true);
+        if (statted)
+          pItem->SetProperty("file:mtime", lTimeDate);
         items.Add(pItem);
       }
     }
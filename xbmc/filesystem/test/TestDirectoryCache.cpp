@@ -0,0 +1,120 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/DirectoryCache.h"
+#include "FileItem.h"
+
+#include "gtest/gtest.h"
+
+#include <sys/stat.h>
+
+using namespace XFILE;
+
+class TestDirectoryCache : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    CFileItemList items;
+
+    CFileItemPtr file(new CFileItem("smb://server/share/movies/movie.mkv", false));
+    file->m_dwSize = 1234;
+    file->SetProperty("file:mtime", (int64_t)1500000000);
+    items.Add(file);
+
+    CFileItemPtr folder(new CFileItem("smb://server/share/movies/extras/", true));
+    folder->SetProperty("file:mtime", (int64_t)1400000000);
+    items.Add(folder);
+
+    items.Add(CFileItemPtr(new CFileItem("smb://server/share/movies/movie.nfo", false)));
+
+    m_cache.SetDirectory("smb://server/share/movies/", items, DIR_CACHE_ALWAYS);
+  }
+
+  CDirectoryCache m_cache;
+};
+
+TEST_F(TestDirectoryCache, Stat)
+{
+  struct __stat64 buffer;
+  bool inCache;
+
+  EXPECT_TRUE(m_cache.GetStat("smb://server/share/movies/movie.mkv", &buffer, inCache));
+  EXPECT_TRUE(inCache);
+  EXPECT_EQ(1234, buffer.st_size);
+  EXPECT_EQ(1500000000, buffer.st_mtime);
+  EXPECT_TRUE(S_ISREG(buffer.st_mode));
+
+  // folders are found with and without the slash at the end
+  EXPECT_TRUE(m_cache.GetStat("smb://server/share/movies/extras", &buffer, inCache));
+  EXPECT_EQ(1400000000, buffer.st_mtime);
+  EXPECT_TRUE(S_ISDIR(buffer.st_mode));
+  EXPECT_TRUE(m_cache.GetStat("smb://server/share/movies/extras/", &buffer, inCache));
+
+  // listed without times, has to be asked for
+  EXPECT_FALSE(m_cache.GetStat("smb://server/share/movies/movie.nfo", &buffer, inCache));
+  EXPECT_FALSE(inCache);
+
+  // not listed in a cached folder
+  EXPECT_FALSE(m_cache.GetStat("smb://server/share/movies/movie.srt", &buffer, inCache));
+  EXPECT_TRUE(inCache);
+
+  // folder not cached
+  EXPECT_FALSE(m_cache.GetStat("smb://server/share/tvshows/show.nfo", &buffer, inCache));
+  EXPECT_FALSE(inCache);
+}
+
+TEST_F(TestDirectoryCache, Missing)
+{
+  struct __stat64 buffer;
+  bool inCache;
+  const std::string path = "smb://server/share/tvshows/show/tvshow.nfo";
+
+  EXPECT_FALSE(m_cache.FileExists(path, inCache));
+  EXPECT_FALSE(inCache);
+
+  m_cache.SetMissing(path);
+  EXPECT_FALSE(m_cache.FileExists(path, inCache));
+  EXPECT_TRUE(inCache);
+  EXPECT_FALSE(m_cache.GetStat(path, &buffer, inCache));
+  EXPECT_TRUE(inCache);
+
+  // a folder of the same name is a different path
+  EXPECT_FALSE(m_cache.FileExists(path + "/", inCache));
+  EXPECT_FALSE(inCache);
+
+  m_cache.AddFile(path);
+  EXPECT_FALSE(m_cache.FileExists(path, inCache));
+  EXPECT_FALSE(inCache);
+
+  // changes to the folder forget about misses below it
+  m_cache.SetMissing(path);
+  m_cache.SetMissing("smb://server/share/tvshows/show/season 1/");
+  m_cache.ClearDirectory("smb://server/share/tvshows/show");
+  EXPECT_FALSE(m_cache.FileExists(path, inCache));
+  EXPECT_FALSE(inCache);
+  EXPECT_FALSE(m_cache.FileExists("smb://server/share/tvshows/show/season 1/", inCache));
+  EXPECT_FALSE(inCache);
+
+  // local paths aren't remembered
+  m_cache.SetMissing("/tmp/missing.nfo");
+  EXPECT_FALSE(m_cache.FileExists("/tmp/missing.nfo", inCache));
+  EXPECT_FALSE(inCache);
+}
@@ -0,0 +1,152 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/CircularCache.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "filesystem/PersistentCache.h"
+#include "settings/AdvancedSettings.h"
+
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <vector>
+
+#define FILE_SIZE (CPersistentCacheStore::BLOCK_SIZE * 5 / 2)
+
+using namespace XFILE;
+
+class TestPersistentCache : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_cachePath = g_advancedSettings.m_cachePath;
+    m_persistentSize = g_advancedSettings.m_cachePersistentSize;
+    g_advancedSettings.m_cachePath = "special://temp/persistentcache/";
+    g_advancedSettings.m_cachePersistentSize = 4;
+    CDirectory::RemoveRecursive(g_advancedSettings.m_cachePath);
+    CDirectory::Create(g_advancedSettings.m_cachePath);
+    CPersistentCacheStore::GetInstance().Unload();
+
+    m_data.resize(FILE_SIZE);
+    for (size_t i = 0; i < m_data.size(); i++)
+      m_data[i] = (char)(i * 7 + i / 4096);
+  }
+
+  void TearDown() override
+  {
+    CPersistentCacheStore::GetInstance().Unload();
+    CDirectory::RemoveRecursive(g_advancedSettings.m_cachePath);
+    g_advancedSettings.m_cachePath = m_cachePath;
+    g_advancedSettings.m_cachePersistentSize = m_persistentSize;
+  }
+
+  std::unique_ptr<CPersistentCache> CreateCache(const std::string &key)
+  {
+    std::unique_ptr<CPersistentCache> cache(new CPersistentCache(new CCircularCache(FILE_SIZE, 0), key, FILE_SIZE));
+    EXPECT_EQ(CACHE_RC_OK, cache->Open());
+    return cache;
+  }
+
+  // writes the whole file the way the cache thread does, a chunk at a time
+  void Fill(CPersistentCache &cache)
+  {
+    size_t written = 0;
+    while (written < m_data.size())
+    {
+      int len = cache.WriteToCache(m_data.data() + written, std::min((size_t)64 * 1024, m_data.size() - written));
+      ASSERT_LT(0, len);
+      written += len;
+    }
+  }
+
+  std::vector<char> m_data;
+  std::string m_cachePath;
+  unsigned int m_persistentSize;
+};
+
+TEST_F(TestPersistentCache, Key)
+{
+  std::string key = CPersistentCache::GetKey("smb://server/share/movie.mkv", 1000, 1500000000);
+  EXPECT_EQ(key, CPersistentCache::GetKey("smb://server/share/movie.mkv", 1000, 1500000000));
+  EXPECT_NE(key, CPersistentCache::GetKey("smb://server/share/movie2.mkv", 1000, 1500000000));
+  EXPECT_NE(key, CPersistentCache::GetKey("smb://server/share/movie.mkv", 1001, 1500000000));
+  EXPECT_NE(key, CPersistentCache::GetKey("smb://server/share/movie.mkv", 1000, 1500000001));
+}
+
+TEST_F(TestPersistentCache, ReadFromStore)
+{
+  std::string key = CPersistentCache::GetKey("smb://server/share/movie.mkv", FILE_SIZE, 1500000000);
+  Fill(*CreateCache(key));
+
+  // a later open of the same file finds every block, including the short last one
+  std::unique_ptr<CPersistentCache> cache = CreateCache(key);
+  EXPECT_TRUE(cache->IsStoredPosition(0));
+  EXPECT_TRUE(cache->IsStoredPosition(CPersistentCacheStore::BLOCK_SIZE * 2));
+  EXPECT_TRUE(cache->IsStoredPosition(FILE_SIZE - 1));
+  EXPECT_FALSE(cache->IsStoredPosition(FILE_SIZE));
+
+  std::vector<char> data(FILE_SIZE);
+  size_t read = 0;
+  while (read < data.size())
+  {
+    int len = cache->ReadFromStore(read, data.data() + read, data.size() - read);
+    ASSERT_LT(0, len);
+    read += len;
+  }
+  EXPECT_TRUE(m_data == data);
+}
+
+TEST_F(TestPersistentCache, Invalidation)
+{
+  Fill(*CreateCache(CPersistentCache::GetKey("smb://server/share/movie.mkv", FILE_SIZE, 1500000000)));
+
+  // once the file changed, the blocks of the old version aren't used
+  std::unique_ptr<CPersistentCache> cache = CreateCache(CPersistentCache::GetKey("smb://server/share/movie.mkv", FILE_SIZE, 1500000001));
+  EXPECT_FALSE(cache->IsStoredPosition(0));
+  char buffer[16];
+  EXPECT_EQ(0, cache->ReadFromStore(0, buffer, sizeof(buffer)));
+}
+
+TEST_F(TestPersistentCache, Eviction)
+{
+  CPersistentCacheStore &store = CPersistentCacheStore::GetInstance();
+  std::vector<char> block(CPersistentCacheStore::BLOCK_SIZE, 'x');
+  unsigned int size;
+
+  for (int i = 0; i < 4; i++)
+    ASSERT_TRUE(store.Insert(std::to_string(i) + ".blk", block));
+
+  // using a block keeps it, the least recently used one goes first
+  EXPECT_TRUE(store.Lookup("0.blk", size));
+  EXPECT_EQ((unsigned int)CPersistentCacheStore::BLOCK_SIZE, size);
+  ASSERT_TRUE(store.Insert("4.blk", block));
+
+  EXPECT_TRUE(store.Lookup("0.blk", size));
+  EXPECT_FALSE(store.Lookup("1.blk", size));
+  EXPECT_FALSE(CFile::Exists(store.GetBlockPath("1.blk")));
+  EXPECT_TRUE(store.Lookup("4.blk", size));
+
+  // the index is rebuilt from disk and stays within the budget
+  store.Unload();
+  EXPECT_TRUE(store.Lookup("4.blk", size));
+  EXPECT_FALSE(store.Lookup("1.blk", size));
+}
@@ -22,6 +22,7 @@
 #include "utils/log.h"
 #include "cores/FFmpeg.h"
 #include "guilib/Texture.h"
+#include "pictures/PictureScaler.h"
 
 #include <algorithm>
 
@@ -501,23 +502,17 @@ bool CFFmpegImage::DecodeFrame(AVFrame* frame, unsigned int width, unsigned int
     nHeight = (unsigned int)(nWidth / ratio + 0.5f);
   }
 
-  struct SwsContext* context = sws_getContext(m_originalWidth, m_originalHeight, pixFormat,
-    nWidth, nHeight, AV_PIX_FMT_RGB32, SWS_BICUBIC, NULL, NULL, NULL);
-
-  if (range == AVCOL_RANGE_JPEG)
+  if (!CPictureScaler::GetInstance().Scale(frame->data, frame->linesize, m_originalWidth, m_originalHeight,
+                                           pixFormat, range == AVCOL_RANGE_JPEG,
+                                           pictureRGB->data, pictureRGB->linesize, nWidth, nHeight,
+                                           AV_PIX_FMT_RGB32, SWS_BICUBIC))
   {
-    int* inv_table = nullptr;
-    int* table = nullptr;
-    int srcRange, dstRange, brightness, contrast, saturation;
-    sws_getColorspaceDetails(context, &inv_table, &srcRange, &table, &dstRange, &brightness, &contrast, &saturation);
-    srcRange = 1;
-    sws_setColorspaceDetails(context, inv_table, srcRange, table, dstRange, brightness, contrast, saturation);
+    if (!needsCopy)
+      pictureRGB->data[0] = nullptr;
+    av_frame_free(&pictureRGB);
+    return false;
   }
 
-  sws_scale(context, frame->data, frame->linesize, 0, m_originalHeight,
-    pictureRGB->data, pictureRGB->linesize);
-  sws_freeContext(context);
-
   if (needsCopy)
   {
     int minPitch = std::min((int)pitch, pictureRGB->linesize[0]);
@@ -23,6 +23,7 @@
 #include <cassert>
 #include <utility>
 
+#include "GUITexture.h"
 #include "guiinfo/GUIInfoLabels.h"
 
 CGUIControlGroup::CGUIControlGroup()
@@ -117,13 +118,29 @@ void CGUIControlGroup::Render()
   CPoint pos(GetPosition());
   g_graphicsContext.SetOrigin(pos.x, pos.y);
   CGUIControl *focusedControl = NULL;
+  bool batching = false;
   for (auto *control : m_children)
   {
     if (m_renderFocusedLast && control->HasFocus())
       focusedControl = control;
     else
+    {
+      // images only draw textures, so runs of them can be drawn in batches
+      bool isImage = control->GetControlType() == GUICONTROL_IMAGE ||
+                     control->GetControlType() == GUICONTROL_BORDEREDIMAGE;
+      if (isImage != batching)
+      {
+        if (isImage)
+          CGUITexture::BeginBatch();
+        else
+          CGUITexture::EndBatch();
+        batching = isImage;
+      }
       control->DoRender();
+    }
   }
+  if (batching)
+    CGUITexture::EndBatch();
   if (focusedControl)
     focusedControl->DoRender();
   CGUIControl::Render();
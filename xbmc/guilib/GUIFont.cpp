@@ -237,6 +237,13 @@ bool CGUIFont::ClippedRegionIsEmpty(float x, float y, float width, uint32_t alig
   return !g_graphicsContext.SetClipRegion(x, y, width, m_font->GetTextHeight(1, 2) * g_graphicsContext.GetGUIScaleY());
 }
 
+void CGUIFont::PrepareText(const vecText &text)
+{
+  if (!m_font) return;
+  CSingleLock lock(g_graphicsContext);
+  m_font->PrepareCharacters(text.begin(), text.end());
+}
+
 float CGUIFont::GetTextWidth( const vecText &text )
 {
   if (!m_font) return 0;
@@ -140,6 +140,14 @@ public:
 
   bool UpdateScrollInfo(const vecText &text, CScrollInfo &scrollInfo);
 
+  /*!
+   \brief Rasterise the glyphs of text that aren't cached yet
+   \details Larger runs of new glyphs are handed to jobs. Measuring or drawing
+   the text afterwards takes the glyphs they have finished and rasterises the
+   others, it never waits for the jobs.
+   */
+  void PrepareText(const vecText &text);
+
   float GetTextWidth( const vecText &text );
   float GetCharWidth( character_t ch );
   float GetTextHeight(int numLines) const;
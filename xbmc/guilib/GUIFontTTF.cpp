@@ -32,7 +32,11 @@
 #include "URL.h"
 #include "filesystem/File.h"
 #include "threads/SystemClock.h"
+#include "utils/CPUInfo.h"
+#include "utils/JobManager.h"
 
+#include <algorithm>
+#include <atomic>
 #include <math.h>
 #include <memory>
 #include <queue>
@@ -61,6 +65,8 @@
 #define CHAR_CHUNK    64      // 64 chars allocated at a time (1024 bytes)
 #define GLYPH_STRENGTH_BOLD 24
 #define GLYPH_STRENGTH_LIGHT -48
+#define MIN_GLYPHS_PER_JOB 8 // fewer new glyphs than this are rasterised where they're needed
+#define MAX_GLYPH_JOBS 4
 
 
 class CFreeTypeLibrary
@@ -88,8 +94,6 @@ public:
       return NULL;
     }
 
-    FT_Face face;
-
     // ok, now load the font face
     CURL realFile(CSpecialProtocol::TranslatePath(filename));
     if (realFile.GetFileName().empty())
@@ -106,11 +110,28 @@ public:
       XFILE::CFile f;
       if (f.LoadFile(realFile, memoryBuf) <= 0)
         return NULL;
-      if (FT_New_Memory_Face(m_library, (const FT_Byte*)memoryBuf.get(), memoryBuf.size(), 0, &face) != 0)
+    }
+
+    return GetFont(m_library, filename, size, aspect, memoryBuf);
+  };
+
+  /*!
+   \brief Open another face of a font opened by GetFont(), created by library
+   \param memoryBuf the font file as GetFont() loaded it, empty if it's read from the file
+   */
+  static FT_Face GetFont(FT_Library library, const std::string &filename, float size, float aspect, const XUTILS::auto_buffer& memoryBuf)
+  {
+    FT_Face face;
+    if (memoryBuf.size() > 0)
+    {
+      if (FT_New_Memory_Face(library, (const FT_Byte*)memoryBuf.get(), memoryBuf.size(), 0, &face) != 0)
         return NULL;
     }
 #ifndef TARGET_WINDOWS
-    else if (FT_New_Face( m_library, realFile.GetFileName().c_str(), 0, &face ))
+    else if (FT_New_Face(library, CURL(CSpecialProtocol::TranslatePath(filename)).GetFileName().c_str(), 0, &face))
+      return NULL;
+#else
+    else
       return NULL;
 #endif // ! TARGET_WINDOWS
 
@@ -135,8 +156,13 @@ public:
     if (!m_library)
       return NULL;
 
+    return GetStroker(m_library);
+  };
+
+  static FT_Stroker GetStroker(FT_Library library)
+  {
     FT_Stroker stroker;
-    if (FT_Stroker_New(m_library, &stroker))
+    if (FT_Stroker_New(library, &stroker))
       return NULL;
 
     return stroker;
@@ -161,6 +187,172 @@ private:
 XBMC_GLOBAL_REF(CFreeTypeLibrary, g_freeTypeLibrary); // our freetype library
 #define g_freeTypeLibrary XBMC_GLOBAL_USE(CFreeTypeLibrary)
 
+/*!
+ \brief Faces of a font for CRasterJob
+
+ FreeType objects created from one library must not be used by two threads at
+ once, so each face comes with a library of its own. They open the font file,
+ or share the copy in memory of the font they were created for. Faces are
+ handed to one job at a time and kept for later runs.
+ */
+class CGUIFontTTFBase::CRasterFaces
+{
+public:
+  struct Face
+  {
+    FT_Library library;
+    FT_Face face;
+    FT_Stroker stroker;
+  };
+
+  CRasterFaces(const std::string &filename, float size, float aspect, long borderStrength,
+               std::shared_ptr<XUTILS::auto_buffer> fontFileInMemory) :
+    m_filename(filename), m_size(size), m_aspect(aspect), m_borderStrength(borderStrength),
+    m_fontFileInMemory(std::move(fontFileInMemory))
+  {
+  }
+
+  ~CRasterFaces()
+  {
+    for (auto &face : m_faces)
+      Free(face);
+  }
+
+  /*! \brief Take a face nobody else uses, opening one if needed
+   \return false if the font couldn't be opened
+   */
+  bool Acquire(Face &face)
+  {
+    {
+      CSingleLock lock(m_section);
+      if (!m_faces.empty())
+      {
+        face = m_faces.back();
+        m_faces.pop_back();
+        return true;
+      }
+    }
+
+    if (FT_Init_FreeType(&face.library))
+      return false;
+    face.face = CFreeTypeLibrary::GetFont(face.library, m_filename, m_size, m_aspect, *m_fontFileInMemory);
+    face.stroker = NULL;
+    if (face.face && m_borderStrength)
+    {
+      face.stroker = CFreeTypeLibrary::GetStroker(face.library);
+      if (face.stroker)
+        FT_Stroker_Set(face.stroker, m_borderStrength, FT_STROKER_LINECAP_ROUND, FT_STROKER_LINEJOIN_ROUND, 0);
+    }
+    if (!face.face || (m_borderStrength && !face.stroker))
+    {
+      Free(face);
+      return false;
+    }
+    return true;
+  }
+
+  void Release(const Face &face)
+  {
+    CSingleLock lock(m_section);
+    m_faces.push_back(face);
+  }
+
+private:
+  static void Free(Face &face)
+  {
+    if (face.stroker)
+      CFreeTypeLibrary::ReleaseStroker(face.stroker);
+    if (face.face)
+      CFreeTypeLibrary::ReleaseFont(face.face);
+    FT_Done_FreeType(face.library);
+  }
+
+  std::string m_filename;
+  float m_size;
+  float m_aspect;
+  long m_borderStrength;
+  std::shared_ptr<XUTILS::auto_buffer> m_fontFileInMemory;
+
+  CCriticalSection m_section;
+  std::vector<Face> m_faces;
+};
+
+/*!
+ \brief New glyphs of a text, in the order of their letterAndStyle
+ */
+struct CGUIFontTTFBase::RasterRun
+{
+  enum State
+  {
+    PENDING,
+    CLAIMED,
+    DONE,
+    FAILED
+  };
+
+  explicit RasterRun(std::vector<character_t> &&newLetters) :
+    letters(std::move(newLetters)), glyphs(letters.size()), states(new std::atomic<int>[letters.size()]), cancelled(false)
+  {
+    for (size_t i = 0; i < letters.size(); i++)
+      states[i] = PENDING;
+  }
+
+  //! only whoever claims a glyph may rasterise it
+  bool Claim(size_t i)
+  {
+    int expected = PENDING;
+    return states[i].compare_exchange_strong(expected, CLAIMED);
+  }
+
+  std::vector<character_t> letters;
+  std::vector<Glyph> glyphs;
+  std::unique_ptr<std::atomic<int>[]> states;
+  std::atomic<bool> cancelled;
+};
+
+/*!
+ \brief Rasterises the glyphs of a run nobody has claimed yet, starting at first
+ */
+class CGUIFontTTFBase::CRasterJob : public CJob
+{
+public:
+  CRasterJob(std::shared_ptr<RasterRun> run, std::shared_ptr<CRasterFaces> faces, size_t first) :
+    m_run(std::move(run)), m_faces(std::move(faces)), m_first(first)
+  {
+  }
+
+  const char *GetType() const override { return "rasterglyphs"; }
+
+  bool DoWork() override
+  {
+    if (m_run->cancelled)
+      return true;
+
+    CRasterFaces::Face face;
+    if (!m_faces->Acquire(face))
+      return false;
+
+    size_t count = m_run->letters.size();
+    for (size_t n = 0; n < count && !m_run->cancelled; n++)
+    {
+      size_t i = (m_first + n) % count;
+      if (!m_run->Claim(i))
+        continue;
+      character_t letter = m_run->letters[i];
+      bool rasterized = RasterizeGlyph(face.face, face.stroker, (wchar_t)(letter & 0xffff), letter >> 16, m_run->glyphs[i]);
+      m_run->states[i] = rasterized ? RasterRun::DONE : RasterRun::FAILED;
+    }
+
+    m_faces->Release(face);
+    return true;
+  }
+
+private:
+  std::shared_ptr<RasterRun> m_run;
+  std::shared_ptr<CRasterFaces> m_faces;
+  size_t m_first;
+};
+
 CGUIFontTTFBase::CGUIFontTTFBase(const std::string& strFileName) : m_staticCache(*this), m_dynamicCache(*this)
 {
   m_texture = NULL;
@@ -172,6 +364,8 @@ CGUIFontTTFBase::CGUIFontTTFBase(const std::string& strFileName) : m_staticCache
 
   m_face = NULL;
   m_stroker = NULL;
+  m_borderStrength = 0;
+  m_aspect = 1.0f;
   memset(m_charquick, 0, sizeof(m_charquick));
   m_strFileName = strFileName;
   m_referenceCount = 0;
@@ -242,19 +436,27 @@ void CGUIFontTTFBase::Clear()
   if (m_stroker)
     g_freeTypeLibrary.ReleaseStroker(m_stroker);
   m_stroker = NULL;
+  m_borderStrength = 0;
+
+  // running jobs hold on to the run and the faces until they notice
+  if (m_rasterRun)
+    m_rasterRun->cancelled = true;
+  m_rasterRun.reset();
+  m_rasterFaces.reset();
 
   m_vertexTrans.clear();
   m_vertex.clear();
 
   m_strFileName.clear();
-  m_fontFileInMemory.clear();
+  m_fontFileInMemory.reset();
 }
 
 bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float aspect, float lineSpacing, bool border)
 {
   // we now know that this object is unique - only the GUIFont objects are non-unique, so no need
   // for reference tracking these fonts
-  m_face = g_freeTypeLibrary.GetFont(strFilename, height, aspect, m_fontFileInMemory);
+  m_fontFileInMemory = std::make_shared<XUTILS::auto_buffer>();
+  m_face = g_freeTypeLibrary.GetFont(strFilename, height, aspect, *m_fontFileInMemory);
 
   if (!m_face)
     return false;
@@ -296,6 +498,7 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
     m_stroker = g_freeTypeLibrary.GetStroker();
     if (m_stroker)
       FT_Stroker_Set(m_stroker, strength, FT_STROKER_LINECAP_ROUND, FT_STROKER_LINEJOIN_ROUND, 0);
+    m_borderStrength = strength;
   }
 
   // scale to pixel sizing, rounding so that maximal extent is obtained
@@ -307,6 +510,7 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
   m_cellHeight   = cellAscender - cellDescender;
 
   m_height = height;
+  m_aspect = aspect;
 
   delete(m_texture);
   m_texture = NULL;
@@ -629,20 +833,38 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   // letters are stored based on style and letter
   character_t ch = (style << 16) | letter;
 
-  int low = 0;
+  int low;
+  Character *character = FindCharacter(ch, low);
+  if (character)
+    return character;
+
+  // if we get to here, then low is where we should insert the new character
+  Glyph glyph;
+  if (!TakeRasterizedGlyph(ch, glyph) && !RasterizeGlyph(m_face, m_stroker, letter, style, glyph))
+    return NULL;
+
+  return AddCharacter(glyph, ch, low);
+}
+
+CGUIFontTTFBase::Character* CGUIFontTTFBase::FindCharacter(character_t letterAndStyle, int &low)
+{
+  low = 0;
   int high = m_numChars - 1;
   while (low <= high)
   {
     int mid = (low + high) >> 1;
-    if (ch > m_char[mid].letterAndStyle)
+    if (letterAndStyle > m_char[mid].letterAndStyle)
       low = mid + 1;
-    else if (ch < m_char[mid].letterAndStyle)
+    else if (letterAndStyle < m_char[mid].letterAndStyle)
       high = mid - 1;
     else
       return &m_char[mid];
   }
-  // if we get to here, then low is where we should insert the new character
+  return NULL;
+}
 
+CGUIFontTTFBase::Character* CGUIFontTTFBase::AddCharacter(const Glyph &glyph, character_t letterAndStyle, int low)
+{
   // increase the size of the buffer if we need it
   if (m_numChars >= m_maxChars)
   { // need to increase the size of the buffer
@@ -666,12 +888,12 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   unsigned int nestedBeginCount = m_nestedBeginCount;
   m_nestedBeginCount = 1;
   if (nestedBeginCount) End();
-  if (!CacheCharacter(letter, style, m_char + low))
+  if (!CacheCharacter(glyph, letterAndStyle, m_char + low))
   { // unable to cache character - try clearing them all out and starting over
     CLog::Log(LOGDEBUG, "%s: Unable to cache character.  Clearing character cache of %i characters", __FUNCTION__, m_numChars);
     ClearCharacterCache();
     low = 0;
-    if (!CacheCharacter(letter, style, m_char + low))
+    if (!CacheCharacter(glyph, letterAndStyle, m_char + low))
     {
       CLog::Log(LOGERROR, "%s: Unable to cache character (out of memory?)", __FUNCTION__);
       if (nestedBeginCount) Begin();
@@ -696,33 +918,112 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   return m_char + low;
 }
 
-bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *ch)
+void CGUIFontTTFBase::PrepareCharacters(vecText::const_iterator start, vecText::const_iterator end)
 {
-  int glyph_index = FT_Get_Char_Index( m_face, letter );
+  if (!m_face)
+    return;
+
+  FinishRasterRun();
+
+  // collect the letters that aren't cached yet, in the order they'll be stored
+  std::vector<character_t> letters;
+  for (vecText::const_iterator pos = start; pos != end; ++pos)
+  {
+    wchar_t letter = (wchar_t)(*pos & 0xffff);
+    if (letter == L'\r')
+      continue;
+    character_t ch = (((*pos & 0x7000000) >> 24) << 16) | letter;
+    int low;
+    if (!FindCharacter(ch, low))
+      letters.push_back(ch);
+  }
+  std::sort(letters.begin(), letters.end());
+  letters.erase(std::unique(letters.begin(), letters.end()), letters.end());
+
+  unsigned int numJobs = std::min<unsigned int>(std::min(g_cpuInfo.getCPUCount(), MAX_GLYPH_JOBS),
+                                                letters.size() / MIN_GLYPHS_PER_JOB);
+  if (numJobs == 0)
+    return; // not worth handing out, GetCharacter() rasterises them as they're needed
+
+  if (!m_rasterFaces)
+    m_rasterFaces = std::make_shared<CRasterFaces>(m_strFilename, m_height, m_aspect,
+                                                   m_stroker ? m_borderStrength : 0, m_fontFileInMemory);
+
+  // the jobs start at different letters, GetCharacter() claims the others as the text is laid out
+  m_rasterRun = std::make_shared<RasterRun>(std::move(letters));
+  size_t count = m_rasterRun->letters.size();
+  for (unsigned int job = 0; job < numJobs; job++)
+    CJobManager::GetInstance().AddJob(new CRasterJob(m_rasterRun, m_rasterFaces, count * job / numJobs),
+                                      NULL, CJob::PRIORITY_HIGH);
+}
+
+bool CGUIFontTTFBase::TakeRasterizedGlyph(character_t letterAndStyle, Glyph &glyph)
+{
+  if (!m_rasterRun)
+    return false;
+
+  const std::vector<character_t> &letters = m_rasterRun->letters;
+  auto it = std::lower_bound(letters.begin(), letters.end(), letterAndStyle);
+  if (it == letters.end() || *it != letterAndStyle)
+    return false;
+
+  size_t i = it - letters.begin();
+  if (m_rasterRun->states[i] == RasterRun::DONE)
+  {
+    glyph = std::move(m_rasterRun->glyphs[i]);
+    m_rasterRun->states[i] = RasterRun::CLAIMED;
+    return true;
+  }
+
+  // nobody needs to start on it anymore, a job already on it is finished with
+  // rather than waited for
+  m_rasterRun->Claim(i);
+  return false;
+}
+
+void CGUIFontTTFBase::FinishRasterRun()
+{
+  if (!m_rasterRun)
+    return;
+
+  // keep what the jobs have done so far, the rest is rasterised when it's needed
+  m_rasterRun->cancelled = true;
+  for (size_t i = 0; i < m_rasterRun->letters.size(); i++)
+  {
+    int low;
+    if (m_rasterRun->states[i] == RasterRun::DONE && !FindCharacter(m_rasterRun->letters[i], low))
+      AddCharacter(m_rasterRun->glyphs[i], m_rasterRun->letters[i], low);
+  }
+  m_rasterRun.reset();
+}
+
+bool CGUIFontTTFBase::RasterizeGlyph(FT_Face face, FT_Stroker stroker, wchar_t letter, uint32_t style, Glyph &result)
+{
+  int glyph_index = FT_Get_Char_Index( face, letter );
 
   FT_Glyph glyph = NULL;
-  if (FT_Load_Glyph( m_face, glyph_index, FT_LOAD_TARGET_LIGHT ))
+  if (FT_Load_Glyph( face, glyph_index, FT_LOAD_TARGET_LIGHT ))
   {
     CLog::Log(LOGDEBUG, "%s Failed to load glyph %x", __FUNCTION__, letter);
     return false;
   }
   // make bold if applicable
   if (style & FONT_STYLE_BOLD)
-    SetGlyphStrength(m_face->glyph, GLYPH_STRENGTH_BOLD);
+    SetGlyphStrength(face, face->glyph, GLYPH_STRENGTH_BOLD);
   // and italics if applicable
   if (style & FONT_STYLE_ITALICS)
-    ObliqueGlyph(m_face->glyph);
+    ObliqueGlyph(face->glyph);
   // and light if applicable
   if (style & FONT_STYLE_LIGHT)
-    SetGlyphStrength(m_face->glyph, GLYPH_STRENGTH_LIGHT);
+    SetGlyphStrength(face, face->glyph, GLYPH_STRENGTH_LIGHT);
   // grab the glyph
-  if (FT_Get_Glyph(m_face->glyph, &glyph))
+  if (FT_Get_Glyph(face->glyph, &glyph))
   {
     CLog::Log(LOGDEBUG, "%s Failed to get glyph %x", __FUNCTION__, letter);
     return false;
   }
-  if (m_stroker)
-    FT_Glyph_StrokeBorder(&glyph, m_stroker, 0, 1);
+  if (stroker)
+    FT_Glyph_StrokeBorder(&glyph, stroker, 0, 1);
   // render the glyph
   if (FT_Glyph_To_Bitmap(&glyph, FT_RENDER_MODE_NORMAL, NULL, 1))
   {
@@ -731,21 +1032,38 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   }
   FT_BitmapGlyph bitGlyph = (FT_BitmapGlyph)glyph;
   FT_Bitmap bitmap = bitGlyph->bitmap;
-  bool isEmptyGlyph = (bitmap.width == 0 || bitmap.rows == 0);
+
+  result.left = bitGlyph->left;
+  result.top = bitGlyph->top;
+  result.width = bitmap.width;
+  result.rows = bitmap.rows;
+  result.advance = (float)MathUtils::round_int( (float)face->glyph->advance.x / 64 );
+  result.pixels.resize(result.width * result.rows);
+  for (unsigned int y = 0; y < result.rows; y++)
+    memcpy(&result.pixels[y * result.width], bitmap.buffer + y * bitmap.pitch, result.width);
+
+  // free the glyph
+  FT_Done_Glyph(glyph);
+
+  return true;
+}
+
+bool CGUIFontTTFBase::CacheCharacter(const Glyph &glyph, character_t letterAndStyle, Character *ch)
+{
+  bool isEmptyGlyph = (glyph.width == 0 || glyph.rows == 0);
 
   if (!isEmptyGlyph)
   {
-    if (bitGlyph->left < 0)
-      m_posX += -bitGlyph->left;
+    if (glyph.left < 0)
+      m_posX += -glyph.left;
 
     // check we have enough room for the character.
-    // cast-fest is here to avoid warnings due to freeetype version differences (signedness of width).
-    if (static_cast<int>(m_posX + bitGlyph->left + bitmap.width) > static_cast<int>(m_textureWidth))
+    if (static_cast<int>(m_posX + glyph.left + glyph.width) > static_cast<int>(m_textureWidth))
     { // no space - gotta drop to the next line (which means creating a new texture and copying it across)
       m_posX = 0;
       m_posY += GetTextureLineHeight();
-      if (bitGlyph->left < 0)
-        m_posX += -bitGlyph->left;
+      if (glyph.left < 0)
+        m_posX += -glyph.left;
 
       if(m_posY + GetTextureLineHeight() >= m_textureHeight)
       {
@@ -755,7 +1073,6 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
         if (newHeight > CServiceBroker::GetRenderSystem().GetMaxTextureSize())
         {
           CLog::Log(LOGDEBUG, "%s: New cache texture is too large (%u > %u pixels long)", __FUNCTION__, newHeight, CServiceBroker::GetRenderSystem().GetMaxTextureSize());
-          FT_Done_Glyph(glyph);
           return false;
         }
 
@@ -763,7 +1080,6 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
         newTexture = ReallocTexture(newHeight);
         if(newTexture == NULL)
         {
-          FT_Done_Glyph(glyph);
           CLog::Log(LOGDEBUG, "%s: Failed to allocate new texture of height %u", __FUNCTION__, newHeight);
           return false;
         }
@@ -773,20 +1089,19 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
 
     if(m_texture == NULL)
     {
-      FT_Done_Glyph(glyph);
       CLog::Log(LOGDEBUG, "%s: no texture to cache character to", __FUNCTION__);
       return false;
     }
   }
   // set the character in our table
-  ch->letterAndStyle = (style << 16) | letter;
-  ch->offsetX = (short)bitGlyph->left;
-  ch->offsetY = (short)m_cellBaseLine - bitGlyph->top;
+  ch->letterAndStyle = letterAndStyle;
+  ch->offsetX = (short)glyph.left;
+  ch->offsetY = (short)m_cellBaseLine - glyph.top;
   ch->left = isEmptyGlyph ? 0 : ((float)m_posX + ch->offsetX);
   ch->top = isEmptyGlyph ? 0 : ((float)m_posY + ch->offsetY);
-  ch->right = ch->left + bitmap.width;
-  ch->bottom = ch->top + bitmap.rows;
-  ch->advance = (float)MathUtils::round_int( (float)m_face->glyph->advance.x / 64 );
+  ch->right = ch->left + glyph.width;
+  ch->bottom = ch->top + glyph.rows;
+  ch->advance = glyph.advance;
 
   // we need only render if we actually have some pixels
   if (!isEmptyGlyph)
@@ -794,17 +1109,14 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
     // ensure our rect will stay inside the texture (it *should* but we need to be certain)
     unsigned int x1 = std::max(m_posX + ch->offsetX, 0);
     unsigned int y1 = std::max(m_posY + ch->offsetY, 0);
-    unsigned int x2 = std::min(x1 + bitmap.width, m_textureWidth);
-    unsigned int y2 = std::min(y1 + bitmap.rows, m_textureHeight);
-    CopyCharToTexture(bitGlyph, x1, y1, x2, y2);
+    unsigned int x2 = std::min(x1 + glyph.width, m_textureWidth);
+    unsigned int y2 = std::min(y1 + glyph.rows, m_textureHeight);
+    CopyCharToTexture(glyph.pixels.data(), glyph.width, x1, y1, x2, y2);
   
     m_posX += spacing_between_characters_in_texture + (unsigned short)std::max(ch->right - ch->left + ch->offsetX, ch->advance);
   }
   m_numChars++;
 
-  // free the glyph
-  FT_Done_Glyph(glyph);
-
   return true;
 }
 
@@ -980,14 +1292,14 @@ void CGUIFontTTFBase::ObliqueGlyph(FT_GlyphSlot slot)
 
 
 // Embolden code - original taken from freetype2 (ftsynth.c)
-void CGUIFontTTFBase::SetGlyphStrength(FT_GlyphSlot slot, int glyphStrength)
+void CGUIFontTTFBase::SetGlyphStrength(FT_Face face, FT_GlyphSlot slot, int glyphStrength)
 {
   if ( slot->format != FT_GLYPH_FORMAT_OUTLINE )
     return;
 
   /* some reasonable strength */
-  FT_Pos strength = FT_MulFix( m_face->units_per_EM,
-                    m_face->size->metrics.y_scale ) / glyphStrength;
+  FT_Pos strength = FT_MulFix( face->units_per_EM,
+                    face->size->metrics.y_scale ) / glyphStrength;
 
   FT_BBox bbox_before, bbox_after;
   FT_Outline_Get_CBox( &slot->outline, &bbox_before );
@@ -27,6 +27,7 @@
  *
  */
 
+#include <memory>
 #include <string>
 #include <stdint.h>
 #include <vector>
@@ -49,13 +50,11 @@ class CBaseTexture;
 struct FT_FaceRec_;
 struct FT_LibraryRec_;
 struct FT_GlyphSlotRec_;
-struct FT_BitmapGlyphRec_;
 struct FT_StrokerRec_;
 
 typedef struct FT_FaceRec_ *FT_Face;
 typedef struct FT_LibraryRec_ *FT_Library;
 typedef struct FT_GlyphSlotRec_ *FT_GlyphSlot;
-typedef struct FT_BitmapGlyphRec_ *FT_BitmapGlyph;
 typedef struct FT_StrokerRec_ *FT_Stroker;
 
 typedef uint32_t character_t;
@@ -112,9 +111,22 @@ protected:
     float advance;
     character_t letterAndStyle;
   };
+  /*!
+   \brief A rasterised glyph, not yet copied into the texture
+   */
+  struct Glyph
+  {
+    int left, top;
+    unsigned int width, rows;
+    float advance;
+    std::vector<unsigned char> pixels; ///< 8bit alpha, width bytes per row
+  };
+
   void AddReference();
   void RemoveReference();
 
+  void PrepareCharacters(vecText::const_iterator start, vecText::const_iterator end);
+
   float GetTextWidthInternal(vecText::const_iterator start, vecText::const_iterator end);
   float GetCharWidthInternal(character_t ch);
   float GetTextHeight(float lineSpacing, int numLines) const;
@@ -130,16 +142,19 @@ protected:
 
   // Stuff for pre-rendering for speed
   inline Character *GetCharacter(character_t letter);
-  bool CacheCharacter(wchar_t letter, uint32_t style, Character *ch);
+  Character *FindCharacter(character_t letterAndStyle, int &low);
+  Character *AddCharacter(const Glyph &glyph, character_t letterAndStyle, int low);
+  bool CacheCharacter(const Glyph &glyph, character_t letterAndStyle, Character *ch);
   void RenderCharacter(float posX, float posY, const Character *ch, color_t color, bool roundX, std::vector<SVertex> &vertices);
   void ClearCharacterCache();
 
   virtual CBaseTexture* ReallocTexture(unsigned int& newHeight) = 0;
-  virtual bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) = 0;
+  virtual bool CopyCharToTexture(const unsigned char *pixels, unsigned int pitch, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) = 0;
   virtual void DeleteHardwareTexture() = 0;
 
-  // modifying glyphs
-  void SetGlyphStrength(FT_GlyphSlot slot, int glyphStrength);
+  // rasterising and modifying glyphs
+  static bool RasterizeGlyph(FT_Face face, FT_Stroker stroker, wchar_t letter, uint32_t style, Glyph &glyph);
+  static void SetGlyphStrength(FT_Face face, FT_GlyphSlot slot, int glyphStrength);
   static void ObliqueGlyph(FT_GlyphSlot slot);
 
   CBaseTexture* m_texture;        // texture that holds our rendered characters (8bit alpha only)
@@ -172,6 +187,22 @@ protected:
   // freetype stuff
   FT_Face    m_face;
   FT_Stroker m_stroker;
+  long       m_borderStrength;
+
+  /*! \brief Glyphs of new text rasterised by jobs while the text is laid out
+   Jobs and GetCharacter() claim glyphs as they get to them, so neither waits
+   for the other. GetCharacter() takes the glyphs jobs have finished and
+   rasterises the others itself.
+   */
+  class CRasterFaces;
+  class CRasterJob;
+  struct RasterRun;
+  bool TakeRasterizedGlyph(character_t letterAndStyle, Glyph &glyph);
+  void FinishRasterRun();
+
+  std::shared_ptr<RasterRun> m_rasterRun;
+  std::shared_ptr<CRasterFaces> m_rasterFaces;
+  float m_aspect;
 
   float m_originX;
   float m_originY;
@@ -194,7 +225,7 @@ protected:
   float    m_textureScaleY;
 
   std::string m_strFileName;
-  XUTILS::auto_buffer m_fontFileInMemory; // used only in some cases, see CFreeTypeLibrary::GetFont()
+  std::shared_ptr<XUTILS::auto_buffer> m_fontFileInMemory; // used only in some cases, see CFreeTypeLibrary::GetFont(), shared with m_rasterFaces
 
   CGUIFontCache<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue> m_staticCache;
   CGUIFontCache<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue> m_dynamicCache;
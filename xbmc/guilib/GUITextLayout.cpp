@@ -253,6 +253,12 @@ void CGUITextLayout::UpdateStyled(const vecText &text, const vecColors &colors,
   m_lines.clear();
   m_colors = colors;
 
+  // get new glyphs rasterised in one go rather than one by one while measuring
+  if (m_font)
+    m_font->PrepareText(text);
+  if (m_borderFont)
+    m_borderFont->PrepareText(text);
+
   // if we need to wrap the text, then do so
   if (m_wrap && maxWidth > 0)
     WrapText(text, maxWidth);
@@ -25,6 +25,8 @@
 #include "utils/MathUtils.h"
 #include "utils/StringUtils.h"
 
+unsigned int CGUITextureBase::m_drawCount = 0;
+
 CTextureInfo::CTextureInfo()
 {
   orientation = 0;
@@ -247,6 +249,8 @@ void CGUITextureBase::Render(float left, float top, float right, float bottom, f
 
   int orientation = GetOrientation();
   OrientateTexture(texture, u3, v3, orientation);
+  if (m_texture.m_inAtlas)
+    texture += GetAtlasOffset(m_texture);
 
   if (m_diffuse.size())
   {
@@ -256,6 +260,8 @@ void CGUITextureBase::Render(float left, float top, float right, float bottom, f
     diffuse.y1 *= m_diffuseScaleV / v3; diffuse.y2 *= m_diffuseScaleV / v3;
     diffuse += m_diffuseOffset;
     OrientateTexture(diffuse, m_diffuseU, m_diffuseV, m_info.orientation);
+    if (m_diffuse.m_inAtlas)
+      diffuse += GetAtlasOffset(m_diffuse);
   }
 
   float x[4], y[4], z[4];
@@ -283,6 +289,13 @@ void CGUITextureBase::Render(float left, float top, float right, float bottom, f
   Draw(x, y, z, texture, diffuse, orientation);
 }
 
+CPoint CGUITextureBase::GetAtlasOffset(const CTextureArray &texture)
+{
+  if (texture.m_texCoordsArePixels)
+    return CPoint((float)texture.m_texOffsetX, (float)texture.m_texOffsetY);
+  return CPoint((float)texture.m_texOffsetX / texture.m_texWidth, (float)texture.m_texOffsetY / texture.m_texHeight);
+}
+
 bool CGUITextureBase::AllocResources()
 {
   if (m_info.filename.empty())
@@ -122,6 +122,17 @@ public:
   bool IsAllocated() const { return m_isAllocated != NO; };
   bool FailedToAlloc() const { return m_isAllocated == NORMAL_FAILED || m_isAllocated == LARGE_FAILED; };
   bool ReadyToRender() const;
+
+  /*! \brief Draw consecutive textures sharing the same texture and state at once
+   Between BeginBatch() and EndBatch() textures may defer drawing until the state changes.
+   Only renderers supporting it batch, see CGUITextureGL.
+   */
+  static void BeginBatch() {};
+  static void EndBatch() {};
+
+  /*! \brief Number of draw calls issued for textures so far, for debugging
+   */
+  static unsigned int GetDrawCount() { return m_drawCount; };
 protected:
   bool CalculateSize();
   void LoadDiffuseImage();
@@ -129,6 +140,7 @@ protected:
   bool UpdateAnimFrame(unsigned int currentTime);
   void Render(float left, float top, float bottom, float right, float u1, float v1, float u2, float v2, float u3, float v3);
   static void OrientateTexture(CRect &rect, float width, float height, int orientation);
+  static CPoint GetAtlasOffset(const CTextureArray &texture);
   void ResetAnimState();
 
   // functions that our implementation classes handle
@@ -172,6 +184,8 @@ protected:
 
   CTextureArray m_diffuse;
   CTextureArray m_texture;
+
+  static unsigned int m_drawCount;
 };
 
 
@@ -129,6 +129,7 @@ void CGUITextureD3D::Draw(float *x, float *y, float *z, const CRect &texture, co
     pGUIShader->SetShaderViews(1, &resource);
   }
   pGUIShader->DrawQuad(verts[0], verts[1], verts[2], verts[3]);
+  m_drawCount++;
 }
 
 void CGUITextureD3D::DrawQuad(const CRect &rect, color_t color, CBaseTexture *texture, const CRect *texCoords)
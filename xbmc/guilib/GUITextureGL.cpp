@@ -26,25 +26,24 @@
 #include "utils/GLUtils.h"
 #include "guilib/Geometry.h"
 #include "rendering/gl/RenderSystemGL.h"
+#include "settings/AdvancedSettings.h"
 #include "windowing/WinSystem.h"
 
 #define BUFFER_OFFSET(i) ((char *)NULL + (i))
 
+CGUITextureGL::Batch CGUITextureGL::m_batch;
+
 CGUITextureGL::CGUITextureGL(float posX, float posY, float width, float height, const CTextureInfo &texture)
 : CGUITextureBase(posX, posY, width, height, texture)
 {
   memset(m_col, 0, sizeof(m_col));
+  m_batched = false;
   m_renderSystem = dynamic_cast<CRenderSystemGL*>(&CServiceBroker::GetRenderSystem());
 }
 
 void CGUITextureGL::Begin(color_t color)
 {
   CBaseTexture* texture = m_texture.m_textures[m_currentFrame];
-  texture->LoadToGPU();
-  if (m_diffuse.size())
-    m_diffuse.m_textures[0]->LoadToGPU();
-
-  texture->BindToUnit(0);
 
   // Setup Colors
   m_col[0] = (GLubyte)GET_R(color);
@@ -59,34 +58,39 @@ void CGUITextureGL::Begin(color_t color)
     m_col[2] = (235 - 16) * m_col[2] / 255 + 16.0f / 255.0f;
   }
 
-  bool hasAlpha = m_texture.m_textures[m_currentFrame]->HasAlpha() || m_col[3] < 255;
-
+  bool hasAlpha = texture->HasAlpha() || m_col[3] < 255;
+  bool opaqueWhite = m_col[0] == 255 && m_col[1] == 255 && m_col[2] == 255 && m_col[3] == 255;
+  ESHADERMETHOD shader;
   if (m_diffuse.size())
   {
-    if (m_col[0] == 255 && m_col[1] == 255 && m_col[2] == 255 && m_col[3] == 255 )
-    {
-      m_renderSystem->EnableShader(SM_MULTI);
-    }
-    else
-    {
-      m_renderSystem->EnableShader(SM_MULTI_BLENDCOLOR);
-    }
-
+    shader = opaqueWhite ? SM_MULTI : SM_MULTI_BLENDCOLOR;
     hasAlpha |= m_diffuse.m_textures[0]->HasAlpha();
-
-    m_diffuse.m_textures[0]->BindToUnit(1);
   }
   else
+    shader = opaqueWhite ? SM_TEXTURE_NOBLEND : SM_TEXTURE;
+
+  m_packedVertices.clear();
+  m_idx.clear();
+
+  m_batched = m_batch.depth > 0 && !m_diffuse.size() && g_advancedSettings.m_guiTextureAtlas;
+  if (m_batched && m_batch.active && m_batch.texture == texture && m_batch.shader == shader &&
+      m_batch.hasAlpha == hasAlpha && memcmp(m_batch.col, m_col, sizeof(m_col)) == 0)
   {
-    if (m_col[0] == 255 && m_col[1] == 255 && m_col[2] == 255 && m_col[3] == 255)
-    {
-      m_renderSystem->EnableShader(SM_TEXTURE_NOBLEND);
-    }
-    else
-    {
-      m_renderSystem->EnableShader(SM_TEXTURE);
-    }
+    // an atlas page may have grown since the batch started
+    texture->LoadToGPU();
+    return;
   }
+  FlushBatch();
+
+  texture->LoadToGPU();
+  if (m_diffuse.size())
+    m_diffuse.m_textures[0]->LoadToGPU();
+
+  texture->BindToUnit(0);
+  m_renderSystem->EnableShader(shader);
+
+  if (m_diffuse.size())
+    m_diffuse.m_textures[0]->BindToUnit(1);
 
   if (hasAlpha)
   {
@@ -97,65 +101,124 @@ void CGUITextureGL::Begin(color_t color)
   {
     glDisable(GL_BLEND);
   }
-  m_packedVertices.clear();
-  m_idx.clear();
+
+  if (m_batched)
+  {
+    m_batch.active = true;
+    m_batch.texture = texture;
+    m_batch.shader = shader;
+    memcpy(m_batch.col, m_col, sizeof(m_col));
+    m_batch.hasAlpha = hasAlpha;
+  }
 }
 
 void CGUITextureGL::End()
 {
+  if (m_batched)
+  {
+    // indices are 16 bit
+    if (m_batch.vertices.size() + m_packedVertices.size() > 65536)
+    {
+      DrawVertices(m_renderSystem, m_batch.vertices, m_batch.indices, m_batch.col, false);
+      m_batch.vertices.clear();
+      m_batch.indices.clear();
+    }
+
+    GLushort first = m_batch.vertices.size();
+    m_batch.vertices.insert(m_batch.vertices.end(), m_packedVertices.begin(), m_packedVertices.end());
+    for (GLushort index : m_idx)
+      m_batch.indices.push_back(first + index);
+    return;
+  }
+
   if (m_packedVertices.size())
+    DrawVertices(m_renderSystem, m_packedVertices, m_idx, m_col, m_diffuse.size() > 0);
+
+  if (m_diffuse.size())
+    glActiveTexture(GL_TEXTURE0);
+  glEnable(GL_BLEND);
+
+  m_renderSystem->DisableShader();
+}
+
+void CGUITextureGL::DrawVertices(CRenderSystemGL *renderSystem, const std::vector<PackedVertex> &vertices,
+                                 const std::vector<GLushort> &indices, const GLubyte *col, bool diffuse)
+{
+  GLint posLoc  = renderSystem->ShaderGetPos();
+  GLint tex0Loc = renderSystem->ShaderGetCoord0();
+  GLint tex1Loc = renderSystem->ShaderGetCoord1();
+  GLint uniColLoc = renderSystem->ShaderGetUniCol();
+
+  GLuint VertexVBO;
+  GLuint IndexVBO;
+
+  glGenBuffers(1, &VertexVBO);
+  glBindBuffer(GL_ARRAY_BUFFER, VertexVBO);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(PackedVertex)*vertices.size(), &vertices[0], GL_STATIC_DRAW);
+
+  if (uniColLoc >= 0)
   {
-    GLint posLoc  = m_renderSystem->ShaderGetPos();
-    GLint tex0Loc = m_renderSystem->ShaderGetCoord0();
-    GLint tex1Loc = m_renderSystem->ShaderGetCoord1();
-    GLint uniColLoc = m_renderSystem->ShaderGetUniCol();
+    glUniform4f(uniColLoc,(col[0] / 255.0f), (col[1] / 255.0f), (col[2] / 255.0f), (col[3] / 255.0f));
+  }
 
-    GLuint VertexVBO;
-    GLuint IndexVBO;
+  if (diffuse)
+  {
+    glVertexAttribPointer(tex1Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), BUFFER_OFFSET(offsetof(PackedVertex, u2)));
+    glEnableVertexAttribArray(tex1Loc);
+  }
 
-    glGenBuffers(1, &VertexVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VertexVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(PackedVertex)*m_packedVertices.size(), &m_packedVertices[0], GL_STATIC_DRAW);
+  glVertexAttribPointer(posLoc, 3, GL_FLOAT, 0, sizeof(PackedVertex), BUFFER_OFFSET(offsetof(PackedVertex, x)));
+  glEnableVertexAttribArray(posLoc);
+  glVertexAttribPointer(tex0Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), BUFFER_OFFSET(offsetof(PackedVertex, u1)));
+  glEnableVertexAttribArray(tex0Loc);
 
-    if (uniColLoc >= 0)
-    {
-      glUniform4f(uniColLoc,(m_col[0] / 255.0f), (m_col[1] / 255.0f), (m_col[2] / 255.0f), (m_col[3] / 255.0f));
-    }
+  glGenBuffers(1, &IndexVBO);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IndexVBO);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(ushort)*indices.size(), indices.data(), GL_STATIC_DRAW);
 
-    if (m_diffuse.size())
-    {
-      glVertexAttribPointer(tex1Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), BUFFER_OFFSET(offsetof(PackedVertex, u2)));
-      glEnableVertexAttribArray(tex1Loc);
-    }
+  glDrawElements(GL_TRIANGLES, vertices.size()*6 / 4, GL_UNSIGNED_SHORT, 0);
+  m_drawCount++;
 
-    glVertexAttribPointer(posLoc, 3, GL_FLOAT, 0, sizeof(PackedVertex), BUFFER_OFFSET(offsetof(PackedVertex, x)));
-    glEnableVertexAttribArray(posLoc);
-    glVertexAttribPointer(tex0Loc, 2, GL_FLOAT, 0, sizeof(PackedVertex), BUFFER_OFFSET(offsetof(PackedVertex, u1)));
-    glEnableVertexAttribArray(tex0Loc);
+  if (diffuse)
+    glDisableVertexAttribArray(tex1Loc);
 
-    glGenBuffers(1, &IndexVBO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IndexVBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(ushort)*m_idx.size(), m_idx.data(), GL_STATIC_DRAW);
+  glDisableVertexAttribArray(posLoc);
+  glDisableVertexAttribArray(tex0Loc);
 
-    glDrawElements(GL_TRIANGLES, m_packedVertices.size()*6 / 4, GL_UNSIGNED_SHORT, 0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+  glDeleteBuffers(1, &VertexVBO);
+  glDeleteBuffers(1, &IndexVBO);
+}
 
-    if (m_diffuse.size())
-      glDisableVertexAttribArray(tex1Loc);
+void CGUITextureGL::BeginBatch()
+{
+  m_batch.depth++;
+}
 
-    glDisableVertexAttribArray(posLoc);
-    glDisableVertexAttribArray(tex0Loc);
+void CGUITextureGL::EndBatch()
+{
+  if (m_batch.depth > 0 && --m_batch.depth == 0)
+    FlushBatch();
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-    glDeleteBuffers(1, &VertexVBO);
-    glDeleteBuffers(1, &IndexVBO);
-  }
+void CGUITextureGL::FlushBatch()
+{
+  if (!m_batch.active)
+    return;
 
-  if (m_diffuse.size())
-    glActiveTexture(GL_TEXTURE0);
-  glEnable(GL_BLEND);
+  // reset first, the render system calls back into here when the shader is changed
+  m_batch.active = false;
+  m_batch.texture = nullptr;
 
-  m_renderSystem->DisableShader();
+  CRenderSystemGL *renderSystem = dynamic_cast<CRenderSystemGL*>(&CServiceBroker::GetRenderSystem());
+  if (!m_batch.vertices.empty())
+    DrawVertices(renderSystem, m_batch.vertices, m_batch.indices, m_batch.col, false);
+  m_batch.vertices.clear();
+  m_batch.indices.clear();
+
+  glEnable(GL_BLEND);
+  renderSystem->DisableShader();
 }
 
 void CGUITextureGL::Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation)
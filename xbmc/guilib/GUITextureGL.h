@@ -32,14 +32,20 @@ public:
   CGUITextureGL(float posX, float posY, float width, float height, const CTextureInfo& texture);
   static void DrawQuad(const CRect &coords, color_t color, CBaseTexture *texture = NULL, const CRect *texCoords = NULL);
 
+  static void BeginBatch();
+  static void EndBatch();
+
+  /*! \brief Draw the quads collected in the current batch
+   Called by the render system before any state the batch depends on changes.
+   */
+  static void FlushBatch();
+
 protected:
   void Begin(color_t color) override;
   void Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation) override;
   void End() override;
 
 private:
-  GLubyte m_col[4];
-
   struct PackedVertex
   {
     float x, y, z;
@@ -47,8 +53,30 @@ private:
     float u2, v2;
   };
 
+  static void DrawVertices(CRenderSystemGL *renderSystem, const std::vector<PackedVertex> &vertices,
+                           const std::vector<GLushort> &indices, const GLubyte *col, bool diffuse);
+
+  GLubyte m_col[4];
+  bool m_batched;
+
   std::vector<PackedVertex> m_packedVertices;
   std::vector<GLushort> m_idx;
   CRenderSystemGL *m_renderSystem;
+
+  /*! \brief Quads of consecutive textures drawn with the same texture and state
+   While active the shader and blending of the batch are set up.
+   */
+  struct Batch
+  {
+    unsigned int depth = 0;
+    bool active = false;
+    CBaseTexture *texture = nullptr;
+    int shader = 0;
+    GLubyte col[4];
+    bool hasAlpha = false;
+    std::vector<PackedVertex> vertices;
+    std::vector<GLushort> indices;
+  };
+  static Batch m_batch;
 };
 
@@ -120,6 +120,7 @@ void CGUITextureGLES::End()
     glEnableVertexAttribArray(tex0Loc);
 
     glDrawElements(GL_TRIANGLES, m_packedVertices.size()*6 / 4, GL_UNSIGNED_SHORT, m_idx.data());
+    m_drawCount++;
 
     if (m_diffuse.size())
       glDisableVertexAttribArray(tex1Loc);
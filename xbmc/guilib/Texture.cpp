@@ -40,6 +40,8 @@
 #endif
 #include "rendering/RenderSystem.h"
 
+#include <utility>
+
 /************************************************************************/
 /*                                                                      */
 /************************************************************************/
@@ -54,11 +56,52 @@ CBaseTexture::CBaseTexture(unsigned int width, unsigned int height, unsigned int
 
 CBaseTexture::~CBaseTexture()
 {
-  _aligned_free(m_pixels);
+  FreePixels();
+}
+
+void CBaseTexture::FreePixels()
+{
+  if (m_pixelsOwner)
+    m_pixelsOwner.reset();
+  else
+    _aligned_free(m_pixels);
   m_pixels = NULL;
 }
 
+void CBaseTexture::OwnPixels()
+{
+  // borrowed pixels are read only, take a copy before changing them
+  if (!m_pixelsOwner)
+    return;
+
+  size_t size = GetPitch() * GetRows();
+  unsigned char *pixels = (unsigned char*) _aligned_malloc(size, 32);
+  if (pixels)
+    memcpy(pixels, m_pixels, size);
+  else
+    CLog::Log(LOGERROR, "%s - Could not allocate %zu bytes. Out of memory.", __FUNCTION__, size);
+  m_pixelsOwner.reset();
+  m_pixels = pixels;
+}
+
 void CBaseTexture::Allocate(unsigned int width, unsigned int height, unsigned int format)
+{
+  SetSize(width, height, format);
+
+  FreePixels();
+  if (GetPitch() * GetRows() > 0)
+  {
+    size_t size = GetPitch() * GetRows();
+    m_pixels = (unsigned char*) _aligned_malloc(size, 32);
+
+    if (m_pixels == nullptr)
+    {
+      CLog::Log(LOGERROR, "%s - Could not allocate %zu bytes. Out of memory.", __FUNCTION__, size);
+    }
+  }
+}
+
+void CBaseTexture::SetSize(unsigned int width, unsigned int height, unsigned int format)
 {
   m_imageWidth = m_originalWidth = width;
   m_imageHeight = m_originalHeight = height;
@@ -103,19 +146,6 @@ void CBaseTexture::Allocate(unsigned int width, unsigned int height, unsigned in
   CLAMP(m_textureHeight, CServiceBroker::GetRenderSystem().GetMaxTextureSize());
   CLAMP(m_imageWidth, m_textureWidth);
   CLAMP(m_imageHeight, m_textureHeight);
-
-  _aligned_free(m_pixels);
-  m_pixels = NULL;
-  if (GetPitch() * GetRows() > 0)
-  {
-    size_t size = GetPitch() * GetRows();
-    m_pixels = (unsigned char*) _aligned_malloc(size, 32);
-
-    if (m_pixels == nullptr)
-    {
-      CLog::Log(LOGERROR, "%s - Could not allocate %zu bytes. Out of memory.", __FUNCTION__, size);
-    }
-  }
 }
 
 void CBaseTexture::Update(unsigned int width, unsigned int height, unsigned int pitch, unsigned int format, const unsigned char *pixels, bool loadToGPU)
@@ -155,6 +185,34 @@ void CBaseTexture::Update(unsigned int width, unsigned int height, unsigned int
     LoadToGPU();
 }
 
+void CBaseTexture::UpdateRegion(unsigned int x, unsigned int y, unsigned int width, unsigned int height, unsigned int pitch, const unsigned char *pixels)
+{
+  if (pixels == nullptr || m_format != XB_FMT_A8R8G8B8 ||
+      x + width > m_textureWidth || y + height > m_textureHeight)
+    return;
+
+  unsigned int rowSize = width * 4;
+  OwnPixels();
+  if (m_pixels)
+  {
+    for (unsigned int row = 0; row < height; row++)
+      memcpy(m_pixels + (y + row) * GetPitch() + x * 4, pixels + row * pitch, rowSize);
+  }
+
+  if (m_loadedToGPU)
+  {
+    Region region;
+    region.x = x;
+    region.y = y;
+    region.width = width;
+    region.height = height;
+    region.pixels.resize(rowSize * height);
+    for (unsigned int row = 0; row < height; row++)
+      memcpy(&region.pixels[row * rowSize], pixels + row * pitch, rowSize);
+    m_dirtyRegions.push_back(std::move(region));
+  }
+}
+
 void CBaseTexture::ClampToEdge()
 {
   if (m_pixels == nullptr)
@@ -345,6 +403,24 @@ bool CBaseTexture::LoadFromMemory(unsigned int width, unsigned int height, unsig
   return true;
 }
 
+bool CBaseTexture::LoadFromSharedMemory(unsigned int width, unsigned int height, unsigned int format, bool hasAlpha,
+                                        const unsigned char* pixels, std::shared_ptr<const void> owner)
+{
+  if (pixels == NULL)
+    return false;
+
+  FreePixels();
+  SetSize(width, height, format);
+  if (m_textureWidth != width || m_textureHeight != height ||
+      ((format & XB_FMT_DXT_MASK) && !CServiceBroker::GetRenderSystem().SupportsDXT()))
+    return LoadFromMemory(width, height, 0, format, hasAlpha, pixels);
+
+  m_hasAlpha = hasAlpha;
+  m_pixels = const_cast<unsigned char*>(pixels);
+  m_pixelsOwner = std::move(owner);
+  return true;
+}
+
 bool CBaseTexture::LoadPaletted(unsigned int width, unsigned int height, unsigned int pitch, unsigned int format, const unsigned char *pixels, const COLOR *palette)
 {
   if (pixels == NULL || palette == NULL)
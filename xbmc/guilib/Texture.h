@@ -27,6 +27,9 @@
 #include "linux/XMemUtils.h"
 #endif
 
+#include <memory>
+#include <vector>
+
 #pragma pack(1)
 struct COLOR {unsigned char b,g,r,x;};	// Windows GDI expects 4bytes per color
 #pragma pack()
@@ -80,6 +83,15 @@ public:
                                             unsigned int idealWidth = 0, unsigned int idealHeight = 0);
 
   bool LoadFromMemory(unsigned int width, unsigned int height, unsigned int pitch, unsigned int format, bool hasAlpha, const unsigned char* pixels);
+
+  /*! \brief Load a texture from pixels owned by someone else without copying them
+   The pixels are uploaded from where they are and are never modified, owner is held until they
+   have been uploaded. If the texture needs them padded they are copied as LoadFromMemory() does.
+   \param pixels the image, laid out as the texture stores it
+   \param owner keeps pixels valid
+   */
+  bool LoadFromSharedMemory(unsigned int width, unsigned int height, unsigned int format, bool hasAlpha,
+                            const unsigned char* pixels, std::shared_ptr<const void> owner);
   bool LoadPaletted(unsigned int width, unsigned int height, unsigned int pitch, unsigned int format, const unsigned char *pixels, const COLOR *palette);
 
   bool HasAlpha() const;
@@ -107,11 +119,23 @@ public:
   unsigned int GetOriginalWidth() const { return m_originalWidth; }
   /*! \brief return the original height of the image, before scaling/cropping */
   unsigned int GetOriginalHeight() const { return m_originalHeight; }
+  unsigned int GetFormat() const { return m_format; }
 
   int GetOrientation() const { return m_orientation; }
   void SetOrientation(int orientation) { m_orientation = orientation; }
 
   void Update(unsigned int width, unsigned int height, unsigned int pitch, unsigned int format, const unsigned char *pixels, bool loadToGPU);
+
+  /*! \brief Replace part of an A8R8G8B8 texture
+   Once the texture is on the GPU only the region is uploaded, by the next call to LoadToGPU().
+   \param x left edge of the region within the texture
+   \param y top edge of the region within the texture
+   \param width width of the region
+   \param height height of the region
+   \param pitch bytes per row of pixels
+   \param pixels the new pixels of the region
+   */
+  void UpdateRegion(unsigned int x, unsigned int y, unsigned int width, unsigned int height, unsigned int pitch, const unsigned char *pixels);
   void Allocate(unsigned int width, unsigned int height, unsigned int format);
   void ClampToEdge();
 
@@ -127,11 +151,24 @@ protected:
                          unsigned int maxWidth, unsigned int maxHeight);
   bool LoadFromFileInternal(const std::string& texturePath, unsigned int maxWidth, unsigned int maxHeight, bool requirePixels, const std::string& strMimeType = "");
   bool LoadIImage(IImage* pImage, unsigned char* buffer, unsigned int bufSize, unsigned int width, unsigned int height);
+  void SetSize(unsigned int width, unsigned int height, unsigned int format);
+  void FreePixels();
+  void OwnPixels();
+
   // helpers for computation of texture parameters for compressed textures
   unsigned int GetPitch(unsigned int width) const;
   unsigned int GetRows(unsigned int height) const;
   unsigned int GetBlockSize() const;
 
+  struct Region
+  {
+    unsigned int x;
+    unsigned int y;
+    unsigned int width;
+    unsigned int height;
+    std::vector<unsigned char> pixels; ///< rows of width * 4 bytes
+  };
+
   unsigned int m_imageWidth;
   unsigned int m_imageHeight;
   unsigned int m_textureWidth;
@@ -140,6 +177,7 @@ protected:
   unsigned int m_originalHeight;  ///< original image height before scaling or cropping
 
   unsigned char* m_pixels;
+  std::shared_ptr<const void> m_pixelsOwner; ///< set if m_pixels are borrowed, they are read only then
   bool m_loadedToGPU;
   unsigned int m_format;
   int m_orientation;
@@ -147,6 +185,7 @@ protected:
   bool m_mipmapping;
   TEXTURE_SCALING m_scalingMethod = TEXTURE_SCALING::LINEAR;
   bool m_bCacheMemory = false;
+  std::vector<Region> m_dirtyRegions; ///< regions updated since the texture was loaded to the GPU
 };
 
 #if defined(TARGET_RASPBERRY_PI)
@@ -0,0 +1,240 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TextureAtlas.h"
+#include "ServiceBroker.h"
+#include "Texture.h"
+#include "rendering/RenderSystem.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cstring>
+
+#define ATLAS_PAGE_SIZE       1024
+#define ATLAS_MAX_IMAGE_SIZE  256
+
+CTextureAtlas::~CTextureAtlas()
+{
+  for (const auto &page : m_pages)
+    delete page->texture;
+}
+
+bool CTextureAtlas::CanPack(const CBaseTexture *texture)
+{
+  // only plain ARGB can be copied around, and packing images without alpha
+  // would make the renderer blend them
+  return texture && texture->GetPixels() && texture->GetFormat() == XB_FMT_A8R8G8B8 &&
+         texture->GetWidth() > 0 && texture->GetWidth() <= ATLAS_MAX_IMAGE_SIZE &&
+         texture->GetHeight() > 0 && texture->GetHeight() <= ATLAS_MAX_IMAGE_SIZE &&
+         texture->HasAlpha() && !texture->IsMipmapped() && !texture->GetOrientation();
+}
+
+bool CTextureAtlas::Allocate(Page &page, unsigned int width, unsigned int height, unsigned int &x, unsigned int &y)
+{
+  if (!AllocateFree(page, width, height, x, y))
+  {
+    unsigned int shelfX = page.shelfX;
+    unsigned int shelfY = page.shelfY;
+    unsigned int shelfHeight = page.shelfHeight;
+    if (shelfX + width > page.size)
+    { // start a new shelf
+      shelfY += shelfHeight;
+      shelfX = 0;
+      shelfHeight = 0;
+    }
+    if (width > page.size || shelfY + height > page.size)
+      return false;
+
+    // leave room for the border
+    x = shelfX + 1;
+    y = shelfY + 1;
+
+    page.shelfX = shelfX + width;
+    page.shelfY = shelfY;
+    page.shelfHeight = std::max(shelfHeight, height);
+  }
+
+  page.images.push_back({ x - 1, y - 1, width, height });
+  return true;
+}
+
+bool CTextureAtlas::AllocateFree(Page &page, unsigned int width, unsigned int height, unsigned int &x, unsigned int &y)
+{
+  // take the smallest released rectangle the image fits into
+  auto best = page.free.end();
+  for (auto it = page.free.begin(); it != page.free.end(); ++it)
+  {
+    if (it->width >= width && it->height >= height &&
+        (best == page.free.end() || it->width * it->height < best->width * best->height))
+      best = it;
+  }
+  if (best == page.free.end())
+    return false;
+
+  Rect rect = *best;
+  page.free.erase(best);
+  x = rect.x + 1;
+  y = rect.y + 1;
+
+  // split the rest along the longer leftover edge, keeping the larger piece whole
+  if (rect.width - width > rect.height - height)
+  {
+    AddFree(page, { rect.x + width, rect.y, rect.width - width, rect.height });
+    AddFree(page, { rect.x, rect.y + height, width, rect.height - height });
+  }
+  else
+  {
+    AddFree(page, { rect.x + width, rect.y, rect.width - width, height });
+    AddFree(page, { rect.x, rect.y + height, rect.width, rect.height - height });
+  }
+  return true;
+}
+
+void CTextureAtlas::AddFree(Page &page, Rect rect)
+{
+  // slivers too small for any image with its border are dropped
+  if (rect.width < 3 || rect.height < 3)
+    return;
+
+  // join with released neighbours sharing a full edge, so freeing a run of
+  // images on a shelf makes room for a wider one
+  bool merged = true;
+  while (merged)
+  {
+    merged = false;
+    for (auto it = page.free.begin(); it != page.free.end(); ++it)
+    {
+      if (it->y == rect.y && it->height == rect.height &&
+          (it->x + it->width == rect.x || rect.x + rect.width == it->x))
+      {
+        rect.x = std::min(rect.x, it->x);
+        rect.width += it->width;
+      }
+      else if (it->x == rect.x && it->width == rect.width &&
+               (it->y + it->height == rect.y || rect.y + rect.height == it->y))
+      {
+        rect.y = std::min(rect.y, it->y);
+        rect.height += it->height;
+      }
+      else
+        continue;
+      page.free.erase(it);
+      merged = true;
+      break;
+    }
+  }
+  page.free.push_back(rect);
+}
+
+void CTextureAtlas::Copy(Page &page, const CBaseTexture *texture, unsigned int x, unsigned int y)
+{
+  // the image and its border are assembled here and uploaded as one region
+  unsigned int width = texture->GetWidth();
+  unsigned int height = texture->GetHeight();
+  unsigned int pitch = (width + 2) * 4;
+  std::vector<uint8_t> pixels(pitch * (height + 2));
+  const uint8_t *src = texture->GetPixels();
+
+  for (unsigned int row = 0; row < height; row++)
+  {
+    uint8_t *dst = &pixels[(row + 1) * pitch + 4];
+    memcpy(dst, src + row * texture->GetPitch(), width * 4);
+    memcpy(dst - 4, dst, 4);
+    memcpy(dst + width * 4, dst + (width - 1) * 4, 4);
+  }
+  memcpy(&pixels[0], &pixels[pitch], pitch);
+  memcpy(&pixels[(height + 1) * pitch], &pixels[height * pitch], pitch);
+
+  page.texture->UpdateRegion(x - 1, y - 1, width + 2, height + 2, pitch, pixels.data());
+}
+
+CBaseTexture* CTextureAtlas::Add(const CBaseTexture *texture, unsigned int &x, unsigned int &y)
+{
+  unsigned int width = texture->GetWidth() + 2;
+  unsigned int height = texture->GetHeight() + 2;
+
+  // images are loaded in the order a window draws them, keeping them on the
+  // page of the previous image lets the renderer batch them
+  if (m_lastPage < m_pages.size() && Allocate(*m_pages[m_lastPage], width, height, x, y))
+  {
+    Copy(*m_pages[m_lastPage], texture, x, y);
+    return m_pages[m_lastPage]->texture;
+  }
+  for (size_t i = 0; i < m_pages.size(); i++)
+  {
+    if (Allocate(*m_pages[i], width, height, x, y))
+    {
+      Copy(*m_pages[i], texture, x, y);
+      m_lastPage = i;
+      return m_pages[i]->texture;
+    }
+  }
+
+  std::unique_ptr<Page> page(new Page);
+  page->size = std::min((unsigned int)ATLAS_PAGE_SIZE, CServiceBroker::GetRenderSystem().GetMaxTextureSize());
+  page->shelfX = 0;
+  page->shelfY = 0;
+  page->shelfHeight = 0;
+  if (!Allocate(*page, width, height, x, y))
+    return NULL;
+
+  page->texture = new CTexture(page->size, page->size, XB_FMT_A8R8G8B8);
+  if (!page->texture->GetPixels())
+  {
+    delete page->texture;
+    return NULL;
+  }
+  memset(page->texture->GetPixels(), 0, page->texture->GetPitch() * page->texture->GetRows());
+
+  Copy(*page, texture, x, y);
+  m_pages.push_back(std::move(page));
+  m_lastPage = m_pages.size() - 1;
+
+  CLog::Log(LOGDEBUG, "CTextureAtlas::Add - created page %u", (unsigned int)m_pages.size());
+  return m_pages.back()->texture;
+}
+
+void CTextureAtlas::Release(const CBaseTexture *texture, unsigned int x, unsigned int y)
+{
+  for (auto it = m_pages.begin(); it != m_pages.end(); ++it)
+  {
+    Page &page = **it;
+    if (page.texture != texture)
+      continue;
+
+    for (auto image = page.images.begin(); image != page.images.end(); ++image)
+    {
+      if (image->x + 1 == x && image->y + 1 == y)
+      {
+        Rect rect = *image;
+        page.images.erase(image);
+        if (page.images.empty())
+        {
+          delete page.texture;
+          m_pages.erase(it);
+        }
+        else
+          AddFree(page, rect);
+        return;
+      }
+    }
+    return;
+  }
+}
@@ -0,0 +1,99 @@
+#pragma once
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+#include <vector>
+
+class CBaseTexture;
+
+/*!
+ \ingroup textures
+ \brief Packs small skin images into shared textures.
+
+ Images are placed on shelves of a page texture, with a one pixel border
+ repeating their edges so filtering never picks up a neighbour. Consecutive
+ images drawn from the same page share one texture binding, which lets the
+ renderer batch them, so a new image goes to the page of the previous one
+ when it fits. Space released by an image is reused for later images that fit
+ into it, a page is freed once all images packed into it are released. Only
+ the rectangle of a new image is uploaded to the page.
+ */
+class CTextureAtlas
+{
+public:
+  CTextureAtlas() = default;
+  ~CTextureAtlas();
+
+  /*!
+   \brief Whether the image is small enough and of a format that can be packed
+   */
+  static bool CanPack(const CBaseTexture *texture);
+
+  /*!
+   \brief Copy an image into a page
+   \param texture the image, must satisfy CanPack()
+   \param x [out] position of the image within the page
+   \param y [out] position of the image within the page
+   \return the page holding the image, NULL if it couldn't be packed
+   */
+  CBaseTexture* Add(const CBaseTexture *texture, unsigned int &x, unsigned int &y);
+
+  /*!
+   \brief Release an image previously packed into page
+   \param page the page returned by Add()
+   \param x position of the image returned by Add()
+   \param y position of the image returned by Add()
+   */
+  void Release(const CBaseTexture *page, unsigned int x, unsigned int y);
+
+  unsigned int GetPageCount() const { return m_pages.size(); }
+
+private:
+  CTextureAtlas(const CTextureAtlas&) = delete;
+  CTextureAtlas& operator=(const CTextureAtlas&) = delete;
+
+  struct Rect
+  {
+    unsigned int x;
+    unsigned int y;
+    unsigned int width;
+    unsigned int height;
+  };
+
+  struct Page
+  {
+    CBaseTexture *texture;
+    unsigned int size;
+    unsigned int shelfX;
+    unsigned int shelfY;
+    unsigned int shelfHeight;
+    std::vector<Rect> images;  ///< space taken by the packed images, including their border
+    std::vector<Rect> free;    ///< space released by images, used before starting new shelves
+  };
+
+  static bool Allocate(Page &page, unsigned int width, unsigned int height, unsigned int &x, unsigned int &y);
+  static bool AllocateFree(Page &page, unsigned int width, unsigned int height, unsigned int &x, unsigned int &y);
+  static void AddFree(Page &page, Rect rect);
+  static void Copy(Page &page, const CBaseTexture *texture, unsigned int x, unsigned int y);
+
+  std::vector<std::unique_ptr<Page>> m_pages;
+  size_t m_lastPage = 0; ///< page the previous image was added to
+};
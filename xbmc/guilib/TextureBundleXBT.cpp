@@ -34,6 +34,9 @@
 #include "XBTFReader.h"
 #include <lzo/lzo1x.h>
 
+#include <memory>
+#include <string.h>
+
 #ifdef TARGET_WINDOWS_DESKTOP
 #ifdef NDEBUG
 #pragma comment(lib,"lzo2.lib")
@@ -214,50 +217,41 @@ int CTextureBundleXBT::LoadAnim(const std::string& Filename, CBaseTexture*** ppT
 
 bool CTextureBundleXBT::ConvertFrameToTexture(const std::string& name, CXBTFFrame& frame, CBaseTexture** ppTexture)
 {
-  // found texture - allocate the necessary buffers
-  unsigned char *buffer = new unsigned char [(size_t)frame.GetPackedSize()];
-  if (buffer == NULL)
-  {
-    CLog::Log(LOGERROR, "Out of memory loading texture: %s (need %" PRIu64" bytes)", name.c_str(), frame.GetPackedSize());
-    return false;
-  }
-
-  // load the compressed texture
-  if (!m_XBTFReader->Load(frame, buffer))
+  // packed frames are unpacked straight from the mapped bundle if possible. The
+  // texture uploads its pixels later on, so they are never left pointing into
+  // the mapping: the bundle may have been rewritten by then.
+  const unsigned char *data = frame.IsPacked() ? m_XBTFReader->GetFrameData(frame) : nullptr;
+  std::unique_ptr<unsigned char[]> buffer;
+  if (data == nullptr)
   {
-    CLog::Log(LOGERROR, "Error loading texture: %s", name.c_str());
-    delete[] buffer;
-    return false;
+    buffer.reset(new unsigned char[(size_t)frame.GetPackedSize()]);
+    if (!m_XBTFReader->Load(frame, buffer.get()))
+    {
+      CLog::Log(LOGERROR, "Error loading texture: %s", name.c_str());
+      return false;
+    }
+    data = buffer.get();
   }
 
-  // check if it's packed with lzo
   if (frame.IsPacked())
   { // unpack
-    unsigned char *unpacked = new unsigned char[(size_t)frame.GetUnpackedSize()];
-    if (unpacked == NULL)
-    {
-      CLog::Log(LOGERROR, "Out of memory unpacking texture: %s (need %" PRIu64" bytes)", name.c_str(), frame.GetUnpackedSize());
-      delete[] buffer;
-      return false;
-    }
-    lzo_uint s = (lzo_uint)frame.GetUnpackedSize();
-    if (lzo1x_decompress_safe(buffer, (lzo_uint)frame.GetPackedSize(), unpacked, &s, NULL) != LZO_E_OK ||
-        s != frame.GetUnpackedSize())
+    std::unique_ptr<unsigned char[]> unpacked(new unsigned char[(size_t)frame.GetUnpackedSize()]);
+    if (!CXBTFReader::Unpack(frame, data, unpacked.get()))
     {
       CLog::Log(LOGERROR, "Error loading texture: %s: Decompression error", name.c_str());
-      delete[] buffer;
-      delete[] unpacked;
       return false;
     }
-    delete[] buffer;
-    buffer = unpacked;
+    buffer = std::move(unpacked);
+    data = buffer.get();
   }
 
+  // the texture uploads the pixels from the buffer they were loaded or
+  // unpacked into rather than from a copy of its own
+  std::shared_ptr<const void> owner(buffer.release(), std::default_delete<unsigned char[]>());
+
   // create an xbmc texture
   *ppTexture = new CTexture();
-  (*ppTexture)->LoadFromMemory(frame.GetWidth(), frame.GetHeight(), 0, frame.GetFormat(), frame.HasAlpha(), buffer);
-
-  delete[] buffer;
+  (*ppTexture)->LoadFromSharedMemory(frame.GetWidth(), frame.GetHeight(), frame.GetFormat(), frame.HasAlpha(), data, owner);
 
   return true;
 }
@@ -282,6 +276,22 @@ std::string CTextureBundleXBT::Normalize(const std::string &name)
 
 uint8_t* CTextureBundleXBT::UnpackFrame(const CXBTFReader& reader, const CXBTFFrame& frame)
 {
+  // frames of a mapped bundle are unpacked (or copied) from the mapping directly
+  const uint8_t* mappedBuffer = reader.GetFrameData(frame);
+  if (mappedBuffer != nullptr)
+  {
+    uint8_t* buffer = new uint8_t[static_cast<size_t>(frame.GetUnpackedSize())];
+    if (!frame.IsPacked())
+      memcpy(buffer, mappedBuffer, static_cast<size_t>(frame.GetUnpackedSize()));
+    else if (!CXBTFReader::Unpack(frame, mappedBuffer, buffer))
+    {
+      CLog::Log(LOGERROR, "CTextureBundleXBT: failed to decompress frame with %" PRIu64" unpacked bytes to %" PRIu64" bytes", frame.GetPackedSize(), frame.GetUnpackedSize());
+      delete[] buffer;
+      return nullptr;
+    }
+    return buffer;
+  }
+
   uint8_t* packedBuffer = new uint8_t[static_cast<size_t>(frame.GetPackedSize())];
   if (packedBuffer == nullptr)
   {
@@ -318,8 +328,7 @@ uint8_t* CTextureBundleXBT::UnpackFrame(const CXBTFReader& reader, const CXBTFFr
     return nullptr;
   }
 
-  lzo_uint size = static_cast<lzo_uint>(frame.GetUnpackedSize());
-  if (lzo1x_decompress_safe(packedBuffer, static_cast<lzo_uint>(frame.GetPackedSize()), unpackedBuffer, &size, nullptr) != LZO_E_OK || size != frame.GetUnpackedSize())
+  if (!CXBTFReader::Unpack(frame, packedBuffer, unpackedBuffer))
   {
     CLog::Log(LOGERROR, "CTextureBundleXBT: failed to decompress frame with %" PRIu64" unpacked bytes to %" PRIu64" bytes", frame.GetPackedSize(), frame.GetUnpackedSize());
     delete[] packedBuffer;
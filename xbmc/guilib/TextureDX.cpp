@@ -19,6 +19,7 @@
  */
 
 #include "TextureDX.h"
+#include "rendering/dx/DeviceResources.h"
 #include "utils/log.h"
 
 /************************************************************************/
@@ -77,6 +78,8 @@ void CDXTexture::LoadToGPU()
   if (!m_pixels)
   {
     // nothing to load - probably same image (no change)
+    if (!m_dirtyRegions.empty())
+      LoadRegionsToGPU();
     return;
   }
 
@@ -182,12 +185,34 @@ void CDXTexture::LoadToGPU()
   }
 
   if (!m_bCacheMemory)
+    FreePixels();
+
+  m_dirtyRegions.clear();
+  m_loadedToGPU = true;
+}
+
+void CDXTexture::LoadRegionsToGPU()
+{
+  D3D11_TEXTURE2D_DESC texDesc;
+  m_texture.GetDesc(&texDesc);
+  if (texDesc.Usage != D3D11_USAGE_DEFAULT)
   {
-    _aligned_free(m_pixels);
-    m_pixels = nullptr;
+    // dynamic textures can only be replaced as a whole
+    CLog::Log(LOGERROR, "%s - can't update part of a dynamic texture", __FUNCTION__);
+    m_dirtyRegions.clear();
+    return;
   }
 
-  m_loadedToGPU = true;
+  ID3D11DeviceContext* pContext = DX::DeviceResources::Get()->GetImmediateContext();
+  for (const auto &region : m_dirtyRegions)
+  {
+    D3D11_BOX box = { region.x, region.y, 0, region.x + region.width, region.y + region.height, 1 };
+    pContext->UpdateSubresource(m_texture.Get(), 0, &box, region.pixels.data(), region.width * 4, 0);
+  }
+  m_dirtyRegions.clear();
+
+  if (IsMipmapped())
+    m_texture.GenerateMipmaps();
 }
 
 void CDXTexture::BindToUnit(unsigned int unit)
@@ -48,6 +48,8 @@ public:
   };
 
 private:
+  void LoadRegionsToGPU();
+
   CD3DTexture m_texture;
   DXGI_FORMAT GetFormat();
 };
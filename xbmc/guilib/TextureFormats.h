@@ -32,3 +32,4 @@
 #define XB_FMT_RGBA8      64
 #define XB_FMT_RGB8      128
 #define XB_FMT_OPAQUE  65536
+#define XB_FMT_LZ4    131072 ///< packed frame data is lz4 rather than lzo compressed
@@ -61,6 +61,8 @@ void CGLTexture::LoadToGPU()
   if (!m_pixels)
   {
     // nothing to load - probably same image (no change)
+    if (!m_dirtyRegions.empty())
+      LoadRegionsToGPU();
     return;
   }
   if (m_texture == 0)
@@ -186,6 +188,7 @@ void CGLTexture::LoadToGPU()
       }
       else
       {
+        OwnPixels();
         SwapBlueRed(m_pixels, m_textureHeight, GetPitch());
         internalformat = pixelformat = GL_RGBA;
       }
@@ -203,12 +206,46 @@ void CGLTexture::LoadToGPU()
   VerifyGLState();
 
   if (!m_bCacheMemory)
+    FreePixels();
+
+  m_dirtyRegions.clear();
+  m_loadedToGPU = true;
+}
+
+void CGLTexture::LoadRegionsToGPU()
+{
+  glBindTexture(GL_TEXTURE_2D, m_texture);
+
+#ifndef HAS_GLES
+  GLenum format = GL_BGRA;
+#else
+#ifndef GL_BGRA_EXT
+#define GL_BGRA_EXT 0x80E1
+#endif
+  // must match the pixel format the texture was created with
+  GLenum format = GL_BGRA_EXT;
+  bool swap = !CServiceBroker::GetRenderSystem().SupportsBGRA() && !CServiceBroker::GetRenderSystem().SupportsBGRAApple();
+  if (swap)
+    format = GL_RGBA;
+#endif
+
+  for (auto &region : m_dirtyRegions)
   {
-    _aligned_free(m_pixels);
-    m_pixels = NULL;
+#ifdef HAS_GLES
+    if (swap)
+      SwapBlueRed(region.pixels.data(), region.height, region.width * 4);
+#endif
+    glTexSubImage2D(GL_TEXTURE_2D, 0, region.x, region.y, region.width, region.height,
+                    format, GL_UNSIGNED_BYTE, region.pixels.data());
   }
+  m_dirtyRegions.clear();
 
-  m_loadedToGPU = true;
+#ifdef HAS_GLES
+  if (IsMipmapped())
+    glGenerateMipmap(GL_TEXTURE_2D);
+#endif
+
+  VerifyGLState();
 }
 
 void CGLTexture::BindToUnit(unsigned int unit)
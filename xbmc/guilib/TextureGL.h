@@ -41,6 +41,8 @@ public:
   void BindToUnit(unsigned int unit) override;
 
 protected:
+  void LoadRegionsToGPU();
+
   GLuint m_texture;
 };
 
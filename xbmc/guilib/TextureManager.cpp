@@ -26,6 +26,7 @@
 #include "filesystem/Directory.h"
 #include "filesystem/File.h"
 #include "GraphicContext.h"
+#include "settings/AdvancedSettings.h"
 #include "system.h"
 #include "Texture.h"
 #include "threads/SingleLock.h"
@@ -55,7 +56,10 @@ CTextureArray::CTextureArray(int width, int height, int loops,  bool texCoordsAr
   m_orientation = 0;
   m_texWidth = 0;
   m_texHeight = 0;
+  m_texOffsetX = 0;
+  m_texOffsetY = 0;
   m_texCoordsArePixels = false;
+  m_inAtlas = false;
 }
 
 CTextureArray::CTextureArray()
@@ -81,7 +85,10 @@ void CTextureArray::Reset()
   m_orientation = 0;
   m_texWidth = 0;
   m_texHeight = 0;
+  m_texOffsetX = 0;
+  m_texOffsetY = 0;
   m_texCoordsArePixels = false;
+  m_inAtlas = false;
 }
 
 void CTextureArray::Add(CBaseTexture *texture, int delay)
@@ -111,7 +118,10 @@ void CTextureArray::Free()
   CSingleLock lock(g_graphicsContext);
   for (unsigned int i = 0; i < m_textures.size(); i++)
   {
-    delete m_textures[i];
+    if (m_inAtlas)
+      g_TextureManager.ReleaseAtlasTexture(m_textures[i], m_texOffsetX, m_texOffsetY);
+    else
+      delete m_textures[i];
   }
 
   m_textures.clear();
@@ -219,6 +229,17 @@ void CTextureMap::Add(CBaseTexture* texture, int delay)
     m_memUsage += sizeof(CTexture) + (texture->GetTextureWidth() * texture->GetTextureHeight() * 4);
 }
 
+void CTextureMap::AddFromAtlas(CBaseTexture* page, unsigned int x, unsigned int y)
+{
+  m_texture.Add(page, 100);
+  m_texture.m_texOffsetX = x;
+  m_texture.m_texOffsetY = y;
+  m_texture.m_inAtlas = true;
+
+  // the page is shared, only account for our part of it
+  m_memUsage += (m_texture.m_width + 2) * (m_texture.m_height + 2) * 4;
+}
+
 /************************************************************************/
 /*                                                                      */
 /************************************************************************/
@@ -455,7 +476,20 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
   if (!pTexture) return emptyTexture;
 
   CTextureMap* pMap = new CTextureMap(strTextureName, width, height, 0);
-  pMap->Add(pTexture, 100);
+
+  // small skin images are packed together so they can be drawn without switching textures
+  unsigned int x, y;
+  CBaseTexture *page = NULL;
+  if (bundle >= 0 && g_advancedSettings.m_guiTextureAtlas && CTextureAtlas::CanPack(pTexture))
+    page = m_atlas.Add(pTexture, x, y);
+
+  if (page)
+  {
+    pMap->AddFromAtlas(page, x, y);
+    delete pTexture;
+  }
+  else
+    pMap->Add(pTexture, 100);
   m_vecTextures.push_back(pMap);
 
 #ifdef _DEBUG_TEXTURES
@@ -533,6 +567,12 @@ void CGUITextureManager::ReleaseHwTexture(unsigned int texture)
   m_unusedHwTextures.push_back(texture);
 }
 
+void CGUITextureManager::ReleaseAtlasTexture(const CBaseTexture *page, unsigned int x, unsigned int y)
+{
+  CSingleLock lock(g_graphicsContext);
+  m_atlas.Release(page, x, y);
+}
+
 void CGUITextureManager::Cleanup()
 {
   CSingleLock lock(g_graphicsContext);
@@ -28,6 +28,7 @@
 #include <vector>
 #include <utility>
 
+#include "TextureAtlas.h"
 #include "TextureBundle.h"
 #include "threads/CriticalSection.h"
 
@@ -57,7 +58,10 @@ public:
   int m_loops;
   int m_texWidth;
   int m_texHeight;
+  int m_texOffsetX;          ///< position of the image within the texture, for images packed into an atlas
+  int m_texOffsetY;
   bool m_texCoordsArePixels;
+  bool m_inAtlas;            ///< the texture is an atlas page owned by the texture manager
 };
 
 /*!
@@ -75,6 +79,7 @@ public:
   virtual ~CTextureMap();
 
   void Add(CBaseTexture* texture, int delay);
+  void AddFromAtlas(CBaseTexture* page, unsigned int x, unsigned int y);
   bool Release();
 
   const std::string& GetName() const;
@@ -124,6 +129,7 @@ public:
 
   void FreeUnusedTextures(unsigned int timeDelay = 0); ///< Free textures (called from app thread only)
   void ReleaseHwTexture(unsigned int texture);
+  void ReleaseAtlasTexture(const CBaseTexture *page, unsigned int x, unsigned int y);
 protected:
   std::vector<CTextureMap*> m_vecTextures;
   std::list<std::pair<CTextureMap*, unsigned int> > m_unusedTextures;
@@ -132,6 +138,7 @@ protected:
   typedef std::list<std::pair<CTextureMap*, unsigned int> >::iterator ilistUnused;
   // we have 2 texture bundles (one for the base textures, one for the theme)
   CTextureBundle m_TexBundle[2];
+  CTextureAtlas m_atlas;
 
   std::vector<std::string> m_texturePaths;
   CCriticalSection m_section;
@@ -64,6 +64,19 @@ void CXBTFFrame::SetPackedSize(uint64_t size)
   m_packedSize = size;
 }
 
+XBTFCodec CXBTFFrame::GetCodec() const
+{
+  return (m_format & XB_FMT_LZ4) ? XBTFCodec::LZ4 : XBTFCodec::LZO;
+}
+
+void CXBTFFrame::SetCodec(XBTFCodec codec)
+{
+  if (codec == XBTFCodec::LZ4)
+    m_format |= XB_FMT_LZ4;
+  else
+    m_format &= ~XB_FMT_LZ4;
+}
+
 bool CXBTFFrame::IsPacked() const
 {
   return m_unpackedSize != m_packedSize;
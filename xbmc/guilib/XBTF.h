@@ -31,6 +31,18 @@ static const std::string XBTF_VERSION = "2";
 
 #include "TextureFormats.h"
 
+/*!
+ \brief Compression used for the data of a packed frame.
+
+ Stored as a flag outside XB_FMT_MASK of the frame format, so bundles written
+ before it existed read as LZO.
+ */
+enum class XBTFCodec
+{
+  LZO,
+  LZ4
+};
+
 class CXBTFFrame
 {
 public:
@@ -59,6 +71,9 @@ public:
   uint32_t GetDuration() const;
   void SetDuration(uint32_t duration);
 
+  XBTFCodec GetCodec() const;
+  void SetCodec(XBTFCodec codec);
+
   bool IsPacked() const;
   bool HasAlpha() const;
 
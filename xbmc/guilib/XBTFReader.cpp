@@ -26,6 +26,18 @@
 #include "XBTFReader.h"
 #include "guilib/XBTF.h"
 #include "utils/EndianSwap.h"
+#include "utils/log.h"
+
+#include <lzo/lzo1x.h>
+#ifdef HAVE_LZ4
+#include <lz4.h>
+#endif
+
+#if defined(TARGET_POSIX)
+#include "utils/posix/Mmap.h"
+
+#include <system_error>
+#endif
 
 #ifdef TARGET_WINDOWS
 #include "filesystem/SpecialProtocol.h"
@@ -69,6 +81,9 @@ CXBTFReader::CXBTFReader()
   : CXBTFBase(),
     m_path(),
     m_file(nullptr)
+#if defined(TARGET_POSIX)
+  , m_mappedTime(0)
+#endif
 { }
 
 CXBTFReader::~CXBTFReader()
@@ -177,6 +192,24 @@ bool CXBTFReader::Open(const std::string& path)
   if (pos != GetHeaderSize())
     return false;
 
+#if defined(TARGET_POSIX)
+  // map the whole bundle, frames are then paged in when first used rather
+  // than read into buffers of their own
+  struct stat fileStat;
+  if (fstat(fileno(m_file), &fileStat) == 0 && fileStat.st_size > 0)
+  {
+    try
+    {
+      m_mapping.reset(new KODI::UTILS::POSIX::CMmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fileno(m_file), 0));
+      m_mappedTime = fileStat.st_mtime;
+    }
+    catch (const std::system_error& error)
+    {
+      CLog::Log(LOGWARNING, "CXBTFReader::Open - unable to map %s, reading frames instead: %s", m_path.c_str(), error.what());
+    }
+  }
+#endif
+
   return true;
 }
 
@@ -187,6 +220,10 @@ bool CXBTFReader::IsOpen() const
 
 void CXBTFReader::Close()
 {
+#if defined(TARGET_POSIX)
+  m_mapping.reset();
+#endif
+
   if (m_file != nullptr)
   {
     fclose(m_file);
@@ -214,6 +251,13 @@ bool CXBTFReader::Load(const CXBTFFrame& frame, unsigned char* buffer) const
   if (m_file == nullptr)
     return false;
 
+  const unsigned char* data = GetFrameData(frame);
+  if (data != nullptr)
+  {
+    memcpy(buffer, data, static_cast<size_t>(frame.GetPackedSize()));
+    return true;
+  }
+
 #if defined(TARGET_DARWIN) || defined(TARGET_FREEBSD)
   if (fseeko(m_file, static_cast<off_t>(frame.GetOffset()), SEEK_SET) == -1)
 #elif defined(TARGET_ANDROID)
@@ -228,3 +272,47 @@ bool CXBTFReader::Load(const CXBTFFrame& frame, unsigned char* buffer) const
 
   return true;
 }
+
+const unsigned char* CXBTFReader::GetFrameData(const CXBTFFrame& frame) const
+{
+#if defined(TARGET_POSIX)
+  if (m_mapping == nullptr || frame.GetOffset() > m_mapping->Size() ||
+      frame.GetPackedSize() > m_mapping->Size() - frame.GetOffset())
+    return nullptr;
+
+  // reading pages of a bundle that was truncated in place raises SIGBUS, so the
+  // mapping is only used while the file is as it was when it was mapped. Load()
+  // reads the file instead, which fails gracefully.
+  struct stat fileStat;
+  if (fstat(fileno(m_file), &fileStat) != 0 ||
+      static_cast<uint64_t>(fileStat.st_size) < m_mapping->Size() || fileStat.st_mtime != m_mappedTime)
+    return nullptr;
+
+  return static_cast<const unsigned char*>(m_mapping->Data()) + frame.GetOffset();
+#else
+  return nullptr;
+#endif
+}
+
+bool CXBTFReader::Unpack(const CXBTFFrame& frame, const unsigned char* packed, unsigned char* unpacked)
+{
+  switch (frame.GetCodec())
+  {
+  case XBTFCodec::LZO:
+  {
+    lzo_uint size = static_cast<lzo_uint>(frame.GetUnpackedSize());
+    return lzo1x_decompress_safe(packed, static_cast<lzo_uint>(frame.GetPackedSize()), unpacked, &size, nullptr) == LZO_E_OK &&
+           size == frame.GetUnpackedSize();
+  }
+  case XBTFCodec::LZ4:
+#ifdef HAVE_LZ4
+    return LZ4_decompress_safe(reinterpret_cast<const char*>(packed), reinterpret_cast<char*>(unpacked),
+                               static_cast<int>(frame.GetPackedSize()), static_cast<int>(frame.GetUnpackedSize())) ==
+           static_cast<int>(frame.GetUnpackedSize());
+#else
+    CLog::Log(LOGERROR, "CXBTFReader::Unpack - frame is packed with lz4, which isn't supported by this build");
+    return false;
+#endif
+  }
+  return false;
+}
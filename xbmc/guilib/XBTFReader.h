@@ -27,6 +27,19 @@
 
 #include "XBTF.h"
 
+#if defined(TARGET_POSIX)
+namespace KODI
+{
+namespace UTILS
+{
+namespace POSIX
+{
+class CMmap;
+}
+}
+}
+#endif
+
 class CXBTFReader : public CXBTFBase
 {
 public:
@@ -41,9 +54,30 @@ public:
 
   bool Load(const CXBTFFrame& frame, unsigned char* buffer) const;
 
+  /*!
+   \brief Get the (packed) data of a frame without copying it
+   \return pointer to GetPackedSize() bytes within the mapped bundle, valid until Close(),
+           or nullptr if Load() has to be used because the bundle isn't mapped or has changed
+           since it was opened. The bundle is only checked here, so copy or unpack the data
+           right away rather than keeping the pointer.
+   */
+  const unsigned char* GetFrameData(const CXBTFFrame& frame) const;
+
+  /*!
+   \brief Decompress the data of a packed frame with the codec it was written with
+   \param packed GetPackedSize() bytes as returned by Load()
+   \param unpacked buffer of GetUnpackedSize() bytes
+   \return false if the data is corrupt or the codec isn't supported by this build
+   */
+  static bool Unpack(const CXBTFFrame& frame, const unsigned char* packed, unsigned char* unpacked);
+
 private:
   std::string m_path;
   FILE* m_file;
+#if defined(TARGET_POSIX)
+  std::unique_ptr<KODI::UTILS::POSIX::CMmap> m_mapping;
+  time_t m_mappedTime; ///< modification time of the bundle when it was mapped
+#endif
 };
 
 typedef std::shared_ptr<CXBTFReader> CXBTFReaderPtr;
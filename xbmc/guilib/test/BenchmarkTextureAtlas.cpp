@@ -0,0 +1,100 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "TestTextureAtlas.h"
+#include "utils/Stopwatch.h"
+
+#include <algorithm>
+#include <vector>
+
+#define BENCHMARK_WINDOWS 200
+#define IMAGES_PER_WINDOW 60
+#define IMAGE_POOL 100
+
+using namespace TextureAtlasTest;
+
+namespace
+{
+struct PackedImage
+{
+  CBaseTexture *page;
+  unsigned int x;
+  unsigned int y;
+};
+}
+
+TEST(BenchmarkTextureAtlas, WindowChanges)
+{
+  // skin images of 16 to 256 pixels
+  std::vector<std::unique_ptr<CBaseTexture>> images;
+  unsigned int seed = 1;
+  for (unsigned int i = 0; i < IMAGE_POOL; i++)
+  {
+    seed = seed * 1103515245 + 12345;
+    unsigned int width = 16 + (seed >> 16) % 241;
+    seed = seed * 1103515245 + 12345;
+    unsigned int height = 16 + (seed >> 16) % 241;
+    images.push_back(CreateImage(width, height, i));
+  }
+
+  // each window loads its images and releases those of the previous one,
+  // so the atlas keeps turning over like it does while browsing a skin
+  CTextureAtlas atlas;
+  std::vector<PackedImage> previous;
+  unsigned int draws = 0;
+  unsigned int maxPages = 0;
+  CStopWatch watch;
+  watch.StartZero();
+  for (unsigned int window = 0; window < BENCHMARK_WINDOWS; window++)
+  {
+    std::vector<PackedImage> current;
+    for (unsigned int i = 0; i < IMAGES_PER_WINDOW; i++)
+    {
+      seed = seed * 1103515245 + 12345;
+      PackedImage packed;
+      packed.page = atlas.Add(images[(seed >> 16) % IMAGE_POOL].get(), packed.x, packed.y);
+      ASSERT_NE(nullptr, packed.page);
+      current.push_back(packed);
+    }
+
+    // consecutive images on the same page are drawn as one batch
+    for (unsigned int i = 0; i < current.size(); i++)
+    {
+      if (i == 0 || current[i].page != current[i - 1].page)
+        draws++;
+    }
+
+    for (const auto &packed : previous)
+      atlas.Release(packed.page, packed.x, packed.y);
+    previous.swap(current);
+    maxPages = std::max(maxPages, atlas.GetPageCount());
+  }
+  for (const auto &packed : previous)
+    atlas.Release(packed.page, packed.x, packed.y);
+  watch.Stop();
+  EXPECT_EQ(0u, atlas.GetPageCount());
+
+  // without the atlas every image is a draw call of its own
+  RecordProperty("images_per_window", IMAGES_PER_WINDOW);
+  RecordProperty("draws_per_window", static_cast<int>(draws / BENCHMARK_WINDOWS));
+  RecordProperty("max_pages", static_cast<int>(maxPages));
+  RecordProperty("us_per_image", static_cast<int>(watch.GetElapsedMilliseconds() * 1000 / (BENCHMARK_WINDOWS * IMAGES_PER_WINDOW)));
+}
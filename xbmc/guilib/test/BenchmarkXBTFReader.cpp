@@ -0,0 +1,63 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TestXBTFReader.h"
+#include "utils/Stopwatch.h"
+
+#ifdef HAVE_LZ4
+class BenchmarkXBTFReader : public TestXBTFReader
+{
+protected:
+  // time to load the bundle and unpack every frame, as the texture manager does at skin load
+  float Load(const std::string &path)
+  {
+    CStopWatch watch;
+    watch.StartZero();
+    CXBTFReader reader;
+    EXPECT_TRUE(reader.Open(path));
+    for (const auto &file : reader.GetFiles())
+    {
+      const CXBTFFrame &frame = file.GetFrames().front();
+      uint8_t *data = CTextureBundleXBT::UnpackFrame(reader, frame);
+      EXPECT_NE(nullptr, data);
+      delete[] data;
+    }
+    watch.Stop();
+    return watch.GetElapsedMilliseconds();
+  }
+};
+
+TEST_F(BenchmarkXBTFReader, Load)
+{
+  std::string lzo = CreateBundle(XBTFCodec::LZO);
+  std::string lz4 = CreateBundle(XBTFCodec::LZ4);
+
+  // warm up the file cache so both read from memory
+  Load(lzo);
+  Load(lz4);
+
+  float timeLZO = Load(lzo);
+  float timeLZ4 = Load(lz4);
+
+  RecordProperty("images", SKIN_IMAGES);
+  RecordProperty("lzo_us", static_cast<int>(timeLZO * 1000));
+  RecordProperty("lz4_us", static_cast<int>(timeLZ4 * 1000));
+}
+#endif
@@ -0,0 +1,89 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "TestTextureAtlas.h"
+
+#include <string.h>
+#include <utility>
+#include <vector>
+
+using namespace TextureAtlasTest;
+
+TEST(TestTextureAtlas, CopiesImageAndBorder)
+{
+  CTextureAtlas atlas;
+  std::unique_ptr<CBaseTexture> image = CreateImage(40, 30, 1);
+  unsigned int x, y;
+  CBaseTexture *page = atlas.Add(image.get(), x, y);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(1u, atlas.GetPageCount());
+
+  for (unsigned int row = 0; row < 30; row++)
+    ASSERT_EQ(0, memcmp(GetPixel(page, x, y + row), GetPixel(image.get(), 0, row), 40 * 4));
+
+  // the border repeats the edges of the image
+  EXPECT_EQ(0, memcmp(GetPixel(page, x - 1, y - 1), GetPixel(image.get(), 0, 0), 4));
+  EXPECT_EQ(0, memcmp(GetPixel(page, x + 40, y + 10), GetPixel(image.get(), 39, 10), 4));
+  EXPECT_EQ(0, memcmp(GetPixel(page, x + 40, y + 30), GetPixel(image.get(), 39, 29), 4));
+
+  atlas.Release(page, x, y);
+  EXPECT_EQ(0u, atlas.GetPageCount());
+}
+
+TEST(TestTextureAtlas, ReusesReleasedSpace)
+{
+  CTextureAtlas atlas;
+  // 64x64 with the border
+  std::unique_ptr<CBaseTexture> image = CreateImage(62, 62, 2);
+  std::vector<std::pair<unsigned int, unsigned int>> positions;
+  CBaseTexture *page = nullptr;
+  while (true)
+  {
+    unsigned int x, y;
+    CBaseTexture *added = atlas.Add(image.get(), x, y);
+    ASSERT_NE(nullptr, added);
+    if (page && added != page)
+    {
+      atlas.Release(added, x, y);
+      break;
+    }
+    page = added;
+    positions.push_back(std::make_pair(x, y));
+  }
+  EXPECT_EQ(1u, atlas.GetPageCount());
+
+  // neighbours released on a shelf make room for a wider image
+  for (unsigned int i = 0; i < 4; i++)
+    atlas.Release(page, positions[i].first, positions[i].second);
+  std::unique_ptr<CBaseTexture> wide = CreateImage(254, 62, 3);
+  unsigned int x, y;
+  EXPECT_EQ(page, atlas.Add(wide.get(), x, y));
+  EXPECT_EQ(positions[0].first, x);
+  EXPECT_EQ(positions[0].second, y);
+  EXPECT_EQ(1u, atlas.GetPageCount());
+
+  // gaps that are too narrow aren't used
+  atlas.Release(page, positions[4].first, positions[4].second);
+  atlas.Release(page, positions[6].first, positions[6].second);
+  std::unique_ptr<CBaseTexture> twice = CreateImage(126, 62, 4);
+  EXPECT_NE(page, atlas.Add(twice.get(), x, y));
+  EXPECT_EQ(2u, atlas.GetPageCount());
+}
@@ -0,0 +1,55 @@
+#pragma once
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "guilib/Texture.h"
+#include "guilib/TextureAtlas.h"
+
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <stdint.h>
+
+namespace TextureAtlasTest
+{
+// every pixel of a row differs, so a shifted copy is noticed
+inline std::unique_ptr<CBaseTexture> CreateImage(unsigned int width, unsigned int height, unsigned int seed)
+{
+  std::unique_ptr<CBaseTexture> texture(new CTexture(width, height, XB_FMT_A8R8G8B8));
+  for (unsigned int y = 0; y < height; y++)
+  {
+    for (unsigned int x = 0; x < width; x++)
+    {
+      uint8_t *pixel = texture->GetPixels() + y * texture->GetPitch() + x * 4;
+      pixel[0] = (uint8_t)x;
+      pixel[1] = (uint8_t)y;
+      pixel[2] = (uint8_t)seed;
+      pixel[3] = 0x80;
+    }
+  }
+  return texture;
+}
+
+inline const uint8_t* GetPixel(const CBaseTexture *texture, unsigned int x, unsigned int y)
+{
+  return texture->GetPixels() + y * texture->GetPitch() + x * 4;
+}
+}
@@ -0,0 +1,107 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TestXBTFReader.h"
+
+#if defined(TARGET_POSIX)
+#include <unistd.h>
+#endif
+
+TEST_F(TestXBTFReader, Codec)
+{
+  CXBTFFrame frame;
+  frame.SetFormat(XB_FMT_A8R8G8B8 | XB_FMT_OPAQUE);
+  EXPECT_EQ(XBTFCodec::LZO, frame.GetCodec());
+
+  frame.SetCodec(XBTFCodec::LZ4);
+  EXPECT_EQ(XBTFCodec::LZ4, frame.GetCodec());
+  EXPECT_EQ((uint32_t)XB_FMT_A8R8G8B8, frame.GetFormat());
+  EXPECT_FALSE(frame.HasAlpha());
+
+  frame.SetCodec(XBTFCodec::LZO);
+  EXPECT_EQ((uint32_t)(XB_FMT_A8R8G8B8 | XB_FMT_OPAQUE), frame.GetFormat(true));
+}
+
+TEST_F(TestXBTFReader, UnpackLZO)
+{
+  ExpectFrames(CreateBundle(XBTFCodec::LZO), XBTFCodec::LZO);
+}
+
+#if defined(TARGET_POSIX)
+TEST_F(TestXBTFReader, Mapped)
+{
+  CXBTFReader reader;
+  ASSERT_TRUE(reader.Open(CreateBundle(XBTFCodec::LZO)));
+  for (const auto &file : reader.GetFiles())
+  {
+    const CXBTFFrame &frame = file.GetFrames().front();
+    const unsigned char *data = reader.GetFrameData(frame);
+    ASSERT_NE(nullptr, data);
+
+    std::vector<unsigned char> loaded(static_cast<size_t>(frame.GetPackedSize()));
+    ASSERT_TRUE(reader.Load(frame, loaded.data()));
+    EXPECT_EQ(0, memcmp(data, loaded.data(), loaded.size()));
+  }
+
+  CXBTFFrame outside;
+  outside.SetOffset(1 << 30);
+  outside.SetPackedSize(16);
+  EXPECT_EQ(nullptr, reader.GetFrameData(outside));
+
+  CXBTFFrame first = reader.GetFiles().front().GetFrames().front();
+  reader.Close();
+  EXPECT_EQ(nullptr, reader.GetFrameData(first));
+}
+
+TEST_F(TestXBTFReader, Truncated)
+{
+  std::string path = CreateBundle(XBTFCodec::LZO);
+  CXBTFReader reader;
+  ASSERT_TRUE(reader.Open(path));
+  CXBTFFrame frame = reader.GetFiles().back().GetFrames().front();
+  ASSERT_NE(nullptr, reader.GetFrameData(frame));
+
+  // the mapping must not be handed out once the pages behind it are gone
+  ASSERT_EQ(0, truncate(path.c_str(), static_cast<off_t>(frame.GetOffset())));
+  EXPECT_EQ(nullptr, reader.GetFrameData(reader.GetFiles().front().GetFrames().front()));
+  EXPECT_EQ(nullptr, reader.GetFrameData(frame));
+
+  std::vector<unsigned char> loaded(static_cast<size_t>(frame.GetPackedSize()));
+  EXPECT_FALSE(reader.Load(frame, loaded.data()));
+}
+#endif
+
+#ifdef HAVE_LZ4
+TEST_F(TestXBTFReader, UnpackLZ4)
+{
+  ExpectFrames(CreateBundle(XBTFCodec::LZ4), XBTFCodec::LZ4);
+}
+#else
+TEST_F(TestXBTFReader, UnpackLZ4Unsupported)
+{
+  std::vector<uint8_t> packed(16, 0);
+  std::vector<uint8_t> unpacked(64);
+  CXBTFFrame frame;
+  frame.SetCodec(XBTFCodec::LZ4);
+  frame.SetPackedSize(packed.size());
+  frame.SetUnpackedSize(unpacked.size());
+  EXPECT_FALSE(CXBTFReader::Unpack(frame, packed.data(), unpacked.data()));
+}
+#endif
@@ -0,0 +1,197 @@
+#pragma once
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/SpecialProtocol.h"
+#include "guilib/TextureBundleXBT.h"
+#include "guilib/XBTFReader.h"
+#include "utils/StringUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <lzo/lzo1x.h>
+#ifdef HAVE_LZ4
+#include <lz4.h>
+#include <lz4hc.h>
+#endif
+
+#include <cstdio>
+#include <string.h>
+#include <vector>
+
+#define SKIN_IMAGES 160
+#define SKIN_IMAGE_SIZE 128
+
+namespace XBTFReaderTest
+{
+// mostly transparent, with a shaded rounded box, like the buttons and panels of a skin
+inline std::vector<uint8_t> CreateImage(unsigned int seed)
+{
+  std::vector<uint8_t> image(SKIN_IMAGE_SIZE * SKIN_IMAGE_SIZE * 4, 0);
+  unsigned int inset = 8 + seed % 16;
+  for (unsigned int y = inset; y < SKIN_IMAGE_SIZE - inset; y++)
+  {
+    for (unsigned int x = inset; x < SKIN_IMAGE_SIZE - inset; x++)
+    {
+      uint8_t *pixel = &image[(y * SKIN_IMAGE_SIZE + x) * 4];
+      pixel[0] = (uint8_t)(seed * 7);
+      pixel[1] = (uint8_t)(y + seed);
+      pixel[2] = (uint8_t)(255 - y);
+      pixel[3] = (x == inset || y == inset) ? 0x80 : 0xFF;
+    }
+  }
+  return image;
+}
+
+inline std::vector<uint8_t> PackLZO(const std::vector<uint8_t> &data)
+{
+  std::vector<uint8_t> packed(data.size() + data.size() / 16 + 64 + 3);
+  std::vector<uint8_t> working(LZO1X_999_MEM_COMPRESS);
+  lzo_uint size = packed.size();
+  if (lzo1x_999_compress(data.data(), data.size(), packed.data(), &size, working.data()) != LZO_E_OK)
+    return data;
+  packed.resize(size);
+  return packed;
+}
+
+#ifdef HAVE_LZ4
+inline std::vector<uint8_t> PackLZ4(const std::vector<uint8_t> &data)
+{
+  std::vector<uint8_t> packed(LZ4_compressBound(data.size()));
+  int size = LZ4_compress_HC((const char *)data.data(), (char *)packed.data(), data.size(), packed.size(), LZ4HC_CLEVEL_MAX);
+  if (size <= 0)
+    return data;
+  packed.resize(size);
+  return packed;
+}
+#endif
+
+inline void WriteU32(std::vector<uint8_t> &out, uint32_t value)
+{
+  for (int i = 0; i < 4; i++)
+    out.push_back((uint8_t)(value >> (i * 8)));
+}
+
+inline void WriteU64(std::vector<uint8_t> &out, uint64_t value)
+{
+  for (int i = 0; i < 8; i++)
+    out.push_back((uint8_t)(value >> (i * 8)));
+}
+
+// writes a bundle the same way TexturePacker does
+inline bool WriteBundle(const std::string &path, const std::vector<std::vector<uint8_t>> &images, XBTFCodec codec)
+{
+  std::vector<std::vector<uint8_t>> packed;
+  for (const auto &image : images)
+  {
+#ifdef HAVE_LZ4
+    packed.push_back(codec == XBTFCodec::LZ4 ? PackLZ4(image) : PackLZO(image));
+#else
+    packed.push_back(PackLZO(image));
+#endif
+  }
+
+  std::vector<uint8_t> header;
+  header.insert(header.end(), XBTF_MAGIC.begin(), XBTF_MAGIC.end());
+  header.insert(header.end(), XBTF_VERSION.begin(), XBTF_VERSION.end());
+  WriteU32(header, images.size());
+  uint64_t offset = 4 + 1 + 4 + images.size() * (CXBTFFile::MaximumPathLength + 4 + 4 + 40);
+  for (size_t i = 0; i < images.size(); i++)
+  {
+    std::string name = StringUtils::Format("image%03u.png", (unsigned int)i);
+    name.resize(CXBTFFile::MaximumPathLength, '\0');
+    header.insert(header.end(), name.begin(), name.end());
+    WriteU32(header, 0);
+    WriteU32(header, 1);
+
+    uint32_t format = XB_FMT_A8R8G8B8;
+    if (codec == XBTFCodec::LZ4 && packed[i].size() != images[i].size())
+      format |= XB_FMT_LZ4;
+    WriteU32(header, SKIN_IMAGE_SIZE);
+    WriteU32(header, SKIN_IMAGE_SIZE);
+    WriteU32(header, format);
+    WriteU64(header, packed[i].size());
+    WriteU64(header, images[i].size());
+    WriteU32(header, 0);
+    WriteU64(header, offset);
+    offset += packed[i].size();
+  }
+
+  FILE *file = fopen(path.c_str(), "wb");
+  if (!file)
+    return false;
+  bool ok = fwrite(header.data(), 1, header.size(), file) == header.size();
+  for (const auto &data : packed)
+    ok &= fwrite(data.data(), 1, data.size(), file) == data.size();
+  fclose(file);
+  return ok;
+}
+}
+
+using namespace XBTFReaderTest;
+
+class TestXBTFReader : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    ASSERT_EQ(LZO_E_OK, lzo_init());
+    for (unsigned int i = 0; i < SKIN_IMAGES; i++)
+      m_images.push_back(CreateImage(i));
+  }
+
+  void TearDown() override
+  {
+    for (const auto &path : m_paths)
+      remove(path.c_str());
+  }
+
+  std::string CreateBundle(XBTFCodec codec)
+  {
+    std::string path = CSpecialProtocol::TranslatePath(
+      StringUtils::Format("special://temp/Textures%i.xbt", (int)codec));
+    m_paths.push_back(path);
+    EXPECT_TRUE(WriteBundle(path, m_images, codec));
+    return path;
+  }
+
+  void ExpectFrames(const std::string &path, XBTFCodec codec)
+  {
+    CXBTFReader reader;
+    ASSERT_TRUE(reader.Open(path));
+    for (unsigned int i = 0; i < SKIN_IMAGES; i++)
+    {
+      CXBTFFile file;
+      ASSERT_TRUE(reader.Get(StringUtils::Format("image%03u.png", i), file));
+      const CXBTFFrame &frame = file.GetFrames().front();
+      EXPECT_EQ((uint32_t)XB_FMT_A8R8G8B8, frame.GetFormat());
+      if (frame.IsPacked())
+        EXPECT_EQ(codec, frame.GetCodec());
+
+      uint8_t *data = CTextureBundleXBT::UnpackFrame(reader, frame);
+      ASSERT_NE(nullptr, data);
+      EXPECT_EQ(0, memcmp(data, m_images[i].data(), m_images[i].size()));
+      delete[] data;
+    }
+  }
+
+  std::vector<std::vector<uint8_t>> m_images;
+  std::vector<std::string> m_paths;
+};
@@ -23,13 +23,14 @@
 
 namespace INFO
 {
-  InfoBool::InfoBool(const std::string &expression, int context, unsigned int &refreshCounter)
+  InfoBool::InfoBool(const std::string &expression, int context, const InfoSourceCounters &sources)
     : m_value(false),
       m_context(context),
       m_listItemDependent(false),
+      m_dependencies(0),
       m_expression(expression),
-      m_refreshCounter(0),
-      m_parentRefreshCounter(refreshCounter)
+      m_stamp(0),
+      m_sources(sources)
   {
     StringUtils::ToLower(m_expression);
   }
@@ -27,6 +27,65 @@ class CGUIListItem;
 
 namespace INFO
 {
+/*!
+ \ingroup info
+ \brief State an info bool can depend on
+ */
+enum InfoSource
+{
+  INFO_SOURCE_PLAYER = 0,   ///< playback state, changes every frame while playing
+  INFO_SOURCE_LIBRARY,      ///< library content flags
+  INFO_SOURCE_WINDOW,       ///< active window, dialogs and window history
+  INFO_SOURCE_LISTITEM,     ///< focused items of containers, changes every frame
+  INFO_SOURCE_TIME,         ///< system date and time
+  INFO_SOURCE_OTHER,        ///< anything not tracked separately, changes every frame
+  INFO_SOURCE_COUNT
+};
+
+#define INFO_DEPENDS_ON(source) (1u << (source))
+
+/*!
+ \ingroup info
+ \brief Change counters of the state info bools depend on
+
+ Sources publish a change by bumping their counter, which makes every info bool
+ depending on the source re-evaluate the next time it is fetched.
+ */
+class InfoSourceCounters
+{
+public:
+  InfoSourceCounters() : m_generation(0)
+  {
+    for (unsigned int i = 0; i < INFO_SOURCE_COUNT; i++)
+      m_counters[i] = 0;
+  }
+
+  void Changed(InfoSource source) { ++m_counters[source]; }
+
+  /*! \brief Mark all info bools as dirty, including those without any dependencies */
+  void ChangedAll() { ++m_generation; }
+
+  /*! \brief Get a stamp that changes whenever any of the given sources changes
+   \param dependencies INFO_DEPENDS_ON() flags of the sources
+   \return the stamp, 0 until any change was published
+   */
+  unsigned int GetStamp(unsigned int dependencies) const
+  {
+    // counters only ever grow, so their sum changes whenever any of them does
+    unsigned int stamp = m_generation;
+    for (unsigned int i = 0; dependencies != 0; i++, dependencies >>= 1)
+    {
+      if (dependencies & 1)
+        stamp += m_counters[i];
+    }
+    return stamp;
+  }
+
+private:
+  unsigned int m_generation;
+  unsigned int m_counters[INFO_SOURCE_COUNT];
+};
+
 /*!
  \ingroup info
  \brief Base class, wrapping boolean conditions and expressions
@@ -34,7 +93,7 @@ namespace INFO
 class InfoBool
 {
 public:
-  InfoBool(const std::string &expression, int context, unsigned int &refreshCounter);
+  InfoBool(const std::string &expression, int context, const InfoSourceCounters &sources);
   virtual ~InfoBool() = default;
 
   virtual void Initialize() {};
@@ -47,10 +106,14 @@ public:
   {
     if (item && m_listItemDependent)
       Update(item);
-    else if (m_refreshCounter != m_parentRefreshCounter || m_refreshCounter == 0)
+    else
     {
-      Update(NULL);
-      m_refreshCounter = m_parentRefreshCounter;
+      unsigned int stamp = m_sources.GetStamp(m_dependencies);
+      if (stamp != m_stamp || stamp == 0)
+      {
+        Update(NULL);
+        m_stamp = stamp;
+      }
     }
     return m_value;
   }
@@ -78,16 +141,18 @@ public:
 
   const std::string &GetExpression() const { return m_expression; }
   bool ListItemDependent() const { return m_listItemDependent; }
+  unsigned int GetDependencies() const { return m_dependencies; }
 protected:
 
   bool m_value;                ///< current value
   int m_context;               ///< contextual information to go with the condition
   bool m_listItemDependent;    ///< do not cache if a listitem pointer is given
+  unsigned int m_dependencies; ///< INFO_DEPENDS_ON() flags of the sources the value is computed from
   std::string  m_expression;   ///< original expression
 
 private:
-  unsigned int m_refreshCounter;
-  unsigned int &m_parentRefreshCounter;
+  unsigned int m_stamp;
+  const InfoSourceCounters &m_sources;
 };
 
 typedef std::shared_ptr<InfoBool> InfoPtr;
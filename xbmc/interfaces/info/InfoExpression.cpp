@@ -22,6 +22,7 @@
 #include <stack>
 #include "utils/log.h"
 #include "GUIInfoManager.h"
+#include <algorithm>
 #include <list>
 #include <memory>
 
@@ -30,6 +31,7 @@ using namespace INFO;
 void InfoSingle::Initialize()
 {
   m_condition = g_infoManager.TranslateSingleString(m_expression, m_listItemDependent);
+  m_dependencies = g_infoManager.GetDependencies(m_condition, m_listItemDependent);
 }
 
 void InfoSingle::Update(const CGUIListItem *item)
@@ -42,36 +44,128 @@ void InfoExpression::Initialize()
   if (!Parse(m_expression))
   {
     CLog::Log(LOGERROR, "Error parsing boolean expression %s", m_expression.c_str());
-    m_expression_tree = std::make_shared<InfoLeaf>(g_infoManager.Register("false", 0), false);
+    m_leaves.clear();
+    m_groups.clear();
+    m_code.assign(1, Instruction(OPCODE_CONSTANT, false, 0));
   }
 }
 
 void InfoExpression::Update(const CGUIListItem *item)
 {
-  m_value = m_expression_tree->Evaluate(item);
+  m_value = Evaluate(item);
 }
 
 /* Expressions are rewritten at parse time into a form which favours the
- * formation of groups of associative nodes. These groups are then reordered at
- * evaluation time such that nodes whose value renders the evaluation of the
- * remainder of the group unnecessary tend to be evaluated first (these are
- * true nodes for OR subexpressions, or false nodes for AND subexpressions).
- * The end effect is to minimise the number of leaf nodes that need to be
- * evaluated in order to determine the value of the expression. The runtime
- * adaptability has the advantage of not being customised for any particular skin.
+ * formation of groups of associative nodes, and the resulting tree is then
+ * compiled into a flat list of instructions.
  *
  * The modifications to the expression at parse time fall into two groups:
  * 1) Moving logical NOTs so that they are only applied to leaf nodes.
- *    For example, rewriting ![A+B]|C as !A|!B|C allows reordering such that
- *    any of the three leaves can be evaluated first.
+ *    For example, rewriting ![A+B]|C as !A|!B|C, so no instruction is needed
+ *    to invert the value of a subexpression.
  * 2) Combining adjacent AND or OR operations such that each path from the root
  *    to a leaf encounters a strictly alternating pattern of AND and OR
  *    operations. So [A|B]|[C|D+[[E|F]|G] becomes A|B|C|[D+[E|F|G]].
+ *
+ * Each group is compiled into one block per child, holding the code of the
+ * child followed by a jump to the end of the group, which is taken as soon as
+ * the value of the child decides the value of the group (true for OR groups,
+ * false for AND groups). Evaluation only keeps the value of the last evaluated
+ * child, so A|B+C compiles to
+ *   LEAF A; JUMP_IF_TRUE 5; LEAF B; JUMP_IF_FALSE 2; LEAF C; JUMP_IF_FALSE 0; JUMP_IF_TRUE 0
+ * Conditions which never change, like true or System.Platform.Linux, are
+ * evaluated while compiling and folded into their group.
+ *
+ * Blocks are reordered at evaluation time such that blocks deciding the value
+ * of their group tend to be evaluated first. The end effect is to minimise the
+ * number of leaves that need to be evaluated in order to determine the value
+ * of the expression. The runtime adaptability has the advantage of not being
+ * customised for any particular skin.
  */
 
-bool InfoExpression::InfoLeaf::Evaluate(const CGUIListItem *item)
+bool InfoExpression::Evaluate(const CGUIListItem *item)
+{
+  bool value = false;
+  const Instruction *begin = m_code.data();
+  const Instruction *end = begin + m_code.size();
+  for (const Instruction *ip = begin; ip < end; ++ip)
+  {
+    switch (ip->opcode)
+    {
+    case OPCODE_LEAF:
+      value = ip->invert ^ m_leaves[ip->operand]->Get(item);
+      continue;
+    case OPCODE_CONSTANT:
+      value = ip->invert;
+      continue;
+    case OPCODE_JUMP_IF_TRUE:
+      if (!value)
+        continue;
+      break;
+    case OPCODE_JUMP_IF_FALSE:
+      if (value)
+        continue;
+      break;
+    }
+
+    // the block decided its group, evaluate it first next time
+    unsigned int position = ip - begin;
+    const Group &group = m_groups[ip->group];
+    if (position + 1 != group.start + group.blocks.front())
+      MoveBlockToFront(ip->group, position);
+    ip = begin + group.start + group.size - 1;
+  }
+  return value;
+}
+
+void InfoExpression::MoveBlockToFront(unsigned int index, unsigned int position)
+{
+  Group &group = m_groups[index];
+
+  // find the block ending at position
+  unsigned int offset = 0;
+  std::vector<unsigned int>::iterator block = group.blocks.begin();
+  while (group.start + offset + *block != position + 1)
+    offset += *block++;
+
+  std::vector<Instruction>::iterator start = m_code.begin() + group.start;
+  std::rotate(start, start + offset, start + offset + *block);
+  std::rotate(group.blocks.begin(), block, block + 1);
+
+  // fix the jumps at the end of the blocks of this group, which are the only jumps
+  // that leave a block
+  offset = 0;
+  for (block = group.blocks.begin(); block != group.blocks.end(); ++block)
+  {
+    offset += *block;
+    m_code[group.start + offset - 1].operand = group.size - offset;
+  }
+
+  // groups inside the moved blocks moved along with them
+  for (unsigned int i = group.start; i < group.start + group.size; i++)
+  {
+    const Instruction &instruction = m_code[i];
+    if (instruction.opcode != OPCODE_LEAF && instruction.opcode != OPCODE_CONSTANT && instruction.group != index)
+    {
+      Group &inner = m_groups[instruction.group];
+      inner.start = i + 1 + instruction.operand - inner.size;
+    }
+  }
+}
+
+int InfoExpression::InfoLeaf::Compile(std::vector<InfoPtr> &leaves, std::vector<Group> &groups, std::vector<Instruction> &code) const
 {
-  return m_invert ^ m_info->Get(item);
+  if (m_info->GetDependencies() == 0 && !m_info->ListItemDependent())
+    return m_invert ^ m_info->Get();
+
+  unsigned int index = 0;
+  while (index < leaves.size() && leaves[index] != m_info)
+    index++;
+  if (index == leaves.size())
+    leaves.push_back(m_info);
+
+  code.push_back(Instruction(OPCODE_LEAF, m_invert, index));
+  return -1;
 }
 
 InfoExpression::InfoAssociativeGroup::InfoAssociativeGroup(
@@ -94,27 +188,73 @@ void InfoExpression::InfoAssociativeGroup::Merge(std::shared_ptr<InfoAssociative
   m_children.splice(m_children.end(), other->m_children);
 }
 
-bool InfoExpression::InfoAssociativeGroup::Evaluate(const CGUIListItem *item)
+int InfoExpression::InfoAssociativeGroup::Compile(std::vector<InfoPtr> &leaves, std::vector<Group> &groups, std::vector<Instruction> &code) const
 {
-  /* Handle either AND or OR by using the relation
-   * A AND B == !(!A OR !B)
-   * to convert ANDs into ORs
-   */
-  std::list<InfoSubexpressionPtr>::iterator last = m_children.end();
-  std::list<InfoSubexpressionPtr>::iterator it = m_children.begin();
-  bool use_and = (m_type == NODE_AND);
-  bool result = use_and ^ (*it)->Evaluate(item);
-  while (!result && ++it != last)
+  // the value that decides the group: true for OR, false for AND
+  const int decisive = m_type == NODE_OR ? 1 : 0;
+
+  std::vector<std::vector<Instruction>> children;
+  for (std::list<InfoSubexpressionPtr>::const_iterator it = m_children.begin(); it != m_children.end(); ++it)
+  {
+    std::vector<Instruction> child;
+    int value = (*it)->Compile(leaves, groups, child);
+    if (value == decisive)
+      return decisive;
+    else if (value < 0)
+      children.push_back(child);
+    // constant children which don't decide the group don't change its value either
+  }
+  if (children.empty())
+    return !decisive;
+  if (children.size() == 1)
+  {
+    code.insert(code.end(), children.front().begin(), children.front().end());
+    return -1;
+  }
+
+  Group group;
+  group.start = 0; // known once the whole expression is compiled
+  group.size = 0;
+  for (size_t i = 0; i < children.size(); i++)
+  {
+    group.blocks.push_back(children[i].size() + 1);
+    group.size += group.blocks.back();
+  }
+
+  const opcode_t jump = decisive ? OPCODE_JUMP_IF_TRUE : OPCODE_JUMP_IF_FALSE;
+  unsigned int offset = 0;
+  for (size_t i = 0; i < children.size(); i++)
+  {
+    code.insert(code.end(), children[i].begin(), children[i].end());
+    offset += group.blocks[i];
+    code.push_back(Instruction(jump, false, group.size - offset, groups.size()));
+  }
+  groups.push_back(group);
+  return -1;
+}
+
+void InfoExpression::Compile(const InfoSubexpressionPtr &expression_tree)
+{
+  m_leaves.clear();
+  m_groups.clear();
+  m_code.clear();
+  int value = expression_tree->Compile(m_leaves, m_groups, m_code);
+  if (value >= 0)
+  {
+    m_code.assign(1, Instruction(OPCODE_CONSTANT, value != 0, 0));
+    return;
+  }
+
+  // every jump leads to the end of its group
+  for (unsigned int i = 0; i < m_code.size(); i++)
   {
-    result = use_and ^ (*it)->Evaluate(item);
-    if (result)
+    const Instruction &instruction = m_code[i];
+    if (instruction.opcode == OPCODE_JUMP_IF_TRUE || instruction.opcode == OPCODE_JUMP_IF_FALSE)
     {
-      /* Move this child to the head of the list so we evaluate faster next time */
-      m_children.push_front(*it);
-      m_children.erase(it);
+      Group &group = m_groups[instruction.group];
+      group.start = i + 1 + instruction.operand - group.size;
     }
   }
-  return use_and ^ result;
 }
 
 /* Expressions are parsed using the shunting-yard algorithm. Binary operators
@@ -246,8 +386,9 @@ bool InfoExpression::Parse(const std::string &expression)
           CLog::Log(LOGERROR, "Bad operand '%s'", operand.c_str());
           return false;
         }
-        /* Propagate any listItem dependency from the operand to the expression */
+        /* Propagate any listItem dependency and state dependencies from the operand to the expression */
         m_listItemDependent |= info->ListItemDependent();
+        m_dependencies |= info->GetDependencies();
         nodes.push(std::make_shared<InfoLeaf>(info, invert));
         /* Reuse operand string for next operand */
         operand.clear();
@@ -297,13 +438,14 @@ bool InfoExpression::Parse(const std::string &expression)
       CLog::Log(LOGERROR, "Bad operand '%s'", operand.c_str());
       return false;
     }
-    /* Propagate any listItem dependency from the operand to the expression */
+    /* Propagate any listItem dependency and state dependencies from the operand to the expression */
     m_listItemDependent |= info->ListItemDependent();
+    m_dependencies |= info->GetDependencies();
     nodes.push(std::make_shared<InfoLeaf>(info, invert));
   }
   while (!operator_stack.empty())
     OperatorPop(operator_stack, invert, nodes);
 
-  m_expression_tree = nodes.top();
+  Compile(nodes.top());
   return true;
 }
@@ -34,8 +34,8 @@ namespace INFO
 class InfoSingle : public InfoBool
 {
 public:
-  InfoSingle(const std::string &expression, int context, unsigned int &refreshCounter)
-    : InfoBool(expression, context, refreshCounter) {};
+  InfoSingle(const std::string &expression, int context, const InfoSourceCounters &sources)
+    : InfoBool(expression, context, sources) {};
   void Initialize() override;
 
   void Update(const CGUIListItem *item) override;
@@ -48,8 +48,8 @@ private:
 class InfoExpression : public InfoBool
 {
 public:
-  InfoExpression(const std::string &expression, int context, unsigned int &refreshCounter)
-    : InfoBool(expression, context, refreshCounter) {};
+  InfoExpression(const std::string &expression, int context, const InfoSourceCounters &sources)
+    : InfoBool(expression, context, sources) {};
   ~InfoExpression() override = default;
 
   void Initialize() override;
@@ -73,13 +73,43 @@ private:
     NODE_OR,
   } node_type_t;
 
-  // An abstract base class for nodes in the expression tree
+  typedef enum
+  {
+    OPCODE_LEAF,          ///< value = leaf value ^ invert
+    OPCODE_CONSTANT,      ///< value = invert
+    OPCODE_JUMP_IF_TRUE,  ///< skip the next operand instructions if value is true
+    OPCODE_JUMP_IF_FALSE, ///< skip the next operand instructions if value is false
+  } opcode_t;
+
+  struct Instruction
+  {
+    Instruction(opcode_t op, bool inv, unsigned int arg, unsigned int grp = 0)
+      : opcode(op), invert(inv), operand(arg), group(grp) {};
+    opcode_t opcode;
+    bool invert;
+    unsigned int operand;   ///< index of the leaf or number of instructions to skip
+    unsigned int group;     ///< group a jump ends a block of
+  };
+
+  // The code of an AND or OR group: one block per child, each ending with a jump to the end of the group
+  struct Group
+  {
+    unsigned int start;               ///< position of the first instruction of the group
+    unsigned int size;
+    std::vector<unsigned int> blocks; ///< size of the blocks in the order they are evaluated
+  };
+
+  // An abstract base class for nodes in the expression tree, which is only built while parsing
   class InfoSubexpression
   {
   public:
     virtual ~InfoSubexpression(void) = default; // so we can destruct derived classes using a pointer to their base class
-    virtual bool Evaluate(const CGUIListItem *item) = 0;
     virtual node_type_t Type() const=0;
+
+    /*! \brief Append the instructions evaluating this node to code
+     \return the value if the node is constant and no instructions were added, -1 otherwise
+     */
+    virtual int Compile(std::vector<InfoPtr> &leaves, std::vector<Group> &groups, std::vector<Instruction> &code) const = 0;
   };
 
   typedef std::shared_ptr<InfoSubexpression> InfoSubexpressionPtr;
@@ -89,8 +119,8 @@ private:
   {
   public:
     InfoLeaf(InfoPtr info, bool invert) : m_info(info), m_invert(invert) {};
-    bool Evaluate(const CGUIListItem *item) override;
     node_type_t Type() const override { return NODE_LEAF; };
+    int Compile(std::vector<InfoPtr> &leaves, std::vector<Group> &groups, std::vector<Instruction> &code) const override;
   private:
     InfoPtr m_info;
     bool m_invert;
@@ -103,8 +133,8 @@ private:
     InfoAssociativeGroup(node_type_t type, const InfoSubexpressionPtr &left, const InfoSubexpressionPtr &right);
     void AddChild(const InfoSubexpressionPtr &child);
     void Merge(std::shared_ptr<InfoAssociativeGroup> other);
-    bool Evaluate(const CGUIListItem *item) override;
     node_type_t Type() const override { return m_type; };
+    int Compile(std::vector<InfoPtr> &leaves, std::vector<Group> &groups, std::vector<Instruction> &code) const override;
   private:
     node_type_t m_type;
     std::list<InfoSubexpressionPtr> m_children;
@@ -113,7 +143,13 @@ private:
   static operator_t GetOperator(char ch);
   static void OperatorPop(std::stack<operator_t> &operator_stack, bool &invert, std::stack<InfoSubexpressionPtr> &nodes);
   bool Parse(const std::string &expression);
-  InfoSubexpressionPtr m_expression_tree;
+  void Compile(const InfoSubexpressionPtr &expression_tree);
+  bool Evaluate(const CGUIListItem *item);
+  void MoveBlockToFront(unsigned int group, unsigned int position);
+
+  std::vector<Instruction> m_code;  ///< compiled expression, see Compile()
+  std::vector<InfoPtr> m_leaves;    ///< conditions referenced by OPCODE_LEAF instructions
+  std::vector<Group> m_groups;
 };
 
 };
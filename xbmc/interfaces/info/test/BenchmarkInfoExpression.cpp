@@ -0,0 +1,87 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "GUIInfoManager.h"
+#include "TestInfoExpression.h"
+#include "utils/Stopwatch.h"
+
+#include "gtest/gtest.h"
+
+using namespace InfoExpressionTest;
+
+#define BENCHMARK_EVALUATIONS 200000
+
+namespace
+{
+struct InfoLeaves
+{
+  explicit InfoLeaves(const CFileItem &item) : m_item(item)
+  {
+    for (unsigned int i = 0; i < LEAF_COUNT; i++)
+      m_infos.push_back(g_infoManager.Register(Expand(std::string(1, (char)('a' + i)))));
+  }
+  bool operator()(char leaf) const { return m_infos[leaf - 'a']->Get(&m_item); }
+
+  const CFileItem &m_item;
+  std::vector<INFO::InfoPtr> m_infos;
+};
+}
+
+TEST(BenchmarkInfoExpression, Evaluate)
+{
+  // a visibility condition as found in skins, where the last blocks of the
+  // groups decide them most of the time
+  const char *expression = "a+b+[c|d|e+!f]|![a|b|c]+d|e+f";
+  INFO::InfoSourceCounters sources;
+  CFileItem item;
+  CTreeExpression tree(expression);
+  INFO::InfoPtr info = Compile(expression, sources);
+  InfoLeaves leaves(item);
+
+  // mostly d, e and f set, so the blocks compiled last decide their groups
+  const unsigned int values[] = { 0x38, 0x30, 0x38, 0x3c, 0x38, 0x1f };
+  const unsigned int count = sizeof(values) / sizeof(values[0]);
+
+  unsigned int matches = 0;
+  CStopWatch watch;
+  watch.StartZero();
+  for (unsigned int i = 0; i < BENCHMARK_EVALUATIONS; i++)
+  {
+    SetLeaves(item, values[i % count]);
+    matches += info->Get(&item);
+  }
+  float compiledMs = watch.GetElapsedMilliseconds();
+
+  unsigned int treeMatches = 0;
+  watch.StartZero();
+  for (unsigned int i = 0; i < BENCHMARK_EVALUATIONS; i++)
+  {
+    SetLeaves(item, values[i % count]);
+    treeMatches += tree.Evaluate(leaves);
+  }
+  float treeMs = watch.GetElapsedMilliseconds();
+
+  EXPECT_EQ(treeMatches, matches);
+
+  ::testing::Test::RecordProperty("evaluations", BENCHMARK_EVALUATIONS);
+  ::testing::Test::RecordProperty("compiled_ns_per_evaluation", static_cast<int>(compiledMs * 1000000 / BENCHMARK_EVALUATIONS));
+  ::testing::Test::RecordProperty("tree_ns_per_evaluation", static_cast<int>(treeMs * 1000000 / BENCHMARK_EVALUATIONS));
+}
@@ -0,0 +1,121 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "TestInfoExpression.h"
+
+#include "gtest/gtest.h"
+
+using namespace InfoExpressionTest;
+
+namespace
+{
+// expressions over the leaves a to f and the constants T and F; each covers a
+// different nesting of AND, OR and NOT
+const char *const expressions[] = {
+  "a|b",
+  "a+b",
+  "!a",
+  "a|b+c",
+  "[a|b]+c",
+  "!a+b|c",
+  "![a|b]+c",
+  "!![a+b]|!c",
+  "a+[b|c+!d]|![e+f]",
+  "[a|b]+[c|d]+[e|f]",
+  "![a+!b|c]+[d|!e]|f",
+  "a+[b|[c+[d|[e+f]]]]",
+  "!a|[b+![c|!d+[e|!f]]]",
+  "a+[a|b]+!a|b",
+  "a|T",
+  "a+F|b",
+  "[a|F]+[T+b]|!T+c",
+  "![T+a]|[F|b]+c",
+};
+
+struct BitLeaves
+{
+  explicit BitLeaves(unsigned int values) : m_values(values) {}
+  bool operator()(char leaf) const { return (m_values & (1 << (leaf - 'a'))) != 0; }
+  unsigned int m_values;
+};
+}
+
+TEST(TestInfoExpression, MatchesTree)
+{
+  // a new expression for every evaluation, so the blocks are in the order they were compiled
+  INFO::InfoSourceCounters sources;
+  CFileItem item;
+  for (const char *expression : expressions)
+  {
+    SCOPED_TRACE(expression);
+    CTreeExpression tree(expression);
+    for (unsigned int values = 0; values < (1 << LEAF_COUNT); values++)
+    {
+      SCOPED_TRACE(values);
+      SetLeaves(item, values);
+      BitLeaves leaves(values);
+      EXPECT_EQ(tree.Evaluate(leaves), Compile(expression, sources)->Get(&item));
+    }
+  }
+}
+
+TEST(TestInfoExpression, MatchesTreeAfterReordering)
+{
+  // evaluating the same expression with changing values moves the deciding blocks to the
+  // front of their groups, which must not change the value
+  INFO::InfoSourceCounters sources;
+  CFileItem item;
+  const unsigned int combinations = 1 << LEAF_COUNT;
+  for (const char *expression : expressions)
+  {
+    SCOPED_TRACE(expression);
+    CTreeExpression tree(expression);
+    INFO::InfoPtr info = Compile(expression, sources);
+
+    std::vector<unsigned int> sequence;
+    for (unsigned int values = 0; values < combinations; values++)
+      sequence.push_back(values);
+    for (unsigned int values = combinations; values > 0; values--)
+      sequence.push_back(values - 1);
+    unsigned int random = 12345;
+    for (unsigned int i = 0; i < 1000; i++)
+    {
+      random = random * 1103515245 + 12345;
+      sequence.push_back((random >> 16) % combinations);
+    }
+
+    for (unsigned int values : sequence)
+    {
+      SCOPED_TRACE(values);
+      SetLeaves(item, values);
+      BitLeaves leaves(values);
+      ASSERT_EQ(tree.Evaluate(leaves), info->Get(&item));
+    }
+  }
+}
+
+TEST(TestInfoExpression, Constant)
+{
+  INFO::InfoSourceCounters sources;
+  EXPECT_TRUE(Compile("T|F", sources)->Get());
+  EXPECT_FALSE(Compile("![T+!F]", sources)->Get());
+  EXPECT_TRUE(Compile("[F|!F]+[T|a]", sources)->Get());
+}
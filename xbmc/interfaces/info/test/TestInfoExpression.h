@@ -0,0 +1,166 @@
+#pragma once
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "FileItem.h"
+#include "interfaces/info/InfoExpression.h"
+#include "utils/Variant.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace InfoExpressionTest
+{
+// leaves are the list item properties a to f, T and F are the constants
+static const unsigned int LEAF_COUNT = 6;
+
+/*!
+ \brief Straightforward evaluator of the expression tree, used as reference for InfoExpression
+ */
+class CTreeExpression
+{
+public:
+  explicit CTreeExpression(const std::string &expression)
+  {
+    size_t pos = 0;
+    m_root = ParseOr(expression, pos);
+  }
+
+  /*!
+   \param leaf functor returning the value of a leaf, given its letter
+   */
+  template<typename TLeaf>
+  bool Evaluate(TLeaf &leaf) const
+  {
+    return Evaluate(*m_root, leaf);
+  }
+
+private:
+  struct Node
+  {
+    char type; ///< '|', '+', '!' or the letter of a leaf
+    std::vector<std::unique_ptr<Node>> children;
+  };
+
+  static std::unique_ptr<Node> ParseOr(const std::string &str, size_t &pos)
+  {
+    std::unique_ptr<Node> node = ParseAnd(str, pos);
+    while (pos < str.size() && str[pos] == '|')
+      node = Combine('|', std::move(node), ParseAnd(str, ++pos));
+    return node;
+  }
+
+  static std::unique_ptr<Node> ParseAnd(const std::string &str, size_t &pos)
+  {
+    std::unique_ptr<Node> node = ParseUnary(str, pos);
+    while (pos < str.size() && str[pos] == '+')
+      node = Combine('+', std::move(node), ParseUnary(str, ++pos));
+    return node;
+  }
+
+  static std::unique_ptr<Node> ParseUnary(const std::string &str, size_t &pos)
+  {
+    std::unique_ptr<Node> node(new Node);
+    char c = str[pos++];
+    if (c == '!')
+    {
+      node->type = '!';
+      node->children.push_back(ParseUnary(str, pos));
+    }
+    else if (c == '[')
+    {
+      node = ParseOr(str, pos);
+      pos++; // ]
+    }
+    else
+      node->type = c;
+    return node;
+  }
+
+  static std::unique_ptr<Node> Combine(char type, std::unique_ptr<Node> left, std::unique_ptr<Node> right)
+  {
+    std::unique_ptr<Node> node(new Node);
+    node->type = type;
+    node->children.push_back(std::move(left));
+    node->children.push_back(std::move(right));
+    return node;
+  }
+
+  template<typename TLeaf>
+  static bool Evaluate(const Node &node, TLeaf &leaf)
+  {
+    switch (node.type)
+    {
+    case '|':
+      return Evaluate(*node.children[0], leaf) || Evaluate(*node.children[1], leaf);
+    case '+':
+      return Evaluate(*node.children[0], leaf) && Evaluate(*node.children[1], leaf);
+    case '!':
+      return !Evaluate(*node.children[0], leaf);
+    case 'T':
+      return true;
+    case 'F':
+      return false;
+    default:
+      return leaf(node.type);
+    }
+  }
+
+  std::unique_ptr<Node> m_root;
+};
+
+/*!
+ \brief Turn the letters of an expression into the conditions InfoExpression understands
+ */
+inline std::string Expand(const std::string &expression)
+{
+  std::string expanded;
+  for (char c : expression)
+  {
+    if (c >= 'a' && c < 'a' + (char)LEAF_COUNT)
+      expanded += std::string("ListItem.Property(") + c + ")";
+    else if (c == 'T')
+      expanded += "true";
+    else if (c == 'F')
+      expanded += "false";
+    else
+      expanded += c;
+  }
+  return expanded;
+}
+
+/*!
+ \brief Set the properties of item to the leaf values given as bits of values, a being the lowest
+ */
+inline void SetLeaves(CFileItem &item, unsigned int values)
+{
+  for (unsigned int i = 0; i < LEAF_COUNT; i++)
+    item.SetProperty(std::string(1, (char)('a' + i)), (values & (1 << i)) != 0);
+}
+
+inline INFO::InfoPtr Compile(const std::string &expression, const INFO::InfoSourceCounters &sources)
+{
+  INFO::InfoPtr info = std::make_shared<INFO::InfoExpression>(Expand(expression), 0, sources);
+  info->Initialize();
+  return info;
+}
+}
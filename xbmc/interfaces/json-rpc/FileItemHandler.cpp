@@ -23,6 +23,7 @@
 
 #include "FileItemHandler.h"
 #include "AudioLibrary.h"
+#include "JSONResponseStream.h"
 #include "VideoLibrary.h"
 #include "FileOperations.h"
 #include "utils/SortUtils.h"
@@ -204,6 +205,57 @@ void CFileItemHandler::FillDetails(const ISerializable *info, const CFileItemPtr
   }
 }
 
+/*!
+ \brief Produces the items of a list for a CJSONResponseStream the same way HandleFileItemList() does.
+ */
+class CFileItemHandler::CFileItemListSource : public IResultItemSource
+{
+public:
+  CFileItemListSource(const char *ID, bool allowFile, const CFileItemList &items, int start, int end,
+                      const CVariant &parameterObject, const std::set<std::string> &fields, CThumbLoader *thumbLoader)
+    : m_hasID(ID != NULL)
+    , m_ID(ID ? ID : "")
+    , m_allowFile(allowFile)
+    , m_parameterObject(parameterObject)
+    , m_fields(fields)
+    , m_thumbLoader(thumbLoader)
+    , m_current(0)
+  {
+    m_items.reserve(end - start);
+    for (int i = start; i < end; i++)
+      m_items.push_back(items.Get(i));
+  }
+
+  ~CFileItemListSource() override
+  {
+    delete m_thumbLoader;
+  }
+
+  bool Next(CVariant &item) override
+  {
+    if (m_current >= m_items.size())
+      return false;
+
+    CVariant result;
+    HandleFileItem(m_hasID ? m_ID.c_str() : NULL, m_allowFile, "item", m_items[m_current], m_parameterObject, m_fields, result, false, m_thumbLoader);
+    item = std::move(result["item"]);
+
+    // the item won't be needed again
+    m_items[m_current++].reset();
+    return true;
+  }
+
+private:
+  bool m_hasID;
+  std::string m_ID;
+  bool m_allowFile;
+  CVariant m_parameterObject;
+  std::set<std::string> m_fields;
+  CThumbLoader *m_thumbLoader;
+  std::vector<CFileItemPtr> m_items;
+  size_t m_current;
+};
+
 void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const char *resultname, CFileItemList &items, const CVariant &parameterObject, CVariant &result, bool sortLimit /* = true */)
 {
   HandleFileItemList(ID, allowFile, resultname, items, parameterObject, result, items.Size(), sortLimit);
@@ -241,6 +293,14 @@ void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const
       fields.insert(field->asString());
   }
 
+  // let the response stream produce the items while it's being sent instead of
+  // holding all of them in the result
+  if (end - start > 0 && CJSONResponseStream::CanDefer())
+  {
+    CJSONResponseStream::Defer(result[resultname], new CFileItemListSource(ID, allowFile, items, start, end, parameterObject, fields, thumbLoader));
+    return;
+  }
+
   for (int i = start; i < end; i++)
   {
     CFileItemPtr item = items.Get(i);
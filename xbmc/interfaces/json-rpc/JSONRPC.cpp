@@ -21,6 +21,7 @@
 #include <string.h>
 
 #include "JSONRPC.h"
+#include "JSONResponseStream.h"
 #include "ServiceDescription.h"
 #include "addons/Addon.h"
 #include "addons/IAddon.h"
@@ -235,9 +236,19 @@ JSONRPC_STATUS CJSONRPC::NotifyAll(const std::string &method, ITransportLayer *t
 }
 
 std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client)
+{
+  CJSONResponseStream response;
+  if (!MethodCall(inputString, transport, client, response))
+    return "";
+
+  return response.ReadAll();
+}
+
+bool CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client, CJSONResponseStream &response)
 {
   CVariant inputroot, outputroot, result;
   bool hasResponse = false;
+  CJSONResponseStream::CScope scope(&response);
 
   CLog::Log(LOGDEBUG, LOGJSONRPC, "JSONRPC: Incoming request: %s", inputString.c_str());
 
@@ -274,11 +285,10 @@ std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer
     hasResponse = true;
   }
 
-  std::string str;
-  if (hasResponse)
-    CJSONVariantWriter::Write(outputroot, str, g_advancedSettings.m_jsonOutputCompact);
+  if (!hasResponse)
+    return false;
 
-  return str;
+  return response.SetResponse(outputroot, g_advancedSettings.m_jsonOutputCompact);
 }
 
 bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client)
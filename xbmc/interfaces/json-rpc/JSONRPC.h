@@ -31,6 +31,8 @@ class CVariant;
 
 namespace JSONRPC
 {
+  class CJSONResponseStream;
+
   /*!
    \ingroup jsonrpc
    \brief JSON RPC handler
@@ -64,6 +66,19 @@ namespace JSONRPC
      */
     static std::string MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client);
 
+    /*
+     \brief Handles an incoming JSON-RPC request with a response read piece by piece
+     \param inputString received JSON-RPC request
+     \param transport Transport protocol on which the request arrived
+     \param client Client which sent the request
+     \param response Stream the JSON-RPC response is read from
+     \return false if there is no response to be sent back to the client
+
+     Long lists in the response are only produced while the response is read
+     from the stream, see CJSONResponseStream.
+     */
+    static bool MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client, CJSONResponseStream &response);
+
     static JSONRPC_STATUS Introspect(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Version(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Permission(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
@@ -0,0 +1,199 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "JSONResponseStream.h"
+#include "threads/ThreadLocal.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/log.h"
+#include "utils/Variant.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+using namespace JSONRPC;
+
+static XbmcThreads::ThreadLocal<CJSONResponseStream> currentStream;
+
+CJSONResponseStream::CScope::CScope(CJSONResponseStream *stream)
+  : m_previous(currentStream.get())
+{
+  currentStream.set(stream);
+}
+
+CJSONResponseStream::CScope::~CScope()
+{
+  currentStream.set(m_previous);
+}
+
+CJSONResponseStream::CJSONResponseStream()
+  : m_compact(true)
+  , m_textPos(0)
+  , m_nextDeferred(0)
+  , m_source(-1)
+  , m_firstItem(false)
+  , m_pendingPos(0)
+{
+}
+
+CJSONResponseStream::~CJSONResponseStream() = default;
+
+bool CJSONResponseStream::CanDefer()
+{
+  return currentStream.get() != NULL;
+}
+
+void CJSONResponseStream::Defer(CVariant &target, IResultItemSource *source)
+{
+  CJSONResponseStream *stream = currentStream.get();
+  assert(stream != NULL);
+
+  target = CVariant::CreateDeferred(stream->m_sources.size());
+  stream->m_sources.emplace_back(source);
+}
+
+bool CJSONResponseStream::SetResponse(const CVariant &response, bool compact)
+{
+  m_compact = compact;
+  m_textPos = 0;
+  m_nextDeferred = 0;
+  m_source = -1;
+  m_pending.clear();
+  m_pendingPos = 0;
+
+  if (!CJSONVariantWriter::Write(response, m_text, compact, m_deferred))
+  {
+    m_text.clear();
+    m_deferred.clear();
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Produces the next part of the response in m_pending: either the text up to
+ * and including the opening bracket of the next deferred list, a single item of
+ * that list or its closing bracket.
+ */
+bool CJSONResponseStream::Fill()
+{
+  m_pending.clear();
+  m_pendingPos = 0;
+
+  if (m_source >= 0)
+  {
+    CVariant item;
+    if (m_sources[m_source]->Next(item))
+    {
+      if (!m_firstItem)
+        m_pending = ",";
+      m_firstItem = false;
+
+      std::string str;
+      if (!CJSONVariantWriter::Write(item, str, m_compact))
+      {
+        CLog::Log(LOGERROR, "JSONRPC: Failed to serialise a list item");
+        str = "null";
+      }
+      m_pending += str;
+      return true;
+    }
+
+    // release what the list holds on to as soon as possible
+    m_sources[m_source].reset();
+    m_source = -1;
+    m_pending = "]";
+    return true;
+  }
+
+  if (m_textPos >= m_text.size())
+    return false;
+
+  if (m_nextDeferred < m_deferred.size())
+  {
+    size_t offset = m_deferred[m_nextDeferred].first;
+    uint64_t index = m_deferred[m_nextDeferred].second;
+    m_nextDeferred++;
+
+    m_pending.assign(m_text, m_textPos, offset - m_textPos);
+    m_textPos = offset + 4; // skip the null written in place of the list
+
+    // a deferred value copied into several places of the response produces its list once
+    if (index < m_sources.size() && m_sources[index])
+    {
+      m_pending += "[";
+      m_source = (int)index;
+      m_firstItem = true;
+    }
+    else
+      m_pending += "[]";
+  }
+  else
+  {
+    m_pending.assign(m_text, m_textPos, std::string::npos);
+    m_textPos = m_text.size();
+  }
+  return true;
+}
+
+size_t CJSONResponseStream::Read(char *buffer, size_t size)
+{
+  size_t read = 0;
+  while (read < size)
+  {
+    if (m_pendingPos >= m_pending.size() && !Fill())
+      break;
+
+    size_t len = std::min(size - read, m_pending.size() - m_pendingPos);
+    memcpy(buffer + read, m_pending.c_str() + m_pendingPos, len);
+    m_pendingPos += len;
+    read += len;
+  }
+  return read;
+}
+
+void CJSONResponseStream::Close()
+{
+  m_sources.clear();
+  m_source = -1;
+  m_text.clear();
+  m_textPos = 0;
+  m_deferred.clear();
+  m_nextDeferred = 0;
+  m_pending.clear();
+  m_pendingPos = 0;
+}
+
+std::string CJSONResponseStream::ReadAll()
+{
+  std::string str;
+  if (!IsDeferred() && m_textPos == 0)
+  {
+    // nothing read yet and nothing to produce, hand out the text as it is
+    str.swap(m_text);
+    return str;
+  }
+
+  char buffer[4096];
+  size_t read;
+  while ((read = Read(buffer, sizeof(buffer))) > 0)
+    str.append(buffer, read);
+  return str;
+}
@@ -0,0 +1,147 @@
+#pragma once
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+class CVariant;
+
+namespace JSONRPC
+{
+  /*!
+   \brief Produces the items of a list in a JSON-RPC response one at a time.
+   */
+  class IResultItemSource
+  {
+  public:
+    virtual ~IResultItemSource() = default;
+
+    /*!
+     \brief Produce the next item of the list
+     \param item set to the next item
+     \return false once all items have been produced
+     */
+    virtual bool Next(CVariant &item) = 0;
+  };
+
+  /*!
+   \brief Serialised JSON-RPC response which is produced while the transport reads it.
+
+   While a method is executed for a stream, long lists can be handed to the
+   stream with Defer() instead of being appended to the result. The result then
+   only holds a deferred value (see CVariant::CreateDeferred()), and the items
+   are generated and serialised one at a time when the transport reads that part
+   of the response. Memory used for the response is bounded by the largest
+   single item instead of growing with the number of items.
+
+   The lists are produced by the transport's thread while it reads, so the
+   stream must not outlive the request. Transports destroy it, or call Close(),
+   as soon as the response has been sent or the connection is gone.
+   */
+  class CJSONResponseStream
+  {
+  public:
+    CJSONResponseStream();
+    ~CJSONResponseStream();
+
+    /*!
+     \brief Makes the stream the target of Defer() calls on the current thread while in scope
+
+     \details A scope without a stream lets code which post-processes the lists
+     it builds turn deferring off.
+     */
+    class CScope
+    {
+    public:
+      explicit CScope(CJSONResponseStream *stream);
+      ~CScope();
+
+    private:
+      CScope(const CScope&) = delete;
+      CScope& operator=(const CScope&) = delete;
+
+      CJSONResponseStream *m_previous;
+    };
+
+    /*!
+     \brief Set the response to be serialised
+     \param response response tree, possibly containing deferred lists
+     \param compact whether to write compact or pretty printed JSON
+     \return false if the response could not be serialised
+     */
+    bool SetResponse(const CVariant &response, bool compact);
+
+    /*!
+     \brief Whether any part of the response is only produced while reading
+     */
+    bool IsDeferred() const { return !m_sources.empty(); }
+
+    /*!
+     \brief Read the next part of the serialised response
+     \return number of bytes copied to buffer, 0 once the whole response has been read
+     */
+    size_t Read(char *buffer, size_t size);
+
+    /*!
+     \brief Read the remaining response at once
+     */
+    std::string ReadAll();
+
+    /*!
+     \brief Drop the rest of the response and release the lists which haven't been produced yet
+     */
+    void Close();
+
+    /*!
+     \brief Whether a stream is in scope on the current thread, see Defer()
+     */
+    static bool CanDefer();
+
+    /*!
+     \brief Replace target with a deferred value for a list produced by source
+
+     \details The stream in scope on the current thread takes ownership of
+     source. Must only be called if CanDefer() returned true.
+     */
+    static void Defer(CVariant &target, IResultItemSource *source);
+
+  private:
+    CJSONResponseStream(const CJSONResponseStream&) = delete;
+    CJSONResponseStream& operator=(const CJSONResponseStream&) = delete;
+
+    bool Fill();
+
+    bool m_compact;
+    std::string m_text;       ///< serialised response, deferred lists are written as null
+    size_t m_textPos;
+    std::vector<std::pair<size_t, uint64_t>> m_deferred; ///< offsets of the deferred lists in m_text and their sources
+    size_t m_nextDeferred;
+    std::vector<std::unique_ptr<IResultItemSource>> m_sources;
+
+    int m_source;             ///< index of the list currently written, -1 while writing m_text
+    bool m_firstItem;
+    std::string m_pending;    ///< serialised data not read yet
+    size_t m_pendingPos;
+  };
+}
@@ -19,6 +19,7 @@
  */
 
 #include "ProfilesOperations.h"
+#include "JSONResponseStream.h"
 #include "messaging/ApplicationMessenger.h"
 #include "guilib/LocalizeStrings.h"
 #include "profiles/ProfilesManager.h"
@@ -40,7 +41,11 @@ JSONRPC_STATUS CProfilesOperations::GetProfiles(const std::string &method, ITran
     listItems.Add(item);
   }
 
-  HandleFileItemList("profileid", false, "profiles", listItems, parameterObject, result);
+  {
+    // the profiles are amended below, so they have to be in the result
+    CJSONResponseStream::CScope noStream(NULL);
+    HandleFileItemList("profileid", false, "profiles", listItems, parameterObject, result);
+  }
 
   for (CVariant::const_iterator_array propertyiter = parameterObject["properties"].begin_array(); propertyiter != parameterObject["properties"].end_array(); ++propertyiter)
   {
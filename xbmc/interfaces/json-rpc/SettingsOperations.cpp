@@ -664,7 +664,9 @@ bool CSettingsOperations::SerializeSettingList(std::shared_ptr<const CSettingLis
   SerializeSettingListValues(CSettingUtils::GetList(setting), obj["value"]);
   SerializeSettingListValues(CSettingUtils::ListToValues(setting, setting->GetDefault()), obj["default"]);
 
-  obj["elementtype"] = obj["definition"]["type"];
+  // copy first, adding a member to obj invalidates references to its other members
+  CVariant elementType = obj["definition"]["type"];
+  obj["elementtype"] = std::move(elementType);
   obj["delimiter"] = setting->GetDelimiter();
   obj["minimumItems"] = setting->GetMinimumItems();
   obj["maximumItems"] = setting->GetMaximumItems();
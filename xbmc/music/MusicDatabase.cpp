@@ -72,6 +72,7 @@ using namespace MUSIC_INFO;
 
 using ADDON::AddonPtr;
 using KODI::MESSAGING::HELPERS::DialogResponse;
+using dbiplus::field_value;
 
 #define RECENTLY_PLAYED_LIMIT 25
 #define MIN_FULL_SEARCH_LENGTH 3
@@ -529,19 +530,19 @@ int CMusicDatabase::AddSong(const int idAlbum,
     URIUtils::Split(strPathAndFileName, strPath, strFileName);
     int idPath = AddPath(strPath);
 
+    bool found;
     if (!strMusicBrainzTrackID.empty())
-      strSQL = PrepareSQL("SELECT idSong FROM song WHERE idAlbum = %i AND iTrack=%i AND strMusicBrainzTrackID = '%s'",
-                          idAlbum, 
-                          iTrack,
-                          strMusicBrainzTrackID.c_str());
+    {
+      strSQL = "SELECT idSong FROM song WHERE idAlbum = ? AND iTrack=? AND strMusicBrainzTrackID = ?";
+      found = m_pDS->query(strSQL, { field_value(idAlbum), field_value(iTrack), field_value(strMusicBrainzTrackID) });
+    }
     else
-      strSQL = PrepareSQL("SELECT idSong FROM song WHERE idAlbum=%i AND strFileName='%s' AND strTitle='%s' AND iTrack=%i AND strMusicBrainzTrackID IS NULL",
-                          idAlbum,
-                          strFileName.c_str(),
-                          strTitle.c_str(),
-                          iTrack);
+    {
+      strSQL = "SELECT idSong FROM song WHERE idAlbum=? AND strFileName=? AND strTitle=? AND iTrack=? AND strMusicBrainzTrackID IS NULL";
+      found = m_pDS->query(strSQL, { field_value(idAlbum), field_value(strFileName), field_value(strTitle), field_value(iTrack) });
+    }
 
-    if (!m_pDS->query(strSQL))
+    if (!found)
       return -1;
 
     if (m_pDS->num_rows() == 0)
@@ -1041,14 +1042,14 @@ int CMusicDatabase::AddGenre(std::string& strGenre)
       return it->second;
 
 
-    strSQL=PrepareSQL("SELECT idGenre, strGenre FROM genre WHERE strGenre LIKE '%s'", strGenre.c_str());
-    m_pDS->query(strSQL);
+    strSQL = "SELECT idGenre, strGenre FROM genre WHERE strGenre LIKE ?";
+    m_pDS->query(strSQL, { field_value(strGenre) });
     if (m_pDS->num_rows() == 0)
     {
       m_pDS->close();
       // doesnt exists, add it
-      strSQL=PrepareSQL("INSERT INTO genre (idGenre, strGenre) values( NULL, '%s' )", strGenre.c_str());
-      m_pDS->exec(strSQL);
+      strSQL = "INSERT INTO genre (idGenre, strGenre) values( NULL, ? )";
+      m_pDS->exec(strSQL, { field_value(strGenre) });
 
       int idGenre = (int)m_pDS->lastinsertid();
       m_genreCache.insert(std::pair<std::string, int>(strGenre, idGenre));
@@ -1161,9 +1162,8 @@ int CMusicDatabase::AddArtist(const std::string& strArtist, const std::string& s
     if (!strMusicBrainzArtistID.empty())
     {
       // 1.a) Match on a MusicBrainz ID
-      strSQL = PrepareSQL("SELECT idArtist, strArtist FROM artist WHERE strMusicBrainzArtistID = '%s'",
-        strMusicBrainzArtistID.c_str());
-      m_pDS->query(strSQL);
+      strSQL = "SELECT idArtist, strArtist FROM artist WHERE strMusicBrainzArtistID = ?";
+      m_pDS->query(strSQL, { field_value(strMusicBrainzArtistID) });
       if (m_pDS->num_rows() > 0)
       {
         int idArtist = (int)m_pDS->fv("idArtist").get_asInt();
@@ -1182,8 +1182,8 @@ int CMusicDatabase::AddArtist(const std::string& strArtist, const std::string& s
 
       // 1.b) No match on MusicBrainz ID. Look for a previously added artist with no MusicBrainz ID
       //     and update that if it exists.
-      strSQL = PrepareSQL("SELECT idArtist FROM artist WHERE strArtist LIKE '%s' AND strMusicBrainzArtistID IS NULL", strArtist.c_str());
-      m_pDS->query(strSQL);
+      strSQL = "SELECT idArtist FROM artist WHERE strArtist LIKE ? AND strMusicBrainzArtistID IS NULL";
+      m_pDS->query(strSQL, { field_value(strArtist) });
       if (m_pDS->num_rows() > 0)
       {
         int idArtist = (int)m_pDS->fv("idArtist").get_asInt();
@@ -1461,10 +1461,8 @@ bool CMusicDatabase::AddSongArtist(int idArtist, int idSong, const std::string&
 
 bool CMusicDatabase::AddSongArtist(int idArtist, int idSong, int idRole, const std::string& strArtist, int iOrder)
 {
-  std::string strSQL;
-  strSQL = PrepareSQL("replace into song_artist (idArtist, idSong, idRole, strArtist, iOrder) values(%i,%i,%i,'%s',%i)",
-    idArtist, idSong, idRole, strArtist.c_str(), iOrder);
-  return ExecuteQuery(strSQL);
+  return ExecuteQuery("replace into song_artist (idArtist, idSong, idRole, strArtist, iOrder) values(?,?,?,?,?)",
+    { field_value(idArtist), field_value(idSong), field_value(idRole), field_value(strArtist), field_value(iOrder) });
 }
 
 int CMusicDatabase::AddSongContributor(int idSong, const std::string& strRole, const std::string& strArtist, const std::string &strSort)
@@ -1598,10 +1596,8 @@ bool CMusicDatabase::DeleteSongArtistsBySong(int idSong)
 
 bool CMusicDatabase::AddAlbumArtist(int idArtist, int idAlbum, std::string strArtist, int iOrder)
 {
-  std::string strSQL;
-  strSQL = PrepareSQL("replace into album_artist (idArtist, idAlbum, strArtist, iOrder) values(%i,%i,'%s',%i)",
-    idArtist, idAlbum, strArtist.c_str(), iOrder);
-  return ExecuteQuery(strSQL);
+  return ExecuteQuery("replace into album_artist (idArtist, idAlbum, strArtist, iOrder) values(?,?,?,?)",
+    { field_value(idArtist), field_value(idAlbum), field_value(strArtist), field_value(iOrder) });
 }
 
 bool CMusicDatabase::DeleteAlbumArtistsByAlbum(int idAlbum)
@@ -1626,9 +1622,8 @@ bool CMusicDatabase::AddSongGenres(int idSong, const std::vector<std::string>& g
     for (auto &strGenre : modgenres)
     {
       int idGenre = AddGenre(strGenre); // Genre string trimed and matched case insensitively
-      strSQL = PrepareSQL("INSERT INTO song_genre (idGenre, idSong, iOrder) VALUES(%i,%i,%i)",
-        idGenre, idSong, index++);
-      if (!ExecuteQuery(strSQL))
+      strSQL = "INSERT INTO song_genre (idGenre, idSong, iOrder) VALUES(?,?,?)";
+      if (!ExecuteQuery(strSQL, { field_value(idGenre), field_value(idSong), field_value(index++) }))
         return false;
     }
     // Update concatenated genre string from the standardised genre values
@@ -1944,14 +1939,14 @@ int CMusicDatabase::AddPath(const std::string& strPath1)
     if (it != m_pathCache.end())
       return it->second;
 
-    strSQL=PrepareSQL( "select * from path where strPath='%s'", strPath.c_str());
-    m_pDS->query(strSQL);
+    strSQL = "select * from path where strPath=?";
+    m_pDS->query(strSQL, { field_value(strPath) });
     if (m_pDS->num_rows() == 0)
     {
       m_pDS->close();
       // doesnt exists, add it
-      strSQL=PrepareSQL("insert into path (idPath, strPath) values( NULL, '%s' )", strPath.c_str());
-      m_pDS->exec(strSQL);
+      strSQL = "insert into path (idPath, strPath) values( NULL, ? )";
+      m_pDS->exec(strSQL, { field_value(strPath) });
 
       int idPath = (int)m_pDS->lastinsertid();
       m_pathCache.insert(std::pair<std::string, int>(strPath, idPath));
@@ -3798,30 +3793,31 @@ bool CMusicDatabase::GetCommonNav(const std::string &strBaseDir, const std::stri
     
     // run query
     CLog::Log(LOGDEBUG, "%s query: %s", __FUNCTION__, strSQL.c_str());
-    if (!m_pDS->query(strSQL))
+    dbiplus::column_set columns;
+    if (!m_pDS->query_columns(strSQL, columns))
       return false;
     
-    int iRowsFound = m_pDS->num_rows();
+    int iRowsFound = columns.num_rows();
     if (iRowsFound <= 0)
-    {
-      m_pDS->close();
       return false;
-    }
     
     if (countOnly)
     {
       CFileItemPtr pItem(new CFileItem());
-      pItem->SetProperty("total", iRowsFound == 1 ? m_pDS->fv(0).get_asInt() : iRowsFound);
+      pItem->SetProperty("total", iRowsFound == 1 ? columns.get_int(0, 0) : iRowsFound);
       items.Add(pItem);
-      
-      m_pDS->close();
       return true;
     }
     
+    int labelColumn = columns.column_index(labelField.c_str());
+    if (labelColumn < 0)
+      return false;
+
     // get data from returned rows
-    while (!m_pDS->eof())
+    items.Reserve(iRowsFound);
+    for (int row = 0; row < iRowsFound; row++)
     {
-      std::string labelValue = m_pDS->fv(labelField.c_str()).get_asString();
+      std::string labelValue = columns.get_string(row, labelColumn);
       CFileItemPtr pItem(new CFileItem(labelValue));
       
       CMusicDbUrl itemUrl = musicUrl;
@@ -3831,13 +3827,8 @@ bool CMusicDatabase::GetCommonNav(const std::string &strBaseDir, const std::stri
       
       pItem->m_bIsFolder = true;
       items.Add(pItem);
-      
-      m_pDS->next();
     }
     
-    // cleanup
-    m_pDS->close();
-    
     return true;
   }
   catch (...)
@@ -5627,10 +5618,9 @@ int CMusicDatabase::GetArtistByName(const std::string& strArtist)
     if (NULL == m_pDB.get()) return false;
     if (NULL == m_pDS.get()) return false;
 
-    std::string strSQL=PrepareSQL("select idArtist from artist where artist.strArtist like '%s'", strArtist.c_str());
-
     // run query
-    if (!m_pDS->query(strSQL)) return false;
+    if (!m_pDS->query("select idArtist from artist where artist.strArtist like ?", { field_value(strArtist) }))
+      return false;
     int iRowsFound = m_pDS->num_rows();
     if (iRowsFound != 1)
     {
@@ -6112,19 +6102,10 @@ bool CMusicDatabase::GetPaths(std::set<std::string> &paths)
     paths.clear();
 
     // find all paths
-    if (!m_pDS->query("select strPath from path")) return false;
-    int iRowsFound = m_pDS->num_rows();
-    if (iRowsFound == 0)
-    {
-      m_pDS->close();
-      return true;
-    }
-    while (!m_pDS->eof())
-    {
-      paths.insert(m_pDS->fv("strPath").get_asString());
-      m_pDS->next();
-    }
-    m_pDS->close();
+    dbiplus::column_set columns;
+    if (!m_pDS->query_columns("select strPath from path", columns)) return false;
+    for (unsigned int row = 0; row < columns.num_rows(); row++)
+      paths.insert(columns.get_text(row, 0));
     return true;
   }
   catch (...)
@@ -6242,7 +6223,8 @@ bool CMusicDatabase::CommitTransaction()
 {
   if (CDatabase::CommitTransaction())
   { // number of items in the db has likely changed, so reset the infomanager cache
-    g_infoManager.SetLibraryBool(LIBRARY_HAS_MUSIC, GetSongsCount() > 0);
+    if (!InTransaction())
+      g_infoManager.SetLibraryBool(LIBRARY_HAS_MUSIC, GetSongsCount() > 0);
     return true;
   }
   return false;
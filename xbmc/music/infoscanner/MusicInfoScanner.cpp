@@ -47,12 +47,14 @@
 #include "music/MusicThumbLoader.h"
 #include "music/tags/MusicInfoTag.h"
 #include "music/tags/MusicInfoTagLoaderFactory.h"
+#include "music/tags/TagLoaderTagLib.h"
 #include "MusicAlbumInfo.h"
 #include "MusicInfoScraper.h"
 #include "NfoFile.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "TextureCache.h"
+#include "threads/Event.h"
 #include "threads/SystemClock.h"
 #include "Util.h"
 #include "utils/FileExtensionProvider.h"
@@ -61,6 +63,7 @@
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
+#include "utils/WorkerPool.h"
 
 using namespace MUSIC_INFO;
 using namespace XFILE;
@@ -68,6 +71,9 @@ using namespace MUSICDATABASEDIRECTORY;
 using namespace MUSIC_GRABBER;
 using namespace ADDON;
 
+// number of songs added to the database in one transaction
+#define SCAN_COMMIT_SONGS 1000
+
 CMusicInfoScanner::CMusicInfoScanner()
 : CThread("MusicInfoScanner"),
   m_needsCleanup(false),
@@ -77,6 +83,7 @@ CMusicInfoScanner::CMusicInfoScanner()
   m_currentItem=0;
   m_itemCount=0;
   m_flags = 0;
+  m_uncommittedSongs = 0;
 }
 
 CMusicInfoScanner::~CMusicInfoScanner() = default;
@@ -130,6 +137,12 @@ void CMusicInfoScanner::Process()
       m_bCanInterrupt = false;
       m_needsCleanup = false;
 
+      if (g_advancedSettings.m_iMusicLibraryScannerThreads > 0)
+      {
+        unsigned int threads = g_advancedSettings.m_iMusicLibraryScannerThreads;
+        m_pool.reset(new CWorkerPool("MusicInfoScanner", threads, threads * 2));
+      }
+
       bool commit = true;
       for (std::set<std::string>::const_iterator it = m_pathsToScan.begin(); it != m_pathsToScan.end(); ++it)
       {
@@ -147,6 +160,7 @@ void CMusicInfoScanner::Process()
         }
 
         bool scancomplete = DoScan(*it);
+        CommitSongs(true);
         if (scancomplete)
         { 
           if (m_albumsAdded.size() > 0)
@@ -165,6 +179,8 @@ void CMusicInfoScanner::Process()
         }
       }
 
+      m_pool.reset();
+
       if (commit)
       {
         g_infoManager.ResetLibraryBools();
@@ -265,6 +281,10 @@ void CMusicInfoScanner::Process()
   {
     CLog::Log(LOGERROR, "MusicInfoScanner: Exception while scanning.");
   }
+  m_pool.reset();
+  m_pendingFolders.clear();
+  m_pendingArtistArt.clear();
+  m_uncommittedSongs = 0;
   m_musicDatabase.Close();
   CLog::Log(LOGDEBUG, "%s - Finished scan", __FUNCTION__);
   
@@ -521,15 +541,10 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
     items.FilterCueItems();
     items.Sort(SortByLabel, SortOrderAscending);
 
-    // and then scan in the new information from tags
-    if (RetrieveMusicInfo(strDirectory, items) > 0)
-    {
-      if (m_handle)
-        OnDirectoryScanned(strDirectory);
-    }
-
-    // save information about this folder
-    m_musicDatabase.SetPathHash(strDirectory, hash);
+    // and then scan in the new information from tags, the folder is added to
+    // the database together with others once enough songs were read
+    m_uncommittedSongs += RetrieveMusicInfo(strDirectory, items, hash);
+    CommitSongs(false);
   }
   else
   { // path is the same - no need to rescan
@@ -570,11 +585,9 @@ CInfoScanner::INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items,
 {
   std::vector<std::string> regexps = g_advancedSettings.m_audioExcludeFromScanRegExps;
 
+  std::vector<CFileItemPtr> files;
   for (int i = 0; i < items.Size(); ++i)
   {
-    if (m_bStop)
-      return INFO_CANCELLED;
-
     CFileItemPtr pItem = items[i];
 
     if (CUtil::ExcludeFileOrFolder(pItem->GetPath(), regexps))
@@ -583,10 +596,44 @@ CInfoScanner::INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items,
     if (pItem->m_bIsFolder || pItem->IsPlayList() || pItem->IsPicture() || pItem->IsLyrics())
       continue;
 
+    files.push_back(pItem);
+  }
+
+  // let the workers read the tags taglib handles while we add them in order below
+  std::vector<std::shared_ptr<CEvent>> loaded(files.size());
+  for (size_t i = 0; m_pool && i < files.size(); ++i)
+  {
+    CMusicInfoTag *tag = files[i]->GetMusicInfoTag();
+    if (tag->Loaded())
+      continue;
+
+    std::shared_ptr<IMusicInfoTagLoader> pLoader(CMusicInfoTagLoaderFactory::CreateLoader(*files[i]));
+    if (!dynamic_cast<CTagLoaderTagLib*>(pLoader.get()))
+      continue;
+
+    std::shared_ptr<CEvent> event = std::make_shared<CEvent>(true);
+    std::string path = files[i]->GetPath();
+    if (m_pool->Submit([pLoader, path, tag, event]() { pLoader->Load(path, *tag); event->Set(); }))
+      loaded[i] = event;
+  }
+
+  INFO_RET ret = INFO_ADDED;
+  for (size_t i = 0; i < files.size(); ++i)
+  {
+    if (m_bStop)
+    {
+      ret = INFO_CANCELLED;
+      break;
+    }
+
+    CFileItemPtr pItem = files[i];
+
     m_currentItem++;
 
     CMusicInfoTag& tag = *pItem->GetMusicInfoTag();
-    if (!tag.Loaded())
+    if (loaded[i])
+      loaded[i]->Wait();
+    else if (!tag.Loaded())
     {
       std::unique_ptr<IMusicInfoTagLoader> pLoader (CMusicInfoTagLoaderFactory::CreateLoader(*pItem));
       if (NULL != pLoader.get())
@@ -612,7 +659,48 @@ CInfoScanner::INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items,
     else
       scannedItems.Add(pItem);
   }
-  return INFO_ADDED;
+
+  // the items may go away once we return, so wait for the workers still reading
+  for (std::vector<std::shared_ptr<CEvent>>::iterator it = loaded.begin(); it != loaded.end(); ++it)
+  {
+    if (*it)
+      (*it)->Wait();
+  }
+  return ret;
+}
+
+void CMusicInfoScanner::CommitSongs(bool force)
+{
+  if (m_pendingFolders.empty() || (!force && m_uncommittedSongs < SCAN_COMMIT_SONGS))
+    return;
+
+  // nothing in here waits on the file system or the network, so the database
+  // isn't locked any longer than needed
+  m_musicDatabase.BeginTransaction();
+  for (auto &folder : m_pendingFolders)
+    AddFolder(folder);
+  m_musicDatabase.CommitTransaction();
+
+  if (m_handle)
+  {
+    for (const auto &folder : m_pendingFolders)
+    {
+      if (!folder.albums.empty())
+        OnDirectoryScanned(folder.path);
+    }
+  }
+  m_pendingFolders.clear();
+  m_uncommittedSongs = 0;
+
+  // look for local art of the artists added, which reads the file system
+  for (const auto &artistArt : m_pendingArtistArt)
+  {
+    CArtist artist;
+    artist.idArtist = artistArt.first;
+    artist.strPath = artistArt.second;
+    m_musicDatabase.SetArtForItem(artist.idArtist, MediaTypeArtist, GetArtistArtwork(artist, 1));
+  }
+  m_pendingArtistArt.clear();
 }
 
 static bool SortSongsByTrack(const CSong& song, const CSong& song2)
@@ -861,21 +949,48 @@ CMusicInfoScanner::UpdateArtistInfo(CArtist& artist,
   return result;
 }
 
-int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileItemList& items)
+int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileItemList& items, const std::string& hash)
 {
-  MAPSONGS songsMap;
+  PendingFolder folder;
+  folder.path = strDirectory;
+  folder.hash = hash;
 
-  // get all information for all files in current directory from database, and remove them
-  if (m_musicDatabase.RemoveSongsFromPath(strDirectory, songsMap))
-    m_needsCleanup = true;
+  // get all information for all files in current directory from database, the
+  // songs themselves are removed once the folder is added again
+  MAPSONGS songsMap;
+  if (m_musicDatabase.GetSongsByPath(strDirectory, songsMap))
+  {
+    for (auto &song : songsMap)
+      song.second.strThumb = m_musicDatabase.GetArtForItem(song.second.idSong, MediaTypeSong, "thumb");
+  }
 
+  int numAdded = 0;
   CFileItemList scannedItems;
-  if (ScanTags(items, scannedItems) == INFO_CANCELLED || scannedItems.Size() == 0)
-    return 0;
+  if (ScanTags(items, scannedItems) != INFO_CANCELLED && scannedItems.Size() > 0)
+  {
+    FileItemsToAlbums(scannedItems, folder.albums, &songsMap);
+    FindArtForAlbums(folder.albums, items.GetPath());
+
+    for (const auto &album : folder.albums)
+      numAdded += album.songs.size();
 
-  VECALBUMS albums;
-  FileItemsToAlbums(scannedItems, albums, &songsMap);
-  FindArtForAlbums(albums, items.GetPath());
+    if (m_handle)
+      m_handle->SetTitle(g_localizeStrings.Get(505));
+  }
+
+  m_pendingFolders.push_back(std::move(folder));
+  return numAdded;
+}
+
+void CMusicInfoScanner::AddFolder(PendingFolder &folder)
+{
+  // leave the folder as it is, it's scanned again next time
+  if (m_bStop)
+    return;
+
+  MAPSONGS songsMap;
+  if (m_musicDatabase.RemoveSongsFromPath(folder.path, songsMap))
+    m_needsCleanup = true;
 
   /* Strategy: Having scanned tags and made a list of albums, add them to the library. Only then try
   to scrape additional album and artist information. Music is often tagged to a mixed standard
@@ -889,9 +1004,8 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
   the library also means that the user can use their library to select music to play sooner.
   */
 
-  int numAdded = 0;
-
   // Add all albums to the library, and hence any new song or album artists or other contributors
+  VECALBUMS &albums = folder.albums;
   for (VECALBUMS::iterator album = albums.begin(); album != albums.end(); ++album)
   {
     if (m_bStop)
@@ -901,7 +1015,7 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
     if (album->strAlbum.empty())
       album->releaseType = CAlbum::Single;
 
-    album->strPath = strDirectory;
+    album->strPath = folder.path;
     m_musicDatabase.AddAlbum(*album);
     m_albumsAdded.emplace_back(album->idAlbum);
 
@@ -916,6 +1030,7 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
       Hence once art has been found for an album artist, art is not searched for in other folders.
 
       It will find art for "various artists", if artwork is located above the folder containing compilatons.
+      The art is looked for by CommitSongs() once the albums are committed.
     */
     if (albums.size() == 1 && !album->artistCredits.empty())
     {
@@ -927,21 +1042,15 @@ int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileI
         {
           // Artist does not already have art, so try to find some. 
           // Do not have URL of other available art before scraping, so only ID and path needed
-          CArtist artist;
-          artist.idArtist = album->artistCredits[0].GetArtistId();
-          artist.strPath = URIUtils::GetParentPath(album->strPath);
-          m_musicDatabase.SetArtForItem(album->artistCredits[0].GetArtistId(), MediaTypeArtist, GetArtistArtwork(artist, 1));
+          m_pendingArtistArt.push_back(std::make_pair(album->artistCredits[0].GetArtistId(), URIUtils::GetParentPath(album->strPath)));
         }
       }
     }
- 
-    numAdded += album->songs.size();
   }
 
-  if (m_handle)
-    m_handle->SetTitle(g_localizeStrings.Get(505));
-
-  return numAdded;
+  // save information about this folder, unless some of its albums are missing
+  if (!m_bStop)
+    m_musicDatabase.SetPathHash(folder.path, folder.hash);
 }
 
 void MUSIC_INFO::CMusicInfoScanner::ScrapeInfoAddedAlbums()
@@ -24,9 +24,15 @@
 #include "music/MusicDatabase.h"
 #include "threads/Thread.h"
 
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
 class CAlbum;
 class CArtist;
 class CGUIDialogProgressBarHandle;
+class CWorkerPool;
 
 namespace MUSIC_INFO
 {
@@ -164,14 +170,16 @@ protected:
   void Process() override;
 
   /*! \brief Scan in the ID3/Ogg/FLAC tags for a bunch of FileItems
-   Given a list of FileItems, scan in the tags for those FileItems
-   and populate a new FileItemList with the files that were successfully scanned.
-   Add album to library, populate a list of album ids added for possible scraping later.
+   Given a list of FileItems, scan in the tags for those FileItems and group
+   the files that were successfully scanned into albums. The albums are queued
+   to be added to the library by CommitSongs(), together with those of other folders.
    Any files which couldn't be scanned (no/bad tags) are discarded in the process.
+   \param strDirectory [in] folder the items are in
    \param items [in] list of FileItems to scan
-   \param scannedItems [in] list to populate with the scannedItems
+   \param hash [in] hash of the folder, stored once its albums have been added
+   \return number of songs queued
    */
-  int RetrieveMusicInfo(const std::string& strDirectory, CFileItemList& items);
+  int RetrieveMusicInfo(const std::string& strDirectory, CFileItemList& items, const std::string& hash);
 
   void ScrapeInfoAddedAlbums();
   void RetrieveArtistArt();
@@ -184,6 +192,28 @@ protected:
    \param scannedItems [in] list to populate with the scannedItems
    */
   INFO_RET ScanTags(const CFileItemList& items, CFileItemList& scannedItems);
+
+  /*! \brief A folder whose tags have been read, waiting to be added to the database
+   */
+  struct PendingFolder
+  {
+    std::string path;
+    std::string hash;
+    VECALBUMS albums;
+  };
+
+  /*! \brief Add the queued folders to the database
+   Several folders are added in one transaction once enough songs are queued.
+   The transaction only holds the database writes, everything is read from the
+   files before, and artist art is looked for once it has been committed.
+   \param force add the queued folders regardless of the number of songs
+   */
+  void CommitSongs(bool force);
+
+  /*! \brief Replace the songs of a folder in the database with the queued albums
+   Add album to library, populate a list of album ids added for possible scraping later.
+   */
+  void AddFolder(PendingFolder &folder);
   int GetPathHash(const CFileItemList &items, std::string &hash);
   void GetAlbumArtwork(long id, const CAlbum &artist);
 
@@ -215,5 +245,10 @@ protected:
   std::set<std::string> m_seenPaths;
   int m_flags;
   CThread m_fileCountReader;
+
+  std::unique_ptr<CWorkerPool> m_pool; ///< workers reading tags while scanning, see <musiclibrary><scannerthreads>
+  std::vector<PendingFolder> m_pendingFolders;                 ///< folders to add by CommitSongs()
+  std::vector<std::pair<int, std::string>> m_pendingArtistArt; ///< artists and the path to look for their art in
+  unsigned int m_uncommittedSongs;                             ///< songs in m_pendingFolders
 };
 }
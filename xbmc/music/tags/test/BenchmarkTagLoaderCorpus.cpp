@@ -0,0 +1,76 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TestTagLoaderCorpus.h"
+#include "music/tags/MusicInfoTag.h"
+#include "music/tags/TagLoaderTagLib.h"
+#include "utils/Stopwatch.h"
+#include "utils/WorkerPool.h"
+
+using namespace MUSIC_INFO;
+
+class BenchmarkTagLoaderCorpus : public TestTagLoaderCorpus
+{
+};
+
+TEST_F(BenchmarkTagLoaderCorpus, Load)
+{
+  CStopWatch watch;
+
+  std::vector<CMusicInfoTag> sequential(CORPUS_FILES);
+  watch.StartZero();
+  for (int i = 0; i < CORPUS_FILES; i++)
+  {
+    CTagLoaderTagLib loader;
+    loader.Load(GetPath(i), sequential[i]);
+  }
+  watch.Stop();
+  float timeSequential = watch.GetElapsedMilliseconds();
+
+  std::vector<CMusicInfoTag> parallel(CORPUS_FILES);
+  watch.StartZero();
+  {
+    CWorkerPool pool("TagLoaderTest", 4, 8);
+    for (int i = 0; i < CORPUS_FILES; i++)
+    {
+      std::string path = GetPath(i);
+      CMusicInfoTag *tag = &parallel[i];
+      pool.Submit([path, tag]() {
+        CTagLoaderTagLib loader;
+        loader.Load(path, *tag);
+      });
+    }
+    pool.Wait();
+  }
+  watch.Stop();
+  float timeParallel = watch.GetElapsedMilliseconds();
+
+  for (int i = 0; i < CORPUS_FILES; i++)
+  {
+    EXPECT_TRUE(parallel[i].Loaded());
+    EXPECT_EQ(sequential[i].GetTitle(), parallel[i].GetTitle());
+    EXPECT_EQ(sequential[i].GetAlbum(), parallel[i].GetAlbum());
+    EXPECT_EQ(sequential[i].GetTrackNumber(), parallel[i].GetTrackNumber());
+  }
+
+  RecordProperty("files", CORPUS_FILES);
+  RecordProperty("sequential_us", static_cast<int>(timeSequential * 1000));
+  RecordProperty("parallel_us", static_cast<int>(timeParallel * 1000));
+}
@@ -0,0 +1,39 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TestTagLoaderCorpus.h"
+#include "music/tags/MusicInfoTag.h"
+#include "music/tags/TagLoaderTagLib.h"
+
+using namespace MUSIC_INFO;
+
+TEST_F(TestTagLoaderCorpus, ReadsTags)
+{
+  CTagLoaderTagLib loader;
+  CMusicInfoTag tag;
+  ASSERT_TRUE(loader.Load(GetPath(13), tag));
+
+  EXPECT_EQ("Title 13", tag.GetTitle());
+  EXPECT_EQ("Album 1", tag.GetAlbum());
+  ASSERT_EQ(1u, tag.GetArtist().size());
+  EXPECT_EQ("Artist 0", tag.GetArtist().front());
+  EXPECT_EQ(2, tag.GetTrackNumber());
+  EXPECT_EQ(2003, tag.GetYear());
+}
@@ -0,0 +1,95 @@
+#pragma once
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/StringUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <taglib/id3v2tag.h>
+#include <taglib/mpegfile.h>
+
+#include <vector>
+
+#define CORPUS_FILES 240
+#define TRACKS_PER_ALBUM 12
+
+// MPEG-1 layer III, 128 kbit/s, 44.1 kHz
+#define MP3_FRAME_SIZE 417
+#define MP3_FRAMES 20
+
+/*!
+ A folder of tagged mp3 files under special://temp
+ */
+class TestTagLoaderCorpus : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_folder = "special://temp/tagcorpus/";
+    XFILE::CDirectory::RemoveRecursive(m_folder);
+    ASSERT_TRUE(XFILE::CDirectory::Create(m_folder));
+
+    // a few silent frames, enough for taglib to accept the file
+    std::vector<char> audio(MP3_FRAME_SIZE * MP3_FRAMES, 0);
+    for (unsigned int frame = 0; frame < MP3_FRAMES; frame++)
+    {
+      char *header = &audio[frame * MP3_FRAME_SIZE];
+      header[0] = (char)0xFF;
+      header[1] = (char)0xFB;
+      header[2] = (char)0x90;
+      header[3] = (char)0x00;
+    }
+
+    for (int i = 0; i < CORPUS_FILES; i++)
+    {
+      std::string path = GetPath(i);
+      XFILE::CFile file;
+      ASSERT_TRUE(file.OpenForWrite(path, true));
+      ASSERT_EQ((ssize_t)audio.size(), file.Write(audio.data(), audio.size()));
+      file.Close();
+
+      TagLib::MPEG::File mp3(CSpecialProtocol::TranslatePath(path).c_str());
+      ASSERT_TRUE(mp3.isValid());
+      TagLib::ID3v2::Tag *tag = mp3.ID3v2Tag(true);
+      tag->setTitle(StringUtils::Format("Title %i", i));
+      tag->setArtist(StringUtils::Format("Artist %i", i / (TRACKS_PER_ALBUM * 4)));
+      tag->setAlbum(StringUtils::Format("Album %i", i / TRACKS_PER_ALBUM));
+      tag->setTrack(i % TRACKS_PER_ALBUM + 1);
+      tag->setYear(1990 + i % 20);
+      ASSERT_TRUE(mp3.save(TagLib::MPEG::File::ID3v2));
+    }
+  }
+
+  void TearDown() override
+  {
+    XFILE::CDirectory::RemoveRecursive(m_folder);
+  }
+
+  std::string GetPath(int i) const
+  {
+    return m_folder + StringUtils::Format("track%03i.mp3", i);
+  }
+
+  std::string m_folder;
+};
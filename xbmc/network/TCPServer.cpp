@@ -27,6 +27,7 @@
 
 #include "settings/AdvancedSettings.h"
 #include "interfaces/json-rpc/JSONRPC.h"
+#include "interfaces/json-rpc/JSONResponseStream.h"
 #include "interfaces/AnnouncementManager.h"
 #include "utils/log.h"
 #include "utils/Variant.h"
@@ -258,7 +259,7 @@ void CTCPServer::Announce(AnnouncementFlag flag, const char *sender, const char
         continue;
     }
 
-    m_connections[i]->Send(str.c_str(), str.size());
+    m_connections[i]->Announce(str);
   }
 }
 
@@ -518,6 +519,7 @@ CTCPServer::CTCPClient::CTCPClient()
   m_endBrackets = 0;
   m_beginChar = 0;
   m_endChar = 0;
+  m_responding = false;
 
   m_addrlen = sizeof(m_cliaddr);
 }
@@ -551,12 +553,68 @@ bool CTCPServer::CTCPClient::SetAnnouncementFlags(int flags)
 
 void CTCPServer::CTCPClient::Send(const char *data, unsigned int size)
 {
+  SendData(data, size);
+}
+
+void CTCPServer::CTCPClient::Announce(const std::string &announcement)
+{
+  CSingleLock lock (m_critSection);
+  if (m_responding)
+    m_announcements.push_back(announcement);
+  else
+    Send(announcement.c_str(), announcement.size());
+}
+
+bool CTCPServer::CTCPClient::SendData(const char *data, unsigned int size)
+{
+  // hold the lock for the whole message so nothing else is sent in between
+  CSingleLock lock (m_critSection);
   unsigned int sent = 0;
   do
   {
-    CSingleLock lock (m_critSection);
-    sent += send(m_socket, data + sent, size - sent, 0);
+    int result = send(m_socket, data + sent, size - sent, 0);
+    if (result <= 0)
+    {
+      CLog::Log(LOGDEBUG, "JSONRPC Server: Failed to send to the client, it has probably disconnected");
+      return false;
+    }
+    sent += result;
   } while (sent < size);
+
+  return true;
+}
+
+void CTCPServer::CTCPClient::SendResponse(CJSONResponseStream &response)
+{
+  // the response is produced while it is sent, so it never has to be held in memory at once.
+  // Announcements made meanwhile would end up between its pieces and are held back.
+  {
+    CSingleLock lock (m_critSection);
+    m_responding = true;
+  }
+
+  char buffer[16384];
+  size_t size;
+  while ((size = response.Read(buffer, sizeof(buffer))) > 0)
+  {
+    // stop producing the rest of the response for a client which is gone
+    if (!SendData(buffer, size))
+    {
+      response.Close();
+      break;
+    }
+  }
+
+  EndResponse();
+}
+
+void CTCPServer::CTCPClient::EndResponse()
+{
+  CSingleLock lock (m_critSection);
+  m_responding = false;
+  for (const auto &announcement : m_announcements)
+    Send(announcement.c_str(), announcement.size());
+  m_announcements.clear();
 }
 
 void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
@@ -587,8 +645,9 @@ void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, in
         m_endBrackets++;
       if (m_beginBrackets > 0 && m_endBrackets > 0 && m_beginBrackets == m_endBrackets)
       {
-        std::string line = CJSONRPC::MethodCall(m_buffer, host, this);
-        Send(line.c_str(), line.size());
+        CJSONResponseStream response;
+        if (CJSONRPC::MethodCall(m_buffer, host, this, response))
+          SendResponse(response);
         m_beginChar = m_beginBrackets = m_endBrackets = 0;
         m_buffer.clear();
       }
@@ -619,6 +678,8 @@ void CTCPServer::CTCPClient::Copy(const CTCPClient& client)
   m_beginChar         = client.m_beginChar;
   m_endChar           = client.m_endChar;
   m_buffer            = client.m_buffer;
+  m_responding        = client.m_responding;
+  m_announcements     = client.m_announcements;
 }
 
 CTCPServer::CWebSocketClient::CWebSocketClient(CWebSocket *websocket)
@@ -654,6 +715,8 @@ CTCPServer::CWebSocketClient& CTCPServer::CWebSocketClient::operator=(const CWeb
 
 void CTCPServer::CWebSocketClient::Send(const char *data, unsigned int size)
 {
+  // the frames of a message must not be mixed with those of another one
+  CSingleLock lock (m_critSection);
   const CWebSocketMessage *msg = m_websocket->Send(WebSocketTextFrame, data, size);
   if (msg == NULL || !msg->IsComplete())
     return;
@@ -663,6 +726,13 @@ void CTCPServer::CWebSocketClient::Send(const char *data, unsigned int size)
     CTCPClient::Send(frames.at(index)->GetFrameData(), (unsigned int)frames.at(index)->GetFrameLength());
 }
 
+void CTCPServer::CWebSocketClient::SendResponse(CJSONResponseStream &response)
+{
+  // every Send() is a message of its own, so the response has to be sent at once
+  std::string str = response.ReadAll();
+  Send(str.c_str(), str.size());
+}
+
 void CTCPServer::CWebSocketClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
 {
   bool send;
@@ -31,11 +31,16 @@
 #include "websocket/WebSocket.h"
 
 class CVariant;
+class TestTCPServerHelper;
 
 namespace JSONRPC
 {
+  class CJSONResponseStream;
+
   class CTCPServer : public ITransportLayer, public JSONRPC::IJSONRPCAnnouncer, public CThread
   {
+    friend class ::TestTCPServerHelper;
+
   public:
     static bool StartServer(int port, bool nonlocal);
     static void StopServer(bool bWait);
@@ -70,6 +75,11 @@ namespace JSONRPC
       bool SetAnnouncementFlags(int flags) override;
 
       virtual void Send(const char *data, unsigned int size);
+      virtual void SendResponse(CJSONResponseStream &response);
+      /*!
+       \brief Send an announcement, held back while a response is sent in pieces
+       */
+      void Announce(const std::string &announcement);
       virtual void PushBuffer(CTCPServer *host, const char *buffer, int length);
       virtual void Disconnect();
 
@@ -83,12 +93,17 @@ namespace JSONRPC
 
     protected:
       void Copy(const CTCPClient& client);
+      bool SendData(const char *data, unsigned int size);
     private:
+      void EndResponse();
+
       bool m_new;
       int m_announcementflags;
       int m_beginBrackets, m_endBrackets;
       char m_beginChar, m_endChar;
       std::string m_buffer;
+      bool m_responding; ///< a response is sent in pieces, see SendResponse()
+      std::vector<std::string> m_announcements; ///< held back until the response has been sent
     };
 
     class CWebSocketClient : public CTCPClient
@@ -101,6 +116,7 @@ namespace JSONRPC
       ~CWebSocketClient() override;
 
       void Send(const char *data, unsigned int size) override;
+      void SendResponse(CJSONResponseStream &response) override;
       void PushBuffer(CTCPServer *host, const char *buffer, int length) override;
       void Disconnect() override;
 
@@ -30,6 +30,9 @@
 #include "utils/log.h"
 #include "utils/Variant.h"
 
+#include <algorithm>
+#include <cstring>
+
 #define MAX_HTTP_POST_SIZE 65536
 
 bool CHTTPJsonRpcHandler::CanHandleRequest(const HTTPRequest &request) const
@@ -84,7 +87,27 @@ int CHTTPJsonRpcHandler::HandleRequest()
 
   if (isRequest)
   {
-    m_responseData = JSONRPC::CJSONRPC::MethodCall(m_requestData, &m_transportLayer, &client);
+    std::unique_ptr<JSONRPC::CJSONResponseStream> response(new JSONRPC::CJSONResponseStream());
+    if (JSONRPC::CJSONRPC::MethodCall(m_requestData, &m_transportLayer, &client, *response) && response->IsDeferred())
+    {
+      // send the response chunked while it is produced
+      m_responseStream = std::move(response);
+      if (!jsonpCallback.empty())
+      {
+        m_responseData = jsonpCallback + "(";
+        m_responseSuffix = ");";
+      }
+
+      m_requestData.clear();
+
+      m_response.type = HTTPStreamDownload;
+      m_response.status = MHD_HTTP_OK;
+      m_response.contentType = "application/json";
+
+      return MHD_YES;
+    }
+
+    m_responseData = response->ReadAll();
 
     if (!jsonpCallback.empty())
       m_responseData = jsonpCallback + "(" + m_responseData + ");";
@@ -130,6 +153,38 @@ HttpResponseRanges CHTTPJsonRpcHandler::GetResponseData() const
   return ranges;
 }
 
+static size_t ReadFromString(const std::string &str, size_t &pos, char *buffer, size_t size)
+{
+  size_t len = std::min(size, str.size() - std::min(pos, str.size()));
+  memcpy(buffer, str.c_str() + pos, len);
+  pos += len;
+  return len;
+}
+
+size_t CHTTPJsonRpcHandler::ReadResponseStream(char *buffer, size_t size)
+{
+  if (m_responseStream == nullptr)
+    return 0;
+
+  // the stream only returns less than requested once it has been read completely
+  size_t read = ReadFromString(m_responseData, m_responsePos, buffer, size);
+  if (read < size)
+    read += m_responseStream->Read(buffer + read, size - read);
+  if (read < size)
+    read += ReadFromString(m_responseSuffix, m_responseSuffixPos, buffer + read, size - read);
+
+  // everything has been read, don't keep the lists of the response around
+  if (read < size)
+    CloseResponseStream();
+
+  return read;
+}
+
+void CHTTPJsonRpcHandler::CloseResponseStream()
+{
+  m_responseStream.reset();
+}
+
 #if (MHD_VERSION >= 0x00040001)
 bool CHTTPJsonRpcHandler::appendPostData(const char *data, size_t size)
 #else
@@ -19,9 +19,11 @@
  *
  */
 
+#include <memory>
 #include <string>
 
 #include "interfaces/json-rpc/IClient.h"
+#include "interfaces/json-rpc/JSONResponseStream.h"
 #include "interfaces/json-rpc/ITransportLayer.h"
 #include "network/httprequesthandler/IHTTPRequestHandler.h"
 
@@ -38,6 +40,8 @@ public:
   int HandleRequest() override;
 
   HttpResponseRanges GetResponseData() const override;
+  size_t ReadResponseStream(char *buffer, size_t size) override;
+  void CloseResponseStream() override;
 
   int GetPriority() const override { return 5; }
 
@@ -57,6 +61,12 @@ private:
   std::string m_responseData;
   CHttpResponseRange m_responseRange;
 
+  // used for HTTPStreamDownload where m_responseData and m_responseSuffix wrap the streamed response
+  std::unique_ptr<JSONRPC::CJSONResponseStream> m_responseStream;
+  std::string m_responseSuffix;
+  size_t m_responsePos = 0;
+  size_t m_responseSuffixPos = 0;
+
   class CHTTPTransportLayer : public JSONRPC::ITransportLayer
   {
   public:
@@ -65,7 +65,9 @@ typedef enum HTTPResponseType
   HTTPMemoryDownloadFreeNoCopy,
   // creates a HTTP response from a buffer by copying followed by freeing the buffer
   // the buffer must have been malloc'ed and not new'ed
-  HTTPMemoryDownloadFreeCopy
+  HTTPMemoryDownloadFreeCopy,
+  // creates a HTTP response of unknown length which is read from the handler while being sent
+  HTTPStreamDownload
 } HTTPResponseType;
 
 typedef struct HTTPRequest
@@ -172,6 +174,22 @@ public:
   */
   virtual std::string GetResponseFile() const { return ""; }
 
+  /*!
+  * \brief Reads the next part of the response into the given buffer.
+  *
+  * \details This is only used if the response type is HTTPStreamDownload.
+  * \return Number of bytes read, 0 once the whole response has been read
+  */
+  virtual size_t ReadResponseStream(char *buffer, size_t size) { return 0; }
+
+  /*!
+  * \brief Releases whatever is left of the response once it won't be read anymore.
+  *
+  * \details This is only used if the response type is HTTPStreamDownload. It is
+  * called when the response has been sent or the connection has been closed.
+  */
+  virtual void CloseResponseStream() { }
+
   /*!
   * \brief Returns the HTTP request handled by the HTTP request handler.
   */
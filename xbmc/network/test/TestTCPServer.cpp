@@ -0,0 +1,164 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "interfaces/json-rpc/JSONResponseStream.h"
+#include "network/TCPServer.h"
+#include "settings/AdvancedSettings.h"
+#include "utils/StringUtils.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <thread>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace JSONRPC;
+
+#define ITEMS 2000
+
+class TestTCPServerHelper
+{
+public:
+  TestTCPServerHelper() : m_server(0, false)
+  {
+    m_client.m_socket = INVALID_SOCKET;
+    m_peer = INVALID_SOCKET;
+    int sockets[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0)
+    {
+      m_client.m_socket = sockets[0];
+      m_peer = sockets[1];
+      m_server.m_connections.push_back(&m_client);
+    }
+  }
+
+  ~TestTCPServerHelper()
+  {
+    m_server.m_connections.clear();
+    m_client.Disconnect();
+    if (m_peer != INVALID_SOCKET)
+      close(m_peer);
+  }
+
+  bool IsConnected() const { return m_peer != INVALID_SOCKET; }
+
+  void Announce(const std::string &message)
+  {
+    m_server.Announce(ANNOUNCEMENT::Other, "xbmc", message.c_str(), CVariant(message));
+  }
+
+  /*!
+   \brief What the client is sent for Announce(message)
+   */
+  static std::string Announcement(const std::string &message)
+  {
+    return CTCPServer::AnnouncementToJSONRPC(ANNOUNCEMENT::Other, "xbmc", message.c_str(), CVariant(message),
+                                             g_advancedSettings.m_jsonOutputCompact);
+  }
+
+  /*!
+   \brief Send the response to the client, and return all the peer received once it is gone
+   */
+  std::string SendResponse(CJSONResponseStream &response)
+  {
+    std::string received;
+    std::thread reader([this, &received]() {
+      char buffer[4096];
+      ssize_t size;
+      while ((size = read(m_peer, buffer, sizeof(buffer))) > 0)
+        received.append(buffer, size);
+    });
+    m_client.SendResponse(response);
+    m_client.Disconnect();
+    reader.join();
+    return received;
+  }
+
+private:
+  CTCPServer m_server;
+  CTCPServer::CTCPClient m_client;
+  SOCKET m_peer;
+};
+
+namespace
+{
+// a list which has the server announce something while it is produced
+class CAnnouncingSource : public IResultItemSource
+{
+public:
+  CAnnouncingSource(TestTCPServerHelper *helper, int announceAt)
+    : m_helper(helper), m_announceAt(announceAt), m_item(0)
+  {
+  }
+
+  bool Next(CVariant &item) override
+  {
+    if (m_item >= ITEMS)
+      return false;
+
+    // announcements come from the announcement manager's thread
+    if (m_helper && m_item == m_announceAt)
+    {
+      std::thread announcer([this]() { m_helper->Announce("OnTest"); });
+      announcer.join();
+    }
+
+    item["label"] = StringUtils::Format("item %d", m_item++);
+    return true;
+  }
+
+private:
+  TestTCPServerHelper *m_helper;
+  int m_announceAt;
+  int m_item;
+};
+
+void SetResponse(CJSONResponseStream &stream, IResultItemSource *source)
+{
+  CJSONResponseStream::CScope scope(&stream);
+  CVariant response(CVariant::VariantTypeObject);
+  response["id"] = 1;
+  response["jsonrpc"] = "2.0";
+  CJSONResponseStream::Defer(response["result"]["items"], source);
+  stream.SetResponse(response, true);
+}
+}
+
+TEST(TestTCPServer, AnnounceWhileStreaming)
+{
+  TestTCPServerHelper helper;
+  ASSERT_TRUE(helper.IsConnected());
+
+  CJSONResponseStream expected;
+  SetResponse(expected, new CAnnouncingSource(nullptr, -1));
+  std::string announcement = TestTCPServerHelper::Announcement("OnTest");
+
+  // well past the first piece the response is sent in
+  CJSONResponseStream response;
+  SetResponse(response, new CAnnouncingSource(&helper, ITEMS / 2));
+  std::string received = helper.SendResponse(response);
+
+  // the announcement must follow the response instead of ending up in it
+  EXPECT_EQ(expected.ReadAll() + announcement, received);
+}
@@ -0,0 +1,123 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "PictureScaler.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+extern "C"
+{
+#include "libswscale/swscale.h"
+}
+
+CPictureScaler& CPictureScaler::GetInstance()
+{
+  static CPictureScaler scaler;
+  return scaler;
+}
+
+CPictureScaler::~CPictureScaler()
+{
+  Clear();
+}
+
+bool CPictureScaler::Key::operator==(const Key &right) const
+{
+  return srcWidth == right.srcWidth && srcHeight == right.srcHeight &&
+         srcFormat == right.srcFormat && srcFullRange == right.srcFullRange &&
+         dstWidth == right.dstWidth && dstHeight == right.dstHeight &&
+         dstFormat == right.dstFormat && flags == right.flags;
+}
+
+SwsContext* CPictureScaler::Acquire(const Key &key)
+{
+  {
+    CSingleLock lock(m_section);
+    for (auto it = m_idle.begin(); it != m_idle.end(); ++it)
+    {
+      if (it->key == key)
+      {
+        SwsContext *context = it->context;
+        m_idle.erase(it);
+        return context;
+      }
+    }
+  }
+
+  // set up outside the lock, this is the expensive part
+  SwsContext *context = sws_getContext(key.srcWidth, key.srcHeight, key.srcFormat,
+                                       key.dstWidth, key.dstHeight, key.dstFormat,
+                                       key.flags, NULL, NULL, NULL);
+  if (context && key.srcFullRange)
+  {
+    int* inv_table = nullptr;
+    int* table = nullptr;
+    int srcRange, dstRange, brightness, contrast, saturation;
+    sws_getColorspaceDetails(context, &inv_table, &srcRange, &table, &dstRange, &brightness, &contrast, &saturation);
+    srcRange = 1;
+    sws_setColorspaceDetails(context, inv_table, srcRange, table, dstRange, brightness, contrast, saturation);
+  }
+  return context;
+}
+
+void CPictureScaler::Release(const Key &key, SwsContext *context)
+{
+  SwsContext *evicted = NULL;
+  {
+    CSingleLock lock(m_section);
+    m_idle.push_front({ key, context });
+    if (m_idle.size() > MAX_IDLE_CONTEXTS)
+    {
+      evicted = m_idle.back().context;
+      m_idle.pop_back();
+    }
+  }
+  sws_freeContext(evicted);
+}
+
+bool CPictureScaler::Scale(const uint8_t *const src[], const int srcStride[], unsigned int srcWidth, unsigned int srcHeight,
+                           AVPixelFormat srcFormat, bool srcFullRange,
+                           uint8_t *const dst[], const int dstStride[], unsigned int dstWidth, unsigned int dstHeight,
+                           AVPixelFormat dstFormat, int flags)
+{
+  Key key = { srcWidth, srcHeight, srcFormat, srcFullRange, dstWidth, dstHeight, dstFormat, flags };
+  SwsContext *context = Acquire(key);
+  if (!context)
+  {
+    CLog::Log(LOGERROR, "CPictureScaler::Scale - unable to set up scaling from %ux%u to %ux%u",
+              srcWidth, srcHeight, dstWidth, dstHeight);
+    return false;
+  }
+
+  sws_scale(context, src, srcStride, 0, srcHeight, dst, dstStride);
+  Release(key, context);
+  return true;
+}
+
+void CPictureScaler::Clear()
+{
+  std::list<Context> idle;
+  {
+    CSingleLock lock(m_section);
+    idle.swap(m_idle);
+  }
+  for (const auto &context : idle)
+    sws_freeContext(context.context);
+}
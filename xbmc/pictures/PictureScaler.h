@@ -0,0 +1,98 @@
+#pragma once
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/CriticalSection.h"
+
+#include <list>
+#include <stdint.h>
+
+extern "C"
+{
+#include "libavutil/pixfmt.h"
+}
+
+struct SwsContext;
+
+/*!
+ \brief Scales and converts images, reusing swscale contexts between calls.
+
+ Setting up a swscale context computes the filter coefficients for the source
+ and destination geometry, which takes longer than scaling a thumbnail. Idle
+ contexts are kept keyed by geometry, pixel formats and flags, so caching a lot
+ of images of the same few sizes (e.g. library art) only sets them up once.
+ A context is handed to one caller at a time, so any number of threads may
+ scale concurrently.
+ */
+class CPictureScaler
+{
+public:
+  static CPictureScaler& GetInstance();
+
+  /*!
+   \brief Scale an image
+   \param srcFullRange whether YUV input uses the full (jpeg) range
+   \param flags swscale flags, see CPictureScalingAlgorithm::ToSwscale()
+   \return false if no context could be set up for the conversion
+   */
+  bool Scale(const uint8_t *const src[], const int srcStride[], unsigned int srcWidth, unsigned int srcHeight,
+             AVPixelFormat srcFormat, bool srcFullRange,
+             uint8_t *const dst[], const int dstStride[], unsigned int dstWidth, unsigned int dstHeight,
+             AVPixelFormat dstFormat, int flags);
+
+  /*!
+   \brief Free all idle contexts
+   */
+  void Clear();
+
+private:
+  CPictureScaler() = default;
+  ~CPictureScaler();
+  CPictureScaler(const CPictureScaler&) = delete;
+  CPictureScaler& operator=(const CPictureScaler&) = delete;
+
+  struct Key
+  {
+    unsigned int srcWidth;
+    unsigned int srcHeight;
+    AVPixelFormat srcFormat;
+    bool srcFullRange;
+    unsigned int dstWidth;
+    unsigned int dstHeight;
+    AVPixelFormat dstFormat;
+    int flags;
+
+    bool operator==(const Key &right) const;
+  };
+
+  struct Context
+  {
+    Key key;
+    SwsContext *context;
+  };
+
+  SwsContext* Acquire(const Key &key);
+  void Release(const Key &key, SwsContext *context);
+
+  static const unsigned int MAX_IDLE_CONTEXTS = 16;
+
+  CCriticalSection m_section;
+  std::list<Context> m_idle; ///< most recently used first
+};
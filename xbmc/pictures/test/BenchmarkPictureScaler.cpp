@@ -0,0 +1,58 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TestPictureScaler.h"
+#include "utils/Stopwatch.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+
+using namespace PictureScalerTest;
+
+#define BENCHMARK_IMAGES 50
+
+TEST(BenchmarkPictureScaler, Scale)
+{
+  CStopWatch watch;
+  for (const Geometry &geometry : geometries)
+  {
+    std::vector<uint8_t> in = CreateImage(geometry.srcWidth, geometry.srcHeight);
+    std::vector<uint8_t> out(geometry.dstWidth * geometry.dstHeight * 4);
+
+    watch.StartZero();
+    for (int i = 0; i < BENCHMARK_IMAGES; i++)
+      ASSERT_TRUE(ScaleUncached(in, geometry, out));
+    watch.Stop();
+    float timeUncached = watch.GetElapsedMilliseconds();
+
+    watch.StartZero();
+    for (int i = 0; i < BENCHMARK_IMAGES; i++)
+      ASSERT_TRUE(ScaleCached(in, geometry, out));
+    watch.Stop();
+    float timeCached = watch.GetElapsedMilliseconds();
+
+    std::string size = std::to_string(geometry.srcWidth) + "x" + std::to_string(geometry.srcHeight) + "_to_" +
+                       std::to_string(geometry.dstWidth) + "x" + std::to_string(geometry.dstHeight);
+    ::testing::Test::RecordProperty(size + "_uncached_per_s", static_cast<int>(BENCHMARK_IMAGES * 1000.0f / timeUncached));
+    ::testing::Test::RecordProperty(size + "_cached_per_s", static_cast<int>(BENCHMARK_IMAGES * 1000.0f / timeCached));
+  }
+  CPictureScaler::GetInstance().Clear();
+}
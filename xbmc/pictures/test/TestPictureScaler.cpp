@@ -0,0 +1,44 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TestPictureScaler.h"
+
+#include "gtest/gtest.h"
+
+using namespace PictureScalerTest;
+
+TEST(TestPictureScaler, MatchesUncached)
+{
+  for (const Geometry &geometry : geometries)
+  {
+    std::vector<uint8_t> in = CreateImage(geometry.srcWidth, geometry.srcHeight);
+    std::vector<uint8_t> expected(geometry.dstWidth * geometry.dstHeight * 4);
+    ASSERT_TRUE(ScaleUncached(in, geometry, expected));
+
+    // the second pass reuses the context of the first
+    for (int pass = 0; pass < 2; pass++)
+    {
+      std::vector<uint8_t> out(expected.size());
+      ASSERT_TRUE(ScaleCached(in, geometry, out));
+      EXPECT_TRUE(expected == out);
+    }
+  }
+  CPictureScaler::GetInstance().Clear();
+}
@@ -0,0 +1,94 @@
+#pragma once
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "pictures/PictureScaler.h"
+
+extern "C"
+{
+#include "libswscale/swscale.h"
+}
+
+#include <stdint.h>
+#include <vector>
+
+namespace PictureScalerTest
+{
+struct Geometry
+{
+  unsigned int srcWidth;
+  unsigned int srcHeight;
+  unsigned int dstWidth;
+  unsigned int dstHeight;
+};
+
+// poster, fanart and thumb sizes as cached by the texture cache
+static const Geometry geometries[] = {
+  { 1000, 1500,  341,  512 },
+  { 1920, 1080, 1280,  720 },
+  { 3840, 2160, 1920, 1080 },
+  {  500,  500,  256,  256 },
+};
+
+inline std::vector<uint8_t> CreateImage(unsigned int width, unsigned int height)
+{
+  std::vector<uint8_t> image(width * height * 4);
+  for (unsigned int y = 0; y < height; y++)
+  {
+    for (unsigned int x = 0; x < width; x++)
+    {
+      uint8_t *pixel = &image[(y * width + x) * 4];
+      pixel[0] = (uint8_t)x;
+      pixel[1] = (uint8_t)y;
+      pixel[2] = (uint8_t)(x + y);
+      pixel[3] = 0xff;
+    }
+  }
+  return image;
+}
+
+inline bool ScaleUncached(const std::vector<uint8_t> &in, const Geometry &geometry, std::vector<uint8_t> &out)
+{
+  SwsContext *context = sws_getContext(geometry.srcWidth, geometry.srcHeight, AV_PIX_FMT_BGRA,
+                                       geometry.dstWidth, geometry.dstHeight, AV_PIX_FMT_BGRA,
+                                       SWS_BICUBIC, NULL, NULL, NULL);
+  if (!context)
+    return false;
+
+  const uint8_t *src[] = { in.data(), 0, 0, 0 };
+  int srcStride[] = { (int)geometry.srcWidth * 4, 0, 0, 0 };
+  uint8_t *dst[] = { out.data(), 0, 0, 0 };
+  int dstStride[] = { (int)geometry.dstWidth * 4, 0, 0, 0 };
+  sws_scale(context, src, srcStride, 0, geometry.srcHeight, dst, dstStride);
+  sws_freeContext(context);
+  return true;
+}
+
+inline bool ScaleCached(const std::vector<uint8_t> &in, const Geometry &geometry, std::vector<uint8_t> &out)
+{
+  const uint8_t *src[] = { in.data(), 0, 0, 0 };
+  int srcStride[] = { (int)geometry.srcWidth * 4, 0, 0, 0 };
+  uint8_t *dst[] = { out.data(), 0, 0, 0 };
+  int dstStride[] = { (int)geometry.dstWidth * 4, 0, 0, 0 };
+  return CPictureScaler::GetInstance().Scale(src, srcStride, geometry.srcWidth, geometry.srcHeight, AV_PIX_FMT_BGRA, false,
+                                             dst, dstStride, geometry.dstWidth, geometry.dstHeight, AV_PIX_FMT_BGRA,
+                                             SWS_BICUBIC);
+}
+}
@@ -23,6 +23,7 @@
 
 #include "RenderSystemGL.h"
 #include "guilib/GraphicContext.h"
+#include "guilib/GUITextureGL.h"
 #include "settings/AdvancedSettings.h"
 #include "guilib/MatrixGLES.h"
 #include "settings/DisplaySettings.h"
@@ -286,6 +287,7 @@ bool CRenderSystemGL::EndRender()
 
 bool CRenderSystemGL::ClearBuffers(color_t color)
 {
+  CGUITextureGL::FlushBatch();
   if (!m_bRenderCreated)
     return false;
 
@@ -331,6 +333,7 @@ bool CRenderSystemGL::IsExtSupported(const char* extension)
 
 void CRenderSystemGL::PresentRender(bool rendered, bool videoLayer)
 {
+  CGUITextureGL::FlushBatch();
   SetVSync(true);
 
   if (!m_bRenderCreated)
@@ -363,6 +366,7 @@ void CRenderSystemGL::SetVSync(bool enable)
 
 void CRenderSystemGL::CaptureStateBlock()
 {
+  CGUITextureGL::FlushBatch();
   if (!m_bRenderCreated)
     return;
 
@@ -394,6 +398,7 @@ void CRenderSystemGL::ApplyStateBlock()
 
 void CRenderSystemGL::SetCameraPosition(const CPoint &camera, int screenWidth, int screenHeight, float stereoFactor)
 {
+  CGUITextureGL::FlushBatch();
   if (!m_bRenderCreated)
     return;
 
@@ -444,6 +449,7 @@ bool CRenderSystemGL::TestRender()
 
 void CRenderSystemGL::ApplyHardwareTransform(const TransformMatrix &finalMatrix)
 {
+  CGUITextureGL::FlushBatch();
   if (!m_bRenderCreated)
     return;
 
@@ -465,6 +471,7 @@ void CRenderSystemGL::ApplyHardwareTransform(const TransformMatrix &finalMatrix)
 
 void CRenderSystemGL::RestoreHardwareTransform()
 {
+  CGUITextureGL::FlushBatch();
   if (!m_bRenderCreated)
     return;
 
@@ -530,6 +537,7 @@ void CRenderSystemGL::GetViewPort(CRect& viewPort)
 
 void CRenderSystemGL::SetViewPort(const CRect& viewPort)
 {
+  CGUITextureGL::FlushBatch();
   if (!m_bRenderCreated)
     return;
 
@@ -565,6 +573,7 @@ CRect CRenderSystemGL::ClipRectToScissorRect(const CRect &rect)
 
 void CRenderSystemGL::SetScissors(const CRect &rect)
 {
+  CGUITextureGL::FlushBatch();
   if (!m_bRenderCreated)
     return;
   GLint x1 = MathUtils::round_int(rect.x1);
@@ -767,6 +776,8 @@ void CRenderSystemGL::InitialiseShader()
 
 void CRenderSystemGL::EnableShader(ESHADERMETHOD method)
 {
+  // textures batched with the current shader have to be drawn before it changes
+  CGUITextureGL::FlushBatch();
   m_method = method;
   if (m_pShader[m_method])
   {
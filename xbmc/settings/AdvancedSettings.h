@@ -253,6 +253,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
 
     int m_iMusicLibraryRecentlyAddedItems;
     int m_iMusicLibraryDateAdded;
+    int m_iMusicLibraryScannerThreads; ///< workers reading tags ahead of the scanner, 0 to read them on the scanner thread
     bool m_bMusicLibraryAllItemsOnBottom;
     bool m_bMusicLibraryCleanOnUpdate;
     bool m_bMusicLibraryArtistSortOnUpdate;
@@ -273,6 +274,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_bVideoLibraryImportResumePoint;
 
     bool m_bVideoScannerIgnoreErrors;
+    int m_iVideoScannerThreads; ///< workers listing folders and fetching info ahead of the scanner, 0 to do everything on the scanner thread
     int m_iVideoLibraryDateAdded;
 
     std::set<std::string> m_vecTokens;
@@ -341,9 +343,11 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_guiVisualizeDirtyRegions;
     int  m_guiAlgorithmDirtyRegions;
     bool m_guiSmartRedraw;
+    bool m_guiTextureAtlas; ///< pack small skin images into shared textures and batch their draws
     unsigned int m_addonPackageFolderSize;
 
     unsigned int m_cacheMemSize;
+    unsigned int m_cachePersistentSize; ///< size of the on-disk read-ahead store for network files in MB, 0 disables it
     unsigned int m_cacheBufferMode;
     float m_cacheReadFactor;
 
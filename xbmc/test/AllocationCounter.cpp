@@ -0,0 +1,116 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+thread_local bool g_counting = false;
+thread_local uint64_t g_count = 0;
+thread_local uint64_t g_bytes = 0;
+
+std::atomic<int> g_globalCounters(0);
+std::atomic<uint64_t> g_globalCount(0);
+std::atomic<uint64_t> g_globalBytes(0);
+}
+
+void* operator new(std::size_t size)
+{
+  if (g_counting)
+  {
+    g_count++;
+    g_bytes += size;
+  }
+  if (g_globalCounters.load(std::memory_order_relaxed))
+  {
+    g_globalCount.fetch_add(1, std::memory_order_relaxed);
+    g_globalBytes.fetch_add(size, std::memory_order_relaxed);
+  }
+  void *p = malloc(size ? size : 1);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+
+void* operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete(void *p) noexcept
+{
+  free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+  free(p);
+}
+
+CAllocationCounter::CAllocationCounter(Scope scope)
+  : m_scope(scope)
+  , m_wasActive(g_counting)
+{
+  if (m_scope == ALL_THREADS)
+    g_globalCounters++;
+  else
+    g_counting = true;
+  Reset();
+}
+
+CAllocationCounter::~CAllocationCounter()
+{
+  if (m_scope == ALL_THREADS)
+    g_globalCounters--;
+  else
+    g_counting = m_wasActive;
+}
+
+uint64_t CAllocationCounter::GetCount() const
+{
+  if (m_scope == ALL_THREADS)
+    return g_globalCount - m_startCount;
+  return g_count - m_startCount;
+}
+
+uint64_t CAllocationCounter::GetBytes() const
+{
+  if (m_scope == ALL_THREADS)
+    return g_globalBytes - m_startBytes;
+  return g_bytes - m_startBytes;
+}
+
+void CAllocationCounter::Reset()
+{
+  if (m_scope == ALL_THREADS)
+  {
+    m_startCount = g_globalCount;
+    m_startBytes = g_globalBytes;
+  }
+  else
+  {
+    m_startCount = g_count;
+    m_startBytes = g_bytes;
+  }
+}
@@ -0,0 +1,60 @@
+#pragma once
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+
+/*! \brief Counts heap allocations made through operator new on the calling
+ thread while an instance is alive. Used by the benchmarks to compare the
+ allocation behaviour of two implementations.
+
+ Only the benchmark binary replaces the global operator new/delete for this,
+ the unit tests can't use it. Counting is only active on threads with a live
+ CAllocationCounter. A counter created
+ with ALL_THREADS counts the allocations of every thread instead, for code
+ that runs on threads of its own like the audio engine.
+ */
+class CAllocationCounter
+{
+public:
+  enum Scope
+  {
+    CURRENT_THREAD,
+    ALL_THREADS
+  };
+
+  explicit CAllocationCounter(Scope scope = CURRENT_THREAD);
+  ~CAllocationCounter();
+
+  /*! \brief Number of allocations since construction or the last Reset() */
+  uint64_t GetCount() const;
+  /*! \brief Number of bytes requested since construction or the last Reset() */
+  uint64_t GetBytes() const;
+  void Reset();
+
+private:
+  CAllocationCounter(const CAllocationCounter&) = delete;
+  CAllocationCounter& operator=(const CAllocationCounter&) = delete;
+
+  Scope m_scope;
+  uint64_t m_startCount;
+  uint64_t m_startBytes;
+  bool m_wasActive;
+};
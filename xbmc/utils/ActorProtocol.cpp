@@ -20,18 +20,26 @@
 
 #include "ActorProtocol.h"
 
+#include <thread>
+
+#define MSG_POOL_PREALLOCATED 16
+
 using namespace Actor;
 
 void Message::Release()
 {
-  bool skip;
-  origin->Lock();
-  skip = isSync ? !isSyncFini : false;
-  isSyncFini = true;
-  origin->Unlock();
-
-  if (skip)
-    return;
+  // only a sync message is shared with a sender waiting for the reply
+  if (isSync)
+  {
+    bool skip;
+    origin->Lock();
+    skip = !isSyncFini;
+    isSyncFini = true;
+    origin->Unlock();
+
+    if (skip)
+      return;
+  }
 
   // free data buffer
   if (data != buffer)
@@ -80,30 +88,209 @@ bool Message::Reply(int sig, void *data /* = NULL*/, int size /* = 0 */)
   return true;
 }
 
-Protocol::~Protocol()
+MessageQueue::MessageQueue()
+  : m_head(&m_stub), m_tail(&m_stub), m_first(NULL), m_last(NULL)
+{
+}
+
+void MessageQueue::Push(Message *msg)
+{
+  msg->next.store(NULL, std::memory_order_relaxed);
+  Message *prev = m_head.exchange(msg, std::memory_order_acq_rel);
+  prev->next.store(msg, std::memory_order_release);
+}
+
+Message *MessageQueue::PopLinked()
+{
+  Message *tail = m_tail;
+  Message *next = tail->next.load(std::memory_order_acquire);
+  if (tail == &m_stub)
+  {
+    if (!next)
+      return NULL;
+    m_tail = next;
+    tail = next;
+    next = next->next.load(std::memory_order_acquire);
+  }
+  if (next)
+  {
+    m_tail = next;
+    return tail;
+  }
+
+  // a sender has swapped itself in but not linked the message yet, it
+  // signals the event after it has, so the receiver will come back
+  if (tail != m_head.load(std::memory_order_acquire))
+    return NULL;
+
+  // tail is the last message, the stub takes its place to keep the list
+  // from running empty
+  Push(&m_stub);
+  next = tail->next.load(std::memory_order_acquire);
+  if (next)
+  {
+    m_tail = next;
+    return tail;
+  }
+  return NULL;
+}
+
+void MessageQueue::Acquire()
+{
+  while (m_receiving.test_and_set(std::memory_order_acquire))
+    std::this_thread::yield();
+}
+
+Message *MessageQueue::Pop()
 {
+  Acquire();
+  Message *msg = m_first;
+  if (msg)
+  {
+    m_first = msg->next.load(std::memory_order_relaxed);
+    if (!m_first)
+      m_last = NULL;
+  }
+  else
+    msg = PopLinked();
+  Release();
+  return msg;
+}
+
+Message *MessageQueue::Remove(int signal)
+{
+  Acquire();
+
+  // everything sent so far goes behind the messages kept back, then the
+  // matching ones are unlinked from there
   Message *msg;
-  Purge();
-  while (!freeMessageQueue.empty())
+  while ((msg = PopLinked()))
   {
-    msg = freeMessageQueue.front();
-    freeMessageQueue.pop();
-    delete msg;
+    msg->next.store(NULL, std::memory_order_relaxed);
+    if (m_last)
+      m_last->next.store(msg, std::memory_order_relaxed);
+    else
+      m_first = msg;
+    m_last = msg;
   }
+
+  Message *removed = NULL;
+  Message *removedLast = NULL;
+  Message *prev = NULL;
+  msg = m_first;
+  while (msg)
+  {
+    Message *next = msg->next.load(std::memory_order_relaxed);
+    if (msg->signal == signal)
+    {
+      if (prev)
+        prev->next.store(next, std::memory_order_relaxed);
+      else
+        m_first = next;
+      if (m_last == msg)
+        m_last = prev;
+
+      msg->next.store(NULL, std::memory_order_relaxed);
+      if (removedLast)
+        removedLast->next.store(msg, std::memory_order_relaxed);
+      else
+        removed = msg;
+      removedLast = msg;
+    }
+    else
+      prev = msg;
+    msg = next;
+  }
+
+  Release();
+  return removed;
 }
 
-Message *Protocol::GetMessage()
+MessagePool::MessagePool()
+  : m_pushPos(0), m_popPos(0)
+{
+  static_assert((MSG_POOL_SIZE & (MSG_POOL_SIZE - 1)) == 0, "MSG_POOL_SIZE must be a power of two");
+  for (size_t i = 0; i < MSG_POOL_SIZE; i++)
+  {
+    m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    m_cells[i].msg = NULL;
+  }
+}
+
+MessagePool::~MessagePool()
 {
   Message *msg;
+  while ((msg = Pop()))
+    delete msg;
+}
 
-  CSingleLock lock(criticalSection);
+bool MessagePool::Push(Message *msg)
+{
+  size_t pos = m_pushPos.load(std::memory_order_relaxed);
+  while (true)
+  {
+    Cell &cell = m_cells[pos & (MSG_POOL_SIZE - 1)];
+    size_t sequence = cell.sequence.load(std::memory_order_acquire);
+    intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+    if (diff == 0)
+    {
+      if (m_pushPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+      {
+        cell.msg = msg;
+        cell.sequence.store(pos + 1, std::memory_order_release);
+        return true;
+      }
+    }
+    else if (diff < 0)
+      return false; // full
+    else
+      pos = m_pushPos.load(std::memory_order_relaxed);
+  }
+}
 
-  if (!freeMessageQueue.empty())
+Message *MessagePool::Pop()
+{
+  size_t pos = m_popPos.load(std::memory_order_relaxed);
+  while (true)
   {
-    msg = freeMessageQueue.front();
-    freeMessageQueue.pop();
+    Cell &cell = m_cells[pos & (MSG_POOL_SIZE - 1)];
+    size_t sequence = cell.sequence.load(std::memory_order_acquire);
+    intptr_t diff = (intptr_t)sequence - (intptr_t)(pos + 1);
+    if (diff == 0)
+    {
+      if (m_popPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+      {
+        Message *msg = cell.msg;
+        cell.sequence.store(pos + MSG_POOL_SIZE, std::memory_order_release);
+        return msg;
+      }
+    }
+    else if (diff < 0)
+      return NULL; // empty
+    else
+      pos = m_popPos.load(std::memory_order_relaxed);
   }
-  else
+}
+
+Protocol::Protocol(std::string name, CEvent* inEvent, CEvent *outEvent)
+  : portName(name), inDefered(false), outDefered(false)
+{
+  containerInEvent = inEvent;
+  containerOutEvent = outEvent;
+
+  for (int i = 0; i < MSG_POOL_PREALLOCATED; i++)
+    freeMessages.Push(new Message());
+}
+
+Protocol::~Protocol()
+{
+  Purge();
+}
+
+Message *Protocol::GetMessage()
+{
+  Message *msg = freeMessages.Pop();
+  if (!msg)
     msg = new Message();
 
   msg->isSync = false;
@@ -120,9 +307,8 @@ Message *Protocol::GetMessage()
 
 void Protocol::ReturnMessage(Message *msg)
 {
-  CSingleLock lock(criticalSection);
-
-  freeMessageQueue.push(msg);
+  if (!freeMessages.Push(msg))
+    delete msg;
 }
 
 bool Protocol::SendOutMessage(int signal, void *data /* = NULL */, int size /* = 0 */, Message *outMsg /* = NULL */)
@@ -145,9 +331,7 @@ bool Protocol::SendOutMessage(int signal, void *data /* = NULL */, int size /* =
     memcpy(msg->data, data, size);
   }
 
-  { CSingleLock lock(criticalSection);
-    outMessages.push(msg);
-  }
+  outMessages.Push(msg);
   if (containerOutEvent)
     containerOutEvent->Set();
 
@@ -174,9 +358,7 @@ bool Protocol::SendInMessage(int signal, void *data /* = NULL */, int size /* =
     memcpy(msg->data, data, size);
   }
 
-  { CSingleLock lock(criticalSection);
-    inMessages.push(msg);
-  }
+  inMessages.Push(msg);
   if (containerInEvent)
     containerInEvent->Set();
 
@@ -218,28 +400,20 @@ bool Protocol::SendOutMessageSync(int signal, Message **retMsg, int timeout, voi
 
 bool Protocol::ReceiveOutMessage(Message **msg)
 {
-  CSingleLock lock(criticalSection);
-
-  if (outMessages.empty() || outDefered)
+  if (outDefered)
     return false;
 
-  *msg = outMessages.front();
-  outMessages.pop();
-
-  return true;
+  *msg = outMessages.Pop();
+  return *msg != NULL;
 }
 
 bool Protocol::ReceiveInMessage(Message **msg)
 {
-  CSingleLock lock(criticalSection);
-
-  if (inMessages.empty() || inDefered)
+  if (inDefered)
     return false;
 
-  *msg = inMessages.front();
-  inMessages.pop();
-
-  return true;
+  *msg = inMessages.Pop();
+  return *msg != NULL;
 }
 
 
@@ -256,44 +430,22 @@ void Protocol::Purge()
 
 void Protocol::PurgeIn(int signal)
 {
-  Message *msg;
-  std::queue<Message*> msgs;
-
-  CSingleLock lock(criticalSection);
-
-  while (!inMessages.empty())
+  Message *msg = inMessages.Remove(signal);
+  while (msg)
   {
-    msg = inMessages.front();
-    inMessages.pop();
-    if (msg->signal != signal)
-      msgs.push(msg);
-  }
-  while (!msgs.empty())
-  {
-    msg = msgs.front();
-    msgs.pop();
-    inMessages.push(msg);
+    Message *next = msg->next.load(std::memory_order_relaxed);
+    msg->Release();
+    msg = next;
   }
 }
 
 void Protocol::PurgeOut(int signal)
 {
-  Message *msg;
-  std::queue<Message*> msgs;
-
-  CSingleLock lock(criticalSection);
-
-  while (!outMessages.empty())
+  Message *msg = outMessages.Remove(signal);
+  while (msg)
   {
-    msg = outMessages.front();
-    outMessages.pop();
-    if (msg->signal != signal)
-      msgs.push(msg);
-  }
-  while (!msgs.empty())
-  {
-    msg = msgs.front();
-    msgs.pop();
-    outMessages.push(msg);
+    Message *next = msg->next.load(std::memory_order_relaxed);
+    msg->Release();
+    msg = next;
   }
 }
@@ -21,19 +21,22 @@
 #pragma once
 
 #include "threads/Thread.h"
-#include <queue>
+#include <atomic>
 #include "memory.h"
 
 #define MSG_INTERNAL_BUFFER_SIZE 32
+#define MSG_POOL_SIZE 64
 
 namespace Actor
 {
 
 class Protocol;
+class MessageQueue;
 
 class Message
 {
   friend class Protocol;
+  friend class MessageQueue;
 public:
   int signal;
   bool isSync;
@@ -51,14 +54,77 @@ public:
   bool Reply(int sig, void *data = NULL, int size = 0);
 
 private:
-  Message() {isSync = false; data = NULL; event = NULL; replyMessage = NULL;};
+  Message() {isSync = false; data = NULL; event = NULL; replyMessage = NULL; next = NULL;};
+  std::atomic<Message*> next;
+};
+
+/*!
+ \brief Lock-free FIFO of messages for any number of senders and one receiver.
+
+ Senders link a message in with a single atomic exchange (Dmitry Vyukov's
+ intrusive MPSC queue), so they never wait for each other or the receiver.
+ Each queue of a protocol is read by the thread owning that end. Receivers
+ that still happen to overlap, e.g. a purge on shutdown, are serialised by
+ a flag which is never contended otherwise.
+ */
+class MessageQueue
+{
+public:
+  MessageQueue();
+  void Push(Message *msg);
+  Message *Pop();
+  /*!
+   \brief Take all queued messages with the signal out of the queue, keeping
+   the order of the others
+   \return the removed messages, linked through next
+   */
+  Message *Remove(int signal);
+
+private:
+  MessageQueue(const MessageQueue&) = delete;
+  MessageQueue& operator=(const MessageQueue&) = delete;
+
+  Message *PopLinked();
+  void Acquire();
+  void Release() {m_receiving.clear(std::memory_order_release);};
+
+  std::atomic<Message*> m_head; ///< last message pushed
+  Message *m_tail; ///< oldest message, owned by the receiver
+  Message m_stub;
+  Message *m_first, *m_last; ///< kept back by Remove(), they come before m_tail
+  std::atomic_flag m_receiving = ATOMIC_FLAG_INIT;
+};
+
+/*!
+ \brief Preallocated free messages, bounded lock-free MPMC ring (Vyukov).
+ Falls back to the heap when it runs dry or overflows.
+ */
+class MessagePool
+{
+public:
+  MessagePool();
+  ~MessagePool();
+  bool Push(Message *msg);
+  Message *Pop();
+
+private:
+  MessagePool(const MessagePool&) = delete;
+  MessagePool& operator=(const MessagePool&) = delete;
+
+  struct Cell
+  {
+    std::atomic<size_t> sequence;
+    Message *msg;
+  };
+  Cell m_cells[MSG_POOL_SIZE];
+  std::atomic<size_t> m_pushPos;
+  std::atomic<size_t> m_popPos;
 };
 
 class Protocol
 {
 public:
-  Protocol(std::string name, CEvent* inEvent, CEvent *outEvent)
-    : portName(name), inDefered(false), outDefered(false) {containerInEvent = inEvent; containerOutEvent = outEvent;};
+  Protocol(std::string name, CEvent* inEvent, CEvent *outEvent);
   Protocol(std::string name)
     : Protocol(name, nullptr, nullptr) {}
   virtual ~Protocol();
@@ -80,11 +146,11 @@ public:
 
 protected:
   CEvent *containerInEvent, *containerOutEvent;
-  CCriticalSection criticalSection;
-  std::queue<Message*> outMessages;
-  std::queue<Message*> inMessages;
-  std::queue<Message*> freeMessageQueue;
-  bool inDefered, outDefered;
+  CCriticalSection criticalSection; ///< only guards the reply of sync messages
+  MessageQueue outMessages;
+  MessageQueue inMessages;
+  MessagePool freeMessages;
+  std::atomic<bool> inDefered, outDefered;
 };
 
 }
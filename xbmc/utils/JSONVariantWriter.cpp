@@ -26,8 +26,10 @@
 
 #include "utils/Variant.h"
 
+typedef std::vector<std::pair<size_t, uint64_t>> DeferredOffsets;
+
 template<class TWriter>
-bool InternalWrite(TWriter& writer, const CVariant &value)
+bool InternalWrite(TWriter& writer, const rapidjson::StringBuffer &buffer, const CVariant &value, DeferredOffsets *deferred)
 {
   switch (value.type())
   {
@@ -52,7 +54,7 @@ bool InternalWrite(TWriter& writer, const CVariant &value)
 
     for (CVariant::const_iterator_array itr = value.begin_array(); itr != value.end_array(); ++itr)
     {
-      if (!InternalWrite(writer, *itr))
+      if (!InternalWrite(writer, buffer, *itr, deferred))
         return false;
     }
 
@@ -65,12 +67,21 @@ bool InternalWrite(TWriter& writer, const CVariant &value)
     for (CVariant::const_iterator_map itr = value.begin_map(); itr != value.end_map(); ++itr)
     {
       if (!writer.Key(itr->first.c_str()) ||
-        !InternalWrite(writer, itr->second))
+        !InternalWrite(writer, buffer, itr->second, deferred))
         return false;
     }
 
     return writer.EndObject(value.size());
 
+  case CVariant::VariantTypeDeferred:
+    if (!writer.Null())
+      return false;
+
+    // the writer puts separators in front of a value, so the null ends the buffer
+    if (deferred != nullptr)
+      deferred->push_back(std::make_pair(buffer.GetSize() - 4, value.asUnsignedInteger()));
+    return true;
+
   case CVariant::VariantTypeConstNull:
   case CVariant::VariantTypeNull:
   default:
@@ -80,14 +91,14 @@ bool InternalWrite(TWriter& writer, const CVariant &value)
   return false;
 }
 
-bool CJSONVariantWriter::Write(const CVariant &value, std::string& output, bool compact)
+static bool WriteDocument(const CVariant &value, std::string& output, bool compact, DeferredOffsets *deferred)
 {
   rapidjson::StringBuffer stringBuffer;
   if (compact)
   {
     rapidjson::Writer<rapidjson::StringBuffer> writer(stringBuffer);
 
-    if (!InternalWrite(writer, value) || !writer.IsComplete())
+    if (!InternalWrite(writer, stringBuffer, value, deferred) || !writer.IsComplete())
       return false;
   }
   else
@@ -95,10 +106,21 @@ bool CJSONVariantWriter::Write(const CVariant &value, std::string& output, bool
     rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(stringBuffer);
     writer.SetIndent('\t', 1);
 
-    if (!InternalWrite(writer, value) || !writer.IsComplete())
+    if (!InternalWrite(writer, stringBuffer, value, deferred) || !writer.IsComplete())
       return false;
   }
 
   output = stringBuffer.GetString();
   return true;
 }
+
+bool CJSONVariantWriter::Write(const CVariant &value, std::string& output, bool compact)
+{
+  return WriteDocument(value, output, compact, nullptr);
+}
+
+bool CJSONVariantWriter::Write(const CVariant &value, std::string& output, bool compact, std::vector<std::pair<size_t, uint64_t>> &deferred)
+{
+  deferred.clear();
+  return WriteDocument(value, output, compact, &deferred);
+}
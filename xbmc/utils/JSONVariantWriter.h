@@ -19,7 +19,10 @@
  *
  */
 
+#include <stdint.h>
 #include <string>
+#include <utility>
+#include <vector>
 
 class CVariant;
 
@@ -29,4 +32,13 @@ public:
   CJSONVariantWriter() = delete;
 
   static bool Write(const CVariant &value, std::string& output, bool compact);
+
+  /*!
+   \brief Write value, keeping track of where its deferred values end up
+
+   \details Deferred values (see CVariant::CreateDeferred()) are written as
+   null. For every one of them, deferred receives the offset of that null in
+   output and the index of the value.
+   */
+  static bool Write(const CVariant &value, std::string& output, bool compact, std::vector<std::pair<size_t, uint64_t>> &deferred);
 };
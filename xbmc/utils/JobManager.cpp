@@ -22,6 +22,7 @@
 #include <algorithm>
 #include <functional>
 #include <stdexcept>
+#include "threads/SharedSection.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #ifdef TARGET_POSIX
@@ -37,7 +38,9 @@ bool CJob::ShouldCancel(unsigned int progress, unsigned int total) const
   return false;
 }
 
-CJobWorker::CJobWorker(CJobManager *manager) : CThread("JobWorker")
+CJobWorker::CJobWorker(CJobManager *manager) : CThread("JobWorker"),
+  m_current(NULL, 0, CJob::PRIORITY_LOW, NULL),
+  m_idle(false)
 {
   m_jobManager = manager;
   Create(true); // start work immediately, and kill ourselves when we're done
@@ -72,7 +75,7 @@ void CJobWorker::Process()
     {
       CLog::Log(LOGERROR, "%s error processing job %s", __FUNCTION__, job->GetType());
     }
-    m_jobManager->OnJobComplete(success, job);
+    m_jobManager->OnJobComplete(this, success);
   }
 }
 
@@ -182,13 +185,18 @@ CJobManager &CJobManager::GetInstance()
 CJobManager::CJobManager()
 {
   m_jobCounter = 0;
+  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
+    m_queued[priority] = 0;
+  m_processingCount = 0;
+  m_steals = 0;
+  m_nextWorker = 0;
   m_running = true;
   m_pauseJobs = false;
 }
 
 void CJobManager::Restart()
 {
-  CSingleLock lock(m_section);
+  CExclusiveLock lock(m_workersSection);
 
   if (m_running)
     throw std::logic_error("CJobManager already running");
@@ -197,24 +205,33 @@ void CJobManager::Restart()
 
 void CJobManager::CancelJobs()
 {
-  CSingleLock lock(m_section);
+  CExclusiveLock lock(m_workersSection);
   m_running = false;
 
-  // clear any pending jobs
-  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
+  for (Workers::iterator it = m_workers.begin(); it != m_workers.end(); ++it)
   {
-    for_each(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), std::mem_fun_ref(&CWorkItem::FreeJob));
-    m_jobQueue[priority].clear();
-  }
+    CJobWorker *worker = *it;
+    CSingleLock workerLock(worker->m_section);
+
+    // clear any pending jobs
+    for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
+    {
+      JobQueue &queue = worker->m_queue[priority];
+      for_each(queue.begin(), queue.end(), std::mem_fun_ref(&CWorkItem::FreeJob));
+      m_queued[priority] -= queue.size();
+      queue.clear();
+    }
 
-  // cancel any callbacks on jobs still processing
-  for_each(m_processing.begin(), m_processing.end(), std::mem_fun_ref(&CWorkItem::Cancel));
+    // cancel any callbacks on jobs still processing
+    worker->m_current.Cancel();
+  }
 
   // tell our workers to finish
   while (m_workers.size())
   {
+    for (Workers::iterator it = m_workers.begin(); it != m_workers.end(); ++it)
+      (*it)->m_jobEvent.Set();
     lock.Leave();
-    m_jobEvent.Set();
     Sleep(0); // yield after setting the event to give the workers some time to die
     lock.Enter();
   }
@@ -224,110 +241,198 @@ CJobManager::~CJobManager() = default;
 
 unsigned int CJobManager::AddJob(CJob *job, IJobCallback *callback, CJob::PRIORITY priority)
 {
-  CSingleLock lock(m_section);
+  CSharedLock lock(m_workersSection);
 
   if (!m_running)
     return 0;
 
   // increment the job counter, ensuring 0 (invalid job) is never hit
-  m_jobCounter++;
-  if (m_jobCounter == 0)
-    m_jobCounter++;
+  unsigned int id = ++m_jobCounter;
+  if (id == 0)
+    id = ++m_jobCounter;
 
   // create a work item for this job
-  CWorkItem work(job, m_jobCounter, priority, callback);
-  m_jobQueue[priority].push_back(work);
+  CWorkItem work(job, id, priority, callback);
+
+  bool wake = false;
+  CJobWorker *worker = SelectWorker(priority, wake);
+  if (!worker)
+  {
+    // everyone is busy - we need more workers
+    lock.Leave();
+    CExclusiveLock exclusiveLock(m_workersSection);
+    if (!m_running)
+      return 0;
+
+    worker = new CJobWorker(this);
+    m_workers.push_back(worker);
+
+    {
+      CSingleLock workerLock(worker->m_section);
+      worker->m_queue[priority].push_back(work);
+      m_queued[priority]++;
+    }
+    worker->m_jobEvent.Set();
+    return id;
+  }
 
-  StartWorkers(priority);
-  return work.m_id;
+  {
+    CSingleLock workerLock(worker->m_section);
+    worker->m_queue[priority].push_back(work);
+    m_queued[priority]++;
+  }
+  if (wake)
+    worker->m_jobEvent.Set();
+
+  return id;
 }
 
-void CJobManager::CancelJob(unsigned int jobID)
+CJobWorker *CJobManager::SelectWorker(CJob::PRIORITY priority, bool &wake)
 {
-  CSingleLock lock(m_section);
+  wake = false;
+  if (m_workers.empty())
+    return NULL;
 
-  // check whether we have this job in the queue
-  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
+  // check how many free threads we have. If none, park the job on any worker
+  // and let whoever finishes first steal it
+  if (m_processingCount >= GetMaxWorkers(priority))
+    return m_workers[m_nextWorker++ % m_workers.size()];
+
+  // do we have any sleeping threads? Claim one so that concurrent calls wake different workers
+  for (Workers::iterator it = m_workers.begin(); it != m_workers.end(); ++it)
   {
-    JobQueue::iterator i = find(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), jobID);
-    if (i != m_jobQueue[priority].end())
+    bool idle = true;
+    if ((*it)->m_idle.compare_exchange_strong(idle, false))
     {
-      delete i->m_job;
-      m_jobQueue[priority].erase(i);
-      return;
+      wake = true;
+      return *it;
     }
   }
-  // or if we're processing it
-  Processing::iterator it = find(m_processing.begin(), m_processing.end(), jobID);
-  if (it != m_processing.end())
-    it->m_callback = NULL; // job is in progress, so only thing to do is to remove callback
+  return NULL;
 }
 
-void CJobManager::StartWorkers(CJob::PRIORITY priority)
+void CJobManager::CancelJob(unsigned int jobID)
 {
-  CSingleLock lock(m_section);
+  CSharedLock lock(m_workersSection);
 
-  // check how many free threads we have
-  if (m_processing.size() >= GetMaxWorkers(priority))
-    return;
+  // a job may be stolen by a worker we've already checked while we look at the
+  // others, so look again if any job moved between workers during the search
+  unsigned int steals;
+  do
+  {
+    steals = m_steals;
+    for (Workers::iterator it = m_workers.begin(); it != m_workers.end(); ++it)
+    {
+      CJobWorker *worker = *it;
+      CSingleLock workerLock(worker->m_section);
+
+      // check whether we have this job in the queue
+      for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
+      {
+        JobQueue &queue = worker->m_queue[priority];
+        JobQueue::iterator i = find(queue.begin(), queue.end(), jobID);
+        if (i != queue.end())
+        {
+          delete i->m_job;
+          queue.erase(i);
+          m_queued[priority]--;
+          return;
+        }
+      }
+      // or if we're processing it
+      if (worker->m_current.m_job && worker->m_current == jobID)
+      {
+        worker->m_current.m_callback = NULL; // job is in progress, so only thing to do is to remove callback
+        return;
+      }
+    }
+  } while (steals != m_steals);
+}
 
-  // do we have any sleeping threads?
-  if (m_processing.size() < m_workers.size())
+bool CJobManager::ReserveSlot(CJob::PRIORITY priority)
+{
+  unsigned int maxWorkers = GetMaxWorkers(priority);
+  unsigned int processing = m_processingCount;
+  do
   {
-    m_jobEvent.Set();
-    return;
-  }
+    if (processing >= maxWorkers)
+      return false;
+  } while (!m_processingCount.compare_exchange_weak(processing, processing + 1));
+  return true;
+}
 
-  // everyone is busy - we need more workers
-  m_workers.push_back(new CJobWorker(this));
+bool CJobManager::TakeJob(CJobWorker *worker, CJobWorker *victim, int priority)
+{
+  // lock in address order so two workers stealing from each other can't deadlock
+  bool ordered = std::less<CJobWorker*>()(worker, victim);
+  CSingleLock lock1(ordered ? worker->m_section : victim->m_section);
+  CSingleLock lock2(ordered ? victim->m_section : worker->m_section);
+
+  JobQueue &queue = victim->m_queue[priority];
+  if (queue.empty())
+    return false;
+
+  worker->m_current = queue.front();
+  queue.pop_front();
+  m_queued[priority]--;
+  if (worker != victim)
+    m_steals++;
+
+  worker->m_current.m_job->m_callback = this;
+  return true;
 }
 
-CJob *CJobManager::PopJob()
+CJob *CJobManager::PopJob(CJobWorker *worker)
 {
-  CSingleLock lock(m_section);
   for (int priority = CJob::PRIORITY_DEDICATED; priority >= CJob::PRIORITY_LOW_PAUSABLE; --priority)
   {
     // Check whether we're pausing pausable jobs
     if (priority == CJob::PRIORITY_LOW_PAUSABLE && m_pauseJobs)
       continue;
 
-    if (m_jobQueue[priority].size() && m_processing.size() < GetMaxWorkers(CJob::PRIORITY(priority)))
+    if (!m_queued[priority] || !ReserveSlot(CJob::PRIORITY(priority)))
+      continue;
+
+    // take the job from our own queue if we can, otherwise steal from another worker
+    if (TakeJob(worker, worker, priority))
+      return worker->m_current.m_job;
+
+    CSharedLock lock(m_workersSection);
+    size_t count = m_workers.size();
+    size_t start = m_nextWorker++;
+    for (size_t i = 0; i < count; ++i)
     {
-      // pop the job off the queue
-      CWorkItem job = m_jobQueue[priority].front();
-      m_jobQueue[priority].pop_front();
-
-      // add to the processing vector
-      m_processing.push_back(job);
-      job.m_job->m_callback = this;
-      return job.m_job;
+      CJobWorker *victim = m_workers[(start + i) % count];
+      if (victim != worker && TakeJob(worker, victim, priority))
+        return worker->m_current.m_job;
     }
+
+    // somebody else got there first
+    m_processingCount--;
   }
   return NULL;
 }
 
 void CJobManager::PauseJobs()
 {
-  CSingleLock lock(m_section);
   m_pauseJobs = true;
 }
 
 void CJobManager::UnPauseJobs()
 {
-  CSingleLock lock(m_section);
   m_pauseJobs = false;
 }
 
 bool CJobManager::IsProcessing(const CJob::PRIORITY &priority) const
 {
-  CSingleLock lock(m_section);
-
   if (m_pauseJobs)
     return false;
 
-  for(Processing::const_iterator it = m_processing.begin(); it < m_processing.end(); ++it)
+  CSharedLock lock(m_workersSection);
+  for (Workers::const_iterator it = m_workers.begin(); it != m_workers.end(); ++it)
   {
-    if (priority == it->m_priority)
+    CSingleLock workerLock((*it)->m_section);
+    if ((*it)->m_current.m_job && priority == (*it)->m_current.m_priority)
       return true;
   }
   return false;
@@ -336,94 +441,126 @@ bool CJobManager::IsProcessing(const CJob::PRIORITY &priority) const
 int CJobManager::IsProcessing(const std::string &type) const
 {
   int jobsMatched = 0;
-  CSingleLock lock(m_section);
 
   if (m_pauseJobs)
     return 0;
 
-  for(Processing::const_iterator it = m_processing.begin(); it < m_processing.end(); ++it)
+  CSharedLock lock(m_workersSection);
+  for (Workers::const_iterator it = m_workers.begin(); it != m_workers.end(); ++it)
   {
-    if (type == std::string(it->m_job->GetType()))
+    CSingleLock workerLock((*it)->m_section);
+    if ((*it)->m_current.m_job && type == std::string((*it)->m_current.m_job->GetType()))
       jobsMatched++;
   }
   return jobsMatched;
 }
 
-CJob *CJobManager::GetNextJob(const CJobWorker *worker)
+CJob *CJobManager::GetNextJob(CJobWorker *worker)
 {
-  CSingleLock lock(m_section);
-  while (m_running)
+  while (true)
   {
-    // grab a job off the queue if we have one
-    CJob *job = PopJob();
+    while (m_running)
+    {
+      // grab a job off the queue if we have one
+      CJob *job = PopJob(worker);
+      if (job)
+        return job;
+
+      // let AddJob know we're available, then look once more so that a job added
+      // before it could see us idle isn't left waiting
+      worker->m_idle = true;
+      job = PopJob(worker);
+      if (job)
+      {
+        worker->m_idle = false;
+        return job;
+      }
+
+      // no jobs are left - sleep for 30 seconds to allow new jobs to come in
+      bool newJob = worker->m_jobEvent.WaitMSec(30000);
+      worker->m_idle = false;
+      if (!newJob)
+        break;
+    }
+    // ensure no jobs have come in during the period after
+    // timeout and before we held the lock
+    CJob *job = PopJob(worker);
     if (job)
       return job;
-    // no jobs are left - sleep for 30 seconds to allow new jobs to come in
-    lock.Leave();
-    bool newJob = m_jobEvent.WaitMSec(30000);
-    lock.Enter();
-    if (!newJob)
-      break;
+
+    // jobs are only queued on us under a shared lock, so once we hold the
+    // exclusive lock with an empty queue we can safely go away
+    CExclusiveLock lock(m_workersSection);
+    bool queued = false;
+    {
+      CSingleLock workerLock(worker->m_section);
+      for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
+        queued |= !worker->m_queue[priority].empty();
+    }
+    if (!queued)
+    {
+      // have no jobs
+      Workers::iterator i = find(m_workers.begin(), m_workers.end(), worker);
+      if (i != m_workers.end())
+        m_workers.erase(i); // workers auto-delete
+      return NULL;
+    }
   }
-  // ensure no jobs have come in during the period after
-  // timeout and before we held the lock
-  CJob *job = PopJob();
-  if (job)
-    return job;
-  // have no jobs
-  RemoveWorker(worker);
-  return NULL;
 }
 
 bool CJobManager::OnJobProgress(unsigned int progress, unsigned int total, const CJob *job) const
 {
-  CSingleLock lock(m_section);
-  // find the job in the processing queue, and check whether it's cancelled (no callback)
-  Processing::const_iterator i = find(m_processing.begin(), m_processing.end(), job);
-  if (i != m_processing.end())
+  CSharedLock lock(m_workersSection);
+  // find the job in the processing workers, and check whether it's cancelled (no callback)
+  for (Workers::const_iterator it = m_workers.begin(); it != m_workers.end(); ++it)
   {
-    CWorkItem item(*i);
-    lock.Leave(); // leave section prior to call
-    if (item.m_callback)
+    CSingleLock workerLock((*it)->m_section);
+    if ((*it)->m_current.m_job && (*it)->m_current == job)
     {
-      item.m_callback->OnJobProgress(item.m_id, progress, total, job);
-      return false;
+      CWorkItem item((*it)->m_current);
+      workerLock.Leave();
+      lock.Leave(); // leave section prior to call
+      if (item.m_callback)
+      {
+        item.m_callback->OnJobProgress(item.m_id, progress, total, job);
+        return false;
+      }
+      return true;
     }
   }
   return true; // couldn't find the job, or it's been cancelled
 }
 
-void CJobManager::OnJobComplete(bool success, CJob *job)
+void CJobManager::OnJobComplete(CJobWorker *worker, bool success)
 {
-  CSingleLock lock(m_section);
-  // remove the job from the processing queue
-  Processing::iterator i = find(m_processing.begin(), m_processing.end(), job);
-  if (i != m_processing.end())
+  CSingleLock lock(worker->m_section);
+  CWorkItem item(worker->m_current);
+  if (!item.m_job)
+    return;
+  lock.Leave();
+
+  // tell any listeners we're done with the job, then delete it
+  try
   {
-    // tell any listeners we're done with the job, then delete it
-    CWorkItem item(*i);
-    lock.Leave();
-    try
-    {
-      if (item.m_callback)
-        item.m_callback->OnJobComplete(item.m_id, success, item.m_job);
-    }
-    catch (...)
-    {
-      CLog::Log(LOGERROR, "%s error processing job %s", __FUNCTION__, item.m_job->GetType());
-    }
-    lock.Enter();
-    Processing::iterator j = find(m_processing.begin(), m_processing.end(), job);
-    if (j != m_processing.end())
-      m_processing.erase(j);
-    lock.Leave();
-    item.FreeJob();
+    if (item.m_callback)
+      item.m_callback->OnJobComplete(item.m_id, success, item.m_job);
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s error processing job %s", __FUNCTION__, item.m_job->GetType());
   }
+
+  lock.Enter();
+  worker->m_current.m_job = NULL;
+  worker->m_current.m_callback = NULL;
+  lock.Leave();
+  m_processingCount--;
+  item.FreeJob();
 }
 
 void CJobManager::RemoveWorker(const CJobWorker *worker)
 {
-  CSingleLock lock(m_section);
+  CExclusiveLock lock(m_workersSection);
   // remove our worker
   Workers::iterator i = find(m_workers.begin(), m_workers.end(), worker);
   if (i != m_workers.end())
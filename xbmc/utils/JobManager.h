@@ -19,25 +19,17 @@
  *
  */
 
+#include <atomic>
 #include <queue>
 #include <vector>
 #include <string>
 #include "threads/CriticalSection.h"
+#include "threads/SharedSection.h"
 #include "threads/Thread.h"
 #include "Job.h"
 
 class CJobManager;
-
-class CJobWorker : public CThread
-{
-public:
-  explicit CJobWorker(CJobManager *manager);
-  ~CJobWorker() override;
-
-  void Process() override;
-private:
-  CJobManager  *m_jobManager;
-};
+class CJobWorker;
 
 /*!
  \ingroup jobs
@@ -170,6 +162,12 @@ private:
  priority levels.  Lower priority jobs are executed only if there are sufficient
  spare worker threads free to allow for higher priority jobs that may arise.
 
+ Each worker owns its own queue of pending jobs per priority level.  New jobs are
+ handed to an idle worker (or a new one) and only that worker is woken.  A worker
+ looking for work checks its own queue first and otherwise steals the oldest job of
+ the same priority from another worker, so adding and popping jobs never serialises
+ all workers on a single lock.
+
  \sa CJob and IJobCallback
  */
 class CJobManager
@@ -315,16 +313,16 @@ protected:
    \param worker a pointer to the current CJobWorker instance requesting a job.
    \sa CJob
    */
-  CJob *GetNextJob(const CJobWorker *worker);
+  CJob *GetNextJob(CJobWorker *worker);
 
   /*!
    \brief Callback from CJobWorker after a job has completed.
    Calls IJobCallback::OnJobComplete(), and then destroys job.
-   \param job a pointer to the calling subclassed CJob instance.
+   \param worker the worker that processed the job.
    \param success the result from the DoWork call
    \sa IJobCallback, CJob
    */
-  void  OnJobComplete(bool success, CJob *job);
+  void  OnJobComplete(CJobWorker *worker, bool success);
 
   /*!
    \brief Callback from CJob to report progress and check for cancellation.
@@ -344,27 +342,64 @@ private:
   CJobManager const& operator=(CJobManager const&) = delete;
   virtual ~CJobManager();
 
-  /*! \brief Pop a job off the job queue and add to the processing queue ready to process
+  /*! \brief Pop a job off the worker's own queue, or steal one from another worker,
+   and make it the worker's current job
+   \param worker the worker requesting a job.
    \return the job to process, NULL if no jobs are available
    */
-  CJob *PopJob();
+  CJob *PopJob(CJobWorker *worker);
+
+  /*! \brief Move the oldest job of the given priority from the queue of victim to
+   the current job of worker. Both workers are locked for the move, so the job is
+   never invisible to CancelJob.
+   \return true if a job was taken, false if victim has no queued job of that priority
+   */
+  bool TakeJob(CJobWorker *worker, CJobWorker *victim, int priority);
+
+  /*! \brief Pick the worker that should queue a job of the given priority and whether it
+   needs to be woken. Must be called with m_workersSection held.
+   \return the worker, NULL if a new worker is required
+   */
+  CJobWorker *SelectWorker(CJob::PRIORITY priority, bool &wake);
+
+  /*! \brief Reserve one of the processing slots available to the given priority
+   \return true if the number of processing jobs was below GetMaxWorkers(priority)
+   */
+  bool ReserveSlot(CJob::PRIORITY priority);
 
-  void StartWorkers(CJob::PRIORITY priority);
   void RemoveWorker(const CJobWorker *worker);
   static unsigned int GetMaxWorkers(CJob::PRIORITY priority);
 
-  unsigned int m_jobCounter;
-
   typedef std::deque<CWorkItem>    JobQueue;
-  typedef std::vector<CWorkItem>   Processing;
   typedef std::vector<CJobWorker*> Workers;
 
-  JobQueue   m_jobQueue[CJob::PRIORITY_DEDICATED + 1];
-  bool       m_pauseJobs;
-  Processing m_processing;
-  Workers    m_workers;
+  std::atomic<unsigned int> m_jobCounter;
+  std::atomic<unsigned int> m_queued[CJob::PRIORITY_DEDICATED + 1]; //!< jobs queued over all workers
+  std::atomic<unsigned int> m_processingCount;                      //!< jobs processing over all workers
+  std::atomic<unsigned int> m_steals;        //!< number of jobs moved between workers, see CancelJob
+  std::atomic<unsigned int> m_nextWorker;    //!< round robin index for workers that are all busy
+  std::atomic<bool>         m_pauseJobs;
+  std::atomic<bool>         m_running;
 
-  CCriticalSection m_section;
-  CEvent           m_jobEvent;
-  bool             m_running;
+  Workers m_workers;
+  CSharedSection m_workersSection; //!< shared for reading m_workers, exclusive to add/remove workers
+};
+
+class CJobWorker : public CThread
+{
+public:
+  explicit CJobWorker(CJobManager *manager);
+  ~CJobWorker() override;
+
+  void Process() override;
+private:
+  friend class CJobManager;
+
+  CJobManager  *m_jobManager;
+
+  mutable CCriticalSection m_section; //!< guards m_queue and m_current
+  CJobManager::JobQueue  m_queue[CJob::PRIORITY_DEDICATED + 1];
+  CJobManager::CWorkItem m_current;   //!< the job being processed, m_job is NULL if none
+  CEvent                 m_jobEvent;
+  std::atomic<bool>      m_idle;      //!< waiting on m_jobEvent and may be claimed by AddJob
 };
@@ -23,7 +23,10 @@
 #include "URL.h"
 #include "Util.h"
 #include "XBDateTime.h"
+#include "threads/Thread.h"
+#include "threads/ThreadLocal.h"
 #include "utils/CharsetConverter.h"
+#include "utils/CPUInfo.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
 #include "utils/log.h"
@@ -433,131 +436,220 @@ std::string ByLastUsed(SortAttribute attributes, const SortItem &values)
   return values.at(FieldLastUsed).asString();
 }
 
-bool preliminarySort(const SortItem &left, const SortItem &right, bool handleFolder, bool &result, std::wstring &labelLeft, std::wstring &labelRight)
+namespace
 {
-  // make sure both items have the necessary data to do the sorting
-  SortItem::const_iterator itLeftSort, itRightSort;
-  if ((itLeftSort = left.find(FieldSort)) == left.end())
+/*!
+ \brief Everything needed to compare an item, computed once per item before sorting.
+ */
+struct SortKey
+{
+  const wchar_t *label;
+  int64_t number;  ///< value of a label only consisting of digits, -1 otherwise
+  int special;     ///< rank of the SortSpecial value: on top, none, on bottom
+  int folder;      ///< 1 for folders, 0 for files, -1 if unknown
+  size_t index;    ///< position of the item before sorting
+};
+
+enum SortKeySpecial
+{
+  SortKeyOnTop = 0,
+  SortKeyNone,
+  SortKeyOnBottom
+};
+
+class SortKeyCompare
+{
+public:
+  SortKeyCompare(SortOrder sortOrder, SortAttribute attributes)
+    : m_descending(sortOrder == SortOrderDescending)
+    , m_handleFolder((attributes & SortAttributeIgnoreFolders) == 0)
+  { }
+
+  bool operator()(const SortKey &left, const SortKey &right) const
   {
-    result = false;
-    return true;
+    // items sorted on top or bottom stay there regardless of the sort order and
+    // keep their order among themselves
+    if (left.special != right.special)
+      return left.special < right.special;
+    if (left.special != SortKeyNone)
+      return false;
+
+    if (m_handleFolder && left.folder >= 0 && right.folder >= 0 && left.folder != right.folder)
+      return left.folder > right.folder;
+
+    // AlphaNumericCompare() compares labels of up to 15 digits by their value
+    int64_t cmp;
+    if (left.number >= 0 && right.number >= 0)
+      cmp = left.number < right.number ? -1 : (left.number > right.number ? 1 : 0);
+    else
+      cmp = StringUtils::AlphaNumericCompare(left.label, right.label);
+
+    return m_descending ? cmp > 0 : cmp < 0;
   }
-  if ((itRightSort = right.find(FieldSort)) == right.end())
+
+private:
+  bool m_descending;
+  bool m_handleFolder;
+};
+
+int64_t GetLabelNumber(const std::wstring &label)
+{
+  if (label.empty() || label.size() > 15)
+    return -1;
+
+  int64_t number = 0;
+  for (wchar_t c : label)
   {
-    result = true;
-    return true;
+    if (c < L'0' || c > L'9')
+      return -1;
+    number = number * 10 + (c - L'0');
   }
+  return number;
+}
 
-  // look at special sorting behaviour
-  SortItem::const_iterator itLeft, itRight;
-  SortSpecial leftSortSpecial = SortSpecialNone;
-  SortSpecial rightSortSpecial = SortSpecialNone;
-  if ((itLeft = left.find(FieldSortSpecial)) != left.end() && itLeft->second.asInteger() <= (int64_t)SortSpecialOnBottom)
-    leftSortSpecial = (SortSpecial)itLeft->second.asInteger();
-  if ((itRight = right.find(FieldSortSpecial)) != right.end() && itRight->second.asInteger() <= (int64_t)SortSpecialOnBottom)
-    rightSortSpecial = (SortSpecial)itRight->second.asInteger();
-  
-  // one has a special sort
-  if (leftSortSpecial != rightSortSpecial)
+inline SortItem& GetSortItem(SortItem &item) { return item; }
+inline SortItem& GetSortItem(const SortItemPtr &item) { return *item; }
+
+class CSortRange : public IRunnable
+{
+public:
+  CSortRange(std::vector<SortKey>::iterator begin, std::vector<SortKey>::iterator end, const SortKeyCompare &compare)
+    : m_begin(begin), m_end(end), m_compare(compare)
+  { }
+
+  void Run() override
   {
-    // left should be sorted on top
-    // or right should be sorted on bottom
-    // => left is sorted above right
-    if (leftSortSpecial == SortSpecialOnTop ||
-        rightSortSpecial == SortSpecialOnBottom)
-    {
-      result = true;
-      return true;
-    }
-    
-    // otherwise right is sorted above left
-    result = false;
-    return true;
+    std::stable_sort(m_begin, m_end, m_compare);
   }
-  // both have either sort on top or sort on bottom -> leave as-is
-  else if (leftSortSpecial != SortSpecialNone && leftSortSpecial == rightSortSpecial)
+
+private:
+  std::vector<SortKey>::iterator m_begin;
+  std::vector<SortKey>::iterator m_end;
+  SortKeyCompare m_compare;
+};
+
+#define PARALLEL_SORT_MIN_ITEMS 4096
+
+/*!
+ \brief Stable sort of the keys, split over the available cores for large lists.
+
+ Every core sorts a consecutive range of keys, which are merged afterwards.
+ As ranges are merged in order and merging is stable, the result is the same
+ as sorting all keys at once.
+ */
+void StableSortKeys(std::vector<SortKey> &keys, const SortKeyCompare &compare)
+{
+  size_t ranges = std::min<size_t>(g_cpuInfo.getCPUCount(), keys.size() / PARALLEL_SORT_MIN_ITEMS);
+  if (ranges < 2)
   {
-    result = false;
-    return true;
+    std::stable_sort(keys.begin(), keys.end(), compare);
+    return;
   }
 
-  if (handleFolder)
+  std::vector<size_t> bounds;
+  for (size_t i = 0; i <= ranges; i++)
+    bounds.push_back(keys.size() * i / ranges);
+
+  std::vector<std::unique_ptr<CSortRange>> sorters;
+  std::vector<std::unique_ptr<CThread>> threads;
+  for (size_t i = 1; i < ranges; i++)
   {
-    itLeft = left.find(FieldFolder);
-    itRight = right.find(FieldFolder);
-    if (itLeft != left.end() && itRight != right.end() &&
-        itLeft->second.asBoolean() != itRight->second.asBoolean())
-    {
-      result = itLeft->second.asBoolean();
-      return true;
-    }
+    sorters.emplace_back(new CSortRange(keys.begin() + bounds[i], keys.begin() + bounds[i + 1], compare));
+    threads.emplace_back(new CThread(sorters.back().get(), "SortUtils"));
+    threads.back()->Create();
   }
 
-  labelLeft = itLeftSort->second.asWideString();
-  labelRight = itRightSort->second.asWideString();
+  std::stable_sort(keys.begin(), keys.begin() + bounds[1], compare);
 
-  return false;
+  for (auto &thread : threads)
+    thread->StopThread(true);
+
+  for (size_t i = 2; i <= ranges; i++)
+    std::inplace_merge(keys.begin(), keys.begin() + bounds[i - 1], keys.begin() + bounds[i], compare);
 }
 
-bool SorterAscending(const SortItem &left, const SortItem &right)
+// sort tokens of the sort being prepared on the current thread
+XbmcThreads::ThreadLocal<const std::set<std::string>> currentSortTokens;
+
+/*!
+ \brief Prepare the sort label of every item, store it under FieldSort and sort the items by it.
+ */
+template<class TItems>
+void SortByPreparator(SortUtils::SortPreparator preparator, const Fields &sortingFields,
+                      SortOrder sortOrder, SortAttribute attributes, TItems &items)
 {
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, true, result, labelLeft, labelRight))
-    return result;
+  // let RemoveArticles() use the same tokens for every item instead of fetching them again
+  const std::set<std::string> sortTokens = g_langInfo.GetSortTokens();
+  const std::set<std::string> *previousSortTokens = currentSortTokens.get();
+  currentSortTokens.set(&sortTokens);
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) < 0;
-}
+  std::vector<std::wstring> labels(items.size());
+  std::vector<SortKey> keys(items.size());
 
-bool SorterDescending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, true, result, labelLeft, labelRight))
-    return result;
+  for (size_t index = 0; index < items.size(); index++)
+  {
+    SortItem &item = GetSortItem(items[index]);
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) > 0;
-}
+    // add all fields to the item that are required for sorting if they are currently missing
+    for (Fields::const_iterator field = sortingFields.begin(); field != sortingFields.end(); ++field)
+    {
+      if (item.find(*field) == item.end())
+        item.insert(std::pair<Field, CVariant>(*field, CVariant::ConstNullVariant));
+    }
 
-bool SorterIgnoreFoldersAscending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, false, result, labelLeft, labelRight))
-    return result;
+    std::wstring sortLabel;
+#ifdef TARGET_ANDROID
+    // Android does not support locale; Translate to ASCII
+    std::string dest;
+    g_charsetConverter.utf8ToASCII(preparator(attributes, item), dest);
+    for (char c : dest)
+    {
+      if (::isalnum(c) || c == ' ')
+        sortLabel.push_back(c);
+    }
+#else
+    g_charsetConverter.utf8ToW(preparator(attributes, item), sortLabel, false);
+#endif
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) < 0;
-}
+    // a label already stored under FieldSort is kept
+    std::pair<SortItem::iterator, bool> sort = item.insert(std::pair<Field, CVariant>(FieldSort, CVariant(sortLabel)));
+    if (sort.second)
+      labels[index] = std::move(sortLabel);
+    else
+      labels[index] = sort.first->second.asWideString();
 
-bool SorterIgnoreFoldersDescending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, false, result, labelLeft, labelRight))
-    return result;
+    SortKey &key = keys[index];
+    key.label = labels[index].c_str();
+    key.number = GetLabelNumber(labels[index]);
+    key.index = index;
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) > 0;
-}
+    key.special = SortKeyNone;
+    SortItem::const_iterator it = item.find(FieldSortSpecial);
+    if (it != item.end())
+    {
+      int64_t special = it->second.asInteger();
+      if (special == SortSpecialOnTop)
+        key.special = SortKeyOnTop;
+      else if (special == SortSpecialOnBottom)
+        key.special = SortKeyOnBottom;
+    }
 
-bool SorterIndirectAscending(const SortItemPtr &left, const SortItemPtr &right)
-{
-  return SorterAscending(*left, *right);
-}
+    it = item.find(FieldFolder);
+    key.folder = it != item.end() ? (it->second.asBoolean() ? 1 : 0) : -1;
+  }
 
-bool SorterIndirectDescending(const SortItemPtr &left, const SortItemPtr &right)
-{
-  return SorterDescending(*left, *right);
-}
+  currentSortTokens.set(previousSortTokens);
 
-bool SorterIndirectIgnoreFoldersAscending(const SortItemPtr &left, const SortItemPtr &right)
-{
-  return SorterIgnoreFoldersAscending(*left, *right);
-}
+  StableSortKeys(keys, SortKeyCompare(sortOrder, attributes));
 
-bool SorterIndirectIgnoreFoldersDescending(const SortItemPtr &left, const SortItemPtr &right)
-{
-  return SorterIgnoreFoldersDescending(*left, *right);
+  // move the items into their new order
+  TItems sorted;
+  sorted.reserve(items.size());
+  for (std::vector<SortKey>::const_iterator key = keys.begin(); key != keys.end(); ++key)
+    sorted.push_back(std::move(items[key->index]));
+  items.swap(sorted);
 }
+} // namespace
 
 std::map<SortBy, SortUtils::SortPreparator> fillPreparators()
 {
@@ -716,38 +808,7 @@ void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attribute
     // get the matching SortPreparator
     SortPreparator preparator = getPreparator(sortBy);
     if (preparator != NULL)
-    {
-      Fields sortingFields = GetFieldsForSorting(sortBy);
-
-      // Prepare the string used for sorting and store it under FieldSort
-      for (DatabaseResults::iterator item = items.begin(); item != items.end(); ++item)
-      {
-        // add all fields to the item that are required for sorting if they are currently missing
-        for (Fields::const_iterator field = sortingFields.begin(); field != sortingFields.end(); ++field)
-        {
-          if (item->find(*field) == item->end())
-            item->insert(std::pair<Field, CVariant>(*field, CVariant::ConstNullVariant));
-        }
-
-        std::wstring sortLabel;
-#ifdef TARGET_ANDROID
-        // Android does not support locale; Translate to ASCII
-        std::string dest;
-        g_charsetConverter.utf8ToASCII(preparator(attributes, *item), dest);
-        for (char c : dest)
-        {
-          if (::isalnum(c) || c == ' ')
-            sortLabel.push_back(c);
-        }
-#else
-        g_charsetConverter.utf8ToW(preparator(attributes, *item), sortLabel, false);
-#endif
-        item->insert(std::pair<Field, CVariant>(FieldSort, CVariant(sortLabel)));
-      }
-
-      // Do the sorting
-      std::stable_sort(items.begin(), items.end(), getSorter(sortOrder, attributes));
-    }
+      SortByPreparator(preparator, GetFieldsForSorting(sortBy), sortOrder, attributes, items);
   }
 
   if (limitStart > 0 && (size_t)limitStart < items.size())
@@ -766,38 +827,7 @@ void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attribute
     // get the matching SortPreparator
     SortPreparator preparator = getPreparator(sortBy);
     if (preparator != NULL)
-    {
-      Fields sortingFields = GetFieldsForSorting(sortBy);
-
-      // Prepare the string used for sorting and store it under FieldSort
-      for (SortItems::iterator item = items.begin(); item != items.end(); ++item)
-      {
-        // add all fields to the item that are required for sorting if they are currently missing
-        for (Fields::const_iterator field = sortingFields.begin(); field != sortingFields.end(); ++field)
-        {
-          if ((*item)->find(*field) == (*item)->end())
-            (*item)->insert(std::pair<Field, CVariant>(*field, CVariant::ConstNullVariant));
-        }
-
-        std::wstring sortLabel;
-#ifdef TARGET_ANDROID
-        // Android does not support locale; Translate to ASCII
-        std::string dest;
-        g_charsetConverter.utf8ToASCII(preparator(attributes, **item), dest);
-        for (char c : dest)
-        {
-          if (::isalnum(c) || c == ' ')
-            sortLabel.push_back(c);
-        }
-#else
-        g_charsetConverter.utf8ToW(preparator(attributes, **item), sortLabel, false);
-#endif
-        (*item)->insert(std::pair<Field, CVariant>(FieldSort, CVariant(sortLabel)));
-      }
-
-      // Do the sorting
-      std::stable_sort(items.begin(), items.end(), getSorterIndirect(sortOrder, attributes));
-    }
+      SortByPreparator(preparator, GetFieldsForSorting(sortBy), sortOrder, attributes, items);
   }
 
   if (limitStart > 0 && (size_t)limitStart < items.size())
@@ -849,22 +879,6 @@ const SortUtils::SortPreparator& SortUtils::getPreparator(SortBy sortBy)
   return m_preparators[SortByNone];
 }
 
-SortUtils::Sorter SortUtils::getSorter(SortOrder sortOrder, SortAttribute attributes)
-{
-  if (attributes & SortAttributeIgnoreFolders)
-    return sortOrder == SortOrderDescending ? SorterIgnoreFoldersDescending : SorterIgnoreFoldersAscending;
-
-  return sortOrder == SortOrderDescending ? SorterDescending : SorterAscending;
-}
-
-SortUtils::SorterIndirect SortUtils::getSorterIndirect(SortOrder sortOrder, SortAttribute attributes)
-{
-  if (attributes & SortAttributeIgnoreFolders)
-    return sortOrder == SortOrderDescending ? SorterIndirectIgnoreFoldersDescending : SorterIndirectIgnoreFoldersAscending;
-
-  return sortOrder == SortOrderDescending ? SorterIndirectDescending : SorterIndirectAscending;
-}
-
 const Fields& SortUtils::GetFieldsForSorting(SortBy sortBy)
 {
   std::map<SortBy, Fields>::const_iterator it = m_sortingFields.find(sortBy);
@@ -876,8 +890,15 @@ const Fields& SortUtils::GetFieldsForSorting(SortBy sortBy)
 
 std::string SortUtils::RemoveArticles(const std::string &label)
 {
-  std::set<std::string> sortTokens = g_langInfo.GetSortTokens();
-  for (std::set<std::string>::const_iterator token = sortTokens.begin(); token != sortTokens.end(); ++token)
+  std::set<std::string> tokens;
+  const std::set<std::string> *sortTokens = currentSortTokens.get();
+  if (sortTokens == NULL)
+  {
+    tokens = g_langInfo.GetSortTokens();
+    sortTokens = &tokens;
+  }
+
+  for (std::set<std::string>::const_iterator token = sortTokens->begin(); token != sortTokens->end(); ++token)
   {
     if (token->size() < label.size() && StringUtils::StartsWithNoCase(label, *token))
       return label.substr(token->size());
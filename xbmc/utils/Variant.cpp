@@ -20,6 +20,7 @@
 
 #include "Variant.h"
 
+#include <algorithm>
 #include <stdlib.h>
 #include <string.h>
 #include <sstream>
@@ -129,6 +130,23 @@ double str2double(const std::wstring &str, double fallback /* = 0.0 */)
   return fallback;
 }
 
+namespace
+{
+template<typename Map>
+typename Map::iterator FindKey(Map &map, const std::string &key)
+{
+  return std::lower_bound(map.begin(), map.end(), key,
+                          [](const typename Map::value_type &entry, const std::string &k) { return entry.first < k; });
+}
+
+template<typename Map>
+typename Map::const_iterator FindKey(const Map &map, const std::string &key)
+{
+  return std::lower_bound(map.begin(), map.end(), key,
+                          [](const typename Map::value_type &entry, const std::string &k) { return entry.first < k; });
+}
+}
+
 CVariant::CVariant()
   : CVariant(VariantTypeNull)
 {
@@ -141,6 +159,7 @@ CVariant::VariantMap CVariant::EMPTY_MAP;
 CVariant::CVariant(VariantType type)
 {
   m_type = type;
+  m_shortLength = 0;
 
   switch (type)
   {
@@ -148,6 +167,7 @@ CVariant::CVariant(VariantType type)
       m_data.integer = 0;
       break;
     case VariantTypeUnsignedInteger:
+    case VariantTypeDeferred:
       m_data.unsignedinteger = 0;
       break;
     case VariantTypeBoolean:
@@ -157,7 +177,7 @@ CVariant::CVariant(VariantType type)
       m_data.dvalue = 0.0;
       break;
     case VariantTypeString:
-      m_data.string = new std::string();
+      m_data.shortString[0] = '\0';
       break;
     case VariantTypeWideString:
       m_data.wstring = new std::wstring();
@@ -179,96 +199,104 @@ CVariant::CVariant(VariantType type)
 CVariant::CVariant(int integer)
 {
   m_type = VariantTypeInteger;
+  m_shortLength = 0;
   m_data.integer = integer;
 }
 
 CVariant::CVariant(int64_t integer)
 {
   m_type = VariantTypeInteger;
+  m_shortLength = 0;
   m_data.integer = integer;
 }
 
 CVariant::CVariant(unsigned int unsignedinteger)
 {
   m_type = VariantTypeUnsignedInteger;
+  m_shortLength = 0;
   m_data.unsignedinteger = unsignedinteger;
 }
 
 CVariant::CVariant(uint64_t unsignedinteger)
 {
   m_type = VariantTypeUnsignedInteger;
+  m_shortLength = 0;
   m_data.unsignedinteger = unsignedinteger;
 }
 
 CVariant::CVariant(double value)
 {
   m_type = VariantTypeDouble;
+  m_shortLength = 0;
   m_data.dvalue = value;
 }
 
 CVariant::CVariant(float value)
 {
   m_type = VariantTypeDouble;
+  m_shortLength = 0;
   m_data.dvalue = (double)value;
 }
 
 CVariant::CVariant(bool boolean)
 {
   m_type = VariantTypeBoolean;
+  m_shortLength = 0;
   m_data.boolean = boolean;
 }
 
 CVariant::CVariant(const char *str)
 {
-  m_type = VariantTypeString;
-  m_data.string = new std::string(str);
+  setString(str, strlen(str));
 }
 
 CVariant::CVariant(const char *str, unsigned int length)
 {
-  m_type = VariantTypeString;
-  m_data.string = new std::string(str, length);
+  setString(str, length);
 }
 
 CVariant::CVariant(const std::string &str)
 {
-  m_type = VariantTypeString;
-  m_data.string = new std::string(str);
+  setString(str.c_str(), str.size());
 }
 
 CVariant::CVariant(std::string &&str)
 {
-  m_type = VariantTypeString;
-  m_data.string = new std::string(std::move(str));
+  setString(std::move(str));
 }
 
 CVariant::CVariant(const wchar_t *str)
 {
   m_type = VariantTypeWideString;
+  m_shortLength = 0;
   m_data.wstring = new std::wstring(str);
 }
 
 CVariant::CVariant(const wchar_t *str, unsigned int length)
 {
   m_type = VariantTypeWideString;
+  m_shortLength = 0;
   m_data.wstring = new std::wstring(str, length);
 }
 
 CVariant::CVariant(const std::wstring &str)
 {
   m_type = VariantTypeWideString;
+  m_shortLength = 0;
   m_data.wstring = new std::wstring(str);
 }
 
 CVariant::CVariant(std::wstring &&str)
 {
   m_type = VariantTypeWideString;
+  m_shortLength = 0;
   m_data.wstring = new std::wstring(std::move(str));
 }
 
 CVariant::CVariant(const std::vector<std::string> &strArray)
 {
   m_type = VariantTypeArray;
+  m_shortLength = 0;
   m_data.array = new VariantArray;
   m_data.array->reserve(strArray.size());
   for (const auto& item : strArray)
@@ -278,32 +306,45 @@ CVariant::CVariant(const std::vector<std::string> &strArray)
 CVariant::CVariant(const std::map<std::string, std::string> &strMap)
 {
   m_type = VariantTypeObject;
+  m_shortLength = 0;
   m_data.map = new VariantMap;
+  m_data.map->reserve(strMap.size());
+  // std::map is already sorted by key
   for (std::map<std::string, std::string>::const_iterator it = strMap.begin(); it != strMap.end(); ++it)
-    m_data.map->insert(make_pair(it->first, CVariant(it->second)));
+    m_data.map->push_back(make_pair(it->first, CVariant(it->second)));
 }
 
 CVariant::CVariant(const std::map<std::string, CVariant> &variantMap)
 {
   m_type = VariantTypeObject;
+  m_shortLength = 0;
   m_data.map = new VariantMap(variantMap.begin(), variantMap.end());
 }
 
 CVariant::CVariant(const CVariant &variant)
 {
   m_type = VariantTypeNull;
+  m_shortLength = 0;
   *this = variant;
 }
 
-CVariant::CVariant(CVariant&& rhs)
+CVariant::CVariant(CVariant&& rhs) noexcept
 {
   //Set this so that operator= don't try and run cleanup
   //when we're not initialized.
   m_type = VariantTypeNull;
+  m_shortLength = 0;
 
   *this = std::move(rhs);
 }
 
+CVariant CVariant::CreateDeferred(uint64_t index)
+{
+  CVariant variant(VariantTypeDeferred);
+  variant.m_data.unsignedinteger = index;
+  return variant;
+}
+
 CVariant::~CVariant()
 {
   cleanup();
@@ -314,7 +355,8 @@ void CVariant::cleanup()
   switch (m_type)
   {
   case VariantTypeString:
-    delete m_data.string;
+    if (isHeapString())
+      delete m_data.string;
     m_data.string = nullptr;
     break;
 
@@ -336,6 +378,46 @@ void CVariant::cleanup()
     break;
   }
   m_type = VariantTypeNull;
+  m_shortLength = 0;
+}
+
+void CVariant::setString(const char *str, size_t length)
+{
+  m_type = VariantTypeString;
+  if (length < SHORT_STRING_SIZE)
+  {
+    memcpy(m_data.shortString, str, length);
+    m_data.shortString[length] = '\0';
+    m_shortLength = (uint8_t)length;
+  }
+  else
+  {
+    m_data.string = new std::string(str, length);
+    m_shortLength = HEAP_STRING;
+  }
+}
+
+void CVariant::setString(std::string &&str)
+{
+  if (str.size() < SHORT_STRING_SIZE)
+    setString(str.c_str(), str.size());
+  else
+  {
+    // keep the buffer of the moved string instead of copying it
+    m_type = VariantTypeString;
+    m_data.string = new std::string(std::move(str));
+    m_shortLength = HEAP_STRING;
+  }
+}
+
+const char *CVariant::stringData() const
+{
+  return isHeapString() ? m_data.string->c_str() : m_data.shortString;
+}
+
+size_t CVariant::stringLength() const
+{
+  return isHeapString() ? m_data.string->size() : m_shortLength;
 }
 
 bool CVariant::isInteger() const
@@ -388,6 +470,11 @@ bool CVariant::isNull() const
   return m_type == VariantTypeNull || m_type == VariantTypeConstNull;
 }
 
+bool CVariant::isDeferred() const
+{
+  return m_type == VariantTypeDeferred;
+}
+
 CVariant::VariantType CVariant::type() const
 {
   return m_type;
@@ -404,7 +491,7 @@ int64_t CVariant::asInteger(int64_t fallback) const
     case VariantTypeDouble:
       return (int64_t)m_data.dvalue;
     case VariantTypeString:
-      return str2int64(*m_data.string, fallback);
+      return str2int64(std::string(stringData(), stringLength()), fallback);
     case VariantTypeWideString:
       return str2int64(*m_data.wstring, fallback);
     default:
@@ -419,13 +506,14 @@ uint64_t CVariant::asUnsignedInteger(uint64_t fallback) const
   switch (m_type)
   {
     case VariantTypeUnsignedInteger:
+    case VariantTypeDeferred:
       return m_data.unsignedinteger;
     case VariantTypeInteger:
       return (uint64_t)m_data.integer;
     case VariantTypeDouble:
       return (uint64_t)m_data.dvalue;
     case VariantTypeString:
-      return str2uint64(*m_data.string, fallback);
+      return str2uint64(std::string(stringData(), stringLength()), fallback);
     case VariantTypeWideString:
       return str2uint64(*m_data.wstring, fallback);
     default:
@@ -446,7 +534,7 @@ double CVariant::asDouble(double fallback) const
     case VariantTypeUnsignedInteger:
       return (double)m_data.unsignedinteger;
     case VariantTypeString:
-      return str2double(*m_data.string, fallback);
+      return str2double(std::string(stringData(), stringLength()), fallback);
     case VariantTypeWideString:
       return str2double(*m_data.wstring, fallback);
     default:
@@ -467,7 +555,7 @@ float CVariant::asFloat(float fallback) const
     case VariantTypeUnsignedInteger:
       return (float)m_data.unsignedinteger;
     case VariantTypeString:
-      return (float)str2double(*m_data.string, fallback);
+      return (float)str2double(std::string(stringData(), stringLength()), fallback);
     case VariantTypeWideString:
       return (float)str2double(*m_data.wstring, fallback);
     default:
@@ -490,9 +578,12 @@ bool CVariant::asBoolean(bool fallback) const
     case VariantTypeDouble:
       return (m_data.dvalue != 0);
     case VariantTypeString:
-      if (m_data.string->empty() || m_data.string->compare("0") == 0 || m_data.string->compare("false") == 0)
+    {
+      const char *str = stringData();
+      if (*str == '\0' || strcmp(str, "0") == 0 || strcmp(str, "false") == 0)
         return false;
       return true;
+    }
     case VariantTypeWideString:
       if (m_data.wstring->empty() || m_data.wstring->compare(L"0") == 0 || m_data.wstring->compare(L"false") == 0)
         return false;
@@ -509,7 +600,9 @@ std::string CVariant::asString(const std::string &fallback /* = "" */) const
   switch (m_type)
   {
     case VariantTypeString:
-      return *m_data.string;
+      if (isHeapString())
+        return *m_data.string;
+      return std::string(m_data.shortString, m_shortLength);
     case VariantTypeBoolean:
       return m_data.boolean ? "true" : "false";
     case VariantTypeInteger:
@@ -569,7 +662,23 @@ CVariant &CVariant::operator[](const std::string &key)
   }
 
   if (m_type == VariantTypeObject)
-    return (*m_data.map)[key];
+  {
+    // members are mostly added in key order, so check the end first
+    VariantMap &map = *m_data.map;
+    if (map.empty() || map.back().first < key)
+    {
+      // objects rarely have a single member, skip the smallest reallocations
+      if (map.capacity() == 0)
+        map.reserve(4);
+      map.push_back(std::make_pair(key, CVariant()));
+      return map.back().second;
+    }
+
+    VariantMap::iterator it = FindKey(map, key);
+    if (it == map.end() || it->first != key)
+      it = map.insert(it, std::make_pair(key, CVariant()));
+    return it->second;
+  }
   else
     return ConstNullVariant;
 }
@@ -577,7 +686,7 @@ CVariant &CVariant::operator[](const std::string &key)
 const CVariant &CVariant::operator[](const std::string &key) const
 {
   VariantMap::const_iterator it;
-  if (m_type == VariantTypeObject && (it = m_data.map->find(key)) != m_data.map->end())
+  if (m_type == VariantTypeObject && (it = FindKey(*m_data.map, key)) != m_data.map->end() && it->first == key)
     return it->second;
   else
     return ConstNullVariant;
@@ -614,6 +723,7 @@ CVariant &CVariant::operator=(const CVariant &rhs)
     m_data.integer = rhs.m_data.integer;
     break;
   case VariantTypeUnsignedInteger:
+  case VariantTypeDeferred:
     m_data.unsignedinteger = rhs.m_data.unsignedinteger;
     break;
   case VariantTypeBoolean:
@@ -623,7 +733,7 @@ CVariant &CVariant::operator=(const CVariant &rhs)
     m_data.dvalue = rhs.m_data.dvalue;
     break;
   case VariantTypeString:
-    m_data.string = new std::string(*rhs.m_data.string);
+    setString(rhs.stringData(), rhs.stringLength());
     break;
   case VariantTypeWideString:
     m_data.wstring = new std::wstring(*rhs.m_data.wstring);
@@ -641,7 +751,7 @@ CVariant &CVariant::operator=(const CVariant &rhs)
   return *this;
 }
 
-CVariant& CVariant::operator=(CVariant&& rhs)
+CVariant& CVariant::operator=(CVariant&& rhs) noexcept
 {
   if (m_type == VariantTypeConstNull || this == &rhs)
     return *this;
@@ -651,6 +761,7 @@ CVariant& CVariant::operator=(CVariant&& rhs)
     cleanup();
 
   m_type = rhs.m_type;
+  m_shortLength = rhs.m_shortLength;
   m_data = std::move(rhs.m_data);
 
   //Should be enough to just set m_type here
@@ -665,6 +776,7 @@ CVariant& CVariant::operator=(CVariant&& rhs)
     rhs.m_data.map = nullptr;
 
   rhs.m_type = VariantTypeNull;
+  rhs.m_shortLength = 0;
 
   return *this;
 }
@@ -678,13 +790,14 @@ bool CVariant::operator==(const CVariant &rhs) const
     case VariantTypeInteger:
       return m_data.integer == rhs.m_data.integer;
     case VariantTypeUnsignedInteger:
+    case VariantTypeDeferred:
       return m_data.unsignedinteger == rhs.m_data.unsignedinteger;
     case VariantTypeBoolean:
       return m_data.boolean == rhs.m_data.boolean;
     case VariantTypeDouble:
       return m_data.dvalue == rhs.m_data.dvalue;
     case VariantTypeString:
-      return *m_data.string == *rhs.m_data.string;
+      return stringLength() == rhs.stringLength() && memcmp(stringData(), rhs.stringData(), stringLength()) == 0;
     case VariantTypeWideString:
       return *m_data.wstring == *rhs.m_data.wstring;
     case VariantTypeArray:
@@ -736,7 +849,7 @@ void CVariant::append(CVariant&& variant)
 const char *CVariant::c_str() const
 {
   if (m_type == VariantTypeString)
-    return m_data.string->c_str();
+    return stringData();
   else
     return NULL;
 }
@@ -744,12 +857,15 @@ const char *CVariant::c_str() const
 void CVariant::swap(CVariant &rhs)
 {
   VariantType  temp_type = m_type;
+  uint8_t      temp_length = m_shortLength;
   VariantUnion temp_data = m_data;
 
   m_type = rhs.m_type;
+  m_shortLength = rhs.m_shortLength;
   m_data = rhs.m_data;
 
   rhs.m_type = temp_type;
+  rhs.m_shortLength = temp_length;
   rhs.m_data = temp_data;
 }
 
@@ -824,7 +940,7 @@ unsigned int CVariant::size() const
   else if (m_type == VariantTypeArray)
     return m_data.array->size();
   else if (m_type == VariantTypeString)
-    return m_data.string->size();
+    return stringLength();
   else if (m_type == VariantTypeWideString)
     return m_data.wstring->size();
   else
@@ -838,7 +954,7 @@ bool CVariant::empty() const
   else if (m_type == VariantTypeArray)
     return m_data.array->empty();
   else if (m_type == VariantTypeString)
-    return m_data.string->empty();
+    return stringLength() == 0;
   else if (m_type == VariantTypeWideString)
     return m_data.wstring->empty();
   else if (m_type == VariantTypeNull)
@@ -854,7 +970,15 @@ void CVariant::clear()
   else if (m_type == VariantTypeArray)
     m_data.array->clear();
   else if (m_type == VariantTypeString)
-    m_data.string->clear();
+  {
+    if (isHeapString())
+      m_data.string->clear();
+    else
+    {
+      m_data.shortString[0] = '\0';
+      m_shortLength = 0;
+    }
+  }
   else if (m_type == VariantTypeWideString)
     m_data.wstring->clear();
 }
@@ -867,7 +991,11 @@ void CVariant::erase(const std::string &key)
     m_data.map = new VariantMap;
   }
   else if (m_type == VariantTypeObject)
-    m_data.map->erase(key);
+  {
+    VariantMap::iterator it = FindKey(*m_data.map, key);
+    if (it != m_data.map->end() && it->first == key)
+      m_data.map->erase(it);
+  }
 }
 
 void CVariant::erase(unsigned int position)
@@ -885,7 +1013,10 @@ void CVariant::erase(unsigned int position)
 bool CVariant::isMember(const std::string &key) const
 {
   if (m_type == VariantTypeObject)
-    return m_data.map->find(key) != m_data.map->end();
+  {
+    VariantMap::const_iterator it = FindKey(*m_data.map, key);
+    return it != m_data.map->end() && it->first == key;
+  }
 
   return false;
 }
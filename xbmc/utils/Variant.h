@@ -21,6 +21,7 @@
 #include <map>
 #include <vector>
 #include <string>
+#include <utility>
 #include <stdint.h>
 #include <wchar.h>
 
@@ -36,6 +37,14 @@ double str2double(const std::wstring &str, double fallback = 0.0);
 #pragma pack(8)
 #endif
 
+/*!
+ \brief Variant type used for JSON-RPC, sorting, settings and announcements.
+
+ Strings of up to SHORT_STRING_SIZE - 1 characters are stored inline without
+ allocating. Objects are kept in a vector sorted by key, so like for arrays,
+ adding a member to an object invalidates references and iterators to its
+ other members.
+ */
 class CVariant
 {
 public:
@@ -50,7 +59,8 @@ public:
     VariantTypeArray,
     VariantTypeObject,
     VariantTypeNull,
-    VariantTypeConstNull
+    VariantTypeConstNull,
+    VariantTypeDeferred ///< slot of a value produced by the serialiser, see CreateDeferred()
   };
 
   CVariant();
@@ -74,7 +84,7 @@ public:
   CVariant(const std::map<std::string, std::string> &strMap);
   CVariant(const std::map<std::string, CVariant> &variantMap);
   CVariant(const CVariant &variant);
-  CVariant(CVariant &&rhs);
+  CVariant(CVariant &&rhs) noexcept;
   ~CVariant();
 
 
@@ -89,6 +99,7 @@ public:
   bool isArray() const;
   bool isObject() const;
   bool isNull() const;
+  bool isDeferred() const;
 
   VariantType type() const;
 
@@ -106,7 +117,7 @@ public:
   const CVariant &operator[](unsigned int position) const;
 
   CVariant &operator=(const CVariant &rhs);
-  CVariant &operator=(CVariant &&rhs);
+  CVariant &operator=(CVariant &&rhs) noexcept;
   bool operator==(const CVariant &rhs) const;
   bool operator!=(const CVariant &rhs) const { return !(*this == rhs); }
 
@@ -121,7 +132,7 @@ public:
 
 private:
   typedef std::vector<CVariant> VariantArray;
-  typedef std::map<std::string, CVariant> VariantMap;
+  typedef std::vector<std::pair<std::string, CVariant> > VariantMap;
 
 public:
   typedef VariantArray::iterator        iterator_array;
@@ -150,8 +161,22 @@ public:
 
   static CVariant ConstNullVariant;
 
+  /*!
+   \brief Create a slot for a value which is only produced while the variant is serialised
+   \param index identifies the value to the serialiser, returned by asUnsignedInteger()
+   */
+  static CVariant CreateDeferred(uint64_t index);
+
+  static const unsigned int SHORT_STRING_SIZE = 24;
+
 private:
   void cleanup();
+  void setString(const char *str, size_t length);
+  void setString(std::string &&str);
+  const char *stringData() const;
+  size_t stringLength() const;
+  bool isHeapString() const { return m_shortLength == HEAP_STRING; }
+
   union VariantUnion
   {
     int64_t integer;
@@ -162,9 +187,13 @@ private:
     std::wstring *wstring;
     VariantArray *array;
     VariantMap *map;
+    char shortString[SHORT_STRING_SIZE];
   };
 
+  static const uint8_t HEAP_STRING = 0xff;
+
   VariantType m_type;
+  uint8_t m_shortLength; ///< length of an inline string, HEAP_STRING if m_data.string is used
   VariantUnion m_data;
 
   static VariantArray EMPTY_ARRAY;
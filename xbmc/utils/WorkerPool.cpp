@@ -0,0 +1,127 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "WorkerPool.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+
+#include <algorithm>
+
+class CWorkerPool::CWorker : public IRunnable
+{
+public:
+  explicit CWorker(CWorkerPool &pool) : m_pool(pool) { }
+
+  void Run() override
+  {
+    Task task;
+    while (m_pool.Take(task))
+    {
+      task();
+      // release whatever the task holds on to before anybody learns it's done
+      task = nullptr;
+      m_pool.Finished();
+    }
+  }
+
+private:
+  CWorkerPool &m_pool;
+};
+
+CWorkerPool::CWorkerPool(const std::string &name, unsigned int workers, unsigned int maxQueued)
+  : m_maxQueued(std::max(maxQueued, 1u))
+  , m_running(0)
+  , m_cancelled(false)
+  , m_stopping(false)
+{
+  workers = std::max(workers, 1u);
+  for (unsigned int i = 0; i < workers; i++)
+  {
+    m_workers.emplace_back(new CWorker(*this));
+    m_threads.emplace_back(new CThread(m_workers.back().get(), name.c_str()));
+    m_threads.back()->Create();
+  }
+}
+
+CWorkerPool::~CWorkerPool()
+{
+  {
+    CSingleLock lock(m_section);
+    m_stopping = true;
+    m_tasks.clear();
+    m_queued.notifyAll();
+    m_progress.notifyAll();
+  }
+
+  for (auto &thread : m_threads)
+    thread->StopThread(true);
+}
+
+bool CWorkerPool::Submit(Task task)
+{
+  CSingleLock lock(m_section);
+  while (!m_cancelled && !m_stopping && m_tasks.size() >= m_maxQueued)
+    m_progress.wait(lock);
+
+  if (m_cancelled || m_stopping)
+    return false;
+
+  m_tasks.push_back(std::move(task));
+  m_queued.notify();
+  return true;
+}
+
+void CWorkerPool::Wait()
+{
+  CSingleLock lock(m_section);
+  while (!m_tasks.empty() || m_running > 0)
+    m_progress.wait(lock);
+}
+
+void CWorkerPool::Cancel()
+{
+  CSingleLock lock(m_section);
+  m_cancelled = true;
+  m_tasks.clear();
+  m_progress.notifyAll();
+}
+
+bool CWorkerPool::Take(Task &task)
+{
+  CSingleLock lock(m_section);
+  while (!m_stopping && m_tasks.empty())
+    m_queued.wait(lock);
+
+  if (m_stopping)
+    return false;
+
+  task = std::move(m_tasks.front());
+  m_tasks.pop_front();
+  m_running++;
+  m_progress.notifyAll();
+  return true;
+}
+
+void CWorkerPool::Finished()
+{
+  CSingleLock lock(m_section);
+  m_running--;
+  m_progress.notifyAll();
+}
@@ -0,0 +1,99 @@
+#pragma once
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+class CThread;
+
+/*!
+ \brief A fixed number of threads working off a bounded queue of tasks.
+
+ Meant for work that mostly waits on I/O, like the network lookups of a
+ library scan, where a few requests in flight hide most of the latency.
+ Submit() blocks while the queue is full, so a producer can't run arbitrarily
+ far ahead of the workers. Tasks run in the order they were submitted, but
+ finish in any order.
+ */
+class CWorkerPool
+{
+public:
+  typedef std::function<void()> Task;
+
+  /*!
+   \param name name of the worker threads
+   \param workers number of worker threads, at least one is started
+   \param maxQueued number of tasks waiting for a worker before Submit() blocks
+   */
+  CWorkerPool(const std::string &name, unsigned int workers, unsigned int maxQueued);
+
+  /*!
+   \brief Drops tasks not started yet and waits for the running ones
+   */
+  ~CWorkerPool();
+
+  /*!
+   \brief Queue a task, waiting while the queue is full
+   \return false if the pool was cancelled, the task won't run
+   */
+  bool Submit(Task task);
+
+  /*!
+   \brief Wait until all submitted tasks have finished
+   */
+  void Wait();
+
+  /*!
+   \brief Drop tasks not started yet and refuse new ones
+
+   \details Dropped tasks never run, so nobody must wait for them.
+   */
+  void Cancel();
+
+  unsigned int GetWorkers() const { return m_threads.size(); }
+
+private:
+  CWorkerPool(const CWorkerPool&) = delete;
+  CWorkerPool& operator=(const CWorkerPool&) = delete;
+
+  class CWorker;
+
+  bool Take(Task &task);
+  void Finished();
+
+  CCriticalSection m_section;
+  XbmcThreads::ConditionVariable m_queued;   ///< a task was queued or the pool is stopping
+  XbmcThreads::ConditionVariable m_progress; ///< a task was taken from the queue or finished
+  std::deque<Task> m_tasks;
+  unsigned int m_maxQueued;
+  unsigned int m_running;
+  bool m_cancelled;
+  bool m_stopping;
+
+  std::vector<std::unique_ptr<CWorker>> m_workers;
+  std::vector<std::unique_ptr<CThread>> m_threads;
+};
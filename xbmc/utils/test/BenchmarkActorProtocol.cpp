@@ -0,0 +1,111 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/Event.h"
+#include "utils/ActorProtocol.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace Actor;
+
+#define SENDERS 4
+#define PINGS 2000
+
+enum Signals
+{
+  PING,
+  PONG,
+  NOISE
+};
+
+struct Payload
+{
+  int sender;
+  int sequence;
+};
+
+TEST(BenchmarkActorProtocol, RoundTrip)
+{
+  // an actor answering pings while other threads flood the same queue,
+  // the way streams and the sink feed ActiveAE
+  CEvent inEvent, outEvent;
+  Protocol port("bench", &inEvent, &outEvent);
+  std::atomic<bool> stop(false);
+
+  std::thread actor([&]() {
+    while (!stop)
+    {
+      Message *msg;
+      if (!port.ReceiveOutMessage(&msg))
+      {
+        outEvent.WaitMSec(10);
+        continue;
+      }
+      if (msg->signal == PING)
+        msg->Reply(PONG, msg->data, sizeof(std::chrono::steady_clock::time_point));
+      msg->Release();
+    }
+  });
+
+  std::vector<std::thread> noise;
+  for (int i = 0; i < SENDERS - 1; i++)
+  {
+    noise.emplace_back([&]() {
+      Payload payload = { 0, 0 };
+      while (!stop)
+      {
+        port.SendOutMessage(NOISE, &payload, sizeof(payload));
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+      }
+    });
+  }
+
+  std::vector<double> latencies;
+  for (int i = 0; i < PINGS; i++)
+  {
+    auto sent = std::chrono::steady_clock::now();
+    port.SendOutMessage(PING, &sent, sizeof(sent));
+    Message *msg;
+    while (!port.ReceiveInMessage(&msg))
+      inEvent.WaitMSec(10);
+    auto received = std::chrono::steady_clock::now();
+    EXPECT_EQ(PONG, msg->signal);
+    latencies.push_back(std::chrono::duration<double, std::micro>(received - sent).count());
+    msg->Release();
+  }
+
+  stop = true;
+  outEvent.Set();
+  actor.join();
+  for (auto &thread : noise)
+    thread.join();
+  port.Purge();
+
+  std::sort(latencies.begin(), latencies.end());
+  ::testing::Test::RecordProperty("senders", SENDERS - 1);
+  ::testing::Test::RecordProperty("median_us", static_cast<int>(latencies[latencies.size() / 2]));
+  ::testing::Test::RecordProperty("p99_us", static_cast<int>(latencies[latencies.size() * 99 / 100]));
+}
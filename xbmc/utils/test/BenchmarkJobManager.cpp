@@ -0,0 +1,157 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/Event.h"
+#include "threads/Thread.h"
+#include "utils/JobManager.h"
+#include "utils/Stopwatch.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <vector>
+
+#define BENCHMARK_JOBS 20000
+#define BENCHMARK_PRODUCERS 4
+#define LATENCY_SAMPLES 2000
+
+class BenchmarkJobManager : public testing::Test
+{
+protected:
+  ~BenchmarkJobManager() override
+  {
+    CJobManager::GetInstance().CancelJobs();
+    CJobManager::GetInstance().Restart();
+  }
+};
+
+namespace
+{
+class CountingJob : public CJob
+{
+public:
+  CountingJob(std::atomic<int> &counter, CEvent &done, int total) :
+    m_counter(counter), m_done(done), m_total(total)
+  {
+  }
+
+  bool DoWork() override
+  {
+    if (++m_counter == m_total)
+      m_done.Set();
+    return true;
+  }
+
+private:
+  std::atomic<int> &m_counter;
+  CEvent &m_done;
+  int m_total;
+};
+
+class SignalJob : public CJob
+{
+public:
+  explicit SignalJob(CEvent &done) : m_done(done) {}
+
+  bool DoWork() override
+  {
+    m_done.Set();
+    return true;
+  }
+
+private:
+  CEvent &m_done;
+};
+
+class ProducerThread : public CThread
+{
+public:
+  ProducerThread(std::atomic<int> &counter, CEvent &done, int jobs, int total) :
+    CThread("JobProducer"), m_counter(counter), m_done(done), m_jobs(jobs), m_total(total)
+  {
+  }
+
+  void Process() override
+  {
+    for (int i = 0; i < m_jobs; i++)
+      CJobManager::GetInstance().AddJob(new CountingJob(m_counter, m_done, m_total), NULL, CJob::PRIORITY_NORMAL);
+  }
+
+private:
+  std::atomic<int> &m_counter;
+  CEvent &m_done;
+  int m_jobs;
+  int m_total;
+};
+}
+
+TEST_F(BenchmarkJobManager, Throughput)
+{
+  std::atomic<int> counter(0);
+  CEvent done;
+  const int total = BENCHMARK_JOBS * BENCHMARK_PRODUCERS;
+
+  CStopWatch watch;
+  watch.StartZero();
+  std::vector<ProducerThread*> producers;
+  for (int i = 0; i < BENCHMARK_PRODUCERS; i++)
+  {
+    producers.push_back(new ProducerThread(counter, done, BENCHMARK_JOBS, total));
+    producers.back()->Create();
+  }
+  for (std::vector<ProducerThread*>::iterator it = producers.begin(); it != producers.end(); ++it)
+  {
+    (*it)->StopThread(true);
+    delete *it;
+  }
+
+  EXPECT_TRUE(done.WaitMSec(60000));
+  watch.Stop();
+  EXPECT_EQ(total, counter);
+
+  // wait for the workers to finish with our counter and event
+  CJobManager::GetInstance().CancelJobs();
+  CJobManager::GetInstance().Restart();
+
+  float ms = watch.GetElapsedMilliseconds();
+  RecordProperty("jobs", total);
+  RecordProperty("producers", BENCHMARK_PRODUCERS);
+  RecordProperty("jobs_per_second", static_cast<int>(ms > 0 ? total / ms * 1000 : 0));
+}
+
+TEST_F(BenchmarkJobManager, Latency)
+{
+  // each job is added once the previous one has run, so every sample measures
+  // waking an idle worker rather than queueing behind other jobs
+  CEvent done;
+  CStopWatch watch;
+  watch.StartZero();
+  for (int i = 0; i < LATENCY_SAMPLES; i++)
+  {
+    CJobManager::GetInstance().AddJob(new SignalJob(done), NULL, CJob::PRIORITY_HIGH);
+    ASSERT_TRUE(done.WaitMSec(10000));
+  }
+  watch.Stop();
+  CJobManager::GetInstance().CancelJobs();
+  CJobManager::GetInstance().Restart();
+
+  RecordProperty("round_trips", LATENCY_SAMPLES);
+  RecordProperty("us_per_job", static_cast<int>(watch.GetElapsedMilliseconds() * 1000 / LATENCY_SAMPLES));
+}
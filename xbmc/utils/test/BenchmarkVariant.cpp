@@ -0,0 +1,106 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "test/AllocationCounter.h"
+#include "utils/Stopwatch.h"
+#include "utils/StringUtils.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+#define BENCHMARK_ITEMS 10000
+
+namespace
+{
+// builds an item like the ones returned by VideoLibrary.GetMovies
+CVariant CreateMovie(int i)
+{
+  CVariant movie(CVariant::VariantTypeObject);
+  movie["movieid"] = i;
+  movie["label"] = StringUtils::Format("Movie %i", i);
+  movie["title"] = StringUtils::Format("Movie %i", i);
+  movie["year"] = 1950 + i % 70;
+  movie["rating"] = (i % 100) / 10.0;
+  movie["runtime"] = 5400 + i % 3600;
+  movie["file"] = StringUtils::Format("smb://server/share/movies/Movie %i (%i)/movie.mkv", i, 1950 + i % 70);
+  movie["playcount"] = i % 3;
+  movie["genre"].push_back("Drama");
+  movie["genre"].push_back("Comedy");
+  movie["resume"]["position"] = 0;
+  movie["resume"]["total"] = 0;
+  return movie;
+}
+}
+
+TEST(BenchmarkVariant, Build)
+{
+  CStopWatch watch;
+  CVariant movies(CVariant::VariantTypeArray);
+  uint64_t allocations;
+  {
+    CAllocationCounter counter;
+    watch.StartZero();
+    for (int i = 0; i < BENCHMARK_ITEMS; i++)
+      movies.push_back(CreateMovie(i));
+    watch.Stop();
+    allocations = counter.GetCount();
+  }
+
+  EXPECT_EQ((unsigned int)BENCHMARK_ITEMS, movies.size());
+  // member names and most values don't allocate, only the containers and long strings do
+  EXPECT_LT(allocations, (uint64_t)BENCHMARK_ITEMS * 20);
+
+  ::testing::Test::RecordProperty("allocations", static_cast<int>(allocations));
+  ::testing::Test::RecordProperty("us", static_cast<int>(watch.GetElapsedMilliseconds() * 1000));
+}
+
+TEST(BenchmarkVariant, CopyAndLookup)
+{
+  CVariant movies(CVariant::VariantTypeArray);
+  for (int i = 0; i < BENCHMARK_ITEMS; i++)
+    movies.push_back(CreateMovie(i));
+
+  CStopWatch watch;
+  uint64_t allocations;
+  {
+    CAllocationCounter counter;
+    watch.StartZero();
+    CVariant copy = movies;
+    watch.Stop();
+    allocations = counter.GetCount();
+    EXPECT_TRUE(copy == movies);
+  }
+  ::testing::Test::RecordProperty("copy_allocations", static_cast<int>(allocations));
+  ::testing::Test::RecordProperty("copy_us", static_cast<int>(watch.GetElapsedMilliseconds() * 1000));
+
+  int64_t sum = 0;
+  const CVariant &constMovies = movies;
+  {
+    CAllocationCounter counter;
+    watch.StartZero();
+    for (CVariant::const_iterator_array it = constMovies.begin_array(); it != constMovies.end_array(); ++it)
+      sum += (*it)["year"].asInteger() + (*it)["runtime"].asInteger() + (*it)["title"].size();
+    watch.Stop();
+    allocations = counter.GetCount();
+  }
+  EXPECT_GT(sum, 0);
+  ::testing::Test::RecordProperty("lookup_allocations", static_cast<int>(allocations));
+  ::testing::Test::RecordProperty("lookup_us", static_cast<int>(watch.GetElapsedMilliseconds() * 1000));
+}
@@ -0,0 +1,177 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/Event.h"
+#include "utils/ActorProtocol.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace Actor;
+
+#define SENDERS 4
+#define MESSAGES_PER_SENDER 20000
+
+enum Signals
+{
+  PING,
+  PONG,
+  NOISE,
+  OTHER
+};
+
+struct Payload
+{
+  int sender;
+  int sequence;
+};
+
+TEST(TestActorProtocol, Order)
+{
+  Protocol port("test");
+  for (int i = 0; i < 100; i++)
+    EXPECT_TRUE(port.SendOutMessage(NOISE, &i, sizeof(i)));
+
+  Message *msg;
+  for (int i = 0; i < 100; i++)
+  {
+    ASSERT_TRUE(port.ReceiveOutMessage(&msg));
+    EXPECT_EQ(i, *(int*)msg->data);
+    msg->Release();
+  }
+  EXPECT_FALSE(port.ReceiveOutMessage(&msg));
+  EXPECT_FALSE(port.ReceiveInMessage(&msg));
+}
+
+TEST(TestActorProtocol, LargePayload)
+{
+  Protocol port("test");
+  std::vector<uint8_t> payload(MSG_INTERNAL_BUFFER_SIZE * 4, 0xAB);
+  port.SendInMessage(OTHER, payload.data(), payload.size());
+
+  Message *msg;
+  ASSERT_TRUE(port.ReceiveInMessage(&msg));
+  EXPECT_NE(msg->buffer, msg->data);
+  EXPECT_TRUE(std::equal(payload.begin(), payload.end(), msg->data));
+  msg->Release();
+}
+
+TEST(TestActorProtocol, Defer)
+{
+  Protocol port("test");
+  port.SendOutMessage(NOISE);
+  port.DeferOut(true);
+
+  Message *msg;
+  EXPECT_FALSE(port.ReceiveOutMessage(&msg));
+  port.DeferOut(false);
+  ASSERT_TRUE(port.ReceiveOutMessage(&msg));
+  msg->Release();
+}
+
+TEST(TestActorProtocol, PurgeKeepsOrder)
+{
+  Protocol port("test");
+  for (int i = 0; i < 20; i++)
+    port.SendOutMessage(i % 3 ? NOISE : OTHER, &i, sizeof(i));
+
+  port.PurgeOut(OTHER);
+  // sent after the purge, must come after the ones kept back
+  int last = 20;
+  port.SendOutMessage(NOISE, &last, sizeof(last));
+
+  Message *msg;
+  for (int i = 0; i <= 20; i++)
+  {
+    if (i % 3 == 0 && i != 20)
+      continue;
+    ASSERT_TRUE(port.ReceiveOutMessage(&msg));
+    EXPECT_EQ(NOISE, msg->signal);
+    EXPECT_EQ(i, *(int*)msg->data);
+    msg->Release();
+  }
+  EXPECT_FALSE(port.ReceiveOutMessage(&msg));
+}
+
+TEST(TestActorProtocol, Sync)
+{
+  CEvent outEvent;
+  Protocol port("test", nullptr, &outEvent);
+  std::thread actor([&]() {
+    Message *msg;
+    while (!port.ReceiveOutMessage(&msg))
+      outEvent.WaitMSec(100);
+    int value = *(int*)msg->data + 1;
+    msg->Reply(PONG, &value, sizeof(value));
+    msg->Release();
+  });
+
+  int value = 41;
+  Message *reply;
+  ASSERT_TRUE(port.SendOutMessageSync(PING, &reply, 5000, &value, sizeof(value)));
+  EXPECT_EQ(PONG, reply->signal);
+  EXPECT_EQ(42, *(int*)reply->data);
+  reply->Release();
+  actor.join();
+}
+
+TEST(TestActorProtocol, ConcurrentSenders)
+{
+  CEvent outEvent;
+  Protocol port("test", nullptr, &outEvent);
+
+  std::vector<std::thread> senders;
+  for (int sender = 0; sender < SENDERS; sender++)
+  {
+    senders.emplace_back([&port, sender]() {
+      for (int i = 0; i < MESSAGES_PER_SENDER; i++)
+      {
+        Payload payload = { sender, i };
+        port.SendOutMessage(NOISE, &payload, sizeof(payload));
+      }
+    });
+  }
+
+  // messages of one sender arrive in the order they were sent
+  std::vector<int> next(SENDERS, 0);
+  int received = 0;
+  while (received < SENDERS * MESSAGES_PER_SENDER)
+  {
+    Message *msg;
+    if (!port.ReceiveOutMessage(&msg))
+    {
+      outEvent.WaitMSec(10);
+      continue;
+    }
+    Payload *payload = (Payload*)msg->data;
+    ASSERT_EQ(next[payload->sender], payload->sequence);
+    next[payload->sender]++;
+    received++;
+    msg->Release();
+  }
+
+  for (auto &sender : senders)
+    sender.join();
+  for (int count : next)
+    EXPECT_EQ(MESSAGES_PER_SENDER, count);
+}
@@ -161,3 +161,27 @@ TEST(TestJSONVariantWriter, CanWriteArray)
   ASSERT_TRUE(CJSONVariantWriter::Write(variant, str, false));
   ASSERT_STREQ("[\n\t{\n\t\t\"foo\": \"bar\"\n\t}\n]", str.c_str());
 }
+
+TEST(TestJSONVariantWriter, CanWriteDeferred)
+{
+  CVariant variant;
+  variant["items"] = CVariant::CreateDeferred(1);
+  // a string can't be mistaken for a deferred value, whatever it holds
+  variant["name"] = "\x01" "deferred:0";
+  variant["other"] = CVariant::CreateDeferred(0);
+
+  std::vector<std::pair<size_t, uint64_t>> deferred;
+  std::string str;
+  ASSERT_TRUE(CJSONVariantWriter::Write(variant, str, true, deferred));
+  ASSERT_STREQ("{\"items\":null,\"name\":\"\\u0001deferred:0\",\"other\":null}", str.c_str());
+  ASSERT_EQ(2u, deferred.size());
+  EXPECT_EQ(str.find("null"), deferred[0].first);
+  EXPECT_EQ(1u, deferred[0].second);
+  EXPECT_EQ(str.rfind("null"), deferred[1].first);
+  EXPECT_EQ(0u, deferred[1].second);
+
+  ASSERT_TRUE(CJSONVariantWriter::Write(variant, str, false, deferred));
+  ASSERT_EQ(2u, deferred.size());
+  EXPECT_EQ(0, str.compare(deferred[0].first, 4, "null"));
+  EXPECT_EQ(0, str.compare(deferred[1].first, 4, "null"));
+}
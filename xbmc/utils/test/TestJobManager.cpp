@@ -22,9 +22,12 @@
 #include "utils/JobManager.h"
 #include "settings/Settings.h"
 #include "utils/SystemInfo.h"
+#include "threads/Event.h"
 
 #include "gtest/gtest.h"
 
+#include <atomic>
+
 /* CSysInfoJob::GetInternetState() will test for network connectivity. */
 class TestJobManager : public testing::Test
 {
@@ -179,3 +182,47 @@ TEST_F(TestJobManager, IsProcessing)
 
   job->FinishAndStopBlocking();
 }
+
+namespace
+{
+class CountingJob : public CJob
+{
+public:
+  CountingJob(std::atomic<int> &counter, CEvent &done, int total) :
+    m_counter(counter), m_done(done), m_total(total)
+  {
+  }
+
+  bool DoWork() override
+  {
+    if (++m_counter == m_total)
+      m_done.Set();
+    return true;
+  }
+
+private:
+  std::atomic<int> &m_counter;
+  CEvent &m_done;
+  int m_total;
+};
+}
+
+TEST_F(TestJobManager, CancelQueuedJob)
+{
+  JobControlPackage package;
+  BroadcastingJob *job (WaitForJobToStartProcessing(CJob::PRIORITY_LOW_PAUSABLE, package));
+  JobControlPackage package2;
+  BroadcastingJob *job2 (WaitForJobToStartProcessing(CJob::PRIORITY_LOW_PAUSABLE, package2));
+
+  // LOW_PAUSABLE runs at most two jobs at once, so this one stays queued
+  std::atomic<int> counter(0);
+  CEvent done;
+  unsigned int id = CJobManager::GetInstance().AddJob(new CountingJob(counter, done, 1), NULL, CJob::PRIORITY_LOW_PAUSABLE);
+  EXPECT_NE(0u, id);
+  CJobManager::GetInstance().CancelJob(id);
+
+  job->FinishAndStopBlocking();
+  job2->FinishAndStopBlocking();
+  EXPECT_FALSE(done.WaitMSec(100));
+  EXPECT_EQ(0, counter);
+}
@@ -19,10 +19,13 @@
  */
 
 #include "utils/SortUtils.h"
+#include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
 #include "gtest/gtest.h"
 
+#include <cstring>
+
 TEST(TestSortUtils, Sort_SortBy)
 {
   SortItems items;
@@ -133,3 +136,83 @@ TEST(TestSortUtils, GetFieldsForSorting)
   EXPECT_EQ(FieldTrackNumber, *it);
   EXPECT_EQ((unsigned int)5, fields.size());
 }
+
+TEST(TestSortUtils, Sort_SortSpecialAndFolders)
+{
+  SortItems items;
+  const char *labels[] = { "b", "on bottom", "a", "folder", "c", "on top" };
+  for (unsigned int i = 0; i < sizeof(labels) / sizeof(labels[0]); i++)
+  {
+    SortItemPtr item(new SortItem());
+    (*item)[FieldLabel] = labels[i];
+    (*item)[FieldFolder] = strcmp(labels[i], "folder") == 0;
+    items.push_back(item);
+  }
+  (*items[1])[FieldSortSpecial] = SortSpecialOnBottom;
+  (*items[5])[FieldSortSpecial] = SortSpecialOnTop;
+
+  SortUtils::Sort(SortByLabel, SortOrderDescending, SortAttributeNone, items);
+
+  const char *expected[] = { "on top", "folder", "c", "b", "a", "on bottom" };
+  for (unsigned int i = 0; i < items.size(); i++)
+    EXPECT_STREQ(expected[i], (*items[i])[FieldLabel].asString().c_str());
+  EXPECT_TRUE((*items[0]).at(FieldSort).asWideString() == L"on top");
+
+  SortUtils::Sort(SortByLabel, SortOrderAscending, SortAttributeIgnoreFolders, items);
+
+  const char *expectedIgnoreFolders[] = { "on top", "a", "b", "c", "folder", "on bottom" };
+  for (unsigned int i = 0; i < items.size(); i++)
+    EXPECT_STREQ(expectedIgnoreFolders[i], (*items[i])[FieldLabel].asString().c_str());
+}
+
+TEST(TestSortUtils, Sort_Numeric)
+{
+  DatabaseResults items;
+  int64_t sizes[] = { 100, 9, 2000000000000LL, 10, 9 };
+  for (unsigned int i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+  {
+    DatabaseResult item;
+    item[FieldSize] = sizes[i];
+    item[FieldId] = i;
+    items.push_back(item);
+  }
+
+  SortUtils::Sort(SortBySize, SortOrderAscending, SortAttributeNone, items);
+
+  int64_t expected[] = { 9, 9, 10, 100, 2000000000000LL };
+  for (unsigned int i = 0; i < items.size(); i++)
+    EXPECT_EQ(expected[i], items[i][FieldSize].asInteger());
+  // equal items keep their order
+  EXPECT_EQ(1, items[0][FieldId].asInteger());
+  EXPECT_EQ(4, items[1][FieldId].asInteger());
+}
+
+TEST(TestSortUtils, Sort_Large)
+{
+  // enough items to be sorted in parallel, with many equal labels to check stability
+  const int count = 50000;
+  SortItems items;
+  for (int i = 0; i < count; i++)
+  {
+    SortItemPtr item(new SortItem());
+    (*item)[FieldArtist] = StringUtils::Format("Artist %d", (i * 7) % 1000);
+    (*item)[FieldAlbum] = StringUtils::Format("The Album %d", (i * 13) % 50);
+    (*item)[FieldTrackNumber] = (i * 31) % 20;
+    (*item)[FieldId] = i;
+    items.push_back(item);
+  }
+
+  SortUtils::Sort(SortByArtist, SortOrderAscending, SortAttributeIgnoreArticle, items);
+
+  ASSERT_EQ((size_t)count, items.size());
+  for (int i = 1; i < count; i++)
+  {
+    const SortItem &left = *items[i - 1];
+    const SortItem &right = *items[i];
+    int64_t cmp = StringUtils::AlphaNumericCompare(left.at(FieldSort).asWideString().c_str(),
+                                                   right.at(FieldSort).asWideString().c_str());
+    ASSERT_LE(cmp, 0) << "at " << i;
+    if (cmp == 0)
+      ASSERT_LT(left.at(FieldId).asInteger(), right.at(FieldId).asInteger()) << "at " << i;
+  }
+}
@@ -18,6 +18,7 @@
  *
  */
 
+#include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
 #include "gtest/gtest.h"
@@ -348,3 +349,80 @@ TEST(TestVariant, isMember)
   EXPECT_TRUE(a.isMember("key1"));
   EXPECT_FALSE(a.isMember("key2"));
 }
+
+TEST(TestVariant, ShortString)
+{
+  std::string shortString(CVariant::SHORT_STRING_SIZE - 1, 'a');
+  std::string longString(CVariant::SHORT_STRING_SIZE, 'b');
+  CVariant a(shortString), b(longString);
+
+  EXPECT_EQ(shortString, a.asString());
+  EXPECT_EQ(longString, b.asString());
+  EXPECT_EQ(shortString.size(), a.size());
+  EXPECT_EQ(longString.size(), b.size());
+  EXPECT_STREQ(shortString.c_str(), a.c_str());
+
+  a.swap(b);
+  EXPECT_EQ(longString, a.asString());
+  EXPECT_EQ(shortString, b.asString());
+
+  CVariant c(std::move(b));
+  EXPECT_EQ(shortString, c.asString());
+  EXPECT_TRUE(b.isNull());
+  EXPECT_FALSE(c == a);
+  c = a;
+  EXPECT_TRUE(c == a);
+
+  c.clear();
+  EXPECT_TRUE(c.empty());
+  EXPECT_STREQ("", c.c_str());
+
+  CVariant d("false");
+  EXPECT_FALSE(d.asBoolean(true));
+  CVariant e("42");
+  EXPECT_EQ(42, e.asInteger());
+}
+
+TEST(TestVariant, ObjectOrder)
+{
+  CVariant a;
+  a["key3"] = 3;
+  a["key1"] = 1;
+  a["key4"] = 4;
+  a["key2"] = 2;
+  a["key1"] = 5;
+
+  EXPECT_EQ(4u, a.size());
+  int64_t expected[] = { 5, 2, 3, 4 };
+  int i = 0;
+  for (CVariant::const_iterator_map it = a.begin_map(); it != a.end_map(); ++it, ++i)
+  {
+    EXPECT_EQ(StringUtils::Format("key%i", i + 1), it->first);
+    EXPECT_EQ(expected[i], it->second.asInteger());
+  }
+
+  a.erase("key3");
+  EXPECT_FALSE(a.isMember("key3"));
+  EXPECT_TRUE(a.isMember("key4"));
+  EXPECT_EQ(3u, a.size());
+
+  const CVariant &b = a;
+  EXPECT_TRUE(b["key0"].isNull());
+  EXPECT_TRUE(b["key5"].isNull());
+}
+
+TEST(TestVariant, Deferred)
+{
+  CVariant a = CVariant::CreateDeferred(3);
+  EXPECT_TRUE(a.isDeferred());
+  EXPECT_FALSE(a.isNull());
+  EXPECT_EQ(3u, a.asUnsignedInteger());
+
+  CVariant b;
+  b["list"] = a;
+  EXPECT_TRUE(b["list"].isDeferred());
+  EXPECT_TRUE(b["list"] == a);
+  EXPECT_FALSE(CVariant::CreateDeferred(4) == a);
+  EXPECT_FALSE(CVariant(3u) == a);
+  EXPECT_FALSE(CVariant("3").isDeferred());
+}
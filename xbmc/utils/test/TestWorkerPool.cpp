@@ -0,0 +1,86 @@
+/*
+ *      Copyright (C) 2017 Team Kodi
+ *      http://kodi.tv
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Kodi; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/Event.h"
+#include "threads/Thread.h"
+#include "utils/WorkerPool.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+
+TEST(TestWorkerPool, RunsAllTasks)
+{
+  std::atomic<int> sum(0);
+  {
+    CWorkerPool pool("TestWorkerPool", 4, 2);
+    EXPECT_EQ(4u, pool.GetWorkers());
+    for (int i = 1; i <= 100; i++)
+      EXPECT_TRUE(pool.Submit([&sum, i]() { sum += i; }));
+    pool.Wait();
+    EXPECT_EQ(5050, sum);
+  }
+  EXPECT_EQ(5050, sum);
+}
+
+TEST(TestWorkerPool, SubmitBlocksWhileFull)
+{
+  CEvent release(true);
+  std::atomic<int> started(0);
+  std::atomic<int> submitted(0);
+
+  CWorkerPool pool("TestWorkerPool", 1, 1);
+  auto task = [&]() { started++; release.Wait(); };
+
+  EXPECT_TRUE(pool.Submit(task)); // taken by the worker
+  while (started == 0)
+    XbmcThreads::ThreadSleep(1);
+  EXPECT_TRUE(pool.Submit(task)); // queued
+
+  CEvent done(true);
+  CWorkerPool producer("TestWorkerPool", 1, 1);
+  producer.Submit([&]() { pool.Submit(task); submitted++; done.Set(); });
+  EXPECT_FALSE(done.WaitMSec(100));
+  EXPECT_EQ(0, submitted);
+
+  release.Set();
+  EXPECT_TRUE(done.WaitMSec(5000));
+  pool.Wait();
+  EXPECT_EQ(3, started);
+}
+
+TEST(TestWorkerPool, Cancel)
+{
+  CEvent release(true);
+  std::atomic<int> started(0);
+
+  CWorkerPool pool("TestWorkerPool", 1, 10);
+  auto task = [&]() { started++; release.Wait(); };
+  EXPECT_TRUE(pool.Submit(task));
+  while (started == 0)
+    XbmcThreads::ThreadSleep(1);
+  EXPECT_TRUE(pool.Submit(task));
+
+  pool.Cancel();
+  EXPECT_FALSE(pool.Submit(task));
+  release.Set();
+  pool.Wait();
+  EXPECT_EQ(1, started);
+}
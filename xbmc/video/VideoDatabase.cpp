@@ -527,8 +527,8 @@ int CVideoDatabase::GetPathId(const std::string& strPath)
 
     URIUtils::AddSlashAtEnd(strPath1);
 
-    strSQL=PrepareSQL("select idPath from path where strPath='%s'",strPath1.c_str());
-    m_pDS->query(strSQL);
+    strSQL = "select idPath from path where strPath=?";
+    m_pDS->query(strSQL, { field_value(strPath1) });
     if (!m_pDS->eof())
       idPath = m_pDS->fv("path.idPath").get_asInt();
 
@@ -551,58 +551,54 @@ bool CVideoDatabase::GetPaths(std::set<std::string> &paths)
 
     paths.clear();
 
+    column_set columns;
+
     // grab all paths with movie content set
-    if (!m_pDS->query("select strPath,noUpdate from path"
+    if (!m_pDS->query_columns("select strPath,noUpdate from path"
                       " where (strContent = 'movies' or strContent = 'musicvideos')"
                       " and strPath NOT like 'multipath://%%'"
-                      " order by strPath"))
+                      " order by strPath", columns))
       return false;
 
-    while (!m_pDS->eof())
+    for (unsigned int row = 0; row < columns.num_rows(); row++)
     {
-      if (!m_pDS->fv("noUpdate").get_asBool())
-        paths.insert(m_pDS->fv("strPath").get_asString());
-      m_pDS->next();
+      if (!columns.get_bool(row, 1))
+        paths.insert(columns.get_text(row, 0));
     }
-    m_pDS->close();
 
     // then grab all tvshow paths
-    if (!m_pDS->query("select strPath,noUpdate from path"
+    if (!m_pDS->query_columns("select strPath,noUpdate from path"
                       " where ( strContent = 'tvshows'"
                       "       or idPath in (select idPath from tvshowlinkpath))"
                       " and strPath NOT like 'multipath://%%'"
-                      " order by strPath"))
+                      " order by strPath", columns))
       return false;
 
-    while (!m_pDS->eof())
+    for (unsigned int row = 0; row < columns.num_rows(); row++)
     {
-      if (!m_pDS->fv("noUpdate").get_asBool())
-        paths.insert(m_pDS->fv("strPath").get_asString());
-      m_pDS->next();
+      if (!columns.get_bool(row, 1))
+        paths.insert(columns.get_text(row, 0));
     }
-    m_pDS->close();
 
     // finally grab all other paths holding a movie which is not a stack or a rar archive
     // - this isnt perfect but it should do fine in most situations.
     // reason we need it to hold a movie is stacks from different directories (cdx folders for instance)
     // not making mistakes must take priority
-    if (!m_pDS->query("select strPath,noUpdate from path"
+    if (!m_pDS->query_columns("select strPath,noUpdate from path"
                        " where idPath in (select idPath from files join movie on movie.idFile=files.idFile)"
                        " and idPath NOT in (select idPath from tvshowlinkpath)"
                        " and idPath NOT in (select idPath from files where strFileName like 'video_ts.ifo')" // dvd folders get stacked to a single item in parent folder
                        " and idPath NOT in (select idPath from files where strFileName like 'index.bdmv')" // bluray folders get stacked to a single item in parent folder
                        " and strPath NOT like 'multipath://%%'"
                        " and strContent NOT in ('movies', 'tvshows', 'None')" // these have been added above
-                       " order by strPath"))
+                       " order by strPath", columns))
 
       return false;
-    while (!m_pDS->eof())
+    for (unsigned int row = 0; row < columns.num_rows(); row++)
     {
-      if (!m_pDS->fv("noUpdate").get_asBool())
-        paths.insert(m_pDS->fv("strPath").get_asString());
-      m_pDS->next();
+      if (!columns.get_bool(row, 1))
+        paths.insert(columns.get_text(row, 0));
     }
-    m_pDS->close();
     return true;
   }
   catch (...)
@@ -730,21 +726,15 @@ int CVideoDatabase::AddPath(const std::string& strPath, const std::string &paren
     int idParentPath = GetPathId(parentPath.empty() ? (std::string)URIUtils::GetParentPath(strPath1) : parentPath);
 
     // add the path
+    field_value parent(idParentPath);
     if (idParentPath < 0)
-    {
-      if (dateAdded.IsValid())
-        strSQL=PrepareSQL("insert into path (idPath, strPath, dateAdded) values (NULL, '%s', '%s')", strPath1.c_str(), dateAdded.GetAsDBDateTime().c_str());
-      else
-        strSQL=PrepareSQL("insert into path (idPath, strPath) values (NULL, '%s')", strPath1.c_str());
-    }
-    else
-    {
-      if (dateAdded.IsValid())
-        strSQL = PrepareSQL("insert into path (idPath, strPath, dateAdded, idParentPath) values (NULL, '%s', '%s', %i)", strPath1.c_str(), dateAdded.GetAsDBDateTime().c_str(), idParentPath);
-      else
-        strSQL=PrepareSQL("insert into path (idPath, strPath, idParentPath) values (NULL, '%s', %i)", strPath1.c_str(), idParentPath);
-    }
-    m_pDS->exec(strSQL);
+      parent.set_isNull();
+    field_value added(dateAdded.IsValid() ? dateAdded.GetAsDBDateTime() : std::string());
+    if (!dateAdded.IsValid())
+      added.set_isNull();
+
+    strSQL = "insert into path (idPath, strPath, dateAdded, idParentPath) values (NULL, ?, ?, ?)";
+    m_pDS->exec(strSQL, { field_value(strPath1), added, parent });
     idPath = (int)m_pDS->lastinsertid();
     return idPath;
   }
@@ -876,9 +866,8 @@ int CVideoDatabase::AddFile(const std::string& strFileNameAndPath)
     if (idPath < 0)
       return -1;
 
-    std::string strSQL=PrepareSQL("select idFile from files where strFileName='%s' and idPath=%i", strFileName.c_str(),idPath);
-
-    m_pDS->query(strSQL);
+    strSQL = "select idFile from files where strFileName=? and idPath=?";
+    m_pDS->query(strSQL, { field_value(strFileName), field_value(idPath) });
     if (m_pDS->num_rows() > 0)
     {
       idFile = m_pDS->fv("idFile").get_asInt() ;
@@ -887,8 +876,8 @@ int CVideoDatabase::AddFile(const std::string& strFileNameAndPath)
     }
     m_pDS->close();
 
-    strSQL=PrepareSQL("insert into files (idFile, idPath, strFileName) values(NULL, %i, '%s')", idPath, strFileName.c_str());
-    m_pDS->exec(strSQL);
+    strSQL = "insert into files (idFile, idPath, strFileName) values(NULL, ?, ?)";
+    m_pDS->exec(strSQL, { field_value(idPath), field_value(strFileName) });
     idFile = (int)m_pDS->lastinsertid();
     return idFile;
   }
@@ -1059,9 +1048,8 @@ int CVideoDatabase::GetFileId(const std::string& strFilenameAndPath)
     int idPath = GetPathId(strPath);
     if (idPath >= 0)
     {
-      std::string strSQL;
-      strSQL=PrepareSQL("select idFile from files where strFileName='%s' and idPath=%i", strFileName.c_str(),idPath);
-      m_pDS->query(strSQL);
+      m_pDS->query("select idFile from files where strFileName=? and idPath=?",
+                   { field_value(strFileName), field_value(idPath) });
       if (m_pDS->num_rows() > 0)
       {
         int idFile = m_pDS->fv("files.idFile").get_asInt();
@@ -1406,14 +1394,15 @@ int CVideoDatabase::AddToTable(const std::string& table, const std::string& firs
     if (NULL == m_pDB.get()) return -1;
     if (NULL == m_pDS.get()) return -1;
 
-    std::string strSQL = PrepareSQL("select %s from %s where %s like '%s'", firstField.c_str(), table.c_str(), secondField.c_str(), value.substr(0, 255).c_str());
-    m_pDS->query(strSQL);
+    const field_value truncated(value.substr(0, 255));
+    std::string strSQL = PrepareSQL("select %s from %s where %s like ?", firstField.c_str(), table.c_str(), secondField.c_str());
+    m_pDS->query(strSQL, { truncated });
     if (m_pDS->num_rows() == 0)
     {
       m_pDS->close();
       // doesnt exists, add it
-      strSQL = PrepareSQL("insert into %s (%s, %s) values(NULL, '%s')", table.c_str(), firstField.c_str(), secondField.c_str(), value.substr(0, 255).c_str());
-      m_pDS->exec(strSQL);
+      strSQL = PrepareSQL("insert into %s (%s, %s) values(NULL, ?)", table.c_str(), firstField.c_str(), secondField.c_str());
+      m_pDS->exec(strSQL, { truncated });
       int id = (int)m_pDS->lastinsertid();
       return id;
     }
@@ -1609,14 +1598,14 @@ int CVideoDatabase::AddActor(const std::string& name, const std::string& thumbUR
     std::string trimmedName = name.c_str();
     StringUtils::Trim(trimmedName);
 
-    std::string strSQL=PrepareSQL("select actor_id from actor where name like '%s'", trimmedName.substr(0, 255).c_str());
-    m_pDS->query(strSQL);
+    const field_value truncated(trimmedName.substr(0, 255));
+    m_pDS->query("select actor_id from actor where name like ?", { truncated });
     if (m_pDS->num_rows() == 0)
     {
       m_pDS->close();
       // doesnt exists, add it
-      strSQL=PrepareSQL("insert into actor (actor_id, name, art_urls) values(NULL, '%s', '%s')", trimmedName.substr(0,255).c_str(), thumbURLs.c_str());
-      m_pDS->exec(strSQL);
+      m_pDS->exec("insert into actor (actor_id, name, art_urls) values(NULL, ?, ?)",
+                  { truncated, field_value(thumbURLs) });
       idActor = (int)m_pDS->lastinsertid();
     }
     else
@@ -1625,10 +1614,8 @@ int CVideoDatabase::AddActor(const std::string& name, const std::string& thumbUR
       m_pDS->close();
       // update the thumb url's
       if (!thumbURLs.empty())
-      {
-        strSQL=PrepareSQL("update actor set art_urls = '%s' where actor_id = %i", thumbURLs.c_str(), idActor);
-        m_pDS->exec(strSQL);
-      }
+        m_pDS->exec("update actor set art_urls = ? where actor_id = ?",
+                    { field_value(thumbURLs), field_value(idActor) });
     }
     // add artwork
     if (!thumb.empty())
@@ -1646,24 +1633,24 @@ int CVideoDatabase::AddActor(const std::string& name, const std::string& thumbUR
 
 void CVideoDatabase::AddLinkToActor(int mediaId, const char *mediaType, int actorId, const std::string &role, int order)
 {
-  std::string sql=PrepareSQL("SELECT 1 FROM actor_link WHERE actor_id=%i AND media_id=%i AND media_type='%s'", actorId, mediaId, mediaType);
-
-  if (GetSingleValue(sql).empty())
+  if (GetSingleValue("SELECT 1 FROM actor_link WHERE actor_id=? AND media_id=? AND media_type=?",
+                     { field_value(actorId), field_value(mediaId), field_value(mediaType) }).empty())
   { // doesnt exists, add it
-    sql = PrepareSQL("INSERT INTO actor_link (actor_id, media_id, media_type, role, cast_order) VALUES(%i,%i,'%s','%s',%i)", actorId, mediaId, mediaType, role.c_str(), order);
-    ExecuteQuery(sql);
+    ExecuteQuery("INSERT INTO actor_link (actor_id, media_id, media_type, role, cast_order) VALUES(?,?,?,?,?)",
+                 { field_value(actorId), field_value(mediaId), field_value(mediaType), field_value(role), field_value(order) });
   }
 }
 
 void CVideoDatabase::AddToLinkTable(int mediaId, const std::string& mediaType, const std::string& table, int valueId, const char *foreignKey)
 {
   const char *key = foreignKey ? foreignKey : table.c_str();
-  std::string sql = PrepareSQL("SELECT 1 FROM %s_link WHERE %s_id=%i AND media_id=%i AND media_type='%s'", table.c_str(), key, valueId, mediaId, mediaType.c_str());
+  const std::vector<field_value> params = { field_value(valueId), field_value(mediaId), field_value(mediaType) };
+  std::string sql = PrepareSQL("SELECT 1 FROM %s_link WHERE %s_id=? AND media_id=? AND media_type=?", table.c_str(), key);
 
-  if (GetSingleValue(sql).empty())
+  if (GetSingleValue(sql, params).empty())
   { // doesnt exists, add it
-    sql = PrepareSQL("INSERT INTO %s_link (%s_id,media_id,media_type) VALUES(%i,%i,'%s')", table.c_str(), key, valueId, mediaId, mediaType.c_str());
-    ExecuteQuery(sql);
+    sql = PrepareSQL("INSERT INTO %s_link (%s_id,media_id,media_type) VALUES(?,?,?)", table.c_str(), key);
+    ExecuteQuery(sql, params);
   }
 }
 
@@ -9600,10 +9587,13 @@ void CVideoDatabase::InvalidatePathHash(const std::string& strPath)
 bool CVideoDatabase::CommitTransaction()
 {
   if (CDatabase::CommitTransaction())
-  { // number of items in the db has likely changed, so recalculate
-    g_infoManager.SetLibraryBool(LIBRARY_HAS_MOVIES, HasContent(VIDEODB_CONTENT_MOVIES));
-    g_infoManager.SetLibraryBool(LIBRARY_HAS_TVSHOWS, HasContent(VIDEODB_CONTENT_TVSHOWS));
-    g_infoManager.SetLibraryBool(LIBRARY_HAS_MUSICVIDEOS, HasContent(VIDEODB_CONTENT_MUSICVIDEOS));
+  { // number of items in the db has likely changed, so recalculate once the outermost transaction is committed
+    if (!InTransaction())
+    {
+      g_infoManager.SetLibraryBool(LIBRARY_HAS_MOVIES, HasContent(VIDEODB_CONTENT_MOVIES));
+      g_infoManager.SetLibraryBool(LIBRARY_HAS_TVSHOWS, HasContent(VIDEODB_CONTENT_TVSHOWS));
+      g_infoManager.SetLibraryBool(LIBRARY_HAS_MUSICVIDEOS, HasContent(VIDEODB_CONTENT_MUSICVIDEOS));
+    }
     return true;
   }
   return false;
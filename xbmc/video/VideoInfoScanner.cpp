@@ -23,6 +23,7 @@
 #include <utility>
 
 #include "ServiceBroker.h"
+#include "addons/AddonManager.h"
 #include "dialogs/GUIDialogExtendedProgressBar.h"
 #include "dialogs/GUIDialogProgress.h"
 #include "events/EventLog.h"
@@ -44,6 +45,7 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "TextureCache.h"
+#include "threads/SingleLock.h"
 #include "threads/SystemClock.h"
 #include "URL.h"
 #include "Util.h"
@@ -54,6 +56,7 @@
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
+#include "utils/WorkerPool.h"
 #include "video/VideoLibraryQueue.h"
 #include "video/VideoThumbLoader.h"
 #include "VideoInfoDownloader.h"
@@ -64,13 +67,98 @@ using namespace KODI::MESSAGING;
 
 using KODI::MESSAGING::HELPERS::DialogResponse;
 
+// number of database writes grouped into one transaction
+#define SCAN_COMMIT_BATCH 50
+
 namespace VIDEO
 {
+  /*!
+   \brief A folder to scan. Its settings are looked up on the scanner thread, listing and
+   hashing it can be done ahead on a worker.
+   */
+  struct CVideoInfoScanner::FolderScan
+  {
+    explicit FolderScan(const std::string &strPath) : path(strPath), examined(true) {}
+
+    std::string path;
+    ADDON::ScraperPtr info;
+    SScanSettings settings;
+    bool foundDirectly = false;
+    CONTENT_TYPE content = CONTENT_NONE;
+    bool ignore = false;
+    bool hasDbHash = false;
+    std::string dbHash;
+    bool queued = false;
+
+    // filled in by ExamineFolder()
+    CFileItemList items;
+    std::string hash;
+    std::string fastHash;
+    CEvent examined;
+  };
+
+  /*!
+   \brief A video whose information is retrieved by a worker
+   */
+  struct CVideoInfoScanner::PendingVideo
+  {
+    PendingVideo() : fetched(true) {}
+
+    CFileItemPtr item;
+    ADDON::ScraperPtr scraper;
+    bool videoFolder = false;
+    float progress = 0;
+    EPISODE file;               ///< episode file, for episodes only
+    EPISODE guide;              ///< matching entry of the episode guide
+    bool needsGuide = false;
+    INFO_RET result = INFO_CANCELLED;
+    CEvent fetched;
+  };
+
+  /*!
+   \brief A folder whose videos are written to the database once retrieved
+   */
+  struct CVideoInfoScanner::PendingFolder
+  {
+    std::shared_ptr<FolderScan> folder;
+    std::vector<std::shared_ptr<PendingVideo>> videos;
+    size_t committed = 0;
+    bool complete = false;      ///< all videos of the folder were queued
+    bool foundSomeInfo = false;
+    bool failed = false;
+  };
+
+  static const std::vector<std::string>& GetExcludeRegExps(CONTENT_TYPE content)
+  {
+    return content == CONTENT_TVSHOWS ? g_advancedSettings.m_tvshowExcludeFromScanRegExps
+                                      : g_advancedSettings.m_moviesExcludeFromScanRegExps;
+  }
+
+  /*!
+   \brief Get a scraper instance for use on a worker. XML scrapers keep state while
+   running, so every worker needs its own instance.
+   \return the instance, or an empty pointer if the scraper can't be loaded
+   */
+  static ScraperPtr GetScraperForWorker(const ScraperPtr &scraper)
+  {
+    if (scraper->IsPython())
+      return scraper;
+
+    AddonPtr addon;
+    if (!CServiceBroker::GetAddonMgr().GetAddon(scraper->ID(), addon, ADDON_UNKNOWN, false))
+      return ScraperPtr();
+    ScraperPtr instance = std::dynamic_pointer_cast<CScraper>(addon);
+    if (!instance || !instance->SetPathSettings(scraper->Content(), scraper->GetPathSettings()))
+      return ScraperPtr();
+    return instance;
+  }
 
   CVideoInfoScanner::CVideoInfoScanner()
   {
     m_bStop = false;
     m_scanAll = false;
+    m_pendingVideos = 0;
+    m_maxPendingVideos = 0;
   }
 
   CVideoInfoScanner::~CVideoInfoScanner()
@@ -109,6 +197,13 @@ namespace VIDEO
 
       m_database.Open();
 
+      if (g_advancedSettings.m_iVideoScannerThreads > 0)
+      {
+        unsigned int threads = g_advancedSettings.m_iVideoScannerThreads;
+        m_pool.reset(new CWorkerPool("VideoInfoScanner", threads, threads * 2));
+        m_maxPendingVideos = threads * 4;
+      }
+
       m_bCanInterrupt = true;
 
       CLog::Log(LOGNOTICE, "VideoInfoScanner: Starting scan ..");
@@ -147,6 +242,10 @@ namespace VIDEO
           bCancelled = true;
       }
 
+      // write what the workers retrieved before cleaning up
+      CommitPending(0);
+      m_pool.reset();
+
       if (!bCancelled)
       {
         if (m_bClean)
@@ -169,7 +268,12 @@ namespace VIDEO
     {
       CLog::Log(LOGERROR, "VideoInfoScanner: Exception while scanning.");
     }
-    
+
+    // stop the workers before dropping what they work on
+    m_pool.reset();
+    m_pending.clear();
+    m_pendingVideos = 0;
+
     m_bRunning = false;
     ANNOUNCEMENT::CAnnouncementManager::GetInstance().Announce(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnScanFinished");
     
@@ -232,6 +336,90 @@ namespace VIDEO
 
   bool CVideoInfoScanner::DoScan(const std::string& strDirectory)
   {
+    std::shared_ptr<FolderScan> folder = PrepareFolder(strDirectory);
+    return ScanFolder(folder);
+  }
+
+  std::shared_ptr<CVideoInfoScanner::FolderScan> CVideoInfoScanner::PrepareFolder(const std::string &strDirectory)
+  {
+    std::shared_ptr<FolderScan> folder = std::make_shared<FolderScan>(strDirectory);
+    folder->info = m_database.GetScraperForPath(strDirectory, folder->settings, folder->foundDirectly);
+    folder->content = folder->info ? folder->info->Content() : CONTENT_NONE;
+
+    // exclude folders that match our exclude regexps
+    if (IsExcluded(strDirectory, GetExcludeRegExps(folder->content)))
+      folder->ignore = true;
+    else
+    {
+      bool ignoreFolder = !m_scanAll && folder->settings.noupdate;
+      if (folder->content == CONTENT_NONE || ignoreFolder)
+        folder->ignore = true;
+      else
+        folder->hasDbHash = m_database.GetPathHash(strDirectory, folder->dbHash);
+    }
+    return folder;
+  }
+
+  void CVideoInfoScanner::ExamineFolder(FolderScan &folder) const
+  {
+    if (!folder.ignore && !m_bStop)
+    {
+      const std::vector<std::string> &regexps = GetExcludeRegExps(folder.content);
+      if (folder.content == CONTENT_MOVIES || folder.content == CONTENT_MUSICVIDEOS)
+      {
+        if (g_advancedSettings.m_bVideoLibraryUseFastHash)
+          folder.fastHash = GetFastHash(folder.path, regexps);
+
+        if (folder.hasDbHash && !folder.fastHash.empty() && folder.fastHash == folder.dbHash)
+        { // fast hashes match - no need to process anything
+          folder.hash = folder.fastHash;
+        }
+        else
+        { // need to fetch the folder
+          CDirectory::GetDirectory(folder.path, folder.items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions());
+          folder.items.Stack();
+
+          // check whether to re-use previously computed fast hash
+          if (!CanFastHash(folder.items, regexps) || folder.fastHash.empty())
+            GetPathHash(folder.items, folder.hash);
+          else
+            folder.hash = folder.fastHash;
+        }
+      }
+      else if (folder.content == CONTENT_TVSHOWS)
+      {
+        if (folder.foundDirectly && !folder.settings.parent_name_root)
+        {
+          CDirectory::GetDirectory(folder.path, folder.items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions());
+          folder.items.SetPath(folder.path);
+          GetPathHash(folder.items, folder.hash);
+        }
+        else
+        {
+          CFileItemPtr item(new CFileItem(URIUtils::GetFileName(folder.path)));
+          item->SetPath(folder.path);
+          item->m_bIsFolder = true;
+          folder.items.Add(item);
+          folder.items.SetPath(URIUtils::GetParentPath(item->GetPath()));
+        }
+      }
+    }
+    folder.examined.Set();
+  }
+
+  void CVideoInfoScanner::QueueExamineFolder(const std::shared_ptr<FolderScan> &folder)
+  {
+    if (!m_pool || folder->ignore || folder->queued)
+      return;
+
+    folder->queued = m_pool->Submit([this, folder]() { ExamineFolder(*folder); });
+  }
+
+  bool CVideoInfoScanner::ScanFolder(const std::shared_ptr<FolderScan> &folderPtr)
+  {
+    FolderScan &folder = *folderPtr;
+    const std::string &strDirectory = folder.path;
+
     if (m_handle)
     {
       m_handle->SetText(g_localizeStrings.Get(20415));
@@ -246,58 +434,36 @@ namespace VIDEO
     if (it != m_pathsToScan.end())
       m_pathsToScan.erase(it);
 
-    // load subfolder
-    CFileItemList items;
-    bool foundDirectly = false;
-    bool bSkip = false;
-
-    SScanSettings settings;
-    ScraperPtr info = m_database.GetScraperForPath(strDirectory, settings, foundDirectly);
-    CONTENT_TYPE content = info ? info->Content() : CONTENT_NONE;
-
-    // exclude folders that match our exclude regexps
-    const std::vector<std::string> &regexps = content == CONTENT_TVSHOWS ? g_advancedSettings.m_tvshowExcludeFromScanRegExps
-                                                         : g_advancedSettings.m_moviesExcludeFromScanRegExps;
-
-    if (IsExcluded(strDirectory, regexps))
+    if (folder.ignore)
       return true;
 
-    bool ignoreFolder = !m_scanAll && settings.noupdate;
-    if (content == CONTENT_NONE || ignoreFolder)
-      return true;
-
-    std::string hash, dbHash;
-    if (content == CONTENT_MOVIES ||content == CONTENT_MUSICVIDEOS)
+    if (m_handle)
     {
-      if (m_handle)
-      {
-        int str = content == CONTENT_MOVIES ? 20317:20318;
-        m_handle->SetTitle(StringUtils::Format(g_localizeStrings.Get(str).c_str(), info->Name().c_str()));
-      }
-
-      std::string fastHash;
-      if (g_advancedSettings.m_bVideoLibraryUseFastHash)
-        fastHash = GetFastHash(strDirectory, regexps);
-
-      if (m_database.GetPathHash(strDirectory, dbHash) && !fastHash.empty() && fastHash == dbHash)
-      { // fast hashes match - no need to process anything
-        hash = fastHash;
-      }
-      else
-      { // need to fetch the folder
-        CDirectory::GetDirectory(strDirectory, items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions());
-        items.Stack();
+      int str = 20319;
+      if (folder.content == CONTENT_MOVIES)
+        str = 20317;
+      else if (folder.content == CONTENT_MUSICVIDEOS)
+        str = 20318;
+      m_handle->SetTitle(StringUtils::Format(g_localizeStrings.Get(str).c_str(), folder.info->Name().c_str()));
+    }
+
+    // the listing may already be under way on a worker
+    if (!folder.queued)
+      ExamineFolder(folder);
+    folder.examined.Wait();
+    if (m_bStop)
+      return false;
 
-        // check whether to re-use previously computed fast hash
-        if (!CanFastHash(items, regexps) || fastHash.empty())
-          GetPathHash(items, hash);
-        else
-          hash = fastHash;
-      }
+    CFileItemList &items = folder.items;
+    const std::string &hash = folder.hash;
+    const std::string &dbHash = folder.dbHash;
+    bool bSkip = false;
 
+    if (folder.content == CONTENT_MOVIES || folder.content == CONTENT_MUSICVIDEOS)
+    {
       if (hash == dbHash)
       { // hash matches - skipping
-        CLog::Log(LOGDEBUG, "VideoInfoScanner: Skipping dir '%s' due to no change%s", CURL::GetRedacted(strDirectory).c_str(), !fastHash.empty() ? " (fasthash)" : "");
+        CLog::Log(LOGDEBUG, "VideoInfoScanner: Skipping dir '%s' due to no change%s", CURL::GetRedacted(strDirectory).c_str(), !folder.fastHash.empty() ? " (fasthash)" : "");
         bSkip = true;
       }
       else if (hash.empty())
@@ -316,59 +482,42 @@ namespace VIDEO
         CLog::Log(LOGDEBUG, "VideoInfoScanner: Rescanning dir '%s' due to change (%s != %s)", CURL::GetRedacted(strDirectory).c_str(), dbHash.c_str(), hash.c_str());
       }
     }
-    else if (content == CONTENT_TVSHOWS)
+    else if (folder.content == CONTENT_TVSHOWS)
     {
-      if (m_handle)
-        m_handle->SetTitle(StringUtils::Format(g_localizeStrings.Get(20319).c_str(), info->Name().c_str()));
-
-      if (foundDirectly && !settings.parent_name_root)
+      if (folder.foundDirectly && !folder.settings.parent_name_root)
       {
-        CDirectory::GetDirectory(strDirectory, items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions());
-        items.SetPath(strDirectory);
-        GetPathHash(items, hash);
         bSkip = true;
-        if (!m_database.GetPathHash(strDirectory, dbHash) || dbHash != hash)
+        if (!folder.hasDbHash || dbHash != hash)
           bSkip = false;
         else
           items.Clear();
       }
-      else
-      {
-        CFileItemPtr item(new CFileItem(URIUtils::GetFileName(strDirectory)));
-        item->SetPath(strDirectory);
-        item->m_bIsFolder = true;
-        items.Add(item);
-        items.SetPath(URIUtils::GetParentPath(item->GetPath()));
-      }
     }
 
     if (!bSkip)
     {
-      if (RetrieveVideoInfo(items, settings.parent_name_root, content))
-      {
-        if (!m_bStop && (content == CONTENT_MOVIES || content == CONTENT_MUSICVIDEOS))
-        {
-          m_database.SetPathHash(strDirectory, hash);
-          if (m_bClean)
-            m_pathsToClean.insert(m_database.GetPathId(strDirectory));
-          CLog::Log(LOGDEBUG, "VideoInfoScanner: Finished adding information from dir %s", CURL::GetRedacted(strDirectory).c_str());
-        }
-      }
+      if (m_pool && folder.content != CONTENT_TVSHOWS)
+        QueueVideoInfo(folderPtr); // finished once its videos are written
       else
-      {
-        if (m_bClean)
-          m_pathsToClean.insert(m_database.GetPathId(strDirectory));
-        CLog::Log(LOGDEBUG, "VideoInfoScanner: No (new) information was found in dir %s", CURL::GetRedacted(strDirectory).c_str());
-      }
+        FinishFolder(folder, RetrieveVideoInfo(items, folder.settings.parent_name_root, folder.content));
     }
-    else if (hash != dbHash && (content == CONTENT_MOVIES || content == CONTENT_MUSICVIDEOS))
-    { // update the hash either way - we may have changed the hash to a fast version
-      m_database.SetPathHash(strDirectory, hash);
+    else
+    {
+      if (hash != dbHash && (folder.content == CONTENT_MOVIES || folder.content == CONTENT_MUSICVIDEOS))
+      { // update the hash either way - we may have changed the hash to a fast version
+        m_database.SetPathHash(strDirectory, hash);
+      }
+
+      if (m_handle)
+        OnDirectoryScanned(strDirectory);
     }
 
-    if (m_handle)
-      OnDirectoryScanned(strDirectory);
+    // do not recurse for tv shows - we have already looked recursively for episodes
+    if (folder.settings.recurse <= 0 || folder.content == CONTENT_TVSHOWS)
+      return !m_bStop;
 
+    // if we have a directory item (non-playlist) we then recurse into that folder
+    std::vector<std::shared_ptr<FolderScan>> subFolders;
     for (int i = 0; i < items.Size(); ++i)
     {
       CFileItemPtr pItem = items[i];
@@ -376,19 +525,65 @@ namespace VIDEO
       if (m_bStop)
         break;
 
-      // if we have a directory item (non-playlist) we then recurse into that folder
-      // do not recurse for tv shows - we have already looked recursively for episodes
-      if (pItem->m_bIsFolder && !pItem->IsParentFolder() && !pItem->IsPlayList() && settings.recurse > 0 && content != CONTENT_TVSHOWS)
+      if (pItem->m_bIsFolder && !pItem->IsParentFolder() && !pItem->IsPlayList())
+        subFolders.push_back(PrepareFolder(pItem->GetPath()));
+    }
+
+    // keep the workers listing the next few subfolders while we scan one
+    size_t ahead = m_pool ? m_pool->GetWorkers() : 0;
+    for (size_t i = 0; i < subFolders.size() && !m_bStop; ++i)
+    {
+      for (size_t j = i; j < subFolders.size() && j <= i + ahead; ++j)
+        QueueExamineFolder(subFolders[j]);
+
+      if (!ScanFolder(subFolders[i]))
       {
-        if (!DoScan(pItem->GetPath()))
-        {
-          m_bStop = true;
-        }
+        m_bStop = true;
       }
+      subFolders[i].reset();
     }
     return !m_bStop;
   }
 
+  void CVideoInfoScanner::FinishFolder(const FolderScan &folder, bool foundSomeInfo)
+  {
+    const std::string &strDirectory = folder.path;
+    if (foundSomeInfo)
+    {
+      if (!m_bStop && (folder.content == CONTENT_MOVIES || folder.content == CONTENT_MUSICVIDEOS))
+      {
+        m_database.SetPathHash(strDirectory, folder.hash);
+        if (m_bClean)
+          m_pathsToClean.insert(m_database.GetPathId(strDirectory));
+        CLog::Log(LOGDEBUG, "VideoInfoScanner: Finished adding information from dir %s", CURL::GetRedacted(strDirectory).c_str());
+      }
+    }
+    else
+    {
+      if (m_bClean)
+        m_pathsToClean.insert(m_database.GetPathId(strDirectory));
+      CLog::Log(LOGDEBUG, "VideoInfoScanner: No (new) information was found in dir %s", CURL::GetRedacted(strDirectory).c_str());
+    }
+
+    if (m_handle)
+      OnDirectoryScanned(strDirectory);
+  }
+
+  static void OnVideoNotFound(const CFileItem &item, CONTENT_TYPE content)
+  {
+    CLog::Log(LOGWARNING, "No information found for item '%s', it won't be added to the library.", CURL::GetRedacted(item.GetPath()).c_str());
+
+    MediaType mediaType = MediaTypeMovie;
+    if (content == CONTENT_TVSHOWS)
+      mediaType = MediaTypeTvShow;
+    else if (content == CONTENT_MUSICVIDEOS)
+      mediaType = MediaTypeMusicVideo;
+    CEventLog::GetInstance().Add(EventPtr(new CMediaLibraryEvent(
+      mediaType, item.GetPath(), 24145,
+      StringUtils::Format(g_localizeStrings.Get(24147).c_str(), mediaType.c_str(), URIUtils::GetFileName(item.GetPath()).c_str()),
+      item.GetArt("thumb"), CURL::GetRedacted(item.GetPath()), EventLevel::Warning)));
+  }
+
   bool CVideoInfoScanner::RetrieveVideoInfo(CFileItemList& items, bool bDirNames, CONTENT_TYPE content, bool useLocal, CScraperUrl* pURL, bool fetchEpisodes, CGUIDialogProgress* pDlgProgress)
   {
     if (pDlgProgress)
@@ -457,19 +652,7 @@ namespace VIDEO
       if (ret == INFO_ADDED || ret == INFO_HAVE_ALREADY)
         FoundSomeInfo = true;
       else if (ret == INFO_NOT_FOUND)
-      {
-        CLog::Log(LOGWARNING, "No information found for item '%s', it won't be added to the library.", CURL::GetRedacted(pItem->GetPath()).c_str());
-
-        MediaType mediaType = MediaTypeMovie;
-        if (info2->Content() == CONTENT_TVSHOWS)
-          mediaType = MediaTypeTvShow;
-        else if (info2->Content() == CONTENT_MUSICVIDEOS)
-          mediaType = MediaTypeMusicVideo;
-        CEventLog::GetInstance().Add(EventPtr(new CMediaLibraryEvent(
-          mediaType, pItem->GetPath(), 24145,
-          StringUtils::Format(g_localizeStrings.Get(24147).c_str(), mediaType.c_str(), URIUtils::GetFileName(pItem->GetPath()).c_str()),
-          pItem->GetArt("thumb"), CURL::GetRedacted(pItem->GetPath()), EventLevel::Warning)));
-      }
+        OnVideoNotFound(*pItem, info2->Content());
 
       pURL = NULL;
 
@@ -495,6 +678,182 @@ namespace VIDEO
     return FoundSomeInfo;
   }
 
+  void CVideoInfoScanner::QueueVideoInfo(const std::shared_ptr<FolderScan> &folderPtr)
+  {
+    FolderScan &folder = *folderPtr;
+    CFileItemList &items = folder.items;
+    bool bDirNames = folder.settings.parent_name_root;
+
+    // we do this since we may have a override per dir
+    std::vector<ScraperPtr> scrapers;
+    for (int i = 0; i < items.Size(); ++i)
+    {
+      const CFileItemPtr &pItem = items[i];
+      ScraperPtr info2 = m_database.GetScraperForPath(pItem->m_bIsFolder ? pItem->GetPath() : items.GetPath());
+      if (info2 && info2->Content() != CONTENT_MOVIES && info2->Content() != CONTENT_MUSICVIDEOS)
+      { // only movies and music videos are retrieved ahead, anything else the usual way
+        CommitPending(0);
+        FinishFolder(folder, RetrieveVideoInfo(items, bDirNames, folder.content));
+        return;
+      }
+      scrapers.push_back(info2);
+    }
+
+    std::shared_ptr<PendingFolder> pending = std::make_shared<PendingFolder>();
+    pending->folder = folderPtr;
+    m_pending.push_back(pending);
+
+    for (int i = 0; i < items.Size(); ++i)
+    {
+      CFileItemPtr pItem = items[i];
+      ScraperPtr &info2 = scrapers[i];
+      if (!info2) // skip
+        continue;
+
+      // Discard all exclude files defined by regExExclude
+      if (IsExcluded(pItem->GetPath(), GetExcludeRegExps(folder.content)))
+        continue;
+
+      // clear our scraper cache
+      info2->ClearCache();
+
+      if (pItem->m_bIsFolder || !pItem->IsVideo() || pItem->IsNFO() ||
+         (pItem->IsPlayList() && !URIUtils::HasExtension(pItem->GetPath(), ".strm")))
+        continue;
+
+      if (m_bStop)
+      {
+        pending->failed = true;
+        break;
+      }
+
+      if (info2->Content() == CONTENT_MOVIES ? m_database.HasMovieInfo(pItem->GetPath())
+                                             : m_database.HasMusicVideoInfo(pItem->GetPath()))
+      {
+        pending->foundSomeInfo = true;
+        continue;
+      }
+
+      std::shared_ptr<PendingVideo> video = std::make_shared<PendingVideo>();
+      video->item = pItem;
+      video->scraper = info2;
+      video->videoFolder = bDirNames;
+      video->progress = i*100.f/items.Size();
+      pending->videos.push_back(video);
+      m_pendingVideos++;
+
+      if (!m_pool->Submit([this, video]() { FetchVideo(*video); }))
+        FetchVideo(*video);
+
+      // write what's done while keeping a bounded number of videos in flight
+      CommitPending(m_maxPendingVideos);
+    }
+
+    pending->complete = true;
+    CommitPending(m_maxPendingVideos);
+  }
+
+  void CVideoInfoScanner::FetchVideo(PendingVideo &video)
+  {
+    CFileItem *pItem = video.item.get();
+    if (m_bStop)
+      video.result = INFO_CANCELLED;
+    else
+    {
+      if (m_handle)
+        m_handle->SetText(pItem->GetMovieName(video.videoFolder));
+
+      CNfoFile nfoReader;
+      bool useLocalArt = true;
+      video.result = FetchVideoInfo(pItem, video.videoFolder, video.scraper, true, NULL, nfoReader, NULL, useLocalArt);
+      if (video.result == INFO_ADDED)
+        PrepareVideo(pItem, video.scraper->Content(), video.videoFolder, useLocalArt, NULL, false);
+    }
+    video.fetched.Set();
+  }
+
+  void CVideoInfoScanner::CommitPending(unsigned int maxPending)
+  {
+    unsigned int batch = 0;
+    while (!m_pending.empty())
+    {
+      PendingFolder &pending = *m_pending.front();
+      if (pending.committed < pending.videos.size())
+      {
+        PendingVideo &video = *pending.videos[pending.committed];
+        if (!video.fetched.WaitMSec(0))
+        {
+          if (m_pendingVideos <= maxPending)
+            break;
+
+          // don't keep the database locked while waiting on the network
+          if (batch > 0)
+            m_database.CommitTransaction();
+          batch = 0;
+          video.fetched.Wait();
+        }
+
+        if (batch == 0)
+          m_database.BeginTransaction();
+        CommitVideo(pending, video);
+        pending.videos[pending.committed++].reset();
+        m_pendingVideos--;
+
+        if (!m_database.InTransaction())
+        { // the batch couldn't be started, scan the folder again next time
+          pending.failed = true;
+          batch = 0;
+        }
+        else if (++batch >= SCAN_COMMIT_BATCH)
+        {
+          m_database.CommitTransaction();
+          batch = 0;
+        }
+        continue;
+      }
+
+      if (!pending.complete)
+        break;
+
+      if (batch == 0)
+        m_database.BeginTransaction();
+      batch++;
+      FinishFolder(*pending.folder, pending.foundSomeInfo && !pending.failed);
+      m_pending.pop_front();
+    }
+
+    if (batch > 0)
+      m_database.CommitTransaction();
+  }
+
+  void CVideoInfoScanner::CommitVideo(PendingFolder &folder, const PendingVideo &video)
+  {
+    if (m_handle)
+      m_handle->SetPercentage(video.progress);
+
+    // the folder is scanned again next time, like after an error in RetrieveVideoInfo()
+    if (folder.failed)
+      return;
+
+    CFileItem *pItem = video.item.get();
+    INFO_RET ret = video.result;
+    if (ret == INFO_ADDED && StoreVideo(pItem, video.scraper->Content(), video.videoFolder, true, NULL, false) < 0)
+      ret = INFO_ERROR;
+
+    if (ret == INFO_CANCELLED || ret == INFO_ERROR)
+    {
+      CLog::Log(LOGWARNING,
+                "VideoInfoScanner: Error %u occurred while retrieving"
+                "information for %s.", ret,
+                CURL::GetRedacted(pItem->GetPath()).c_str());
+      folder.failed = true;
+    }
+    else if (ret == INFO_ADDED)
+      folder.foundSomeInfo = true;
+    else if (ret == INFO_NOT_FOUND)
+      OnVideoNotFound(*pItem, video.scraper->Content());
+  }
+
   CInfoScanner::INFO_RET
   CVideoInfoScanner::RetrieveInfoForTvShow(CFileItem *pItem,
                                            bool bDirNames,
@@ -602,46 +961,11 @@ namespace VIDEO
     if (m_handle)
       m_handle->SetText(pItem->GetMovieName(bDirNames));
 
-    CNfoFile::NFOResult result=CNfoFile::NO_NFO;
-    CScraperUrl scrUrl;
-    // handle .nfo files
-    if (useLocal)
-      result = CheckForNFOFile(pItem, bDirNames, info2, scrUrl);
-    if (result == CNfoFile::FULL_NFO)
-    {
-      pItem->GetVideoInfoTag()->Reset();
-      m_nfoReader.GetDetails(*pItem->GetVideoInfoTag());
-
-      if (AddVideo(pItem, info2->Content(), bDirNames, true) < 0)
-        return INFO_ERROR;
-      return INFO_ADDED;
-    }
-    if (result == CNfoFile::URL_NFO || result == CNfoFile::COMBINED_NFO)
-      pURL = &scrUrl;
-
-    CScraperUrl url;
-    int retVal = 0;
-    if (pURL && !pURL->m_url.empty())
-      url = *pURL;
-    else if ((retVal = FindVideo(pItem->GetMovieName(bDirNames), info2, url, pDlgProgress)) <= 0)
-      return retVal < 0 ? INFO_CANCELLED : INFO_NOT_FOUND;
-
-    CLog::Log(LOGDEBUG,
-              "VideoInfoScanner: Fetching url '%s' using %s scraper (content: '%s')",
-              url.m_url[0].m_url.c_str(), info2->Name().c_str(),
-              TranslateContent(info2->Content()).c_str());
-
-    if (GetDetails(pItem, url, info2,
-                   (result == CNfoFile::COMBINED_NFO
-                    || result == CNfoFile::PARTIAL_NFO) ? &m_nfoReader : NULL,
-                   pDlgProgress))
-    {
-      if (AddVideo(pItem, info2->Content(), bDirNames, useLocal) < 0)
-        return INFO_ERROR;
-      return INFO_ADDED;
-    }
-    //! @todo This is not strictly correct as we could fail to download information here or error, or be cancelled
-    return INFO_NOT_FOUND;
+    bool useLocalArt = useLocal;
+    INFO_RET ret = FetchVideoInfo(pItem, bDirNames, info2, useLocal, pURL, m_nfoReader, pDlgProgress, useLocalArt);
+    if (ret == INFO_ADDED && AddVideo(pItem, info2->Content(), bDirNames, useLocalArt) < 0)
+      return INFO_ERROR;
+    return ret;
   }
 
   CInfoScanner::INFO_RET
@@ -664,18 +988,33 @@ namespace VIDEO
     if (m_handle)
       m_handle->SetText(pItem->GetMovieName(bDirNames));
 
+    bool useLocalArt = useLocal;
+    INFO_RET ret = FetchVideoInfo(pItem, bDirNames, info2, useLocal, pURL, m_nfoReader, pDlgProgress, useLocalArt);
+    if (ret == INFO_ADDED && AddVideo(pItem, info2->Content(), bDirNames, useLocalArt) < 0)
+      return INFO_ERROR;
+    return ret;
+  }
+
+  CInfoScanner::INFO_RET
+  CVideoInfoScanner::FetchVideoInfo(CFileItem *pItem,
+                                    bool bDirNames,
+                                    ScraperPtr &info2,
+                                    bool useLocal,
+                                    CScraperUrl* pURL,
+                                    CNfoFile &nfoReader,
+                                    CGUIDialogProgress* pDlgProgress,
+                                    bool &useLocalArt)
+  {
     CNfoFile::NFOResult result=CNfoFile::NO_NFO;
     CScraperUrl scrUrl;
     // handle .nfo files
     if (useLocal)
-      result = CheckForNFOFile(pItem, bDirNames, info2, scrUrl);
+      result = CheckForNFOFile(pItem, bDirNames, info2, scrUrl, nfoReader);
     if (result == CNfoFile::FULL_NFO)
     {
       pItem->GetVideoInfoTag()->Reset();
-      m_nfoReader.GetDetails(*pItem->GetVideoInfoTag());
-
-      if (AddVideo(pItem, info2->Content(), bDirNames, true) < 0)
-        return INFO_ERROR;
+      nfoReader.GetDetails(*pItem->GetVideoInfoTag());
+      useLocalArt = true;
       return INFO_ADDED;
     }
     if (result == CNfoFile::URL_NFO || result == CNfoFile::COMBINED_NFO)
@@ -695,11 +1034,10 @@ namespace VIDEO
 
     if (GetDetails(pItem, url, info2,
                    (result == CNfoFile::COMBINED_NFO
-                    || result == CNfoFile::PARTIAL_NFO) ? &m_nfoReader : NULL,
+                    || result == CNfoFile::PARTIAL_NFO) ? &nfoReader : NULL,
                    pDlgProgress))
     {
-      if (AddVideo(pItem, info2->Content(), bDirNames, useLocal) < 0)
-        return INFO_ERROR;
+      useLocalArt = useLocal;
       return INFO_ADDED;
     }
     //! @todo This is not strictly correct as we could fail to download information here or error, or be cancelled
@@ -1193,9 +1531,29 @@ namespace VIDEO
     if (!m_database.Open())
       return -1;
 
+    PrepareVideo(pItem, content, videoFolder, useLocal, showInfo, libraryImport);
+    long lResult = StoreVideo(pItem, content, videoFolder, useLocal, showInfo, libraryImport);
+
+    m_database.Close();
+    return lResult;
+  }
+
+  void CVideoInfoScanner::PrepareVideo(CFileItem *pItem, const CONTENT_TYPE &content, bool videoFolder, bool useLocal, const CVideoInfoTag *showInfo, bool libraryImport)
+  {
     if (!libraryImport)
       GetArtwork(pItem, content, videoFolder, useLocal, showInfo ? showInfo->m_strPath : "");
 
+    if (content == CONTENT_MOVIES)
+    {
+      // find local trailer first
+      std::string strTrailer = pItem->FindTrailer();
+      if (!strTrailer.empty())
+        pItem->GetVideoInfoTag()->m_strTrailer = strTrailer;
+    }
+  }
+
+  long CVideoInfoScanner::StoreVideo(CFileItem *pItem, const CONTENT_TYPE &content, bool videoFolder, bool useLocal, const CVideoInfoTag *showInfo, bool libraryImport)
+  {
     // ensure the art map isn't completely empty by specifying an empty thumb
     std::map<std::string, std::string> art = pItem->GetArt();
     if (art.empty())
@@ -1225,11 +1583,6 @@ namespace VIDEO
 
     if (content == CONTENT_MOVIES)
     {
-      // find local trailer first
-      std::string strTrailer = pItem->FindTrailer();
-      if (!strTrailer.empty())
-        movieDetails.m_strTrailer = strTrailer;
-
       lResult = m_database.SetDetailsForMovie(pItem->GetPath(), movieDetails, art);
       movieDetails.m_iDbId = lResult;
       movieDetails.m_type = MediaTypeMovie;
@@ -1302,8 +1655,6 @@ namespace VIDEO
         movieDetails.GetResumePoint().IsSet())
       m_database.AddBookMarkToFile(pItem->GetPath(), movieDetails.GetResumePoint(), CBookmark::RESUME);
 
-    m_database.Close();
-
     CFileItemPtr itemCopy = CFileItemPtr(new CFileItem(*pItem));
     CVariant data;
     data["added"] = true;
@@ -1465,6 +1816,9 @@ namespace VIDEO
                                            const CVideoInfoTag& showInfo,
                                            CGUIDialogProgress* pDlgProgress /* = NULL */)
   {
+    if (m_pool && !pDlgProgress)
+      return ProcessSeriesFolderPipelined(files, scraper, useLocal, showInfo);
+
     if (pDlgProgress)
     {
       pDlgProgress->SetLine(1, CVariant{showInfo.m_strTitle});
@@ -1555,111 +1909,325 @@ namespace VIDEO
         continue;
       }
 
-      EPISODE key(file->iSeason, file->iEpisode, file->iSubepisode);
-      EPISODE backupkey(file->iSeason, file->iEpisode, 0);
-      bool bFound = false;
-      EPISODELIST::iterator guide = episodes.begin();
-      EPISODELIST matches;
+      EPISODE guide;
+      if (FindEpisodeInGuide(*file, episodes, showInfo, guide))
+      {
+        CVideoInfoDownloader imdb(scraper);
+        CFileItem item;
+        item.SetPath(file->strPath);
+        if (!imdb.GetEpisodeDetails(guide.cScraperUrl, *item.GetVideoInfoTag(), pDlgProgress))
+          return INFO_NOT_FOUND; //! @todo should we just skip to the next episode?
+          
+        // Only set season/epnum from filename when it is not already set by a scraper
+        if (item.GetVideoInfoTag()->m_iSeason == -1)
+          item.GetVideoInfoTag()->m_iSeason = guide.iSeason;
+        if (item.GetVideoInfoTag()->m_iEpisode == -1)
+          item.GetVideoInfoTag()->m_iEpisode = guide.iEpisode;
+          
+        if (AddVideo(&item, CONTENT_TVSHOWS, file->isFolder, useLocal, &showInfo) < 0)
+          return INFO_ERROR;
+      }
+      else
+      {
+        CLog::Log(LOGDEBUG,"%s - no match for show: '%s', season: %d, episode: %d.%d, airdate: '%s', title: '%s'",
+                  __FUNCTION__, showInfo.m_strTitle.c_str(), file->iSeason, file->iEpisode, file->iSubepisode,
+                  file->cDate.GetAsLocalizedDate().c_str(), file->strTitle.c_str());
+      }
+    }
+    return INFO_ADDED;
+  }
+
+  CInfoScanner::INFO_RET
+  CVideoInfoScanner::ProcessSeriesFolderPipelined(EPISODELIST& files,
+                                                  const ADDON::ScraperPtr &scraper,
+                                                  bool useLocal,
+                                                  const CVideoInfoTag& showInfo)
+  {
+    // workers may still run after an early return, so they get their own copy of the show
+    std::shared_ptr<const CVideoInfoTag> show = std::make_shared<CVideoInfoTag>(showInfo);
+
+    // look for .nfo files of the episodes not in the library yet
+    std::vector<std::shared_ptr<PendingVideo>> videos;
+    for (EPISODELIST::iterator file = files.begin(); file != files.end(); ++file)
+    {
+      if (m_bStop)
+        break;
+
+      if (m_database.GetEpisodeId(file->strPath, file->iEpisode, file->iSeason) > -1)
+        continue;
+
+      std::shared_ptr<PendingVideo> video = std::make_shared<PendingVideo>();
+      video->item.reset(new CFileItem);
+      video->item->SetPath(file->strPath);
+      video->item->GetVideoInfoTag()->m_iEpisode = file->iEpisode;
+      video->file = *file;
+      video->videoFolder = file->isFolder;
+      video->progress = 100.f * (file - files.begin() + 1) / files.size();
+      video->needsGuide = true;
+      videos.push_back(video);
+
+      if (!useLocal)
+      {
+        video->fetched.Set();
+        continue;
+      }
+
+      video->scraper = GetScraperForWorker(scraper);
+      if (!video->scraper)
+      {
+        video->scraper = scraper;
+        FetchEpisodeNfo(*video, *show);
+      }
+      else if (!m_pool->Submit([this, video, show]() { FetchEpisodeNfo(*video, *show); }))
+        FetchEpisodeNfo(*video, *show);
+    }
 
-      for (; guide != episodes.end(); ++guide )
+    // match the others against the episode guide and retrieve their details
+    EPISODELIST episodes;
+    bool hasEpisodeGuide = false;
+    for (std::vector<std::shared_ptr<PendingVideo>>::iterator i = videos.begin(); i != videos.end(); ++i)
+    {
+      PendingVideo &video = **i;
+      video.fetched.Wait();
+      if (m_bStop)
+      {
+        video.result = INFO_CANCELLED;
+        break;
+      }
+      if (!video.needsGuide)
+        continue;
+
+      video.result = INFO_NOT_NEEDED;
+      if (!hasEpisodeGuide)
       {
-        if ((file->iEpisode!=-1) && (file->iSeason!=-1))
+        // fetch episode guide
+        if (!show->m_strEpisodeGuide.empty())
         {
-          if (key==*guide)
+          CScraperUrl url;
+          url.ParseEpisodeGuide(show->m_strEpisodeGuide);
+
+          CVideoInfoDownloader imdb(scraper);
+          if (!imdb.GetEpisodeList(url, episodes))
           {
-            bFound = true;
+            video.result = INFO_NOT_FOUND;
             break;
           }
-          else if ((file->iSubepisode!=0) && (backupkey==*guide))
-          {
-            matches.push_back(*guide);
-            continue;
-          }
+
+          hasEpisodeGuide = true;
         }
-        if (file->cDate.IsValid() && guide->cDate.IsValid() && file->cDate==guide->cDate)
-        {
-          matches.push_back(*guide);
-          continue;
+      }
+
+      if (episodes.empty())
+      {
+        CLog::Log(LOGERROR, "VideoInfoScanner: Asked to lookup episode %s"
+                            " online, but we have no episode guide. Check your tvshow.nfo and make"
+                            " sure the <episodeguide> tag is in place.", CURL::GetRedacted(video.file.strPath).c_str());
+        continue;
+      }
+
+      if (!FindEpisodeInGuide(video.file, episodes, *show, video.guide))
+      {
+        CLog::Log(LOGDEBUG,"%s - no match for show: '%s', season: %d, episode: %d.%d, airdate: '%s', title: '%s'",
+                  __FUNCTION__, show->m_strTitle.c_str(), video.file.iSeason, video.file.iEpisode, video.file.iSubepisode,
+                  video.file.cDate.GetAsLocalizedDate().c_str(), video.file.strTitle.c_str());
+        continue;
+      }
+
+      video.item.reset(new CFileItem);
+      video.item->SetPath(video.file.strPath);
+      video.fetched.Reset();
+
+      std::shared_ptr<PendingVideo> videoPtr = *i;
+      video.scraper = GetScraperForWorker(scraper);
+      if (!video.scraper)
+      {
+        video.scraper = scraper;
+        FetchEpisodeDetails(video, useLocal, *show);
+      }
+      else if (!m_pool->Submit([this, videoPtr, useLocal, show]() { FetchEpisodeDetails(*videoPtr, useLocal, *show); }))
+        FetchEpisodeDetails(video, useLocal, *show);
+    }
+
+    // add the episodes in order, stopping at the first one that failed
+    INFO_RET ret = m_bStop ? INFO_CANCELLED : INFO_ADDED;
+    unsigned int batch = 0;
+    for (std::vector<std::shared_ptr<PendingVideo>>::iterator i = videos.begin(); i != videos.end(); ++i)
+    {
+      PendingVideo &video = **i;
+      if (!video.fetched.WaitMSec(0))
+      {
+        // don't keep the database locked while waiting on the network
+        if (batch > 0)
+          m_database.CommitTransaction();
+        batch = 0;
+        video.fetched.Wait();
+      }
+
+      if (m_handle)
+        m_handle->SetPercentage(video.progress);
+
+      if (video.result == INFO_ADDED)
+      {
+        if (batch++ == 0)
+          m_database.BeginTransaction();
+        if (StoreVideo(video.item.get(), CONTENT_TVSHOWS, video.videoFolder, useLocal, show.get(), false) < 0 ||
+            !m_database.InTransaction())
+        { // errors only roll back the episode they happened in, but the batch may not have started
+          ret = INFO_ERROR;
+          break;
         }
-        if (!guide->cScraperUrl.strTitle.empty() && StringUtils::EqualsNoCase(guide->cScraperUrl.strTitle, file->strTitle))
+        if (batch >= SCAN_COMMIT_BATCH)
         {
-          bFound = true;
-          break;
+          m_database.CommitTransaction();
+          batch = 0;
         }
       }
+      else if (video.result == INFO_NOT_FOUND || video.result == INFO_CANCELLED)
+      {
+        ret = video.result;
+        break;
+      }
+    }
+
+    if (batch > 0 && m_database.InTransaction())
+      m_database.CommitTransaction();
+    return ret;
+  }
 
-      if (!bFound)
+  void CVideoInfoScanner::FetchEpisodeNfo(PendingVideo &video, const CVideoInfoTag &showInfo)
+  {
+    if (!m_bStop)
+    {
+      CFileItem &item = *video.item;
+      CNfoFile nfoReader;
+      CScraperUrl scrUrl;
+      if (CheckForNFOFile(&item, false, video.scraper, scrUrl, nfoReader) == CNfoFile::FULL_NFO)
       {
-        /*
-         * If there is only one match or there are matches but no title to compare with to help
-         * identify the best match, then pick the first match as the best possible candidate.
-         *
-         * Otherwise, use the title to further refine the best match.
-         */
-        if (matches.size() == 1 || (file->strTitle.empty() && matches.size() > 1))
+        nfoReader.GetDetails(*item.GetVideoInfoTag());
+        // override with episode and season number from file if available
+        if (video.file.iEpisode > -1)
         {
-          guide = matches.begin();
-          bFound = true;
+          item.GetVideoInfoTag()->m_iEpisode = video.file.iEpisode;
+          item.GetVideoInfoTag()->m_iSeason = video.file.iSeason;
         }
-        else if (!file->strTitle.empty())
-        {
-          double minscore = 0; // Default minimum score is 0 to find whatever is the best match.
+        PrepareVideo(&item, CONTENT_TVSHOWS, video.videoFolder, true, &showInfo, false);
+        video.needsGuide = false;
+        video.result = INFO_ADDED;
+      }
+    }
+    video.fetched.Set();
+  }
 
-          EPISODELIST *candidates;
-          if (matches.empty()) // No matches found using earlier criteria. Use fuzzy match on titles across all episodes.
-          {
-            minscore = 0.8; // 80% should ensure a good match.
-            candidates = &episodes;
-          }
-          else // Multiple matches found. Use fuzzy match on the title with already matched episodes to pick the best.
-            candidates = &matches;
+  void CVideoInfoScanner::FetchEpisodeDetails(PendingVideo &video, bool useLocal, const CVideoInfoTag &showInfo)
+  {
+    if (m_bStop)
+      video.result = INFO_CANCELLED;
+    else
+    {
+      CVideoInfoDownloader imdb(video.scraper);
+      CVideoInfoTag &tag = *video.item->GetVideoInfoTag();
+      if (!imdb.GetEpisodeDetails(video.guide.cScraperUrl, tag))
+        video.result = INFO_NOT_FOUND; //! @todo should we just skip to the next episode?
+      else
+      {
+        // Only set season/epnum from filename when it is not already set by a scraper
+        if (tag.m_iSeason == -1)
+          tag.m_iSeason = video.guide.iSeason;
+        if (tag.m_iEpisode == -1)
+          tag.m_iEpisode = video.guide.iEpisode;
 
-          std::vector<std::string> titles;
-          for (guide = candidates->begin(); guide != candidates->end(); ++guide)
-          {
-            StringUtils::ToLower(guide->cScraperUrl.strTitle);
-            titles.push_back(guide->cScraperUrl.strTitle);
-          }
+        PrepareVideo(video.item.get(), CONTENT_TVSHOWS, video.videoFolder, useLocal, &showInfo, false);
+        video.result = INFO_ADDED;
+      }
+    }
+    video.fetched.Set();
+  }
 
-          double matchscore;
-          std::string loweredTitle(file->strTitle);
-          StringUtils::ToLower(loweredTitle);
-          int index = StringUtils::FindBestMatch(loweredTitle, titles, matchscore);
-          if (index >= 0 && matchscore >= minscore)
-          {
-            guide = candidates->begin() + index;
-            bFound = true;
-            CLog::Log(LOGDEBUG,"%s fuzzy title match for show: '%s', title: '%s', match: '%s', score: %f >= %f",
-                      __FUNCTION__, showInfo.m_strTitle.c_str(), file->strTitle.c_str(), titles[index].c_str(), matchscore, minscore);
-          }
+  bool CVideoInfoScanner::FindEpisodeInGuide(const EPISODE &file, EPISODELIST &episodes, const CVideoInfoTag &showInfo, EPISODE &match)
+  {
+    EPISODE key(file.iSeason, file.iEpisode, file.iSubepisode);
+    EPISODE backupkey(file.iSeason, file.iEpisode, 0);
+    bool bFound = false;
+    EPISODELIST::iterator guide = episodes.begin();
+    EPISODELIST matches;
+
+    for (; guide != episodes.end(); ++guide )
+    {
+      if ((file.iEpisode!=-1) && (file.iSeason!=-1))
+      {
+        if (key==*guide)
+        {
+          bFound = true;
+          break;
+        }
+        else if ((file.iSubepisode!=0) && (backupkey==*guide))
+        {
+          matches.push_back(*guide);
+          continue;
         }
       }
+      if (file.cDate.IsValid() && guide->cDate.IsValid() && file.cDate==guide->cDate)
+      {
+        matches.push_back(*guide);
+        continue;
+      }
+      if (!guide->cScraperUrl.strTitle.empty() && StringUtils::EqualsNoCase(guide->cScraperUrl.strTitle, file.strTitle))
+      {
+        bFound = true;
+        break;
+      }
+    }
 
-      if (bFound)
+    if (!bFound)
+    {
+      /*
+       * If there is only one match or there are matches but no title to compare with to help
+       * identify the best match, then pick the first match as the best possible candidate.
+       *
+       * Otherwise, use the title to further refine the best match.
+       */
+      if (matches.size() == 1 || (file.strTitle.empty() && matches.size() > 1))
       {
-        CVideoInfoDownloader imdb(scraper);
-        CFileItem item;
-        item.SetPath(file->strPath);
-        if (!imdb.GetEpisodeDetails(guide->cScraperUrl, *item.GetVideoInfoTag(), pDlgProgress))
-          return INFO_NOT_FOUND; //! @todo should we just skip to the next episode?
-          
-        // Only set season/epnum from filename when it is not already set by a scraper
-        if (item.GetVideoInfoTag()->m_iSeason == -1)
-          item.GetVideoInfoTag()->m_iSeason = guide->iSeason;
-        if (item.GetVideoInfoTag()->m_iEpisode == -1)
-          item.GetVideoInfoTag()->m_iEpisode = guide->iEpisode;
-          
-        if (AddVideo(&item, CONTENT_TVSHOWS, file->isFolder, useLocal, &showInfo) < 0)
-          return INFO_ERROR;
+        guide = matches.begin();
+        bFound = true;
       }
-      else
+      else if (!file.strTitle.empty())
       {
-        CLog::Log(LOGDEBUG,"%s - no match for show: '%s', season: %d, episode: %d.%d, airdate: '%s', title: '%s'",
-                  __FUNCTION__, showInfo.m_strTitle.c_str(), file->iSeason, file->iEpisode, file->iSubepisode,
-                  file->cDate.GetAsLocalizedDate().c_str(), file->strTitle.c_str());
+        double minscore = 0; // Default minimum score is 0 to find whatever is the best match.
+
+        EPISODELIST *candidates;
+        if (matches.empty()) // No matches found using earlier criteria. Use fuzzy match on titles across all episodes.
+        {
+          minscore = 0.8; // 80% should ensure a good match.
+          candidates = &episodes;
+        }
+        else // Multiple matches found. Use fuzzy match on the title with already matched episodes to pick the best.
+          candidates = &matches;
+
+        std::vector<std::string> titles;
+        for (guide = candidates->begin(); guide != candidates->end(); ++guide)
+        {
+          StringUtils::ToLower(guide->cScraperUrl.strTitle);
+          titles.push_back(guide->cScraperUrl.strTitle);
+        }
+
+        double matchscore;
+        std::string loweredTitle(file.strTitle);
+        StringUtils::ToLower(loweredTitle);
+        int index = StringUtils::FindBestMatch(loweredTitle, titles, matchscore);
+        if (index >= 0 && matchscore >= minscore)
+        {
+          guide = candidates->begin() + index;
+          bFound = true;
+          CLog::Log(LOGDEBUG,"%s fuzzy title match for show: '%s', title: '%s', match: '%s', score: %f >= %f",
+                    __FUNCTION__, showInfo.m_strTitle.c_str(), file.strTitle.c_str(), titles[index].c_str(), matchscore, minscore);
+        }
       }
     }
-    return INFO_ADDED;
+
+    if (bFound)
+      match = *guide;
+    return bFound;
   }
 
   std::string CVideoInfoScanner::GetnfoFile(CFileItem *item, bool bGrabAny) const
@@ -1886,10 +2454,15 @@ namespace VIDEO
     {
       int64_t stat_time = 0;
       struct __stat64 buffer;
-      if (XFILE::CFile::Stat(items[i]->GetPath(), &buffer) == 0)
+      // filesystems returning the times with the listing don't need another round trip
+      const CVariant &mtime = items[i]->GetProperty("file:mtime");
+      if (!mtime.isNull())
+      {
+        stat_time = mtime.asInteger();
+        time += stat_time;
+      }
+      else if (XFILE::CFile::Stat(items[i]->GetPath(), &buffer) == 0)
       {
-        //! @todo some filesystems may return the mtime/ctime inline, in which case this is
-        //! unnecessarily expensive. Consider supporting Stat() in our directory cache?
         stat_time = buffer.st_mtime ? buffer.st_mtime : buffer.st_ctime;
         time += stat_time;
       }
@@ -2026,6 +2599,11 @@ namespace VIDEO
   }
 
   CNfoFile::NFOResult CVideoInfoScanner::CheckForNFOFile(CFileItem* pItem, bool bGrabAny, ScraperPtr& info, CScraperUrl& scrUrl)
+  {
+    return CheckForNFOFile(pItem, bGrabAny, info, scrUrl, m_nfoReader);
+  }
+
+  CNfoFile::NFOResult CVideoInfoScanner::CheckForNFOFile(CFileItem* pItem, bool bGrabAny, ScraperPtr& info, CScraperUrl& scrUrl, CNfoFile &nfoReader)
   {
     std::string strNfoFile;
     if (info->Content() == CONTENT_MOVIES || info->Content() == CONTENT_MUSICVIDEOS
@@ -2038,9 +2616,9 @@ namespace VIDEO
     if (!strNfoFile.empty() && CFile::Exists(strNfoFile))
     {
       if (info->Content() == CONTENT_TVSHOWS && !pItem->m_bIsFolder)
-        result = m_nfoReader.Create(strNfoFile,info,pItem->GetVideoInfoTag()->m_iEpisode);
+        result = nfoReader.Create(strNfoFile,info,pItem->GetVideoInfoTag()->m_iEpisode);
       else
-        result = m_nfoReader.Create(strNfoFile,info);
+        result = nfoReader.Create(strNfoFile,info);
 
       std::string type;
       switch(result)
@@ -2068,19 +2646,19 @@ namespace VIDEO
       if (result == CNfoFile::FULL_NFO)
       {
         if (info->Content() == CONTENT_TVSHOWS)
-          info = m_nfoReader.GetScraperInfo();
+          info = nfoReader.GetScraperInfo();
       }
       else if (result != CNfoFile::NO_NFO && result != CNfoFile::ERROR_NFO)
       {
         if (result != CNfoFile::PARTIAL_NFO)
         {
-          scrUrl = m_nfoReader.ScraperUrl();
+          scrUrl = nfoReader.ScraperUrl();
           StringUtils::RemoveCRLF(scrUrl.m_url[0].m_url);
-          info = m_nfoReader.GetScraperInfo();
+          info = nfoReader.GetScraperInfo();
         }
 
         if (result != CNfoFile::URL_NFO)
-          m_nfoReader.GetDetails(*pItem->GetVideoInfoTag());
+          nfoReader.GetDetails(*pItem->GetVideoInfoTag());
       }
     }
     else
@@ -2120,7 +2698,13 @@ namespace VIDEO
     MOVIELIST movielist;
     CVideoInfoDownloader imdb(scraper);
     int returncode = imdb.FindMovie(videoName, movielist, progress);
-    if (returncode < 0 || (returncode == 0 && (m_bStop || !DownloadFailed(progress))))
+    if (returncode == 0 && !m_bStop)
+    { // lookups on several workers may fail at once, ask one at a time
+      CSingleLock lock(m_errorSection);
+      if (!m_bStop && !DownloadFailed(progress))
+        m_bStop = true;
+    }
+    if (returncode < 0 || (returncode == 0 && m_bStop))
     { // scraper reported an error, or we had an error and user wants to cancel the scan
       m_bStop = true;
       return -1; // cancelled
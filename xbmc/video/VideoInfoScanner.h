@@ -19,6 +19,8 @@
  *
  */
 
+#include <deque>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -27,10 +29,12 @@
 #include "NfoFile.h"
 #include "VideoDatabase.h"
 #include "addons/Scraper.h"
+#include "threads/CriticalSection.h"
 
 class CRegExp;
 class CFileItem;
 class CFileItemList;
+class CWorkerPool;
 
 namespace VIDEO
 {
@@ -83,6 +87,7 @@ namespace VIDEO
     static void ApplyThumbToFolder(const std::string &folder, const std::string &imdbThumb);
     static bool DownloadFailed(CGUIDialogProgress* pDlgProgress);
     CNfoFile::NFOResult CheckForNFOFile(CFileItem* pItem, bool bGrabAny, ADDON::ScraperPtr& scraper, CScraperUrl& scrUrl);
+    CNfoFile::NFOResult CheckForNFOFile(CFileItem* pItem, bool bGrabAny, ADDON::ScraperPtr& scraper, CScraperUrl& scrUrl, CNfoFile &nfoReader);
 
     /*! \brief Retrieve any artwork associated with an item
      \param pItem item to find artwork for.
@@ -114,14 +119,81 @@ namespace VIDEO
     bool EnumerateEpisodeItem(const CFileItem *item, EPISODELIST& episodeList);
 
   protected:
+    struct FolderScan;
+    struct PendingVideo;
+    struct PendingFolder;
+
     virtual void Process();
     bool DoScan(const std::string& strDirectory) override;
 
+    /*! \brief Look up how a folder is to be scanned, must be called on the scanner thread
+     \param strDirectory folder to scan
+     \return the folder, ready to be examined
+     */
+    std::shared_ptr<FolderScan> PrepareFolder(const std::string &strDirectory);
+
+    /*! \brief List and hash a folder, safe to be called on a worker of m_pool
+     \param folder folder returned by PrepareFolder()
+     */
+    void ExamineFolder(FolderScan &folder) const;
+
+    /*! \brief Let a worker examine the folder while the scanner thread is busy with the previous ones
+     */
+    void QueueExamineFolder(const std::shared_ptr<FolderScan> &folder);
+
+    /*! \brief Scan a prepared folder and its subfolders
+     \return false if the scan was cancelled
+     */
+    bool ScanFolder(const std::shared_ptr<FolderScan> &folder);
+
+    /*! \brief Update path hash and clean list of a folder once its videos are in the database
+     \param folder the scanned folder
+     \param foundSomeInfo whether information was found for some of its videos
+     */
+    void FinishFolder(const FolderScan &folder, bool foundSomeInfo);
+
+    /*! \brief Retrieve information for the movies or music videos of a folder on the workers of m_pool
+     Videos are written to the database by CommitPending() in the order they are listed.
+     */
+    void QueueVideoInfo(const std::shared_ptr<FolderScan> &folder);
+
+    /*! \brief Write the videos retrieved by the workers to the database, in order
+     \param maxPending number of videos which may remain in flight, blocks until no more are
+     */
+    void CommitPending(unsigned int maxPending);
+    void CommitVideo(PendingFolder &folder, const PendingVideo &video);
+
+    /*! \brief Retrieve information and artwork of a video, safe to be called on a worker of m_pool
+     */
+    void FetchVideo(PendingVideo &video);
+
     INFO_RET RetrieveInfoForTvShow(CFileItem *pItem, bool bDirNames, ADDON::ScraperPtr &scraper, bool useLocal, CScraperUrl* pURL, bool fetchEpisodes, CGUIDialogProgress* pDlgProgress);
     INFO_RET RetrieveInfoForMovie(CFileItem *pItem, bool bDirNames, ADDON::ScraperPtr &scraper, bool useLocal, CScraperUrl* pURL, CGUIDialogProgress* pDlgProgress);
     INFO_RET RetrieveInfoForMusicVideo(CFileItem *pItem, bool bDirNames, ADDON::ScraperPtr &scraper, bool useLocal, CScraperUrl* pURL, CGUIDialogProgress* pDlgProgress);
     INFO_RET RetrieveInfoForEpisodes(CFileItem *item, long showID, const ADDON::ScraperPtr &scraper, bool useLocal, CGUIDialogProgress *progress = NULL);
 
+    /*! \brief Retrieve online information for a movie or music video not in the library yet
+     \param pItem item to retrieve information for
+     \param bDirNames whether we should use folder or file names for lookups.
+     \param scraper scraper to use, may be replaced by the one named in an .nfo file
+     \param useLocal should local data (.nfo and art) be used.
+     \param pURL an optional URL to use to retrieve online info.
+     \param nfoReader reader for the .nfo file of the item
+     \param pDlgProgress progress dialog to update and check for cancellation during processing.
+     \param useLocalArt [out] whether local art should be used for the item
+     \return INFO_ADDED if the details of pItem are ready to be added, INFO_NOT_FOUND or INFO_CANCELLED otherwise
+     */
+    INFO_RET FetchVideoInfo(CFileItem *pItem, bool bDirNames, ADDON::ScraperPtr &scraper, bool useLocal, CScraperUrl* pURL, CNfoFile &nfoReader, CGUIDialogProgress* pDlgProgress, bool &useLocalArt);
+
+    /*! \brief Add a video with artwork already retrieved to the database, see AddVideo()
+     The database must be open.
+     */
+    long StoreVideo(CFileItem *pItem, const CONTENT_TYPE &content, bool videoFolder, bool useLocal, const CVideoInfoTag *showInfo, bool libraryImport);
+
+    /*! \brief Retrieve what AddVideo() needs from the filesystem and the network: artwork and local trailers
+     */
+    void PrepareVideo(CFileItem *pItem, const CONTENT_TYPE &content, bool videoFolder, bool useLocal, const CVideoInfoTag *showInfo, bool libraryImport);
+
     /*! \brief Update the progress bar with the heading and line and check for cancellation
      \param progress CGUIDialogProgress bar
      \param heading string id of heading
@@ -221,6 +293,27 @@ namespace VIDEO
      */
     INFO_RET OnProcessSeriesFolder(EPISODELIST& files, const ADDON::ScraperPtr &scraper, bool useLocal, const CVideoInfoTag& showInfo, CGUIDialogProgress* pDlgProgress = NULL);
 
+    /*! \brief Process a series folder like OnProcessSeriesFolder(), with the lookups done on the workers of m_pool
+     */
+    INFO_RET ProcessSeriesFolderPipelined(EPISODELIST& files, const ADDON::ScraperPtr &scraper, bool useLocal, const CVideoInfoTag& showInfo);
+
+    /*! \brief Look for a full .nfo file of an episode, safe to be called on a worker of m_pool
+     */
+    void FetchEpisodeNfo(PendingVideo &video, const CVideoInfoTag &showInfo);
+
+    /*! \brief Retrieve the details of an episode found in the episode guide, safe to be called on a worker of m_pool
+     */
+    void FetchEpisodeDetails(PendingVideo &video, bool useLocal, const CVideoInfoTag &showInfo);
+
+    /*! \brief Find the entry of the episode guide matching an episode file
+     \param file the episode file
+     \param episodes the episode guide of the show
+     \param showInfo information for the show.
+     \param match [out] the matching entry
+     \return true if a match was found
+     */
+    bool FindEpisodeInGuide(const EPISODE &file, EPISODELIST &episodes, const CVideoInfoTag &showInfo, EPISODE &match);
+
     bool EnumerateSeriesFolder(CFileItem* item, EPISODELIST& episodeList);
     bool ProcessItemByVideoInfoTag(const CFileItem *item, EPISODELIST &episodeList);
 
@@ -233,6 +326,12 @@ namespace VIDEO
     std::set<std::string> m_pathsToCount;
     std::set<int> m_pathsToClean;
     CNfoFile m_nfoReader;
+
+    std::unique_ptr<CWorkerPool> m_pool;   ///< workers for lookups while scanning, see <videoscanner><threads>
+    std::deque<std::shared_ptr<PendingFolder>> m_pending; ///< folders with videos waiting to be written to the database
+    unsigned int m_pendingVideos;           ///< number of videos in m_pending not written yet
+    unsigned int m_maxPendingVideos;
+    CCriticalSection m_errorSection;        ///< serialises asking whether to continue after a failed lookup
   };
 }
 
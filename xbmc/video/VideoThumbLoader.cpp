@@ -52,7 +52,8 @@ CThumbExtractor::CThumbExtractor(const CFileItem& item,
                                  bool thumb,
                                  const std::string& target,
                                  int64_t pos,
-                                 bool fillStreamDetails)
+                                 bool fillStreamDetails,
+                                 const CDVDFileInfo::ThumbDecodersPtr& decoders)
 {
   m_listpath = listpath;
   m_target = target;
@@ -60,6 +61,7 @@ CThumbExtractor::CThumbExtractor(const CFileItem& item,
   m_item = item;
   m_pos = pos;
   m_fillStreamDetails = fillStreamDetails;
+  m_decoders = decoders;
 
   if (item.IsVideoDb() && item.HasVideoInfoTag())
     m_item.SetPath(item.GetVideoInfoTag()->m_strFileNameAndPath);
@@ -82,28 +84,36 @@ bool CThumbExtractor::operator==(const CJob* job) const
   return false;
 }
 
-bool CThumbExtractor::DoWork()
+bool CThumbExtractor::CanExtract(const CFileItem& item)
 {
-  if (m_item.IsLiveTV()
+  if (item.IsLiveTV()
   // Due to a pvr addon api design flaw (no support for multiple concurrent streams
   // per addon instance), pvr recording thumbnail extraction does not work (reliably).
-  ||  m_item.IsPVRRecording()
-  ||  URIUtils::IsUPnP(m_item.GetPath())
-  ||  URIUtils::IsBluray(m_item.GetPath())
-  ||  m_item.IsBDFile()
-  ||  m_item.IsDVD()
-  ||  m_item.IsDiscImage()
-  ||  m_item.IsDVDFile(false, true)
-  ||  m_item.IsInternetStream()
-  ||  m_item.IsDiscStub()
-  ||  m_item.IsPlayList())
+  ||  item.IsPVRRecording()
+  ||  URIUtils::IsUPnP(item.GetPath())
+  ||  URIUtils::IsBluray(item.GetPath())
+  ||  item.IsBDFile()
+  ||  item.IsDVD()
+  ||  item.IsDiscImage()
+  ||  item.IsDVDFile(false, true)
+  ||  item.IsInternetStream()
+  ||  item.IsDiscStub()
+  ||  item.IsPlayList())
     return false;
 
   // For HTTP/FTP we only allow extraction when on a LAN
-  if (URIUtils::IsRemote(m_item.GetPath()) &&
-     !URIUtils::IsOnLAN(m_item.GetPath())  &&
-     (URIUtils::IsFTP(m_item.GetPath())    ||
-      URIUtils::IsHTTP(m_item.GetPath())))
+  if (URIUtils::IsRemote(item.GetPath()) &&
+     !URIUtils::IsOnLAN(item.GetPath())  &&
+     (URIUtils::IsFTP(item.GetPath())    ||
+      URIUtils::IsHTTP(item.GetPath())))
+    return false;
+
+  return true;
+}
+
+bool CThumbExtractor::DoWork()
+{
+  if (!CanExtract(m_item))
     return false;
 
   bool result=false;
@@ -113,7 +123,13 @@ bool CThumbExtractor::DoWork()
     // construct the thumb cache file
     CTextureDetails details;
     details.file = CTextureCache::GetCacheFile(m_target) + ".jpg";
-    result = CDVDFileInfo::ExtractThumb(m_item.GetPath(), details, m_fillStreamDetails ? &m_item.GetVideoInfoTag()->m_streamDetails : NULL, (int) m_pos);
+    std::vector<CDVDFileInfo::ThumbRequest> requests(1);
+    requests[0].path = m_item.GetPath();
+    requests[0].details = &details;
+    requests[0].streamDetails = m_fillStreamDetails ? &m_item.GetVideoInfoTag()->m_streamDetails : nullptr;
+    requests[0].pos = static_cast<int>(m_pos);
+    CDVDFileInfo::ExtractThumbs(requests, 1, m_decoders);
+    result = requests[0].result;
     if(result)
     {
       CTextureCache::GetInstance().AddCachedTexture(m_target, details);
@@ -197,6 +213,7 @@ void CVideoThumbLoader::OnLoaderStart()
   m_videoDatabase->Open();
   m_showArt.clear();
   m_seasonArt.clear();
+  m_thumbDecoders = CDVDFileInfo::CreateThumbDecoders();
   CThumbLoader::OnLoaderStart();
 }
 
@@ -205,6 +222,8 @@ void CVideoThumbLoader::OnLoaderFinish()
   m_videoDatabase->Close();
   m_showArt.clear();
   m_seasonArt.clear();
+  // jobs still queued keep the decoders until they are done
+  m_thumbDecoders.reset();
   CThumbLoader::OnLoaderFinish();
 }
 
@@ -397,7 +416,7 @@ bool CVideoThumbLoader::LoadItemLookup(CFileItem* pItem)
         if (URIUtils::IsInRAR(item.GetPath()))
           SetupRarOptions(item,path);
 
-        CThumbExtractor* extract = new CThumbExtractor(item, path, true, thumbURL);
+        CThumbExtractor* extract = new CThumbExtractor(item, path, true, thumbURL, -1, true, m_thumbDecoders);
         AddJob(extract);
 
         m_videoDatabase->Close();
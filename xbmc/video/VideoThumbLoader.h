@@ -24,6 +24,7 @@
 #include "ThumbLoader.h"
 #include "utils/JobManager.h"
 #include "FileItem.h"
+#include "cores/VideoPlayer/DVDFileInfo.h"
 
 class CStreamDetails;
 class CVideoDatabase;
@@ -39,9 +40,15 @@ class CVideoDatabase;
 class CThumbExtractor : public CJob
 {
 public:
-  CThumbExtractor(const CFileItem& item, const std::string& listpath, bool thumb, const std::string& strTarget="", int64_t pos = -1, bool fillStreamDetails = true);
+  CThumbExtractor(const CFileItem& item, const std::string& listpath, bool thumb, const std::string& strTarget="", int64_t pos = -1, bool fillStreamDetails = true,
+                  const CDVDFileInfo::ThumbDecodersPtr& decoders = nullptr);
   ~CThumbExtractor() override;
 
+  /*!
+   \brief Whether thumbs and stream details may be extracted from the item
+   */
+  static bool CanExtract(const CFileItem& item);
+
   /*!
    \brief Work function that extracts thumb.
    */
@@ -60,6 +67,7 @@ public:
   bool       m_thumb; ///< extract thumb?
   int64_t    m_pos; ///< position to extract thumb from
   bool m_fillStreamDetails; ///< fill in stream details? 
+  CDVDFileInfo::ThumbDecodersPtr m_decoders; ///< decoders shared with the other jobs of the loader
 };
 
 class CVideoThumbLoader : public CThumbLoader, public CJobQueue
@@ -128,6 +136,7 @@ public:
 
 protected:
   CVideoDatabase *m_videoDatabase;
+  CDVDFileInfo::ThumbDecodersPtr m_thumbDecoders;
   typedef std::map<int, std::map<std::string, std::string> > ArtCache;
   ArtCache m_showArt;
   ArtCache m_seasonArt;
@@ -41,8 +41,10 @@
 #include "utils/Variant.h"
 #include "Util.h"
 #include "video/VideoThumbLoader.h"
+#include "cores/VideoPlayer/DVDFileInfo.h"
 #include "filesystem/File.h"
 #include "TextureCache.h"
+#include "URL.h"
 #include "messaging/ApplicationMessenger.h"
 #include "settings/Settings.h"
 #include <string>
@@ -58,6 +60,58 @@ using namespace KODI::MESSAGING;
 
 #define CONTROL_THUMBS                11
 
+/*!
+ \brief Extracts the missing chapter thumbs of a file in a single pass over it
+ */
+class CChapterThumbExtractor : public CJob
+{
+public:
+  CChapterThumbExtractor(const std::string &path, const std::vector<std::pair<std::string, int64_t>> &chapters)
+    : m_path(path), m_chapters(chapters)
+  {
+  }
+
+  bool DoWork() override
+  {
+    if (!CThumbExtractor::CanExtract(CFileItem(m_path, false)))
+      return false;
+
+    CLog::Log(LOGDEBUG, "%s - trying to extract %u chapter thumbs from video file %s", __FUNCTION__,
+              static_cast<unsigned int>(m_chapters.size()), CURL::GetRedacted(m_path).c_str());
+
+    std::vector<CTextureDetails> details(m_chapters.size());
+    std::vector<CDVDFileInfo::ThumbRequest> requests(m_chapters.size());
+    for (size_t i = 0; i < m_chapters.size(); ++i)
+    {
+      details[i].file = CTextureCache::GetCacheFile(m_chapters[i].first) + ".jpg";
+      requests[i].path = m_path;
+      requests[i].details = &details[i];
+      requests[i].pos = static_cast<int>(m_chapters[i].second);
+    }
+    CDVDFileInfo::ExtractThumbs(requests);
+
+    bool result = false;
+    for (size_t i = 0; i < requests.size(); ++i)
+    {
+      if (requests[i].result)
+      {
+        CTextureCache::GetInstance().AddCachedTexture(m_chapters[i].first, details[i]);
+        result = true;
+      }
+    }
+    return result;
+  }
+
+  const char* GetType() const override
+  {
+    return kJobTypeMediaFlags;
+  }
+
+private:
+  std::string m_path;
+  std::vector<std::pair<std::string, int64_t>> m_chapters; ///< thumb path and position in ms
+};
+
 CGUIDialogVideoBookmarks::CGUIDialogVideoBookmarks()
     : CGUIDialog(WINDOW_DIALOG_VIDEO_BOOKMARKS, "VideoOSDBookmarks.xml"),
     CJobQueue(false, 1, CJob::PRIORITY_NORMAL)
@@ -144,7 +198,7 @@ bool CGUIDialogVideoBookmarks::OnMessage(CGUIMessage& message)
         OnRefreshList();
         break;
       case 1:
-        UpdateItem(message.GetParam2());
+        UpdateChapterThumbs();
         break;
       default:
         break;
@@ -208,26 +262,20 @@ void CGUIDialogVideoBookmarks::Delete(int item)
   Update();
 }
 
-void CGUIDialogVideoBookmarks::UpdateItem(unsigned int chapterIdx)
+void CGUIDialogVideoBookmarks::UpdateChapterThumbs()
 {
   CSingleLock lock(m_refreshSection);
 
-  int itemPos = 0;
   for (auto& item : m_vecItems->GetList())
   {
-    if (chapterIdx == item->GetProperty("chapter").asInteger())
-      break;
-    itemPos++;
-  }
+    int chapterIdx = static_cast<int>(item->GetProperty("chapter").asInteger());
+    if (chapterIdx <= 0 || item->HasArt("thumb"))
+      continue;
 
-  if (itemPos < m_vecItems->Size())
-  {
     std::string time = StringUtils::Format("chapter://%s/%i", m_filePath.c_str(), chapterIdx);
     std::string cachefile = CTextureCache::GetInstance().GetCachedPath(CTextureCache::GetInstance().GetCacheFile(time) + ".jpg");
     if (XFILE::CFile::Exists(cachefile))
-    {
-      (*m_vecItems)[itemPos]->SetArt("thumb", cachefile);
-    }
+      item->SetArt("thumb", cachefile);
   }
 }
 
@@ -270,6 +318,7 @@ void CGUIDialogVideoBookmarks::OnRefreshList()
   }
 
   // add chapters if around
+  std::vector<std::pair<std::string, int64_t>> missingThumbs;
   for (int i = 1; i <= g_application.m_pPlayer->GetChapterCount(); ++i)
   {
     std::string chapterName;
@@ -292,11 +341,8 @@ void CGUIDialogVideoBookmarks::OnRefreshList()
       item->SetArt("thumb", cachefile);
     else if (i > m_jobsStarted && CServiceBroker::GetSettings().GetBool(CSettings::SETTING_MYVIDEOS_EXTRACTCHAPTERTHUMBS))
     {
-      CFileItem item(m_filePath, false);
-      CJob* job = new CThumbExtractor(item, m_filePath, true, chapterPath, pos * 1000, false);
-      AddJob(job);
-      m_mapJobsChapter[job] = i;
-      m_jobsStarted++;
+      missingThumbs.push_back(std::make_pair(chapterPath, pos * 1000));
+      m_jobsStarted = i;
     }
 
     item->SetProperty("chapter", i);
@@ -305,6 +351,10 @@ void CGUIDialogVideoBookmarks::OnRefreshList()
     items.push_back(item);
   }
 
+  // all chapters come from the same file, extract them in one go
+  if (!missingThumbs.empty())
+    AddJob(new CChapterThumbExtractor(m_filePath, missingThumbs));
+
   // sort items by resume point
   std::sort(items.begin(), items.end(), [](const CFileItemPtr &item1, const CFileItemPtr &item2) {
     return item1->GetProperty("resumepoint").asDouble() < item2->GetProperty("resumepoint").asDouble();
@@ -477,7 +527,6 @@ void CGUIDialogVideoBookmarks::OnWindowLoaded()
   m_viewControl.SetParentWindow(GetID());
   m_viewControl.AddView(GetControl(CONTROL_THUMBS));
   m_jobsStarted = 0;
-  m_mapJobsChapter.clear();
   m_vecItems->Clear();
 }
 
@@ -485,7 +534,6 @@ void CGUIDialogVideoBookmarks::OnWindowUnload()
 {
   //stop running thumb extraction jobs
   CancelJobs();
-  m_mapJobsChapter.clear();
   m_vecItems->Clear();
   CGUIDialog::OnWindowUnload();
   m_viewControl.Reset();
@@ -575,14 +623,8 @@ void CGUIDialogVideoBookmarks::OnJobComplete(unsigned int jobID,
 {
   if (success && IsActive())
   {
-    MAPJOBSCHAPS::iterator iter = m_mapJobsChapter.find(job);
-    if (iter != m_mapJobsChapter.end())
-    {
-      unsigned int chapterIdx = (*iter).second;
-      CGUIMessage m(GUI_MSG_REFRESH_LIST, GetID(), 0, 1, chapterIdx);
-      CApplicationMessenger::GetInstance().SendGUIMessage(m);
-      m_mapJobsChapter.erase(iter);
-    }
+    CGUIMessage m(GUI_MSG_REFRESH_LIST, GetID(), 0, 1);
+    CApplicationMessenger::GetInstance().SendGUIMessage(m);
   }
   CJobQueue::OnJobComplete(jobID, success, job);
 }
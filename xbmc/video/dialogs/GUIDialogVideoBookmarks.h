@@ -29,8 +29,6 @@ class CFileItemList;
 
 class CGUIDialogVideoBookmarks : public CGUIDialog, public CJobQueue
 {
-  typedef std::map<CJob*, unsigned int> MAPJOBSCHAPS;
-
 public:
   CGUIDialogVideoBookmarks(void);
   ~CGUIDialogVideoBookmarks(void) override;
@@ -79,10 +77,9 @@ protected:
   VECBOOKMARKS m_bookmarks;
 
 private:
-  void UpdateItem(unsigned int chapterIdx);
+  void UpdateChapterThumbs();
 
   int m_jobsStarted;
   std::string m_filePath;
   CCriticalSection m_refreshSection;
-  MAPJOBSCHAPS m_mapJobsChapter;
 };
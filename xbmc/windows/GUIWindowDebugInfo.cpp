@@ -29,6 +29,7 @@
 #include "guilib/GUIControlFactory.h"
 #include "guilib/GUIFontManager.h"
 #include "guilib/GUITextLayout.h"
+#include "guilib/GUITexture.h"
 #include "guilib/GUIWindowManager.h"
 #include "guilib/GUIControlProfiler.h"
 #include "GUIInfoManager.h"
@@ -44,6 +45,7 @@ CGUIWindowDebugInfo::CGUIWindowDebugInfo(void)
 {
   m_needsScaling = false;
   m_layout = nullptr;
+  m_drawCount = 0;
   m_renderOrder = RENDER_ORDER_WINDOW_DEBUG;
 }
 
@@ -146,6 +148,7 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
       point.y *= g_graphicsContext.GetGUIScaleY();
       g_graphicsContext.SetRenderingResolution(g_graphicsContext.GetResInfo(), false);
     }
+    info += StringUtils::Format("Texture draws: %u per frame\n", CGUITexture::GetDrawCount() - m_drawCount);
     info += StringUtils::Format("Mouse: (%d,%d)  ", static_cast<int>(point.x), static_cast<int>(point.y));
     if (window)
     {
@@ -155,6 +158,8 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
     }
   }
 
+  m_drawCount = CGUITexture::GetDrawCount();
+
   float w, h;
   if (m_layout->Update(info))
     MarkDirtyRegion();
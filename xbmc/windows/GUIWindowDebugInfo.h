@@ -40,6 +40,7 @@ protected:
   void UpdateVisibility() override;
 private:
   CGUITextLayout *m_layout;
+  unsigned int m_drawCount; ///< texture draw calls issued up to the previous frame
 #ifdef TARGET_POSIX
   CLinuxResourceCounter m_resourceCounter;
 #endif